@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/World.h"
+#include "Model/MapFormat.h"
+
+#include <kdl/vector_utils.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumBrushes = 64'000;
+        static constexpr size_t NumTextures = 256;
+
+        TEST_CASE("BrushFaceAttributesBenchmark.sharedAttributes", "[BrushFaceAttributesBenchmark]") {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard);
+            BrushBuilder builder(&world, worldBounds);
+
+            // brushes with a handful of distinct texture alignments, cycling through the texture names
+            std::vector<Brush*> brushes;
+            size_t faceCount = 0u;
+            size_t currentTextureIndex = 0u;
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumBrushes; ++i) {
+                    Brush* brush = builder.createCube(64.0, "");
+                    for (auto* face : brush->faces()) {
+                        auto attribs = face->attribs();
+                        const auto textureName = "texture_" + std::to_string((currentTextureIndex++) % NumTextures);
+                        auto renamed = BrushFaceAttributes(textureName, attribs);
+                        renamed.setXOffset(static_cast<float>((i % 4u) * 16u));
+                        face->setAttribs(renamed);
+                        ++faceCount;
+                    }
+                    brushes.push_back(brush);
+                }
+            }, "create " + std::to_string(NumBrushes) + " brushes");
+
+            std::vector<Brush*> clones;
+            clones.reserve(brushes.size());
+            timeLambda([&]() {
+                for (const auto* brush : brushes) {
+                    clones.push_back(brush->clone(worldBounds));
+                }
+            }, "clone " + std::to_string(NumBrushes) + " brushes");
+
+            const auto stats = BrushFaceAttributes::memoryStats();
+
+            // The following figures are estimated from the sizes of the involved types rather than measured, and they
+            // ignore allocator overhead and the characters of the texture names. Unshared is what each face used to
+            // store: its own texture name string and its own copy of the attribute values.
+            const auto unsharedBytes = faceCount * 2u * (sizeof(std::string) + stats.valueSize);
+            const auto sharedBytes = faceCount * 2u * (sizeof(const std::string*) + sizeof(std::shared_ptr<void>))
+                + stats.internedValueCount * stats.valueSize
+                + stats.textureNameCount * sizeof(std::string);
+
+            std::printf("%zu faces share %zu attribute blocks and %zu texture names\n", 2u * faceCount, stats.internedValueCount, stats.textureNameCount);
+            std::printf("Estimated face attribute memory: %zu bytes unshared, %zu bytes shared\n", unsharedBytes, sharedBytes);
+
+            CHECK(stats.internedValueCount < faceCount);
+
+            kdl::vec_clear_and_delete(clones);
+            kdl::vec_clear_and_delete(brushes);
+        }
+    }
+}
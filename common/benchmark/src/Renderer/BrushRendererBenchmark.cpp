@@ -24,13 +24,22 @@
 #include "BenchmarkUtils.h"
 
 #include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushFace.h"
 #include "Model/World.h"
 #include "Model/MapFormat.h"
 #include "Renderer/BrushRenderer.h"
-
+#include "Renderer/FontManager.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "Renderer/RenderBatch.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/VboManager.h"
+
+#include <cstdio>
 #include <vector>
 #include <chrono>
 #include <string>
@@ -41,14 +50,16 @@ namespace TrenchBroom {
     namespace Renderer {
         static constexpr size_t NumBrushes = 64'000;
         static constexpr size_t NumTextures = 256;
+        static constexpr size_t ManyTextures = 4096;
+        static constexpr size_t NumFrames = 100;
 
         /**
          * Both returned vectors need to be freed with VecUtils::clearAndDelete
          */
-        static std::pair<std::vector<Model::Brush*>, std::vector<Assets::Texture*>> makeBrushes() {
+        static std::pair<std::vector<Model::Brush*>, std::vector<Assets::Texture*>> makeBrushes(const size_t numTextures = NumTextures) {
             // make textures
             std::vector<Assets::Texture*> textures;
-            for (size_t i = 0; i < NumTextures; ++i) {
+            for (size_t i = 0; i < numTextures; ++i) {
                 const auto textureName = "texture " + std::to_string(i);
                 textures.push_back(new Assets::Texture(textureName, 64, 64));
             }
@@ -64,7 +75,7 @@ namespace TrenchBroom {
             for (size_t i = 0; i < NumBrushes; ++i) {
                 Model::Brush* brush = builder.createCube(64.0, "");
                 for (auto* face : brush->faces()) {
-                    face->setTexture(textures.at((currentTextureIndex++) % NumTextures));
+                    face->setTexture(textures.at((currentTextureIndex++) % numTextures));
                 }
                 result.push_back(brush);
             }
@@ -128,6 +139,92 @@ namespace TrenchBroom {
             kdl::vec_clear_and_delete(brushes);
             kdl::vec_clear_and_delete(textures);
         }
+    
+        /**
+         * Submits the given renderer to a render batch the given number of times, like a map view does once per frame.
+         * The batch is discarded instead of being rendered, since that would require an OpenGL context.
+         */
+        static void submitFrames(BrushRenderer& renderer, RenderContext& renderContext, VboManager& vboManager, const size_t frameCount) {
+            for (size_t i = 0; i < frameCount; ++i) {
+                RenderBatch renderBatch(vboManager);
+                renderer.render(renderContext, renderBatch);
+            }
+        }
+
+        TEST_CASE("BrushRendererBenchmark.benchBrushRendererManyTextures", "[BrushRendererBenchmark]") {
+            auto brushesTextures = makeBrushes(ManyTextures);
+            std::vector<Model::Brush*> brushes = brushesTextures.first;
+            std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+            FontManager fontManager;
+            ShaderManager shaderManager;
+            VboManager vboManager;
+
+            const auto viewport = Camera::Viewport(0, 0, 1920, 1080);
+            const auto position = vm::vec3f(-512.0f, -512.0f, 768.0f);
+            const PerspectiveCamera camera(90.0f, 1.0f, 8192.0f, viewport, position, vm::normalize(-position), vm::vec3f::pos_z());
+            RenderContext renderContext(RenderMode::Render3D, camera, fontManager, shaderManager);
+
+            BrushRenderer r;
+            r.addBrushes(brushes);
+
+            // the first submission builds one index array per texture, which is what the face renderer draws from
+            timeLambda([&](){ submitFrames(r, renderContext, vboManager, 1u); },
+                       "submit first frame of " + std::to_string(brushes.size()) + " brushes with " + std::to_string(textures.size()) + " textures");
+
+            timeLambda([&](){ submitFrames(r, renderContext, vboManager, NumFrames); },
+                       "submit " + std::to_string(NumFrames) + " unchanged frames of " + std::to_string(brushes.size()) + " brushes with " + std::to_string(textures.size()) + " textures");
+
+            // remove every second brush, leaving holes in every per texture index array that the following frames
+            // compact incrementally
+            std::vector<Model::Brush*> brushesToKeep;
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                if ((i % 2) == 0) {
+                    brushesToKeep.push_back(brushes.at(i));
+                }
+            }
+            r.setBrushes(brushesToKeep);
+
+            timeLambda([&](){ submitFrames(r, renderContext, vboManager, NumFrames); },
+                       "submit " + std::to_string(NumFrames) + " frames of " + std::to_string(brushesToKeep.size()) + " brushes with " + std::to_string(textures.size()) + " textures after removing every second brush");
+
+            timeLambda([&](){ r.compact(brushesToKeep.size()); },
+                       "compact " + std::to_string(brushesToKeep.size()) + " brushes with " + std::to_string(textures.size()) + " textures");
+
+            kdl::vec_clear_and_delete(brushes);
+            kdl::vec_clear_and_delete(textures);
+        }
+
+        TEST_CASE("BrushRendererBenchmark.benchTextureArrayPacking", "[BrushRendererBenchmark]") {
+            // Quake era textures come in a few small sizes, each with a full set of mipmaps
+            static constexpr size_t MipmapCount = 4;
+            std::vector<Assets::Texture*> textures;
+            for (size_t i = 0; i < ManyTextures; ++i) {
+                const auto size = size_t(16) << (i % 3);
+                std::vector<std::vector<unsigned char>> buffers;
+                for (size_t level = 0; level < MipmapCount; ++level) {
+                    const auto mipSize = Assets::sizeAtMipLevel(size, size, level);
+                    buffers.emplace_back(mipSize.x() * mipSize.y() * 4u, static_cast<unsigned char>(0));
+                }
+                textures.push_back(new Assets::Texture("texture " + std::to_string(i), size, size, Color(), std::move(buffers), GL_RGBA, Assets::TextureType::Opaque));
+            }
+
+            // 2048 is the number of layers that current GPUs typically support
+            std::vector<std::vector<Assets::Texture*>> groups;
+            timeLambda([&](){ groups = Assets::TextureCollection::textureArrayGroups(textures, 2048u); },
+                       "group " + std::to_string(textures.size()) + " textures into texture arrays");
+
+            size_t packedCount = 0;
+            for (const auto& group : groups) {
+                packedCount += group.size();
+            }
+            ASSERT_EQ(textures.size(), packedCount);
+
+            // the face renderer binds each texture array once, and every texture that was not packed individually
+            std::printf("Texture binds per frame for %zu textures: %zu without texture arrays, %zu with texture arrays\n",
+                        textures.size(), textures.size(), groups.size() + textures.size() - packedCount);
+
+            kdl::vec_clear_and_delete(textures);
+        }
     }
 }
-
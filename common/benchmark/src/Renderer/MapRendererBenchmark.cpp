@@ -0,0 +1,318 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+#include "../../test/src/Model/TestGame.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Assets/Texture.h"
+#include "Model/AssortNodesVisitor.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/EditorContext.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+#include "Renderer/FontManager.h"
+#include "Renderer/FrameProfiler.h"
+#include "Renderer/MapRenderer.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "Renderer/RenderBatch.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/VboManager.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * These benchmarks drive the CPU side of the map renderer: brush vertex and index generation, index range
+ * building, entity bounds, entity link and text layout. The render batch is discarded instead of being rendered, so
+ * no OpenGL calls are made and no OpenGL context is required.
+ */
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t GridSize = 32;
+        static constexpr size_t GridLayers = 8;
+        static constexpr size_t NumLights = 1024;
+        static constexpr size_t NumButtons = 256;
+        static constexpr size_t NumTextures = 256;
+        static constexpr size_t NumFrames = 10;
+
+        static void writeCube(std::ostream& str, const vm::vec3& min, const vm::vec3& max) {
+            const auto point = [&](const vm::vec3& p) {
+                str << "( " << p.x() << " " << p.y() << " " << p.z() << " ) ";
+            };
+            const auto face = [&](const vm::vec3& p1, const vm::vec3& p2, const vm::vec3& p3) {
+                point(p1);
+                point(p2);
+                point(p3);
+                str << "none 0 0 0 1 1\n";
+            };
+
+            const auto x0 = min.x(), y0 = min.y(), z0 = min.z();
+            const auto x1 = max.x(), y1 = max.y(), z1 = max.z();
+
+            str << "{\n";
+            face(vm::vec3(x0, y0, z0), vm::vec3(x0, y0, z1), vm::vec3(x1, y0, z0));
+            face(vm::vec3(x0, y0, z0), vm::vec3(x0, y1, z0), vm::vec3(x0, y0, z1));
+            face(vm::vec3(x0, y0, z0), vm::vec3(x1, y0, z0), vm::vec3(x0, y1, z0));
+            face(vm::vec3(x1, y1, z1), vm::vec3(x0, y1, z1), vm::vec3(x1, y1, z0));
+            face(vm::vec3(x1, y1, z1), vm::vec3(x1, y1, z0), vm::vec3(x1, y0, z1));
+            face(vm::vec3(x1, y1, z1), vm::vec3(x1, y0, z1), vm::vec3(x0, y1, z1));
+            str << "}\n";
+        }
+
+        /**
+         * Returns a map with a grid of world brushes, point entities, and brush entities that target the point
+         * entities so that there are entity links to render.
+         */
+        static std::string makeMap() {
+            std::stringstream str;
+
+            str << "{\n\"classname\" \"worldspawn\"\n";
+            for (size_t z = 0; z < GridLayers; ++z) {
+                for (size_t y = 0; y < GridSize; ++y) {
+                    for (size_t x = 0; x < GridSize; ++x) {
+                        const auto min = vm::vec3(static_cast<double>(x), static_cast<double>(y), static_cast<double>(z)) * 64.0;
+                        writeCube(str, min, min + vm::vec3(32.0, 32.0, 32.0));
+                    }
+                }
+            }
+            str << "}\n";
+
+            for (size_t i = 0; i < NumLights; ++i) {
+                const auto x = static_cast<double>(i % GridSize) * 64.0 + 16.0;
+                const auto y = static_cast<double>(i / GridSize) * 64.0 + 16.0;
+                str << "{\n\"classname\" \"light\"\n"
+                    << "\"targetname\" \"light" << i << "\"\n"
+                    << "\"origin\" \"" << x << " " << y << " " << static_cast<double>(GridLayers) * 64.0 << "\"\n"
+                    << "}\n";
+            }
+
+            for (size_t i = 0; i < NumButtons; ++i) {
+                const auto min = vm::vec3(static_cast<double>(i % GridSize), static_cast<double>(i / GridSize), -1.0) * 64.0;
+                str << "{\n\"classname\" \"func_button\"\n"
+                    << "\"target\" \"light" << (i * NumLights / NumButtons) << "\"\n";
+                writeCube(str, min, min + vm::vec3(32.0, 32.0, 32.0));
+                str << "}\n";
+            }
+
+            return str.str();
+        }
+
+        /**
+         * Returns a map with the same grid of world brushes as makeMap(), divided into rooms by thick walls so that
+         * most of the grid is hidden from a camera in the first room.
+         */
+        static std::string makeOccludedMap() {
+            static constexpr size_t RoomSize = 4;
+
+            std::stringstream str;
+
+            str << "{\n\"classname\" \"worldspawn\"\n";
+            for (size_t z = 0; z < GridLayers; ++z) {
+                for (size_t y = 0; y < GridSize; ++y) {
+                    for (size_t x = 0; x < GridSize; ++x) {
+                        const auto min = vm::vec3(static_cast<double>(x), static_cast<double>(y), static_cast<double>(z)) * 64.0;
+                        writeCube(str, min, min + vm::vec3(32.0, 32.0, 32.0));
+                    }
+                }
+            }
+
+            const auto extent = static_cast<double>(GridSize) * 64.0;
+            const auto height = static_cast<double>(GridLayers) * 64.0;
+            for (size_t y = RoomSize; y < GridSize; y += RoomSize) {
+                const auto wallY = static_cast<double>(y) * 64.0 - 24.0;
+                writeCube(str, vm::vec3(-64.0, wallY, -64.0), vm::vec3(extent + 64.0, wallY + 16.0, height + 64.0));
+            }
+            str << "}\n";
+
+            return str.str();
+        }
+
+        /**
+         * Assigns the given textures to the brush faces in turn so that the brush renderer has to build one index
+         * array per texture.
+         */
+        static void assignTextures(Model::World& world, const std::vector<Assets::Texture*>& textures) {
+            Model::CollectBrushesVisitor collect;
+            world.acceptAndRecurse(collect);
+
+            size_t currentTextureIndex = 0;
+            for (auto* brush : collect.brushes()) {
+                for (auto* face : brush->faces()) {
+                    face->setTexture(textures[(currentTextureIndex++) % textures.size()]);
+                }
+            }
+        }
+
+        static void renderFrame(MapRenderer& mapRenderer, RenderContext& renderContext, VboManager& vboManager) {
+            auto& profiler = FrameProfiler::instance();
+            profiler.beginFrame();
+            {
+                // the batch is discarded without rendering it, which would require an OpenGL context
+                RenderBatch renderBatch(vboManager);
+                mapRenderer.render(renderContext, renderBatch);
+            }
+            profiler.endFrame();
+        }
+
+        static void printStatistics(const std::string& scenario) {
+            for (const auto& entry : FrameProfiler::instance().statistics()) {
+                printf("%s, '%s': min %fms, avg %fms, max %fms over %zu frames\n",
+                       scenario.c_str(), entry.name.c_str(), entry.minMs, entry.avgMs, entry.maxMs, entry.frameCount);
+            }
+        }
+
+        TEST_CASE("MapRendererBenchmark.benchRenderPrep", "[MapRendererBenchmark]") {
+            std::vector<Assets::Texture*> textures;
+            for (size_t i = 0; i < NumTextures; ++i) {
+                textures.push_back(new Assets::Texture("texture " + std::to_string(i), 64, 64));
+            }
+
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = View::MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(8192.0), game);
+            document->editorContext().setEntityLinkMode(Model::EditorContext::EntityLinkMode_All);
+
+            {
+                auto mapRenderer = std::make_unique<MapRenderer>(document);
+
+                const auto map = makeMap();
+                timeLambda([&]() { document->paste(map); }, "paste map with " + std::to_string(GridSize * GridSize * GridLayers + NumButtons) + " brushes");
+                document->deselectAll();
+                assignTextures(*document->world(), textures);
+
+                FontManager fontManager;
+                ShaderManager shaderManager;
+                VboManager vboManager;
+
+                const auto viewport = Camera::Viewport(0, 0, 1920, 1080);
+                const auto center = vm::vec3f(static_cast<float>(GridSize) * 32.0f, static_cast<float>(GridSize) * 32.0f, 0.0f);
+                const auto position = center + vm::vec3f(-512.0f, -512.0f, 768.0f);
+                const PerspectiveCamera camera(90.0f, 1.0f, 8192.0f, viewport, position, vm::normalize(center - position), vm::vec3f::pos_z());
+                RenderContext renderContext(RenderMode::Render3D, camera, fontManager, shaderManager);
+
+                auto& profiler = FrameProfiler::instance();
+                profiler.clear();
+                profiler.setEnabled(true);
+
+                // the first frame validates everything from scratch and sizes the arrays
+                renderFrame(*mapRenderer, renderContext, vboManager);
+                printStatistics("initial frame");
+                profiler.clear();
+
+                // changing the editor context invalidates all renderers
+                for (size_t i = 0; i < NumFrames; ++i) {
+                    document->editorContext().setBlockSelection(i % 2 == 0);
+                    renderFrame(*mapRenderer, renderContext, vboManager);
+                }
+                printStatistics("invalidate all");
+                profiler.clear();
+
+                // selecting everything moves all objects between the default and the selection renderers
+                for (size_t i = 0; i < NumFrames; ++i) {
+                    if (i % 2 == 0) {
+                        document->selectAllNodes();
+                    } else {
+                        document->deselectAll();
+                    }
+                    renderFrame(*mapRenderer, renderContext, vboManager);
+                }
+                printStatistics("select all / deselect all");
+                profiler.clear();
+
+                // nothing changes, which is the cost of every frame while the camera moves
+                for (size_t i = 0; i < NumFrames; ++i) {
+                    renderFrame(*mapRenderer, renderContext, vboManager);
+                }
+                printStatistics("unchanged");
+                profiler.clear();
+                profiler.setEnabled(false);
+
+                // the renderer observes the document, so it must be destroyed first
+                mapRenderer.reset();
+            }
+
+            // the brush faces reference the textures
+            document.reset();
+            kdl::vec_clear_and_delete(textures);
+        }
+
+        TEST_CASE("MapRendererBenchmark.benchOcclusionCulling", "[MapRendererBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = View::MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(8192.0), game);
+
+            document->paste(makeOccludedMap());
+            document->deselectAll();
+
+            const auto& world = *document->world();
+            const auto& editorContext = document->editorContext();
+
+            const auto viewport = Camera::Viewport(0, 0, 1920, 1080);
+            const auto height = static_cast<float>(GridLayers) * 32.0f;
+            const auto center = static_cast<float>(GridSize) * 32.0f;
+
+            OcclusionCuller culler;
+            auto& profiler = FrameProfiler::instance();
+            profiler.clear();
+            profiler.setEnabled(true);
+
+            // looking down the rooms from a gap between the brushes in the first room, so that only the brushes in the
+            // first room are visible
+            const auto insidePosition = vm::vec3f(center - 16.0f, 48.0f, height - 16.0f);
+            const PerspectiveCamera insideCamera(90.0f, 1.0f, 8192.0f, viewport, insidePosition, vm::vec3f::pos_y(), vm::vec3f::pos_z());
+            for (size_t i = 0; i < NumFrames; ++i) {
+                profiler.beginFrame();
+                culler.update(insideCamera, world, editorContext);
+                profiler.endFrame();
+            }
+            printStatistics("inside first room");
+            printf("inside first room: %zu occluders, %zu visible nodes\n", culler.occluderCount(), culler.visibleNodeCount());
+            profiler.clear();
+
+            // looking at the whole map from above, so that nothing is occluded
+            const PerspectiveCamera aboveCamera(90.0f, 1.0f, 8192.0f, viewport, vm::vec3f(center, center, 4096.0f), vm::vec3f::neg_z(), vm::vec3f::pos_y());
+            for (size_t i = 0; i < NumFrames; ++i) {
+                profiler.beginFrame();
+                culler.update(aboveCamera, world, editorContext);
+                profiler.endFrame();
+            }
+            printStatistics("above map");
+            printf("above map: %zu occluders, %zu visible nodes\n", culler.occluderCount(), culler.visibleNodeCount());
+            profiler.clear();
+            profiler.setEnabled(false);
+        }
+    }
+}
@@ -28,9 +28,12 @@
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iosfwd>
+#include <queue>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -194,6 +197,20 @@ namespace TrenchBroom {
                 updateHeight();
             }
 
+            /**
+             * Returns the left child of this node.
+             */
+            const Node* left() const {
+                return m_left;
+            }
+
+            /**
+             * Returns the right child of this node.
+             */
+            const Node* right() const {
+                return m_right;
+            }
+
         private: // node removal private
             /**
              * Children (or grandchildren etc.) changed. Update the height and bounds.
@@ -484,16 +501,46 @@ namespace TrenchBroom {
         }
 
         /**
-         * Clears this tree and rebuilds it by inserting given objects.
+         * Clears this tree and rebuilds it from the given objects.
+         *
+         * Instead of inserting the objects one by one, the tree is built top down by recursively splitting the objects
+         * at the median of their centers along the longest axis of the bounds of the centers. The resulting tree is
+         * balanced, and building it is much faster than inserting the objects individually.
          *
          * @param objects the objects to insert, a list of DataType
          * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         *
+         * @throws NodeTreeException if an object occurs more than once, or if the bounds of an object contain NaN; the
+         * tree is empty in that case
          */
         template <typename DataList, typename GetBounds>
         void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
             clear();
+
+            std::vector<std::pair<Box, U>> entries;
+            entries.reserve(objects.size());
+            m_leafForData.reserve(objects.size());
+
             for (const U& object : objects) {
-                insert(getBounds(object), object);
+                const Box bounds = getBounds(object);
+                if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max) || !m_leafForData.emplace(object, nullptr).second) {
+                    m_leafForData.clear();
+                    check(bounds);
+                    throw NodeTreeException("Data already in tree");
+                }
+                entries.emplace_back(bounds, object);
+            }
+
+            std::vector<LeafNode*> leaves;
+            leaves.reserve(entries.size());
+            for (const auto& [bounds, object] : entries) {
+                auto* leaf = new LeafNode(bounds, object);
+                m_leafForData[object] = leaf;
+                leaves.push_back(leaf);
+            }
+
+            if (!leaves.empty()) {
+                m_root = build(std::begin(leaves), std::end(leaves));
             }
         }
 
@@ -564,6 +611,36 @@ namespace TrenchBroom {
             insert(newBounds, data);
         }
     private:
+        using LeafIterator = typename std::vector<LeafNode*>::iterator;
+
+        /**
+         * Builds a balanced subtree containing the given leaves.
+         */
+        static Node* build(const LeafIterator first, const LeafIterator last) {
+            const auto count = std::distance(first, last);
+            assert(count > 0);
+            if (count == 1) {
+                return *first;
+            }
+
+            const auto firstCenter = (*first)->bounds().center();
+            auto centerBounds = Box(firstCenter, firstCenter);
+            for (auto it = std::next(first); it != last; ++it) {
+                const auto center = (*it)->bounds().center();
+                centerBounds = vm::merge(centerBounds, Box(center, center));
+            }
+
+            const auto axis = vm::find_abs_max_component(centerBounds.size());
+            const auto mid = std::next(first, count / 2);
+            std::nth_element(first, mid, last, [&](const LeafNode* lhs, const LeafNode* rhs) {
+                return lhs->bounds().center()[axis] < rhs->bounds().center()[axis];
+            });
+
+            auto* left = build(first, mid);
+            auto* right = build(mid, last);
+            return new InnerNode(left, right);
+        }
+
         void check(const Box& bounds) const {
             if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max)) {
                 throw NodeTreeException("Cannot add node to AABB tree with invalid bounds");
@@ -578,6 +655,7 @@ namespace TrenchBroom {
                 delete m_root;
                 m_root = nullptr;
             }
+            m_leafForData.clear();
         }
 
         /**
@@ -589,6 +667,13 @@ namespace TrenchBroom {
             return m_root == nullptr;
         }
 
+        /**
+         * Returns the number of data items in this tree.
+         */
+        size_t size() const {
+            return m_leafForData.size();
+        }
+
         /**
          * Returns the bounds of all nodes in this tree.
          *
@@ -691,6 +776,116 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Finds every data item in this tree whose bounding box satisfies the given predicate and appends it to the
+         * given output iterator.
+         *
+         * The predicate is also applied to the bounding boxes of the inner nodes, and the subtree of an inner node is
+         * skipped if its bounding box does not satisfy the predicate. Therefore the predicate must be monotonic: if it
+         * rejects a box, it must also reject every box contained in that box.
+         *
+         * @tparam P the predicate type, must be callable with a const Box& and return bool
+         * @tparam O the output iterator type
+         * @param predicate the predicate to test the bounding boxes with
+         * @param out the output iterator to append to
+         */
+        template <typename P, typename O>
+        void findMatching(const P& predicate, O out) const {
+            findMatching(predicate, [](const U&) { return true; }, out);
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box satisfies the given predicate and which satisfies the
+         * given filter, and appends it to the given output iterator. The filter is only applied to the data items whose
+         * bounding boxes satisfy the predicate.
+         *
+         * The predicate must be monotonic, see above.
+         *
+         * @tparam P the predicate type, must be callable with a const Box& and return bool
+         * @tparam F the filter type, must be callable with a const U& and return bool
+         * @tparam O the output iterator type
+         * @param predicate the predicate to test the bounding boxes with
+         * @param filter the filter to test the data items with
+         * @param out the output iterator to append to
+         */
+        template <typename P, typename F, typename O>
+        void findMatching(const P& predicate, const F& filter, O out) const {
+            if (!empty()) {
+                LambdaVisitor visitor(
+                    [&](const InnerNode* innerNode) {
+                        return predicate(innerNode->bounds());
+                    },
+                    [&](const LeafNode* leaf) {
+                        if (predicate(leaf->bounds()) && filter(leaf->data())) {
+                            out = leaf->data();
+                            ++out;
+                        }
+                    }
+                );
+                m_root->accept(visitor);
+            }
+        }
+
+        /**
+         * Finds the given number of data items in this tree whose bounding boxes are closest to the given point and
+         * which satisfy the given filter, and appends them to the given output iterator in the order of increasing
+         * distance. The distance of a point inside a bounding box to that box is zero. If the tree contains fewer
+         * matching data items, all of them are appended.
+         *
+         * The nodes of the tree are visited in the order of their distance to the given point, so only the nodes that
+         * are closer than the farthest result (and their siblings) are visited.
+         *
+         * @tparam F the filter type, must be callable with a const U& and return bool
+         * @tparam O the output iterator type
+         * @param point the point to measure the distances from
+         * @param count the maximum number of data items to find
+         * @param filter the filter to test the data items with
+         * @param out the output iterator to append to
+         */
+        template <typename F, typename O>
+        void findNearest(const vm::vec<T,S>& point, const size_t count, const F& filter, O out) const {
+            if (empty() || count == 0u) {
+                return;
+            }
+
+            using Entry = std::pair<T, const Node*>;
+            const auto compare = [](const Entry& lhs, const Entry& rhs) { return lhs.first > rhs.first; };
+            std::priority_queue<Entry, std::vector<Entry>, decltype(compare)> queue(compare);
+
+            size_t found = 0u;
+            LambdaVisitor visitor(
+                [&](const InnerNode* innerNode) {
+                    queue.emplace(squaredDistance(point, innerNode->left()->bounds()), innerNode->left());
+                    queue.emplace(squaredDistance(point, innerNode->right()->bounds()), innerNode->right());
+                    return false;
+                },
+                [&](const LeafNode* leaf) {
+                    if (filter(leaf->data())) {
+                        out = leaf->data();
+                        ++out;
+                        ++found;
+                    }
+                }
+            );
+
+            queue.emplace(squaredDistance(point, m_root->bounds()), m_root);
+            while (!queue.empty() && found < count) {
+                const auto* node = queue.top().second;
+                queue.pop();
+                node->accept(visitor);
+            }
+        }
+    private:
+        static T squaredDistance(const vm::vec<T,S>& point, const Box& bounds) {
+            auto result = static_cast<T>(0);
+            for (size_t i = 0; i < S; ++i) {
+                const auto distance = std::max(std::max(bounds.min[i] - point[i], point[i] - bounds.max[i]), static_cast<T>(0));
+                result += distance * distance;
+            }
+            return result;
+        }
+    public:
+
         /**
          * Prints a textual representation of this tree to the given output stream.
          *
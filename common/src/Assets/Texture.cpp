@@ -39,7 +39,9 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {
+        m_textureId(0),
+        m_textureArrayId(0),
+        m_textureArrayLayer(0) {
             assert(m_width > 0);
             assert(m_height > 0);
             assert(buffer.size() >= m_width * m_height * bytesPerPixelForFormat(format));
@@ -59,7 +61,9 @@ namespace TrenchBroom {
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
         m_textureId(0),
-        m_buffers(std::move(buffers)) {
+        m_buffers(std::move(buffers)),
+        m_textureArrayId(0),
+        m_textureArrayLayer(0) {
             assert(m_width > 0);
             assert(m_height > 0);
 
@@ -84,7 +88,9 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {}
+        m_textureId(0),
+        m_textureArrayId(0),
+        m_textureArrayLayer(0) {}
 
         Texture::~Texture() {
             if (m_collection == nullptr && m_textureId != 0) {
@@ -186,29 +192,30 @@ namespace TrenchBroom {
             return m_textureId != 0;
         }
 
+        static void setUnpackParameters() {
+            glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
+            glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
+            glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+            glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+            glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+            glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+        }
+
         void Texture::prepare(const GLuint textureId, const int minFilter, const int magFilter) {
             assert(textureId > 0);
             assert(m_textureId == 0);
 
             if (!m_buffers.empty()) {
-                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
-                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
-                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+                setUnpackParameters();
 
                 glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
                 glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
                 glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+                setFilterMode(GL_TEXTURE_2D, m_type, minFilter, magFilter);
 
                 if (m_type == TextureType::Masked) {
-                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
+                    // masked textures don't work well with automatic mipmaps, so we don't generate any
                     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
                 } else if (m_buffers.size() == 1) {
                     // generate mipmaps if we don't have any
                     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
@@ -216,9 +223,7 @@ namespace TrenchBroom {
                     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
                 }
 
-                // Upload only the first mipmap for masked textures.
-                const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
-
+                const auto mipmapsToUpload = uploadedMipmapCount();
                 for (size_t j = 0; j < mipmapsToUpload; ++j) {
                     const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
 
@@ -237,22 +242,46 @@ namespace TrenchBroom {
         void Texture::setMode(const int minFilter, const int magFilter) {
             if (isPrepared()) {
                 activate();
-                if (m_type == TextureType::Masked) {
-                    // Force GL_NEAREST filtering for masked textures.
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-                } else {
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
-                }
+                setFilterMode(GL_TEXTURE_2D, m_type, minFilter, magFilter);
                 deactivate();
+
+                // all textures in a texture array have the same type, so the first one updates the array
+                if (inTextureArray() && m_textureArrayLayer == 0u) {
+                    glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, m_textureArrayId));
+                    setFilterMode(GL_TEXTURE_2D_ARRAY_EXT, m_type, minFilter, magFilter);
+                    glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, 0));
+                }
             }
         }
 
         void Texture::activate() const {
             if (isPrepared()) {
                 glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+                activateLayer();
+            }
+        }
+
+        void Texture::deactivate() const {
+            if (isPrepared()) {
+                deactivateLayer();
+                glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+            }
+        }
+
+        bool Texture::inTextureArray() const {
+            return m_textureArrayId != 0;
+        }
+
+        GLuint Texture::textureArrayId() const {
+            return m_textureArrayId;
+        }
 
+        size_t Texture::textureArrayLayer() const {
+            return m_textureArrayLayer;
+        }
+
+        void Texture::activateLayer() const {
+            if (isPrepared()) {
                 switch (m_culling) {
                     case Assets::TextureCulling::CullNone:
                         glAssert(glDisable(GL_CULL_FACE));
@@ -281,7 +310,7 @@ namespace TrenchBroom {
             }
         }
 
-        void Texture::deactivate() const {
+        void Texture::deactivateLayer() const {
             if (isPrepared()) {
                 if (m_blendFunc.enable != TextureBlendFunc::Enable::UseDefault) {
                     glAssert(glPopAttrib());
@@ -301,8 +330,6 @@ namespace TrenchBroom {
                     case Assets::TextureCulling::CullBack:
                         break;
                 }
-
-                glAssert(glBindTexture(GL_TEXTURE_2D, 0));
             }
         }
 
@@ -321,5 +348,47 @@ namespace TrenchBroom {
         void Texture::setCollection(TextureCollection* collection) {
             m_collection = collection;
         }
+
+        bool Texture::packable() const {
+            return !m_buffers.empty() && (m_type == TextureType::Masked || m_buffers.size() > 1u);
+        }
+
+        size_t Texture::uploadedMipmapCount() const {
+            // Upload only the first mipmap for masked textures.
+            return m_type == TextureType::Masked ? std::min(size_t(1), m_buffers.size()) : m_buffers.size();
+        }
+
+        void Texture::prepareTextureArrayLayer(const GLuint textureArrayId, const size_t layer) {
+            assert(textureArrayId > 0);
+            assert(packable());
+
+            setUnpackParameters();
+
+            const auto mipmapsToUpload = uploadedMipmapCount();
+            for (size_t j = 0; j < mipmapsToUpload; ++j) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
+
+                const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].data());
+                glAssert(glTexSubImage3D(GL_TEXTURE_2D_ARRAY_EXT, static_cast<GLint>(j),
+                                         0, 0, static_cast<GLint>(layer),
+                                         static_cast<GLsizei>(mipSize.x()),
+                                         static_cast<GLsizei>(mipSize.y()),
+                                         1, m_format, GL_UNSIGNED_BYTE, data));
+            }
+
+            m_textureArrayId = textureArrayId;
+            m_textureArrayLayer = layer;
+        }
+
+        void Texture::setFilterMode(const GLenum target, const TextureType type, const int minFilter, const int magFilter) {
+            if (type == TextureType::Masked) {
+                // Force GL_NEAREST filtering for masked textures.
+                glAssert(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+                glAssert(glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            } else {
+                glAssert(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, minFilter));
+                glAssert(glTexParameteri(target, GL_TEXTURE_MAG_FILTER, magFilter));
+            }
+        }
     }
 }
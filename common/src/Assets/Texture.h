@@ -99,6 +99,10 @@ namespace TrenchBroom {
 
             mutable GLuint m_textureId;
             mutable BufferList m_buffers;
+
+            // the texture array that this texture was packed into by its collection, if any, and its layer therein
+            GLuint m_textureArrayId;
+            size_t m_textureArrayLayer;
         public:
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, Buffer&& buffer, GLenum format, TextureType type);
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, BufferList&& buffers, GLenum format, TextureType type);
@@ -139,6 +143,21 @@ namespace TrenchBroom {
 
             void activate() const;
             void deactivate() const;
+
+            /**
+             * Indicates whether this texture was also packed into a texture array by its collection. Such a texture
+             * can be rendered from its layer in the texture array instead of from its own texture object.
+             */
+            bool inTextureArray() const;
+            GLuint textureArrayId() const;
+            size_t textureArrayLayer() const;
+
+            /**
+             * Applies the render state of this texture like activate(), but without binding its own texture object.
+             * Used when rendering this texture from its layer in a texture array, which the caller binds.
+             */
+            void activateLayer() const;
+            void deactivateLayer() const;
         public: // exposed for tests only
             /**
              * Returns the texture data in the format returned by format().
@@ -152,6 +171,26 @@ namespace TrenchBroom {
             TextureType type() const;
         private:
             void setCollection(TextureCollection* collection);
+
+            /**
+             * Indicates whether this texture can be packed into a texture array. This requires that its data was not
+             * uploaded yet and that it does not rely on generated mipmaps, which would have to be generated for the
+             * entire texture array.
+             */
+            bool packable() const;
+
+            /**
+             * The number of mipmap levels that are uploaded for this texture.
+             */
+            size_t uploadedMipmapCount() const;
+
+            /**
+             * Uploads the data of this texture to the given layer of the given texture array, which must be bound and
+             * have storage allocated for all uploaded mipmap levels. The data is kept for prepare().
+             */
+            void prepareTextureArrayLayer(GLuint textureArrayId, size_t layer);
+
+            static void setFilterMode(GLenum target, TextureType type, int minFilter, int magFilter);
             friend class TextureCollection;
         };
     }
@@ -21,10 +21,16 @@
 
 #include "Ensure.h"
 #include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
 
 #include <kdl/vector_utils.h>
 
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
@@ -58,6 +64,11 @@ namespace TrenchBroom {
                                           static_cast<GLuint*>(&m_textureIds.front())));
                 m_textureIds.clear();
             }
+            if (!m_textureArrayIds.empty()) {
+                glAssert(glDeleteTextures(static_cast<GLsizei>(m_textureArrayIds.size()),
+                                          static_cast<GLuint*>(&m_textureArrayIds.front())));
+                m_textureArrayIds.clear();
+            }
         }
 
         void TextureCollection::addTextures(const std::vector<Texture*>& textures) {
@@ -122,6 +133,12 @@ namespace TrenchBroom {
         void TextureCollection::prepare(const int minFilter, const int magFilter) {
             assert(!prepared());
 
+            // Texture arrays are an extension to OpenGL 2.1; without it, every texture is only bound individually. The
+            // texture arrays must be prepared first because preparing a texture releases its data.
+            if (GLEW_EXT_texture_array) {
+                prepareTextureArrays(minFilter, magFilter);
+            }
+
             m_textureIds.resize(textureCount());
             glAssert(glGenTextures(static_cast<GLsizei>(textureCount()),
                                    static_cast<GLuint*>(&m_textureIds.front())));
@@ -132,6 +149,76 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<std::vector<Texture*>> TextureCollection::textureArrayGroups(const std::vector<Texture*>& textures, const size_t maxLayers) {
+            using Key = std::tuple<size_t, size_t, GLenum, TextureType, size_t>;
+
+            auto groupsByKey = std::map<Key, std::vector<Texture*>>();
+            for (auto* texture : textures) {
+                if (texture->packable() &&
+                    texture->width() <= MaxTextureArrayTextureSize &&
+                    texture->height() <= MaxTextureArrayTextureSize) {
+                    const auto key = Key(texture->width(), texture->height(), texture->format(), texture->type(), texture->uploadedMipmapCount());
+                    groupsByKey[key].push_back(texture);
+                }
+            }
+
+            auto result = std::vector<std::vector<Texture*>>();
+            if (maxLayers < 2u) {
+                return result;
+            }
+
+            for (const auto& [key, group] : groupsByKey) {
+                for (size_t first = 0u; first + 1u < group.size(); first += maxLayers) {
+                    const auto last = std::min(first + maxLayers, group.size());
+                    result.emplace_back(std::next(std::begin(group), static_cast<std::ptrdiff_t>(first)),
+                                        std::next(std::begin(group), static_cast<std::ptrdiff_t>(last)));
+                }
+            }
+            return result;
+        }
+
+        void TextureCollection::prepareTextureArrays(const int minFilter, const int magFilter) {
+            GLint maxLayers = 0;
+            glAssert(glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS_EXT, &maxLayers));
+
+            const auto groups = textureArrayGroups(m_textures, static_cast<size_t>(std::max(0, maxLayers)));
+            if (groups.empty()) {
+                return;
+            }
+
+            m_textureArrayIds.resize(groups.size());
+            glAssert(glGenTextures(static_cast<GLsizei>(m_textureArrayIds.size()),
+                                   static_cast<GLuint*>(&m_textureArrayIds.front())));
+
+            for (size_t i = 0; i < groups.size(); ++i) {
+                const auto& group = groups[i];
+                const auto* first = group.front();
+                const auto mipmapCount = first->uploadedMipmapCount();
+
+                glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, m_textureArrayIds[i]));
+                glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_WRAP_S, GL_REPEAT));
+                glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_WRAP_T, GL_REPEAT));
+                glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(mipmapCount - 1u)));
+                Texture::setFilterMode(GL_TEXTURE_2D_ARRAY_EXT, first->type(), minFilter, magFilter);
+
+                // allocate the storage for all layers, then upload each texture into its layer
+                for (size_t level = 0; level < mipmapCount; ++level) {
+                    const auto mipSize = sizeAtMipLevel(first->width(), first->height(), level);
+                    glAssert(glTexImage3D(GL_TEXTURE_2D_ARRAY_EXT, static_cast<GLint>(level), GL_RGBA,
+                                          static_cast<GLsizei>(mipSize.x()),
+                                          static_cast<GLsizei>(mipSize.y()),
+                                          static_cast<GLsizei>(group.size()),
+                                          0, first->format(), GL_UNSIGNED_BYTE, nullptr));
+                }
+
+                for (size_t layer = 0; layer < group.size(); ++layer) {
+                    group[layer]->prepareTextureArrayLayer(m_textureArrayIds[i], layer);
+                }
+            }
+
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, 0));
+        }
+
         void TextureCollection::setTextureMode(const int minFilter, const int magFilter) {
             for (auto* texture : m_textures) {
                 texture->setMode(minFilter, magFilter);
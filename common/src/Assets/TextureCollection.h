@@ -42,9 +42,15 @@ namespace TrenchBroom {
             size_t m_usageCount;
 
             TextureIdList m_textureIds;
+            TextureIdList m_textureArrayIds;
 
             friend class Texture;
         public:
+            /**
+             * Textures that are larger than this in either dimension are not packed into texture arrays.
+             */
+            static const size_t MaxTextureArrayTextureSize = 256;
+
             Notifier<> usageCountDidChange;
         public:
             TextureCollection();
@@ -67,9 +73,24 @@ namespace TrenchBroom {
             size_t usageCount() const;
 
             bool prepared() const;
+
+            /**
+             * Uploads the textures of this collection. Every texture gets its own texture object. If texture arrays are
+             * supported, small textures of the same size, format and type are additionally packed into texture arrays
+             * so that faces using them can be rendered without binding each texture separately.
+             */
             void prepare(int minFilter, int magFilter);
             void setTextureMode(int minFilter, int magFilter);
+
+            /**
+             * Groups the given textures that can be packed into texture arrays by their size, format, type and number
+             * of mipmap levels. Each returned group holds at least two and at most the given number of textures, in the
+             * order in which they were given. Textures that cannot be packed are not returned.
+             */
+            static std::vector<std::vector<Texture*>> textureArrayGroups(const std::vector<Texture*>& textures, size_t maxLayers);
         private:
+            void prepareTextureArrays(int minFilter, int magFilter);
+
             void incUsageCount();
             void decUsageCount();
         };
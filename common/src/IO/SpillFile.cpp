@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpillFile.h"
+
+#include "Ensure.h"
+#include "Exceptions.h"
+#include "IO/Reader.h"
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace IO {
+        void SpillFile::RecordWriter::writeString(const std::string& str) {
+            write<uint64_t>(static_cast<uint64_t>(str.size()));
+            m_buffer.insert(std::end(m_buffer), std::begin(str), std::end(str));
+        }
+
+        const std::vector<char>& SpillFile::RecordWriter::buffer() const {
+            return m_buffer;
+        }
+
+        SpillFile::Record::Record() :
+        position(0u),
+        size(0u) {}
+
+        SpillFile::Record::Record(const size_t i_position, const size_t i_size) :
+        position(i_position),
+        size(i_size) {}
+
+        SpillFile::SpillFile() :
+        m_file(std::tmpfile()),
+        m_end(0u),
+        m_recordCount(0u) {
+            if (m_file == nullptr) {
+                throw FileSystemException("Cannot create temporary file");
+            }
+        }
+
+        SpillFile::~SpillFile() {
+            // the file is deleted when it is closed
+            std::fclose(m_file);
+        }
+
+        SpillFile::Record SpillFile::write(const RecordWriter& writer) {
+            const auto& buffer = writer.buffer();
+
+            if (std::fseek(m_file, static_cast<long>(m_end), SEEK_SET) != 0) {
+                throw FileSystemException("fseek failed");
+            }
+            if (std::fwrite(buffer.data(), 1u, buffer.size(), m_file) != buffer.size() || std::fflush(m_file) != 0) {
+                throw FileSystemException("Cannot write to temporary file");
+            }
+
+            const auto record = Record(m_end, buffer.size());
+            m_end += buffer.size();
+            ++m_recordCount;
+            return record;
+        }
+
+        BufferedReader SpillFile::read(const Record& record) const {
+            assert(record.position + record.size <= m_end);
+            return Reader::from(m_file).subReaderFromBegin(record.position, record.size).buffer();
+        }
+
+        void SpillFile::release(const Record& record) {
+            ensure(m_recordCount > 0u, "record was not released before");
+            assert(record.position + record.size <= m_end);
+            unused(record);
+
+            // the space of a single record cannot be reused, but once all records are released, the file is reused
+            // from the beginning
+            if (--m_recordCount == 0u) {
+                m_end = 0u;
+            }
+        }
+    }
+}
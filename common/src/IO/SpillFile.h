@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_SpillFile_h
+#define TrenchBroom_SpillFile_h
+
+#include "Macros.h"
+
+#include <vecmath/forward.h>
+#include <vecmath/vec.h>
+
+#include <cstdio> // for FILE
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        class BufferedReader;
+
+        /**
+         * A temporary file that holds data which was moved out of memory. The data is written to the file in records,
+         * each of which is assembled by a RecordWriter and identified by the returned Record. The data of a record can
+         * be read back with a Reader, and the record should be released when it is no longer needed.
+         *
+         * The file is deleted when this object is destroyed. Its space is reused once all records are released.
+         */
+        class SpillFile {
+        public:
+            /**
+             * Assembles the data of a record in memory. Numbers are written in the native binary representation since
+             * the file never leaves the machine that wrote it.
+             */
+            class RecordWriter {
+            private:
+                std::vector<char> m_buffer;
+            public:
+                template <typename T>
+                void write(const T value) {
+                    static_assert(std::is_arithmetic_v<T>, "only arithmetic values can be written");
+                    const auto* bytes = reinterpret_cast<const char*>(&value);
+                    m_buffer.insert(std::end(m_buffer), bytes, bytes + sizeof(T));
+                }
+
+                template <typename T, size_t S>
+                void writeVec(const vm::vec<T,S>& vec) {
+                    for (size_t i = 0; i < S; ++i) {
+                        write<T>(vec[i]);
+                    }
+                }
+
+                /**
+                 * Writes the size of the given string as an uint64_t, followed by its characters.
+                 */
+                void writeString(const std::string& str);
+
+                const std::vector<char>& buffer() const;
+            };
+
+            struct Record {
+                size_t position;
+                size_t size;
+
+                Record();
+                Record(size_t i_position, size_t i_size);
+            };
+        private:
+            std::FILE* m_file;
+            size_t m_end;
+            size_t m_recordCount;
+        public:
+            /**
+             * Creates a new temporary file.
+             *
+             * @throws FileSystemException if the file cannot be created
+             */
+            SpillFile();
+            ~SpillFile();
+
+            /**
+             * Appends the data assembled by the given writer to this file.
+             *
+             * @throws FileSystemException if the data cannot be written
+             */
+            Record write(const RecordWriter& writer);
+
+            /**
+             * Reads the data of the given record into memory and returns a reader for it.
+             *
+             * @throws ReaderException if the data cannot be read
+             */
+            BufferedReader read(const Record& record) const;
+
+            /**
+             * Indicates that the given record is no longer needed.
+             */
+            void release(const Record& record);
+
+            deleteCopyAndMove(SpillFile)
+        };
+    }
+}
+
+#endif
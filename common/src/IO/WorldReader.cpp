@@ -41,12 +41,14 @@ namespace TrenchBroom {
             readEntities(format, worldBounds, status);
             m_world->rebuildNodeTree();
             m_world->enableNodeTreeUpdates();
+            m_world->enableAttributableIndexUpdates();
             return std::move(m_world);
         }
 
         Model::ModelFactory& WorldReader::initialize(const Model::MapFormat format) {
             m_world = std::make_unique<Model::World>(format);
             m_world->disableNodeTreeUpdates();
+            m_world->disableAttributableIndexUpdates();
             return *m_world;
         }
 
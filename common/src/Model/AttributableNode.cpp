@@ -392,6 +392,15 @@ namespace TrenchBroom {
             return result;
         }
 
+        void AttributableNode::clearLinks() {
+            removeAllLinks();
+        }
+
+        void AttributableNode::linkToTargets() {
+            addAllLinkTargets();
+            addAllKillTargets();
+        }
+
         void AttributableNode::findMissingTargets(const std::string& prefix, std::vector<std::string>& result) const {
             for (const EntityAttribute& attribute : m_attributes.numberedAttributes(prefix)) {
                 const std::string& targetname = attribute.value();
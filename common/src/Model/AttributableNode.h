@@ -128,6 +128,17 @@ namespace TrenchBroom {
             bool hasMissingSources() const;
             std::vector<std::string> findMissingLinkTargets() const;
             std::vector<std::string> findMissingKillTargets() const;
+        public: // link rebuilding, should only be called by the world
+            /**
+             * Removes all links from and to this node.
+             */
+            void clearLinks();
+
+            /**
+             * Links this node to every node that one of its target or kill target attributes refers to. The links
+             * from other nodes to this node are not created.
+             */
+            void linkToTargets();
         private: // link management internals
             void findMissingTargets(const std::string& prefix, std::vector<std::string>& result) const;
 
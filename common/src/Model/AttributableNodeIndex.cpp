@@ -26,7 +26,8 @@
 #include <kdl/compact_trie.h>
 #include <kdl/vector_utils.h>
 
-#include <list>
+#include <algorithm>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -48,23 +49,21 @@ namespace TrenchBroom {
             return AttributableNodeIndexQuery(Type_Any);
         }
 
-        std::set<AttributableNode*> AttributableNodeIndexQuery::execute(const AttributableNodeStringIndex& index) const {
-            std::set<AttributableNode*> result;
+        void AttributableNodeIndexQuery::execute(const AttributableNodeStringIndex& index, std::vector<AttributableNode*>& result) const {
             switch (m_type) {
                 case Type_Exact:
-                    index.find_matches(m_pattern, std::inserter(result, std::end(result)));
+                    index.find_exact(m_pattern, std::back_inserter(result));
                     break;
                 case Type_Prefix:
-                    index.find_matches(m_pattern + "*", std::inserter(result, std::end(result)));
+                    index.find_prefix(m_pattern, std::back_inserter(result));
                     break;
                 case Type_Numbered:
-                    index.find_matches(m_pattern + "%*", std::inserter(result, std::end(result)));
+                    index.find_numbered(m_pattern, std::back_inserter(result));
                     break;
                 case Type_Any:
                     break;
                 switchDefault()
             }
-            return result;
         }
 
         bool AttributableNodeIndexQuery::execute(const AttributableNode* node, const std::string& value) const {
@@ -110,11 +109,22 @@ namespace TrenchBroom {
                 addAttribute(attributable, attribute.name(), attribute.value());
         }
 
+        void AttributableNodeIndex::addAttributableNodes(const std::vector<AttributableNode*>& attributables) {
+            for (AttributableNode* attributable : attributables) {
+                addAttributableNode(attributable);
+            }
+        }
+
         void AttributableNodeIndex::removeAttributableNode(AttributableNode* attributable) {
             for (const EntityAttribute& attribute : attributable->attributes())
                 removeAttribute(attributable, attribute.name(), attribute.value());
         }
 
+        void AttributableNodeIndex::clear() {
+            m_nameIndex->clear();
+            m_valueIndex->clear();
+        }
+
         void AttributableNodeIndex::addAttribute(AttributableNode* attributable, const std::string& name, const std::string& value) {
             m_nameIndex->insert(name, attributable);
             m_valueIndex->insert(value, attributable);
@@ -126,28 +136,25 @@ namespace TrenchBroom {
         }
 
         std::vector<AttributableNode*> AttributableNodeIndex::findAttributableNodes(const AttributableNodeIndexQuery& nameQuery, const std::string& value) const {
-            const std::set<AttributableNode*> nameResult = nameQuery.execute(*m_nameIndex);
-
-            std::set<AttributableNode*> valueResult;
-            m_valueIndex->find_matches(value, std::inserter(valueResult, std::end(valueResult)));
-            if (nameResult.empty() || valueResult.empty()) {
-                return {};
-            }
-
-            std::vector<AttributableNode*> result = kdl::set_intersection(nameResult, valueResult);
-
-            auto it = std::begin(result);
-            while (it != std::end(result)) {
-                const AttributableNode* node = *it;
-                if (!nameQuery.execute(node, value))
-                    it = result.erase(it);
-                else
-                    ++it;
-            }
-
+            std::vector<AttributableNode*> result;
+            findAttributableNodes(nameQuery, value, result);
             return result;
         }
 
+        void AttributableNodeIndex::findAttributableNodes(const AttributableNodeIndexQuery& nameQuery, const std::string& value, std::vector<AttributableNode*>& result) const {
+            // values such as target names are far more selective than attribute names, so we look up the value and
+            // check the names of the few candidates instead of intersecting both results
+            const auto first = result.size();
+            m_valueIndex->find_exact(value, std::back_inserter(result));
+
+            const auto begin = std::next(std::begin(result), static_cast<std::ptrdiff_t>(first));
+            std::sort(begin, std::end(result));
+            const auto end = std::unique(begin, std::end(result));
+            result.erase(std::remove_if(begin, end, [&](const AttributableNode* node) {
+                return !nameQuery.execute(node, value);
+            }), std::end(result));
+        }
+
         std::vector<std::string> AttributableNodeIndex::allNames() const {
             std::vector<std::string> result;
             m_nameIndex->get_keys(std::back_inserter(result));
@@ -157,7 +164,10 @@ namespace TrenchBroom {
         std::vector<std::string> AttributableNodeIndex::allValuesForNames(const AttributableNodeIndexQuery& keyQuery) const {
             std::vector<std::string> result;
 
-            const std::set<AttributableNode*> nameResult = keyQuery.execute(*m_nameIndex);
+            std::vector<AttributableNode*> nameResult;
+            keyQuery.execute(*m_nameIndex, nameResult);
+            kdl::vec_sort_and_remove_duplicates(nameResult);
+
             for (const auto node : nameResult) {
                 const auto matchingAttributes = keyQuery.execute(node);
                 for (const auto& attribute : matchingAttributes) {
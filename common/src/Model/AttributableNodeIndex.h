@@ -23,7 +23,6 @@
 #include <kdl/compact_trie_forward.h>
 
 #include <memory>
-#include <set>
 #include <string>
 #include <vector>
 
@@ -51,7 +50,14 @@ namespace TrenchBroom {
             static AttributableNodeIndexQuery numbered(const std::string& pattern);
             static AttributableNodeIndexQuery any();
 
-            std::set<AttributableNode*> execute(const AttributableNodeStringIndex& index) const;
+            /**
+             * Appends the nodes which have an attribute whose name matches this query to the given vector. A node may
+             * be appended several times if several of its attribute names match.
+             *
+             * Unlike glob patterns, the pattern of this query is never interpreted, so names containing wildcard
+             * characters are matched literally.
+             */
+            void execute(const AttributableNodeStringIndex& index, std::vector<AttributableNode*>& result) const;
             bool execute(const AttributableNode* node, const std::string& value) const;
             std::vector<Model::EntityAttribute> execute(const AttributableNode* node) const;
         private:
@@ -67,12 +73,20 @@ namespace TrenchBroom {
             ~AttributableNodeIndex();
 
             void addAttributableNode(AttributableNode* attributable);
+            void addAttributableNodes(const std::vector<AttributableNode*>& attributables);
             void removeAttributableNode(AttributableNode* attributable);
+            void clear();
 
             void addAttribute(AttributableNode* attributable, const std::string& name, const std::string& value);
             void removeAttribute(AttributableNode* attributable, const std::string& name, const std::string& value);
 
             std::vector<AttributableNode*> findAttributableNodes(const AttributableNodeIndexQuery& keyQuery, const std::string& value) const;
+
+            /**
+             * Appends every node that has an attribute with the given value whose name matches the given query to the
+             * given vector. Each node is appended at most once. The value is matched exactly.
+             */
+            void findAttributableNodes(const AttributableNodeIndexQuery& keyQuery, const std::string& value, std::vector<AttributableNode*>& result) const;
             std::vector<std::string> allNames() const;
             std::vector<std::string> allValuesForNames(const AttributableNodeIndexQuery& keyQuery) const;
         };
@@ -28,7 +28,6 @@
 #include "Model/BrushSnapshot.h"
 #include "Model/Entity.h"
 #include "Model/FindContainerVisitor.h"
-#include "Model/FindGroupVisitor.h"
 #include "Model/FindLayerVisitor.h"
 #include "Model/Group.h"
 #include "Model/IssueGenerator.h"
@@ -296,6 +295,8 @@ namespace TrenchBroom {
         Brush::Brush(const vm::bbox3& worldBounds, const std::vector<BrushFace*>& faces) :
         m_geometry(nullptr),
         m_transparent(false),
+        m_sharedFaceTags(0),
+        m_sharedFaceTagsValid(false),
         m_brushRendererBrushCache(std::make_unique<Renderer::BrushRendererBrushCache>()) {
             addFaces(faces);
             try {
@@ -403,7 +404,6 @@ namespace TrenchBroom {
         void Brush::setFaces(const vm::bbox3& worldBounds, const std::vector<BrushFace*>& faces) {
             const NotifyNodeChange nodeChange(this);
 
-            const vm::bbox3 oldBounds = physicalBounds();
             deleteGeometry();
 
             detachFaces(m_faces);
@@ -411,7 +411,7 @@ namespace TrenchBroom {
             addFaces(faces);
 
             buildGeometry(worldBounds);
-            nodePhysicalBoundsDidChange(oldBounds);
+            nodePhysicalBoundsDidChange();
         }
 
         bool Brush::closed() const {
@@ -434,6 +434,10 @@ namespace TrenchBroom {
             invalidateIssues();
         }
 
+        void Brush::faceTagsDidChange() {
+            invalidateSharedFaceTags();
+        }
+
         void Brush::addFaces(const std::vector<BrushFace*>& faces) {
             addFaces(std::begin(faces), std::end(faces), faces.size());
         }
@@ -446,6 +450,7 @@ namespace TrenchBroom {
             m_faces.push_back(face);
             face->setBrush(this);
             invalidateVertexCache();
+            invalidateSharedFaceTags();
             if (face->selected()) {
                 incChildSelectionCount(1);
             }
@@ -480,6 +485,7 @@ namespace TrenchBroom {
             face->setGeometry(nullptr);
             face->setBrush(nullptr);
             invalidateVertexCache();
+            invalidateSharedFaceTags();
         }
 
         void Brush::cloneFaceAttributesFrom(const std::vector<Brush*>& brushes) {
@@ -1262,6 +1268,7 @@ namespace TrenchBroom {
             }
 
             invalidateVertexCache();
+            invalidateSharedFaceTags();
         }
 
         void Brush::updatePointsFromVertices(const vm::bbox3& worldBounds) {
@@ -1274,10 +1281,9 @@ namespace TrenchBroom {
         }
 
         void Brush::rebuildGeometry(const vm::bbox3& worldBounds) {
-            const vm::bbox3 oldBounds = physicalBounds();
             deleteGeometry();
             buildGeometry(worldBounds);
-            nodePhysicalBoundsDidChange(oldBounds);
+            nodePhysicalBoundsDidChange();
         }
 
         void Brush::buildGeometry(const vm::bbox3& worldBounds) {
@@ -1444,9 +1450,7 @@ namespace TrenchBroom {
         }
 
         Group* Brush::doGetGroup() const {
-            FindGroupVisitor visitor;
-            escalate(visitor);
-            return visitor.hasResult() ? visitor.result() : nullptr;
+            return containingGroup();
         }
 
         void Brush::doTransform(const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds) {
@@ -1550,13 +1554,7 @@ namespace TrenchBroom {
         }
 
         bool Brush::allFacesHaveAnyTagInMask(TagType::Type tagMask) const {
-            // Possible optimization: Store the shared face tag mask in the brush and updated it when a face changes.
-
-            TagType::Type sharedFaceTags = TagType::AnyType; // set all bits to 1
-            for (const auto* face : m_faces) {
-                sharedFaceTags &= face->tagMask();
-            }
-            return (sharedFaceTags & tagMask) != 0;
+            return (sharedFaceTags() & tagMask) != 0;
         }
 
         bool Brush::anyFaceHasAnyTag() const {
@@ -1579,6 +1577,21 @@ namespace TrenchBroom {
             return false;
         }
 
+        void Brush::invalidateSharedFaceTags() {
+            m_sharedFaceTagsValid = false;
+        }
+
+        TagType::Type Brush::sharedFaceTags() const {
+            if (!m_sharedFaceTagsValid) {
+                m_sharedFaceTags = TagType::AnyType; // set all bits to 1
+                for (const auto* face : m_faces) {
+                    m_sharedFaceTags &= face->tagMask();
+                }
+                m_sharedFaceTagsValid = true;
+            }
+            return m_sharedFaceTags;
+        }
+
         void Brush::doAcceptTagVisitor(TagVisitor& visitor) {
             visitor.visit(*this);
         }
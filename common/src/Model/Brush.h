@@ -65,6 +65,12 @@ namespace TrenchBroom {
             BrushGeometry* m_geometry;
 
             mutable bool m_transparent;
+
+            /**
+             * The tags that all faces of this brush have in common, computed lazily.
+             */
+            mutable TagType::Type m_sharedFaceTags;
+            mutable bool m_sharedFaceTagsValid;
             mutable std::unique_ptr<Renderer::BrushRendererBrushCache> m_brushRendererBrushCache; // unique_ptr for breaking header dependencies
         public:
             Brush(const vm::bbox3& worldBounds, const std::vector<BrushFace*>& faces);
@@ -90,6 +96,7 @@ namespace TrenchBroom {
             bool fullySpecified() const;
 
             void faceDidChange();
+            void faceTagsDidChange();
         private:
             void addFaces(const std::vector<BrushFace*>& faces);
             template <typename I>
@@ -336,6 +343,9 @@ namespace TrenchBroom {
              * @return true whether any faces of this brush have any of the given tags
              */
             bool anyFacesHaveAnyTagInMask(TagType::Type tagMask) const;
+        private:
+            void invalidateSharedFaceTags();
+            TagType::Type sharedFaceTags() const;
         private:
             void doAcceptTagVisitor(TagVisitor& visitor) override;
             void doAcceptTagVisitor(ConstTagVisitor& visitor) const override;
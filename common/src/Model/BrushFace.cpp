@@ -57,7 +57,7 @@ namespace TrenchBroom {
             return halfEdge->edge();
         }
 
-        BrushFace::BrushFace(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, std::unique_ptr<TexCoordSystem> texCoordSystem) :
+        BrushFace::BrushFace(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, std::shared_ptr<TexCoordSystem> texCoordSystem) :
         m_brush(nullptr),
         m_lineNumber(0),
         m_lineCount(0),
@@ -67,6 +67,7 @@ namespace TrenchBroom {
         m_markedToRenderFace(false),
         m_attribs(attribs) {
             ensure(m_texCoordSystem != nullptr, "texCoordSystem is null");
+            m_attribs.intern();
             setPoints(point0, point1, point2);
         }
 
@@ -126,12 +127,16 @@ namespace TrenchBroom {
             return new BrushFaceSnapshot(this, *m_texCoordSystem);
         }
 
+        std::shared_ptr<TexCoordSystem> BrushFace::shareTexCoordSystem() const {
+            return m_texCoordSystem;
+        }
+
         std::unique_ptr<TexCoordSystemSnapshot> BrushFace::takeTexCoordSystemSnapshot() const {
             return m_texCoordSystem->takeSnapshot();
         }
 
         void BrushFace::restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot) {
-            coordSystemSnapshot.restore(*m_texCoordSystem);
+            coordSystemSnapshot.restore(mutableTexCoordSystem());
             invalidateVertexCache();
         }
 
@@ -140,12 +145,12 @@ namespace TrenchBroom {
             const auto seam = vm::intersect_plane_plane(sourceFacePlane, m_boundary);
             const auto refPoint = vm::project_point(seam, center());
 
-            coordSystemSnapshot.restore(*m_texCoordSystem);
+            coordSystemSnapshot.restore(mutableTexCoordSystem());
 
             // Get the texcoords at the refPoint using the source face's attribs and tex coord system
             const auto desriedCoords = m_texCoordSystem->getTexCoords(refPoint, attribs) * attribs.textureSize();
 
-            m_texCoordSystem->updateNormal(sourceFacePlane.normal, m_boundary.normal, m_attribs, wrapStyle);
+            mutableTexCoordSystem().updateNormal(sourceFacePlane.normal, m_boundary.normal, m_attribs, wrapStyle);
 
             // Adjust the offset on this face so that the texture coordinates at the refPoint stay the same
             if (!vm::is_zero(seam.direction, vm::C::almost_zero())) {
@@ -245,13 +250,14 @@ namespace TrenchBroom {
         void BrushFace::setAttribs(const BrushFaceAttributes& attribs) {
             const float oldRotation = m_attribs.rotation();
             m_attribs = attribs;
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attribs.rotation());
+            m_attribs.intern();
+            mutableTexCoordSystem().setRotation(m_boundary.normal, oldRotation, m_attribs.rotation());
             updateBrush();
         }
 
         void BrushFace::resetTexCoordSystemCache() {
             if (m_texCoordSystem != nullptr) {
-                m_texCoordSystem->resetCache(m_points[0], m_points[1], m_points[2], m_attribs);
+                mutableTexCoordSystem().resetCache(m_points[0], m_points[1], m_points[2], m_attribs);
             }
         }
 
@@ -404,7 +410,7 @@ namespace TrenchBroom {
 
             const auto oldRotation = m_attribs.rotation();
             m_attribs.setRotation(rotation);
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, rotation);
+            mutableTexCoordSystem().setRotation(m_boundary.normal, oldRotation, rotation);
             updateBrush();
             return true;
         }
@@ -462,7 +468,7 @@ namespace TrenchBroom {
         }
 
         void BrushFace::resetTextureAxes() {
-            m_texCoordSystem->resetTextureAxes(m_boundary.normal);
+            mutableTexCoordSystem().resetTextureAxes(m_boundary.normal);
             invalidateVertexCache();
         }
 
@@ -474,12 +480,12 @@ namespace TrenchBroom {
         void BrushFace::rotateTexture(const float angle) {
             const float oldRotation = m_attribs.rotation();
             m_texCoordSystem->rotateTexture(m_boundary.normal, angle, m_attribs);
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attribs.rotation());
+            mutableTexCoordSystem().setRotation(m_boundary.normal, oldRotation, m_attribs.rotation());
             invalidateVertexCache();
         }
 
         void BrushFace::shearTexture(const vm::vec2f& factors) {
-            m_texCoordSystem->shearTexture(m_boundary.normal, factors);
+            mutableTexCoordSystem().shearTexture(m_boundary.normal, factors);
             invalidateVertexCache();
         }
 
@@ -500,7 +506,7 @@ namespace TrenchBroom {
 
             setPoints(m_points[0], m_points[1], m_points[2]);
 
-            m_texCoordSystem->transform(oldBoundary, m_boundary, transform, m_attribs, lockTexture, invariant);
+            mutableTexCoordSystem().transform(oldBoundary, m_boundary, transform, m_attribs, lockTexture, invariant);
         }
 
         void BrushFace::invert() {
@@ -529,7 +535,7 @@ namespace TrenchBroom {
                 // Get the texcoords at the refPoint using the old face's attribs and tex coord system
                 const auto desriedCoords = m_texCoordSystem->getTexCoords(refPoint, m_attribs) * m_attribs.textureSize();
 
-                m_texCoordSystem->updateNormal(oldPlane.normal, m_boundary.normal, m_attribs, WrapStyle::Projection);
+                mutableTexCoordSystem().updateNormal(oldPlane.normal, m_boundary.normal, m_attribs, WrapStyle::Projection);
 
                 // Adjust the offset on this face so that the texture coordinates at the refPoint stay the same
                 const auto currentCoords = m_texCoordSystem->getTexCoords(refPoint, m_attribs) * m_attribs.textureSize();
@@ -630,6 +636,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t BrushFace::lineCount() const {
+            return m_lineCount;
+        }
+
         void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -704,6 +714,13 @@ namespace TrenchBroom {
             }
         }
 
+        TexCoordSystem& BrushFace::mutableTexCoordSystem() {
+            if (m_texCoordSystem.use_count() > 1) {
+                m_texCoordSystem = m_texCoordSystem->clone();
+            }
+            return *m_texCoordSystem;
+        }
+
         void BrushFace::invalidateVertexCache() {
             if (m_brush != nullptr) {
                 m_brush->invalidateVertexCache();
@@ -725,5 +742,11 @@ namespace TrenchBroom {
         void BrushFace::doAcceptTagVisitor(ConstTagVisitor& visitor) const {
             visitor.visit(*this);
         }
+
+        void BrushFace::doTagsDidChange() {
+            if (m_brush != nullptr) {
+                m_brush->faceTagsDidChange();
+            }
+        }
     }
 }
@@ -87,7 +87,11 @@ namespace TrenchBroom {
             size_t m_lineCount;
             bool m_selected;
 
-            std::unique_ptr<TexCoordSystem> m_texCoordSystem;
+            /**
+             * The texture coordinate system may be shared with brush snapshots, and it is copied before it is modified
+             * if it is shared.
+             */
+            std::shared_ptr<TexCoordSystem> m_texCoordSystem;
             BrushFaceGeometry* m_geometry;
 
             // brush renderer
@@ -95,7 +99,7 @@ namespace TrenchBroom {
         protected:
             BrushFaceAttributes m_attribs;
         public:
-            BrushFace(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, std::unique_ptr<TexCoordSystem> texCoordSystem);
+            BrushFace(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, std::shared_ptr<TexCoordSystem> texCoordSystem);
 
             static BrushFace* createParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const std::string& textureName = "");
             static BrushFace* createParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const std::string& textureName = "");
@@ -107,6 +111,11 @@ namespace TrenchBroom {
             BrushFace* clone() const;
 
             BrushFaceSnapshot* takeSnapshot();
+            /**
+             * Returns the texture coordinate system of this face without copying it. The returned system must not be
+             * modified; this face copies it before it modifies it while it is shared.
+             */
+            std::shared_ptr<TexCoordSystem> shareTexCoordSystem() const;
             std::unique_ptr<TexCoordSystemSnapshot> takeTexCoordSystemSnapshot() const;
             void restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot);
             void copyTexCoordSystemFromFace(const TexCoordSystemSnapshot& coordSystemSnapshot, const BrushFaceAttributes& attribs, const vm::plane3& sourceFacePlane, WrapStyle wrapStyle);
@@ -198,6 +207,7 @@ namespace TrenchBroom {
             void invalidate();
 
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount);
 
             bool selected() const;
@@ -213,6 +223,8 @@ namespace TrenchBroom {
 
             void updateBrush();
 
+            TexCoordSystem& mutableTexCoordSystem();
+
             // renderer cache
             void invalidateVertexCache();
         public: // brush renderer
@@ -227,6 +239,7 @@ namespace TrenchBroom {
         private: // implement Taggable interface
             void doAcceptTagVisitor(TagVisitor& visitor) override;
             void doAcceptTagVisitor(ConstTagVisitor& visitor) const override;
+            void doTagsDidChange() override;
         private:
             deleteCopyAndMove(BrushFace)
         };
@@ -22,47 +22,161 @@
 
 #include <vecmath/vec.h>
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace TrenchBroom {
     namespace Model {
         const std::string BrushFaceAttributes::NoTextureName = "__TB_empty";
 
+        // the pools are never destroyed because attributes with static storage duration may outlive them
+
+        static std::unordered_set<std::string>& textureNames() {
+            static auto* names = new std::unordered_set<std::string>();
+            return *names;
+        }
+
+        static std::mutex& textureNameMutex() {
+            static auto* mutex = new std::mutex();
+            return *mutex;
+        }
+
+        BrushFaceAttributes::Values::Values() :
+        offset(vm::vec2f::zero()),
+        scale(vm::vec2f(1.0f, 1.0f)),
+        rotation(0.0f),
+        surfaceContents(0),
+        surfaceFlags(0),
+        surfaceValue(0.0f) {}
+
+        bool BrushFaceAttributes::Values::operator==(const Values& other) const {
+            return (offset == other.offset &&
+                scale == other.scale &&
+                rotation == other.rotation &&
+                surfaceContents == other.surfaceContents &&
+                surfaceFlags == other.surfaceFlags &&
+                surfaceValue == other.surfaceValue &&
+                color == other.color);
+        }
+
+        static std::uint32_t bits(const float f) {
+            std::uint32_t result;
+            std::memcpy(&result, &f, sizeof(result));
+            return result;
+        }
+
+        size_t BrushFaceAttributes::ValuesHash::operator()(const Values& values) const {
+            size_t result = 17u;
+            const auto combine = [&](const size_t h) { result = result * 31u + h; };
+
+            std::hash<std::uint32_t> bitsHash;
+            std::hash<int> intHash;
+            combine(bitsHash(bits(values.offset.x())));
+            combine(bitsHash(bits(values.offset.y())));
+            combine(bitsHash(bits(values.scale.x())));
+            combine(bitsHash(bits(values.scale.y())));
+            combine(bitsHash(bits(values.rotation)));
+            combine(intHash(values.surfaceContents));
+            combine(intHash(values.surfaceFlags));
+            combine(bitsHash(bits(values.surfaceValue)));
+            for (size_t i = 0u; i < 4u; ++i) {
+                combine(bitsHash(bits(values.color[i])));
+            }
+            return result;
+        }
+
+        bool BrushFaceAttributes::ValuesBitwiseEqual::operator()(const Values& lhs, const Values& rhs) const {
+            const auto equal = [](const float l, const float r) { return bits(l) == bits(r); };
+            return (equal(lhs.offset.x(), rhs.offset.x()) &&
+                equal(lhs.offset.y(), rhs.offset.y()) &&
+                equal(lhs.scale.x(), rhs.scale.x()) &&
+                equal(lhs.scale.y(), rhs.scale.y()) &&
+                equal(lhs.rotation, rhs.rotation) &&
+                lhs.surfaceContents == rhs.surfaceContents &&
+                lhs.surfaceFlags == rhs.surfaceFlags &&
+                equal(lhs.surfaceValue, rhs.surfaceValue) &&
+                equal(lhs.color[0], rhs.color[0]) &&
+                equal(lhs.color[1], rhs.color[1]) &&
+                equal(lhs.color[2], rhs.color[2]) &&
+                equal(lhs.color[3], rhs.color[3]));
+        }
+
+        /**
+         * Holds weak references to all interned attribute blocks. A block removes itself from the pool when the last
+         * reference to it is released.
+         */
+        class BrushFaceAttributes::ValuePool {
+        private:
+            struct Deleter {
+                void operator()(const Values* values) const {
+                    instance().release(values);
+                }
+            };
+
+            std::mutex m_mutex;
+            std::unordered_map<Values, std::weak_ptr<const Values>, ValuesHash, ValuesBitwiseEqual> m_values;
+        public:
+            static ValuePool& instance() {
+                static auto* pool = new ValuePool();
+                return *pool;
+            }
+
+            static bool contains(const std::shared_ptr<const Values>& values) {
+                return std::get_deleter<Deleter>(values) != nullptr;
+            }
+
+            std::shared_ptr<const Values> intern(const Values& values) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto& entry = m_values[values];
+                auto result = entry.lock();
+                if (result == nullptr) {
+                    result = std::shared_ptr<const Values>(new Values(values), Deleter());
+                    entry = result;
+                }
+                return result;
+            }
+
+            size_t size() {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_values.size();
+            }
+        private:
+            void release(const Values* values) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    const auto it = m_values.find(*values);
+                    // the entry may have been replaced by a new block in the meantime
+                    if (it != std::end(m_values) && it->second.expired()) {
+                        m_values.erase(it);
+                    }
+                }
+                delete values;
+            }
+        };
+
         BrushFaceAttributes::BrushFaceAttributes(const std::string& textureName) :
-        m_textureName(textureName),
+        m_textureName(internTextureName(textureName)),
         m_texture(nullptr),
-        m_offset(vm::vec2f::zero()),
-        m_scale(vm::vec2f(1.0f, 1.0f)),
-        m_rotation(0.0f),
-        m_surfaceContents(0),
-        m_surfaceFlags(0),
-        m_surfaceValue(0.0f) {}
+        m_values(defaultValues()) {}
 
         BrushFaceAttributes::BrushFaceAttributes(const BrushFaceAttributes& other) :
         m_textureName(other.m_textureName),
         m_texture(other.m_texture),
-        m_offset(other.m_offset),
-        m_scale(other.m_scale),
-        m_rotation(other.m_rotation),
-        m_surfaceContents(other.m_surfaceContents),
-        m_surfaceFlags(other.m_surfaceFlags),
-        m_surfaceValue(other.m_surfaceValue),
-        m_color(other.m_color) {
+        m_values(other.m_values) {
             if (m_texture != nullptr) {
                 m_texture->incUsageCount();
             }
         }
 
         BrushFaceAttributes::BrushFaceAttributes(const std::string& textureName, const BrushFaceAttributes& other) :
-        m_textureName(textureName),
+        m_textureName(internTextureName(textureName)),
         m_texture(nullptr),
-        m_offset(other.m_offset),
-        m_scale(other.m_scale),
-        m_rotation(other.m_rotation),
-        m_surfaceContents(other.m_surfaceContents),
-        m_surfaceFlags(other.m_surfaceFlags),
-        m_surfaceValue(other.m_surfaceValue),
-        m_color(other.m_color) {}
+        m_values(other.m_values) {}
 
         BrushFaceAttributes::~BrushFaceAttributes() {
             if (m_texture != nullptr) {
@@ -79,42 +193,41 @@ namespace TrenchBroom {
         bool BrushFaceAttributes::operator==(const BrushFaceAttributes& other) const {
             return (m_textureName == other.m_textureName &&
                 m_texture == other.m_texture &&
-                m_offset == other.m_offset &&
-                m_scale == other.m_scale &&
-                m_rotation == other.m_rotation &&
-                m_surfaceContents == other.m_surfaceContents &&
-                m_surfaceFlags == other.m_surfaceFlags &&
-                m_surfaceValue == other.m_surfaceValue &&
-                m_color == other.m_color);
+                (m_values == other.m_values || *m_values == *other.m_values));
         }
 
         void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs) {
             using std::swap;
             swap(lhs.m_textureName, rhs.m_textureName);
             swap(lhs.m_texture, rhs.m_texture);
-            swap(lhs.m_offset, rhs.m_offset);
-            swap(lhs.m_scale, rhs.m_scale);
-            swap(lhs.m_rotation, rhs.m_rotation);
-            swap(lhs.m_surfaceContents, rhs.m_surfaceContents);
-            swap(lhs.m_surfaceFlags, rhs.m_surfaceFlags);
-            swap(lhs.m_surfaceValue, rhs.m_surfaceValue);
-            swap(lhs.m_color, rhs.m_color);
+            swap(lhs.m_values, rhs.m_values);
         }
 
         BrushFaceAttributes BrushFaceAttributes::takeSnapshot() const {
-            BrushFaceAttributes result(m_textureName);
-            result.m_offset = m_offset;
-            result.m_scale = m_scale;
-            result.m_rotation = m_rotation;
-            result.m_surfaceContents = m_surfaceContents;
-            result.m_surfaceFlags = m_surfaceFlags;
-            result.m_surfaceValue = m_surfaceValue;
-            result.m_color = m_color;
+            BrushFaceAttributes result(*m_textureName);
+            result.m_values = m_values;
+            return result;
+        }
+
+        void BrushFaceAttributes::intern() {
+            if (!ValuePool::contains(m_values)) {
+                m_values = ValuePool::instance().intern(*m_values);
+            }
+        }
+
+        BrushFaceAttributes::MemoryStats BrushFaceAttributes::memoryStats() {
+            MemoryStats result;
+            {
+                std::lock_guard<std::mutex> lock(textureNameMutex());
+                result.textureNameCount = textureNames().size();
+            }
+            result.internedValueCount = ValuePool::instance().size();
+            result.valueSize = sizeof(Values);
             return result;
         }
 
         const std::string& BrushFaceAttributes::textureName() const {
-            return m_textureName;
+            return *m_textureName;
         }
 
         Assets::Texture* BrushFaceAttributes::texture() const {
@@ -131,15 +244,15 @@ namespace TrenchBroom {
         }
 
         const vm::vec2f& BrushFaceAttributes::offset() const {
-            return m_offset;
+            return m_values->offset;
         }
 
         float BrushFaceAttributes::xOffset() const {
-            return m_offset.x();
+            return m_values->offset.x();
         }
 
         float BrushFaceAttributes::yOffset() const {
-            return m_offset.y();
+            return m_values->offset.y();
         }
 
         vm::vec2f BrushFaceAttributes::modOffset(const vm::vec2f& offset) const {
@@ -147,31 +260,31 @@ namespace TrenchBroom {
         }
 
         const vm::vec2f& BrushFaceAttributes::scale() const {
-            return m_scale;
+            return m_values->scale;
         }
 
         float BrushFaceAttributes::xScale() const {
-            return m_scale.x();
+            return m_values->scale.x();
         }
 
         float BrushFaceAttributes::yScale() const {
-            return m_scale.y();
+            return m_values->scale.y();
         }
 
         float BrushFaceAttributes::rotation() const {
-            return m_rotation;
+            return m_values->rotation;
         }
 
         int BrushFaceAttributes::surfaceContents() const {
-            return m_surfaceContents;
+            return m_values->surfaceContents;
         }
 
         int BrushFaceAttributes::surfaceFlags() const {
-            return m_surfaceFlags;
+            return m_values->surfaceFlags;
         }
 
         float BrushFaceAttributes::surfaceValue() const {
-            return m_surfaceValue;
+            return m_values->surfaceValue;
         }
 
         void BrushFaceAttributes::setTexture(Assets::Texture* texture) {
@@ -181,7 +294,7 @@ namespace TrenchBroom {
             m_texture = texture;
             if (m_texture != nullptr) {
                 m_texture->incUsageCount();
-                m_textureName = m_texture->name();
+                m_textureName = internTextureName(m_texture->name());
             }
         }
 
@@ -190,59 +303,78 @@ namespace TrenchBroom {
                 m_texture->decUsageCount();
             }
             m_texture = nullptr;
-            m_textureName = BrushFaceAttributes::NoTextureName;
+            m_textureName = internTextureName(BrushFaceAttributes::NoTextureName);
         }
 
         bool BrushFaceAttributes::valid() const {
-            return !vm::is_zero(m_scale.x(), vm::Cf::almost_zero()) && !vm::is_zero(m_scale.y(), vm::Cf::almost_zero());
+            return !vm::is_zero(m_values->scale.x(), vm::Cf::almost_zero()) && !vm::is_zero(m_values->scale.y(), vm::Cf::almost_zero());
         }
 
         void BrushFaceAttributes::setOffset(const vm::vec2f& offset) {
-            m_offset = offset;
+            mutableValues().offset = offset;
         }
 
         void BrushFaceAttributes::setXOffset(const float xOffset) {
-            m_offset[0] = xOffset;
+            mutableValues().offset[0] = xOffset;
         }
 
         void BrushFaceAttributes::setYOffset(const float yOffset) {
-            m_offset[1] = yOffset;
+            mutableValues().offset[1] = yOffset;
         }
 
         void BrushFaceAttributes::setScale(const vm::vec2f& scale) {
-            m_scale = scale;
+            mutableValues().scale = scale;
         }
 
         void BrushFaceAttributes::setXScale(const float xScale) {
-            m_scale[0] = xScale;
+            mutableValues().scale[0] = xScale;
         }
 
         void BrushFaceAttributes::setYScale(const float yScale) {
-            m_scale[1] = yScale;
+            mutableValues().scale[1] = yScale;
         }
 
         void BrushFaceAttributes::setRotation(const float rotation) {
-            m_rotation = rotation;
+            mutableValues().rotation = rotation;
         }
 
         void BrushFaceAttributes::setSurfaceContents(const int surfaceContents) {
-            m_surfaceContents = surfaceContents;
+            mutableValues().surfaceContents = surfaceContents;
         }
 
         void BrushFaceAttributes::setSurfaceFlags(const int surfaceFlags) {
-            m_surfaceFlags = surfaceFlags;
+            mutableValues().surfaceFlags = surfaceFlags;
         }
 
         void BrushFaceAttributes::setSurfaceValue(const float surfaceValue) {
-            m_surfaceValue = surfaceValue;
+            mutableValues().surfaceValue = surfaceValue;
         }
 
         const Color& BrushFaceAttributes::color() const {
-            return m_color;
+            return m_values->color;
         }
 
         void BrushFaceAttributes::setColor(const Color& color) {
-            m_color = color;
+            mutableValues().color = color;
+        }
+
+        const std::string* BrushFaceAttributes::internTextureName(const std::string& textureName) {
+            // the elements of an unordered_set are never moved, so the returned pointer remains valid
+            std::lock_guard<std::mutex> lock(textureNameMutex());
+            return &*textureNames().insert(textureName).first;
+        }
+
+        std::shared_ptr<const BrushFaceAttributes::Values> BrushFaceAttributes::defaultValues() {
+            static const auto values = std::make_shared<const Values>();
+            return values;
+        }
+
+        BrushFaceAttributes::Values& BrushFaceAttributes::mutableValues() {
+            // interned blocks and blocks shared with other instances must not be modified
+            if (m_values.use_count() != 1 || ValuePool::contains(m_values)) {
+                m_values = std::make_shared<Values>(*m_values);
+            }
+            return const_cast<Values&>(*m_values);
         }
     }
 }
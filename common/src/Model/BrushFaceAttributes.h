@@ -23,7 +23,9 @@
 #include "Color.h"
 
 #include <vecmath/forward.h>
+#include <vecmath/vec.h>
 
+#include <memory>
 #include <string>
 
 namespace TrenchBroom {
@@ -32,22 +34,65 @@ namespace TrenchBroom {
     }
 
     namespace Model {
+        /**
+         * The attributes of a brush face.
+         *
+         * Since most faces of a map share their attributes with many other faces, the attributes are stored in a
+         * shared, immutable block which is copied on write. Texture names are interned so that every distinct name is
+         * stored only once. Copying an instance of this class is therefore cheap, and faces with identical attributes
+         * can share a single block by calling intern().
+         */
         class BrushFaceAttributes {
         public:
             static const std::string NoTextureName;
+
+            struct MemoryStats {
+                /**
+                 * The number of distinct interned texture names.
+                 */
+                size_t textureNameCount;
+                /**
+                 * The number of distinct attribute blocks in the intern pool.
+                 */
+                size_t internedValueCount;
+                /**
+                 * The size of a single attribute block in bytes.
+                 */
+                size_t valueSize;
+            };
         private:
-            std::string m_textureName;
-            Assets::Texture* m_texture;
+            struct Values {
+                vm::vec2f offset;
+                vm::vec2f scale;
+                float rotation;
+
+                int surfaceContents;
+                int surfaceFlags;
+                float surfaceValue;
+
+                Color color;
 
-            vm::vec2f m_offset;
-            vm::vec2f m_scale;
-            float m_rotation;
+                Values();
+                bool operator==(const Values& other) const;
+            };
 
-            int m_surfaceContents;
-            int m_surfaceFlags;
-            float m_surfaceValue;
+            /*
+             * The intern pool compares and hashes the bit patterns of the values, so that a block with a NaN value is
+             * found again, even though NaN never compares equal to itself.
+             */
+            struct ValuesHash {
+                size_t operator()(const Values& values) const;
+            };
 
-            Color m_color;
+            struct ValuesBitwiseEqual {
+                bool operator()(const Values& lhs, const Values& rhs) const;
+            };
+
+            class ValuePool;
+
+            const std::string* m_textureName;
+            Assets::Texture* m_texture;
+            std::shared_ptr<const Values> m_values;
         public:
             BrushFaceAttributes(const std::string& textureName);
             BrushFaceAttributes(const BrushFaceAttributes& other);
@@ -59,6 +104,21 @@ namespace TrenchBroom {
 
             BrushFaceAttributes takeSnapshot() const;
 
+            /**
+             * Replaces the attribute block of this object with an identical block that is shared by all interned
+             * attributes, adding the block to the pool if necessary.
+             */
+            void intern();
+
+            /**
+             * Returns statistics about the interned texture names and attribute blocks.
+             */
+            static MemoryStats memoryStats();
+
+            /**
+             * Returns the interned texture name. All attributes with the same texture name return a reference to the
+             * same string, which remains valid for the lifetime of the program.
+             */
             const std::string& textureName() const;
             Assets::Texture* texture() const;
             vm::vec2f textureSize() const;
@@ -96,6 +156,10 @@ namespace TrenchBroom {
 
             const Color& color() const;
             void setColor(const Color& color);
+        private:
+            static const std::string* internTextureName(const std::string& textureName);
+            static std::shared_ptr<const Values> defaultValues();
+            Values& mutableValues();
         };
     }
 }
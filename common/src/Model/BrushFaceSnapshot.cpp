@@ -20,6 +20,7 @@
 #include "BrushFaceSnapshot.h"
 
 #include "Model/BrushFace.h"
+#include "Model/ParallelTexCoordSystem.h"
 #include "Model/TexCoordSystem.h"
 
 namespace TrenchBroom {
@@ -38,5 +39,13 @@ namespace TrenchBroom {
                 face->restoreTexCoordSystemSnapshot(*m_coordSystemSnapshot);
             }
         }
+
+        size_t BrushFaceSnapshot::memoryUsage() const {
+            size_t result = sizeof(*this);
+            if (m_coordSystemSnapshot != nullptr) {
+                result += sizeof(ParallelTexCoordSystemSnapshot);
+            }
+            return result;
+        }
     }
 }
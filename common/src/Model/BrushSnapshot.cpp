@@ -19,33 +19,166 @@
 
 #include "BrushSnapshot.h"
 
+#include "IO/Reader.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+#include "Model/TexCoordSystem.h"
 
-#include <kdl/vector_utils.h>
+#include <algorithm>
+#include <utility>
 
 namespace TrenchBroom {
     namespace Model {
+        BrushSnapshot::FaceRecord::FaceRecord(const BrushFace* face) :
+        points({ face->points()[0], face->points()[1], face->points()[2] }),
+        attribs(face->attribs().takeSnapshot()),
+        texCoordSystem(face->shareTexCoordSystem()),
+        lineNumber(face->lineNumber()),
+        lineCount(face->lineCount()),
+        selected(face->selected()) {}
+
+        BrushSnapshot::FaceRecord::FaceRecord(const std::array<vm::vec3, 3>& i_points, const BrushFaceAttributes& i_attribs, std::shared_ptr<TexCoordSystem> i_texCoordSystem, const size_t i_lineNumber, const size_t i_lineCount, const bool i_selected) :
+        points(i_points),
+        attribs(i_attribs),
+        texCoordSystem(std::move(i_texCoordSystem)),
+        lineNumber(i_lineNumber),
+        lineCount(i_lineCount),
+        selected(i_selected) {}
+
+        BrushSnapshot::FaceRecord::FaceRecord(FaceRecord&& other) noexcept = default;
+
+        BrushSnapshot::FaceRecord::~FaceRecord() = default;
+
+        BrushFace* BrushSnapshot::FaceRecord::restore() {
+            auto* face = new BrushFace(points[0], points[1], points[2], attribs, std::move(texCoordSystem));
+            face->setFilePosition(lineNumber, lineCount);
+            if (selected) {
+                face->select();
+            }
+            return face;
+        }
+
+        void BrushSnapshot::FaceRecord::write(IO::SpillFile::RecordWriter& writer) const {
+            for (const auto& point : points) {
+                writer.writeVec(point);
+            }
+
+            // the texture is not written, it is set again by the document when the snapshot is restored
+            writer.writeString(attribs.textureName());
+            writer.writeVec(attribs.offset());
+            writer.writeVec(attribs.scale());
+            writer.write<float>(attribs.rotation());
+            writer.write<int32_t>(attribs.surfaceContents());
+            writer.write<int32_t>(attribs.surfaceFlags());
+            writer.write<float>(attribs.surfaceValue());
+            writer.writeVec<float, 4>(attribs.color());
+
+            // a paraxial texture coordinate system is determined by the face's plane and rotation, so only the axes of
+            // a parallel texture coordinate system must be written; only the latter returns a snapshot
+            const bool parallel = texCoordSystem->takeSnapshot() != nullptr;
+            writer.write<uint8_t>(parallel ? 1u : 0u);
+            if (parallel) {
+                writer.writeVec(texCoordSystem->xAxis());
+                writer.writeVec(texCoordSystem->yAxis());
+            }
+
+            writer.write<uint64_t>(lineNumber);
+            writer.write<uint64_t>(lineCount);
+            writer.write<uint8_t>(selected ? 1u : 0u);
+        }
+
+        BrushSnapshot::FaceRecord BrushSnapshot::FaceRecord::read(IO::Reader& reader) {
+            std::array<vm::vec3, 3> points;
+            for (auto& point : points) {
+                point = reader.readVec<FloatType, 3>();
+            }
+
+            auto attribs = BrushFaceAttributes(reader.readString(reader.readSize<uint64_t>()));
+            attribs.setOffset(reader.readVec<float, 2>());
+            attribs.setScale(reader.readVec<float, 2>());
+            attribs.setRotation(reader.readFloat<float>());
+            attribs.setSurfaceContents(reader.readInt<int32_t>());
+            attribs.setSurfaceFlags(reader.readInt<int32_t>());
+            attribs.setSurfaceValue(reader.readFloat<float>());
+            attribs.setColor(Color(reader.readVec<float, 4>()));
+            attribs.intern();
+
+            std::shared_ptr<TexCoordSystem> texCoordSystem;
+            if (reader.readBool<uint8_t>()) {
+                const auto xAxis = reader.readVec<FloatType, 3>();
+                const auto yAxis = reader.readVec<FloatType, 3>();
+                texCoordSystem = std::make_shared<ParallelTexCoordSystem>(xAxis, yAxis);
+            } else {
+                texCoordSystem = std::make_shared<ParaxialTexCoordSystem>(points[0], points[1], points[2], attribs);
+            }
+
+            const auto lineNumber = reader.readSize<uint64_t>();
+            const auto lineCount = reader.readSize<uint64_t>();
+            const auto selected = reader.readBool<uint8_t>();
+
+            return FaceRecord(points, attribs, std::move(texCoordSystem), lineNumber, lineCount, selected);
+        }
+
         BrushSnapshot::BrushSnapshot(Brush* brush) :
         m_brush(brush) {
             takeSnapshot(brush);
         }
 
-        BrushSnapshot::~BrushSnapshot() {
-            kdl::vec_clear_and_delete(m_faces);
-        }
+        BrushSnapshot::~BrushSnapshot() = default;
 
         void BrushSnapshot::takeSnapshot(Brush* brush) {
-            for (BrushFace* face : brush->faces()) {
-                BrushFace *faceClone = face->clone();
-                faceClone->setTexture(nullptr);
-                m_faces.push_back(faceClone);
+            const auto& faces = brush->faces();
+            m_faces.reserve(faces.size());
+            for (const BrushFace* face : faces) {
+                m_faces.emplace_back(face);
             }
         }
 
         void BrushSnapshot::doRestore(const vm::bbox3& worldBounds) {
-            m_brush->setFaces(worldBounds, m_faces);
+            std::vector<BrushFace*> faces;
+            faces.reserve(m_faces.size());
+            for (auto& record : m_faces) {
+                faces.push_back(record.restore());
+            }
+            m_faces.clear();
+
+            m_brush->setFaces(worldBounds, faces);
+        }
+
+        size_t BrushSnapshot::doGetMemoryUsage() const {
+            // the attributes are shared with the faces and are not counted here, and neither are the texture
+            // coordinate systems that are still shared; the others are estimated by the larger of the two
+            // implementations
+            const auto texCoordSystemSize = std::max(sizeof(ParaxialTexCoordSystem), sizeof(ParallelTexCoordSystem));
+            size_t result = sizeof(*this) + m_faces.capacity() * sizeof(FaceRecord);
+            for (const auto& record : m_faces) {
+                if (record.texCoordSystem.use_count() == 1) {
+                    result += texCoordSystemSize;
+                }
+            }
+            return result;
+        }
+
+        void BrushSnapshot::doWriteData(IO::SpillFile::RecordWriter& writer) const {
+            writer.write<uint64_t>(m_faces.size());
+            for (const auto& record : m_faces) {
+                record.write(writer);
+            }
+        }
+
+        void BrushSnapshot::doReleaseData() {
             m_faces.clear();
+            m_faces.shrink_to_fit();
+        }
+
+        void BrushSnapshot::doReadData(IO::Reader& reader) {
+            const auto count = reader.readSize<uint64_t>();
+            m_faces.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                m_faces.push_back(FaceRecord::read(reader));
+            }
         }
     }
 }
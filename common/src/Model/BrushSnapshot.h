@@ -20,25 +20,62 @@
 #ifndef TrenchBroom_BrushSnapshot
 #define TrenchBroom_BrushSnapshot
 
+#include "FloatType.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/NodeSnapshot.h"
 
+#include <vecmath/vec.h>
+
+#include <array>
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Model {
         class Brush;
         class BrushFace;
+        class TexCoordSystem;
 
+        /**
+         * Records the data needed to rebuild the faces of a brush. Instead of cloning every face, only the plane
+         * points, the attributes and the texture coordinate system of each face are stored in a single contiguous
+         * array. The attributes and the texture coordinate systems are shared with the original faces, which copy
+         * them when they are changed later, so taking a snapshot allocates nothing but the array, and only the data
+         * of the faces that are actually changed is duplicated.
+         */
         class BrushSnapshot : public NodeSnapshot {
         private:
+            struct FaceRecord {
+                std::array<vm::vec3, 3> points;
+                BrushFaceAttributes attribs;
+                std::shared_ptr<TexCoordSystem> texCoordSystem;
+                size_t lineNumber;
+                size_t lineCount;
+                bool selected;
+
+                explicit FaceRecord(const BrushFace* face);
+                FaceRecord(const std::array<vm::vec3, 3>& i_points, const BrushFaceAttributes& i_attribs, std::shared_ptr<TexCoordSystem> i_texCoordSystem, size_t i_lineNumber, size_t i_lineCount, bool i_selected);
+                FaceRecord(FaceRecord&& other) noexcept;
+                ~FaceRecord();
+
+                BrushFace* restore();
+
+                void write(IO::SpillFile::RecordWriter& writer) const;
+                static FaceRecord read(IO::Reader& reader);
+            };
+
             Brush* m_brush;
-            std::vector<BrushFace*> m_faces;
+            std::vector<FaceRecord> m_faces;
         public:
             BrushSnapshot(Brush* brush);
             ~BrushSnapshot() override;
         private:
             void takeSnapshot(Brush* brush);
             void doRestore(const vm::bbox3& worldBounds) override;
+            size_t doGetMemoryUsage() const override;
+            void doWriteData(IO::SpillFile::RecordWriter& writer) const override;
+            void doReleaseData() override;
+            void doReadData(IO::Reader& reader) override;
         };
     }
 }
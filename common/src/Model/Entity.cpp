@@ -28,7 +28,6 @@
 #include "Model/EntityRotationPolicy.h"
 #include "Model/EntitySnapshot.h"
 #include "Model/FindContainerVisitor.h"
-#include "Model/FindGroupVisitor.h"
 #include "Model/FindLayerVisitor.h"
 #include "Model/IssueGenerator.h"
 #include "Model/NodeVisitor.h"
@@ -159,9 +158,8 @@ namespace TrenchBroom {
         }
 
         void Entity::setModelFrame(const Assets::EntityModelFrame* modelFrame) {
-            const auto oldBounds = physicalBounds();
             m_modelFrame = modelFrame;
-            nodePhysicalBoundsDidChange(oldBounds);
+            nodePhysicalBoundsDidChange();
             cacheAttributes();
         }
 
@@ -220,23 +218,20 @@ namespace TrenchBroom {
         }
 
         void Entity::doChildWasAdded(Node* /* node */) {
-            nodePhysicalBoundsDidChange(physicalBounds());
+            nodePhysicalBoundsDidChange();
         }
 
         void Entity::doChildWasRemoved(Node* /* node */) {
-            nodePhysicalBoundsDidChange(physicalBounds());
+            nodePhysicalBoundsDidChange();
         }
 
         void Entity::doNodePhysicalBoundsDidChange() {
             invalidateBounds();
+            invalidateIssues();
         }
 
-        void Entity::doChildPhysicalBoundsDidChange() {
-            const vm::bbox3 myOldBounds = physicalBounds();
-            invalidateBounds();
-            if (physicalBounds() != myOldBounds) {
-                nodePhysicalBoundsDidChange(myOldBounds);
-            }
+        bool Entity::doPhysicalBoundsInvalidated() const {
+            return !m_boundsValid;
         }
 
         bool Entity::doSelectable() const {
@@ -306,12 +301,12 @@ namespace TrenchBroom {
             }
         }
 
-        void Entity::doAttributesDidChange(const vm::bbox3& oldBounds) {
+        void Entity::doAttributesDidChange(const vm::bbox3& /* oldBounds */) {
             // update m_cachedOrigin and m_cachedRotation. Must be done first because nodePhysicalBoundsDidChange() might
             // call origin()
             cacheAttributes();
 
-            nodePhysicalBoundsDidChange(oldBounds);
+            nodePhysicalBoundsDidChange();
 
             // needs to be called again because the calculated rotation will be different after calling nodePhysicalBoundsDidChange()
             cacheAttributes();
@@ -346,9 +341,7 @@ namespace TrenchBroom {
         }
 
         Group* Entity::doGetGroup() const {
-            FindGroupVisitor visitor;
-            escalate(visitor);
-            return visitor.hasResult() ? visitor.result() : nullptr;
+            return containingGroup();
         }
 
         class TransformEntity : public NodeVisitor {
@@ -440,6 +433,7 @@ namespace TrenchBroom {
             }
 
             m_boundsValid = true;
+            countBoundsComputation();
         }
 
         void Entity::doAcceptTagVisitor(TagVisitor& visitor) {
@@ -98,7 +98,7 @@ namespace TrenchBroom {
             void doChildWasRemoved(Node* node) override;
 
             void doNodePhysicalBoundsDidChange() override;
-            void doChildPhysicalBoundsDidChange() override;
+            bool doPhysicalBoundsInvalidated() const override;
 
             bool doSelectable() const override;
 
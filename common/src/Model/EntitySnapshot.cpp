@@ -19,6 +19,7 @@
 
 #include "EntitySnapshot.h"
 
+#include "IO/Reader.h"
 #include "Model/Entity.h"
 
 namespace TrenchBroom {
@@ -30,5 +31,36 @@ namespace TrenchBroom {
         void EntitySnapshot::doRestore(const vm::bbox3& /* worldBounds */) {
             m_entity->setAttributes(m_attributesSnapshot);
         }
+
+        size_t EntitySnapshot::doGetMemoryUsage() const {
+            size_t result = sizeof(*this) + m_attributesSnapshot.capacity() * sizeof(EntityAttribute);
+            for (const auto& attribute : m_attributesSnapshot) {
+                result += attribute.name().capacity() + attribute.value().capacity();
+            }
+            return result;
+        }
+
+        void EntitySnapshot::doWriteData(IO::SpillFile::RecordWriter& writer) const {
+            writer.write<uint64_t>(m_attributesSnapshot.size());
+            for (const auto& attribute : m_attributesSnapshot) {
+                writer.writeString(attribute.name());
+                writer.writeString(attribute.value());
+            }
+        }
+
+        void EntitySnapshot::doReleaseData() {
+            m_attributesSnapshot.clear();
+            m_attributesSnapshot.shrink_to_fit();
+        }
+
+        void EntitySnapshot::doReadData(IO::Reader& reader) {
+            const auto count = reader.readSize<uint64_t>();
+            m_attributesSnapshot.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                auto name = reader.readString(reader.readSize<uint64_t>());
+                auto value = reader.readString(reader.readSize<uint64_t>());
+                m_attributesSnapshot.emplace_back(name, value);
+            }
+        }
     }
 }
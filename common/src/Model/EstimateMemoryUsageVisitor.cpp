@@ -0,0 +1,100 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EstimateMemoryUsageVisitor.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+#include "Model/Polyhedron.h"
+#include "Model/World.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static size_t estimateAttributesMemoryUsage(const AttributableNode* node) {
+            const auto& attributes = node->attributes();
+            size_t result = attributes.capacity() * sizeof(EntityAttribute);
+            for (const auto& attribute : attributes) {
+                result += attribute.name().capacity() + attribute.value().capacity();
+            }
+            return result;
+        }
+
+        EstimateMemoryUsageVisitor::EstimateMemoryUsageVisitor() :
+        m_memoryUsage(0u) {}
+
+        size_t EstimateMemoryUsageVisitor::memoryUsage() const {
+            return m_memoryUsage;
+        }
+
+        void EstimateMemoryUsageVisitor::doVisit(const World* world) {
+            m_memoryUsage += sizeof(World) + estimateAttributesMemoryUsage(world);
+        }
+
+        void EstimateMemoryUsageVisitor::doVisit(const Layer* layer) {
+            m_memoryUsage += sizeof(Layer) + layer->name().capacity();
+        }
+
+        void EstimateMemoryUsageVisitor::doVisit(const Group* group) {
+            m_memoryUsage += sizeof(Group) + group->name().capacity();
+        }
+
+        void EstimateMemoryUsageVisitor::doVisit(const Entity* entity) {
+            m_memoryUsage += sizeof(Entity) + estimateAttributesMemoryUsage(entity);
+        }
+
+        void EstimateMemoryUsageVisitor::doVisit(const Brush* brush) {
+            // texture coordinate systems may be shared with snapshots, and face attributes are interned; both are
+            // counted in full here, which overestimates the usage of a brush that shares them
+            const auto texCoordSystemSize = std::max(sizeof(ParaxialTexCoordSystem), sizeof(ParallelTexCoordSystem));
+            const auto faceSize = sizeof(BrushFace) + texCoordSystemSize + sizeof(BrushFaceGeometry);
+            const auto edgeSize = sizeof(BrushEdge) + 2u * sizeof(BrushHalfEdge);
+
+            m_memoryUsage += sizeof(Brush) + sizeof(BrushGeometry);
+            m_memoryUsage += brush->faceCount() * faceSize;
+            m_memoryUsage += brush->edgeCount() * edgeSize;
+            m_memoryUsage += brush->vertexCount() * sizeof(BrushVertex);
+        }
+
+        size_t estimateMemoryUsage(const std::vector<Node*>& nodes) {
+            return estimateMemoryUsage(std::begin(nodes), std::end(nodes));
+        }
+
+        size_t estimateMemoryUsage(const std::map<Node*, std::vector<Node*>>& nodes) {
+            using Entry = std::map<Node*, std::vector<Node*>>::value_type;
+
+            // every map entry is a tree node with three pointers and a color
+            size_t result = 0u;
+            for (const auto& entry : nodes) {
+                result += sizeof(Entry) + 4u * sizeof(void*) + entry.second.capacity() * sizeof(Node*);
+            }
+            return result;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_EstimateMemoryUsageVisitor
+#define TrenchBroom_EstimateMemoryUsageVisitor
+
+#include "Model/NodeVisitor.h"
+#include "Model/Node.h"
+
+#include <map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Estimates the number of bytes occupied by the visited nodes, including their faces, geometry and
+         * attributes. The visitor does not recurse by itself; use Node::acceptAndRecurse to include the children.
+         */
+        class EstimateMemoryUsageVisitor : public ConstNodeVisitor {
+        private:
+            size_t m_memoryUsage;
+        public:
+            EstimateMemoryUsageVisitor();
+            size_t memoryUsage() const;
+        private:
+            void doVisit(const World* world) override;
+            void doVisit(const Layer* layer) override;
+            void doVisit(const Group* group) override;
+            void doVisit(const Entity* entity) override;
+            void doVisit(const Brush* brush) override;
+        };
+
+        /**
+         * Estimates the number of bytes occupied by the given nodes and all of their descendants.
+         */
+        size_t estimateMemoryUsage(const std::vector<Node*>& nodes);
+
+        template <typename I>
+        size_t estimateMemoryUsage(I cur, I end) {
+            auto visitor = EstimateMemoryUsageVisitor();
+            Node::acceptAndRecurse(cur, end, visitor);
+            return visitor.memoryUsage();
+        }
+
+        /**
+         * Estimates the number of bytes occupied by the given map of parents to children, excluding the nodes.
+         */
+        size_t estimateMemoryUsage(const std::map<Node*, std::vector<Node*>>& nodes);
+    }
+}
+
+#endif /* defined(TrenchBroom_EstimateMemoryUsageVisitor) */
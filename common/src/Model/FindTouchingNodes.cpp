@@ -0,0 +1,177 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FindTouchingNodes.h"
+
+#include "AABBTree.h"
+#include "FloatType.h"
+#include "Model/Brush.h"
+#include "Model/EditorContext.h"
+#include "Model/Group.h"
+#include "Model/NodeFilter.h"
+#include "Model/NodeVisitor.h"
+#include "Model/World.h"
+
+#include <kdl/parallel.h>
+#include <kdl/vector_set.h>
+
+#include <vecmath/bbox.h>
+
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        using BrushTree = AABBTree<FloatType, 3, const Brush*>;
+
+        /**
+         * Collects the groups that may be selectable. Only the top level of the map and the contents of open groups
+         * (and of groups with an open descendant) can contain selectable groups, so the recursion never enters
+         * entities or closed groups.
+         */
+        class CollectSelectableGroupsVisitor : public NodeVisitor {
+        private:
+            const EditorContext& m_editorContext;
+            std::vector<Node*> m_groups;
+        public:
+            explicit CollectSelectableGroupsVisitor(const EditorContext& editorContext) :
+            m_editorContext(editorContext) {}
+
+            const std::vector<Node*>& groups() const {
+                return m_groups;
+            }
+        private:
+            void doVisit(World*) override {}
+            void doVisit(Layer*) override {}
+
+            void doVisit(Group* group) override {
+                if (m_editorContext.selectable(group)) {
+                    m_groups.push_back(group);
+                }
+                if (!group->opened() && !group->hasOpenedDescendant()) {
+                    stopRecursion();
+                }
+            }
+
+            void doVisit(Entity*) override { stopRecursion(); }
+            void doVisit(Brush*) override  { stopRecursion(); }
+        };
+
+        /**
+         * Returns the selectable groups, and the selectable entities and brushes whose bounds intersect the bounds of
+         * any of the given brushes. The groups come first, in the order of the map, followed by the entities and
+         * brushes in the order in which they are found in the node tree.
+         */
+        static std::vector<Node*> findCandidates(World& world, const std::vector<Brush*>& brushes, const EditorContext& editorContext) {
+            CollectSelectableGroupsVisitor collectGroups(editorContext);
+            world.acceptAndRecurse(collectGroups);
+
+            auto result = collectGroups.groups();
+
+            const auto filter = NodeFilter(editorContext, NodeFilter::Selectable);
+            std::unordered_set<Node*> visited;
+            for (const auto* brush : brushes) {
+                for (auto* node : world.findNodesIntersecting(brush->logicalBounds(), filter)) {
+                    if (visited.insert(node).second) {
+                        result.push_back(node);
+                    }
+                }
+            }
+
+            // the bounds of groups and entities are computed lazily, so they must be computed before they are accessed
+            // concurrently
+            for (const auto* node : result) {
+                node->logicalBounds();
+            }
+
+            return result;
+        }
+
+        static bool hasMatchedAncestor(const Node* node, const kdl::vector_set<const Node*>& matchedGroups) {
+            for (const auto* parent = node->parent(); parent != nullptr; parent = parent->parent()) {
+                if (matchedGroups.count(parent) > 0u) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Returns every candidate for which the given predicate returns true for any of the given brushes whose bounds
+         * intersect the candidate's bounds. The predicate is evaluated in parallel. If a group is found, then none of
+         * its descendants are returned.
+         */
+        template <typename P>
+        static std::vector<Node*> findMatchingNodes(World& world, const std::vector<Brush*>& brushes, const EditorContext& editorContext, const P& predicate) {
+            if (brushes.empty()) {
+                return {};
+            }
+
+            BrushTree brushTree;
+            for (const auto* brush : brushes) {
+                brushTree.insert(brush->logicalBounds(), brush);
+            }
+
+            const auto candidates = findCandidates(world, brushes, editorContext);
+            const auto matches = kdl::vec_parallel_transform(candidates, [&](Node* candidate) -> Node* {
+                const auto& bounds = candidate->logicalBounds();
+
+                std::vector<const Brush*> nearbyBrushes;
+                brushTree.findMatching([&](const vm::bbox3& brushBounds) { return brushBounds.intersects(bounds); }, std::back_inserter(nearbyBrushes));
+
+                for (const auto* brush : nearbyBrushes) {
+                    if (predicate(brush, candidate)) {
+                        return candidate;
+                    }
+                }
+                return nullptr;
+            }, 16u);
+
+            kdl::vector_set<const Node*> matchedGroups;
+            for (const auto* group : matches) {
+                if (group != nullptr && group->hasChildren()) {
+                    matchedGroups.insert(group);
+                }
+            }
+
+            std::vector<Node*> result;
+            for (auto* node : matches) {
+                if (node != nullptr && !hasMatchedAncestor(node, matchedGroups)) {
+                    result.push_back(node);
+                }
+            }
+            return result;
+        }
+
+        std::vector<Node*> findTouchingNodes(World& world, const std::vector<Brush*>& brushes, const EditorContext& editorContext) {
+            const std::unordered_set<const Node*> queryNodes(std::begin(brushes), std::end(brushes));
+            return findMatchingNodes(world, brushes, editorContext, [&](const Brush* brush, const Node* node) {
+                // if `node` is one of the search query nodes, don't count it as touching
+                return queryNodes.count(node) == 0u && brush->intersects(node);
+            });
+        }
+
+        std::vector<Node*> findContainedNodes(World& world, const std::vector<Brush*>& brushes, const EditorContext& editorContext) {
+            return findMatchingNodes(world, brushes, editorContext, [](const Brush* brush, const Node* node) {
+                return brush != node && brush->contains(node);
+            });
+        }
+    }
+}
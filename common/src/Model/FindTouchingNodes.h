@@ -0,0 +1,54 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_FindTouchingNodes
+#define TrenchBroom_FindTouchingNodes
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class Brush;
+        class EditorContext;
+        class Node;
+        class World;
+
+        /**
+         * Returns the selectable nodes of the given world that intersect any of the given brushes. The given brushes
+         * themselves are never returned, and if a group is returned, none of its descendants are returned.
+         *
+         * This yields the same nodes as CollectTouchingNodesVisitor, but the candidate entities and brushes are
+         * taken from the world's node tree and the exact intersection tests are performed in parallel. Thus, the node
+         * tree of the given world must be up to date.
+         */
+        std::vector<Node*> findTouchingNodes(World& world, const std::vector<Brush*>& brushes, const EditorContext& editorContext);
+
+        /**
+         * Returns the selectable nodes of the given world that are contained in any of the given brushes. A brush is
+         * not considered to contain itself, and if a group is returned, none of its descendants are returned.
+         *
+         * This yields the same nodes as CollectContainedNodesVisitor, but the candidate entities and brushes are
+         * taken from the world's node tree and the exact containment tests are performed in parallel. Thus, the node
+         * tree of the given world must be up to date.
+         */
+        std::vector<Node*> findContainedNodes(World& world, const std::vector<Brush*>& brushes, const EditorContext& editorContext);
+    }
+}
+
+#endif /* defined(TrenchBroom_FindTouchingNodes) */
@@ -26,7 +26,6 @@
 #include "Model/ComputeNodeBoundsVisitor.h"
 #include "Model/Entity.h"
 #include "Model/FindContainerVisitor.h"
-#include "Model/FindGroupVisitor.h"
 #include "Model/FindLayerVisitor.h"
 #include "Model/GroupSnapshot.h"
 #include "Model/IssueGenerator.h"
@@ -154,23 +153,19 @@ namespace TrenchBroom {
         }
 
         void Group::doChildWasAdded(Node* /* node */) {
-            nodePhysicalBoundsDidChange(physicalBounds());
+            nodePhysicalBoundsDidChange();
         }
 
         void Group::doChildWasRemoved(Node* /* node */) {
-            nodePhysicalBoundsDidChange(physicalBounds());
+            nodePhysicalBoundsDidChange();
         }
 
         void Group::doNodePhysicalBoundsDidChange() {
             invalidateBounds();
         }
 
-        void Group::doChildPhysicalBoundsDidChange() {
-            const vm::bbox3 myOldBounds = physicalBounds();
-            invalidateBounds();
-            if (physicalBounds() != myOldBounds) {
-                nodePhysicalBoundsDidChange(myOldBounds);
-            }
+        bool Group::doPhysicalBoundsInvalidated() const {
+            return !m_boundsValid;
         }
 
         bool Group::doSelectable() const {
@@ -221,9 +216,7 @@ namespace TrenchBroom {
         }
 
         Group* Group::doGetGroup() const {
-            FindGroupVisitor visitor;
-            escalate(visitor);
-            return visitor.hasResult() ? visitor.result() : nullptr;
+            return containingGroup();
         }
 
         void Group::doTransform(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
@@ -259,6 +252,7 @@ namespace TrenchBroom {
             m_physicalBounds = physicalBoundsVisitor.bounds();
 
             m_boundsValid = true;
+            countBoundsComputation();
         }
 
         void Group::doAcceptTagVisitor(TagVisitor& visitor) {
@@ -47,5 +47,31 @@ namespace TrenchBroom {
             for (NodeSnapshot* snapshot : m_snapshots)
                 snapshot->restore(worldBounds);
         }
+
+        size_t GroupSnapshot::doGetMemoryUsage() const {
+            size_t result = sizeof(*this) + m_snapshots.capacity() * sizeof(NodeSnapshot*);
+            for (const NodeSnapshot* snapshot : m_snapshots) {
+                result += snapshot->memoryUsage();
+            }
+            return result;
+        }
+
+        void GroupSnapshot::doWriteData(IO::SpillFile::RecordWriter& writer) const {
+            for (const NodeSnapshot* snapshot : m_snapshots) {
+                snapshot->writeData(writer);
+            }
+        }
+
+        void GroupSnapshot::doReleaseData() {
+            for (NodeSnapshot* snapshot : m_snapshots) {
+                snapshot->releaseData();
+            }
+        }
+
+        void GroupSnapshot::doReadData(IO::Reader& reader) {
+            for (NodeSnapshot* snapshot : m_snapshots) {
+                snapshot->readData(reader);
+            }
+        }
     }
 }
@@ -38,6 +38,10 @@ namespace TrenchBroom {
         private:
             void takeSnapshot(Group* group);
             void doRestore(const vm::bbox3& worldBounds) override;
+            size_t doGetMemoryUsage() const override;
+            void doWriteData(IO::SpillFile::RecordWriter& writer) const override;
+            void doReleaseData() override;
+            void doReadData(IO::Reader& reader) override;
         };
     }
 }
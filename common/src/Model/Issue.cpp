@@ -27,6 +27,7 @@
 
 #include <kdl/vector_utils.h>
 
+#include <atomic>
 #include <string>
 
 namespace TrenchBroom {
@@ -84,6 +85,10 @@ namespace TrenchBroom {
             m_node->setIssueHidden(type(), hidden);
         }
 
+        void Issue::renumber() {
+            m_seqId = nextSeqId();
+        }
+
         Issue::Issue(Node* node) :
         m_seqId(nextSeqId()),
         m_node(node) {
@@ -91,7 +96,7 @@ namespace TrenchBroom {
         }
 
         size_t Issue::nextSeqId() {
-            static size_t seqId = 0;
+            static std::atomic<size_t> seqId(0);
             return seqId++;
         }
 
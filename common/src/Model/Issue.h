@@ -52,6 +52,12 @@ namespace TrenchBroom {
 
             bool hidden() const;
             void setHidden(bool hidden);
+
+            /**
+             * Assigns a new sequence number to this issue. Issues that were generated concurrently are renumbered
+             * afterwards so that their order does not depend on the scheduling of the worker threads.
+             */
+            void renumber();
         protected:
             explicit Issue(Node* node);
             static size_t nextSeqId();
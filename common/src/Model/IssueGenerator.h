@@ -36,6 +36,12 @@ namespace TrenchBroom {
         class Layer;
         class World;
 
+        /**
+         * Generates issues for nodes. The issues of different nodes are generated in parallel, so a generator may be
+         * called from multiple threads at once. Implementations of doGenerate must therefore not modify any state that
+         * is shared between calls, including mutable members of the generator itself; they may only add issues to the
+         * given list.
+         */
         class IssueGenerator {
         protected:
             using IssueList = std::vector<Issue*>;
@@ -91,10 +91,22 @@ namespace TrenchBroom {
             return false;
         }
 
+        void Layer::doChildWasAdded(Node* /* node */) {
+            nodePhysicalBoundsDidChange();
+        }
+
+        void Layer::doChildWasRemoved(Node* /* node */) {
+            nodePhysicalBoundsDidChange();
+        }
+
         void Layer::doNodePhysicalBoundsDidChange() {
             invalidateBounds();
         }
 
+        bool Layer::doPhysicalBoundsInvalidated() const {
+            return !m_boundsValid;
+        }
+
         bool Layer::doSelectable() const {
             return false;
         }
@@ -132,6 +144,7 @@ namespace TrenchBroom {
             m_physicalBounds = physicalBoundsVisitor.bounds();
 
             m_boundsValid = true;
+            countBoundsComputation();
         }
 
         void Layer::doAcceptTagVisitor(TagVisitor& visitor) {
@@ -52,7 +52,10 @@ namespace TrenchBroom {
             bool doCanRemoveChild(const Node* child) const override;
             bool doRemoveIfEmpty() const override;
             bool doShouldAddToSpacialIndex() const override;
+            void doChildWasAdded(Node* node) override;
+            void doChildWasRemoved(Node* node) override;
             void doNodePhysicalBoundsDidChange() override;
+            bool doPhysicalBoundsInvalidated() const override;
             bool doSelectable() const override;
 
             void doPick(const vm::ray3& ray, PickResult& pickResult) override;
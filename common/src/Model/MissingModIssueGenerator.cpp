@@ -113,18 +113,12 @@ namespace TrenchBroom {
             auto game = kdl::mem_lock(m_game);
             const std::vector<std::string> mods = game->extractEnabledMods(*node);
 
-            if (mods == m_lastMods) {
-                return;
-            }
-
             const auto additionalSearchPaths = IO::Path::asPaths(mods);
             const auto errors = game->checkAdditionalSearchPaths(additionalSearchPaths);
 
             for (const auto& [searchPath, message] : errors) {
                 issues.push_back(new MissingModIssue(node, searchPath.asString(), message));
             }
-
-            m_lastMods = mods;
         }
     }
 }
@@ -36,7 +36,6 @@ namespace TrenchBroom {
             class MissingModIssueQuickFix;
 
             std::weak_ptr<Game> m_game;
-            mutable std::vector<std::string> m_lastMods;
         public:
             MissingModIssueGenerator(std::weak_ptr<Game> game);
         private:
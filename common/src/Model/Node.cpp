@@ -21,15 +21,18 @@
 
 #include "Ensure.h"
 #include "Macros.h"
+#include "Model/FindGroupVisitor.h"
 #include "Model/Issue.h"
 #include "Model/IssueGenerator.h"
 #include "Model/LockState.h"
 #include "Model/VisibilityState.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox.h>
 
+#include <atomic>
 #include <cassert>
 #include <iterator>
 #include <string>
@@ -37,6 +40,8 @@
 
 namespace TrenchBroom {
     namespace Model {
+        static std::atomic<size_t> s_boundsComputationCount(0u);
+
         Node::Node() :
         m_parent(nullptr),
         m_descendantCount(0),
@@ -45,6 +50,9 @@ namespace TrenchBroom {
         m_descendantSelectionCount(0),
         m_visibilityState(VisibilityState::Visibility_Inherited),
         m_lockState(LockState::Lock_Inherited),
+        m_visible(true),
+        m_editable(true),
+        m_containingGroup(nullptr),
         m_lineNumber(0),
         m_lineCount(0),
         m_issuesValid(false),
@@ -67,6 +75,14 @@ namespace TrenchBroom {
             return doGetPhysicalBounds();
         }
 
+        size_t Node::boundsComputationCount() {
+            return s_boundsComputationCount.load(std::memory_order_relaxed);
+        }
+
+        void Node::countBoundsComputation() {
+            s_boundsComputationCount.fetch_add(1u, std::memory_order_relaxed);
+        }
+
         Node* Node::clone(const vm::bbox3& worldBounds) const {
             return doClone(worldBounds);
         }
@@ -257,7 +273,11 @@ namespace TrenchBroom {
             doDescendantWasAdded(node, depth);
             if (shouldPropagateDescendantEvents() && m_parent != nullptr)
                 m_parent->descendantWasAdded(node, depth + 1);
-            invalidateIssues();
+            // The issues of a node depend on whether it has children, but not on its other descendants. Nodes whose
+            // issues depend on the bounds of their children invalidate their issues when their bounds change.
+            if (depth == 1) {
+                invalidateIssues();
+            }
         }
 
         void Node::descendantWillBeRemoved(Node* node, const size_t depth) {
@@ -270,7 +290,9 @@ namespace TrenchBroom {
             doDescendantWasRemoved(oldParent, node, depth);
             if (shouldPropagateDescendantEvents() && m_parent != nullptr)
                 m_parent->descendantWasRemoved(oldParent, node, depth + 1);
-            invalidateIssues();
+            if (depth == 1) {
+                invalidateIssues();
+            }
         }
 
         bool Node::shouldPropagateDescendantEvents() const {
@@ -324,6 +346,10 @@ namespace TrenchBroom {
         }
 
         void Node::ancestorDidChange() {
+            m_visible = computeVisible();
+            m_editable = computeEditable();
+            updateContainingGroup();
+
             doAncestorDidChange();
             for (auto* child : m_children) {
                 child->ancestorDidChange();
@@ -353,11 +379,10 @@ namespace TrenchBroom {
             m_node->nodeDidChange();
         }
 
-        // notice that we take a copy here so that we can safely propagate the old bounds up
-        void Node::nodePhysicalBoundsDidChange(const vm::bbox3 oldBounds) {
+        void Node::nodePhysicalBoundsDidChange() {
             doNodePhysicalBoundsDidChange();
             if (m_parent != nullptr)
-                m_parent->childPhysicalBoundsDidChange(this, oldBounds);
+                m_parent->childPhysicalBoundsDidChange(this);
         }
 
         void Node::childWillChange(Node* node) {
@@ -375,7 +400,6 @@ namespace TrenchBroom {
             if (shouldPropagateDescendantEvents() && m_parent != nullptr) {
                 m_parent->descendantWillChange(node);
             }
-            invalidateIssues();
         }
 
         void Node::descendantDidChange(Node* node) {
@@ -383,24 +407,27 @@ namespace TrenchBroom {
             if (shouldPropagateDescendantEvents() && m_parent != nullptr) {
                 m_parent->descendantDidChange(node);
             }
-            invalidateIssues();
         }
 
-        void Node::childPhysicalBoundsDidChange(Node* node, const vm::bbox3& oldBounds) {
-            const vm::bbox3 myOldBounds = physicalBounds();
-            if (!myOldBounds.encloses(oldBounds) && !myOldBounds.encloses(node->physicalBounds())) {
-                // Our bounds will change only if the child's bounds potentially contributed to our own bounds.
-                nodePhysicalBoundsDidChange(myOldBounds);
+        void Node::childPhysicalBoundsDidChange(Node* node) {
+            /*
+             * We don't compute any bounds here. If our cached bounds are already invalid, our ancestors were notified
+             * when they were invalidated and have not recomputed their bounds since, so there is nothing to propagate.
+             * This way, changing many descendants of a node invalidates the bounds of its ancestors only once, and
+             * they are recomputed only once when they are requested again.
+             */
+            if (!doPhysicalBoundsInvalidated()) {
+                nodePhysicalBoundsDidChange();
             }
 
             doChildPhysicalBoundsDidChange();
-            descendantPhysicalBoundsDidChange(node, oldBounds, 1);
+            descendantPhysicalBoundsDidChange(node, 1);
         }
 
-        void Node::descendantPhysicalBoundsDidChange(Node* node, const vm::bbox3& oldBounds, const size_t depth) {
+        void Node::descendantPhysicalBoundsDidChange(Node* node, const size_t depth) {
             doDescendantPhysicalBoundsDidChange(node);
             if (shouldPropagateDescendantEvents() && m_parent != nullptr) {
-                m_parent->descendantPhysicalBoundsDidChange(node, oldBounds, depth + 1);
+                m_parent->descendantPhysicalBoundsDidChange(node, depth + 1);
             }
         }
 
@@ -504,15 +531,7 @@ namespace TrenchBroom {
         }
 
         bool Node::visible() const {
-            switch (m_visibilityState) {
-                case VisibilityState::Visibility_Inherited:
-                    return m_parent == nullptr || m_parent->visible();
-                case VisibilityState::Visibility_Hidden:
-                    return false;
-                case VisibilityState::Visibility_Shown:
-                    return true;
-                switchDefault()
-            }
+            return m_visible;
         }
 
         bool Node::shown() const {
@@ -530,6 +549,7 @@ namespace TrenchBroom {
         bool Node::setVisibilityState(const VisibilityState visibility) {
             if (visibility != m_visibilityState) {
                 m_visibilityState = visibility;
+                updateVisible();
                 return true;
             }
             return false;
@@ -542,15 +562,7 @@ namespace TrenchBroom {
         }
 
         bool Node::editable() const {
-            switch (m_lockState) {
-                case LockState::Lock_Inherited:
-                    return m_parent == nullptr || m_parent->editable();
-                case LockState::Lock_Locked:
-                    return false;
-                case LockState::Lock_Unlocked:
-                    return true;
-                switchDefault()
-            }
+            return m_editable;
         }
 
         bool Node::locked() const {
@@ -564,12 +576,75 @@ namespace TrenchBroom {
         bool Node::setLockState(const LockState lockState) {
             if (lockState != m_lockState) {
                 m_lockState = lockState;
+                updateEditable();
                 return true;
             }
             return false;
 
         }
 
+        bool Node::computeVisible() const {
+            switch (m_visibilityState) {
+                case VisibilityState::Visibility_Inherited:
+                    return m_parent == nullptr || m_parent->visible();
+                case VisibilityState::Visibility_Hidden:
+                    return false;
+                case VisibilityState::Visibility_Shown:
+                    return true;
+                switchDefault()
+            }
+        }
+
+        bool Node::computeEditable() const {
+            switch (m_lockState) {
+                case LockState::Lock_Inherited:
+                    return m_parent == nullptr || m_parent->editable();
+                case LockState::Lock_Locked:
+                    return false;
+                case LockState::Lock_Unlocked:
+                    return true;
+                switchDefault()
+            }
+        }
+
+        void Node::updateVisible() {
+            const auto visible = computeVisible();
+            if (visible != m_visible) {
+                m_visible = visible;
+                for (auto* child : m_children) {
+                    if (child->m_visibilityState == VisibilityState::Visibility_Inherited) {
+                        child->updateVisible();
+                    }
+                }
+            }
+        }
+
+        void Node::updateEditable() {
+            const auto editable = computeEditable();
+            if (editable != m_editable) {
+                m_editable = editable;
+                for (auto* child : m_children) {
+                    if (child->m_lockState == LockState::Lock_Inherited) {
+                        child->updateEditable();
+                    }
+                }
+            }
+        }
+
+        void Node::updateContainingGroup() {
+            if (m_parent == nullptr) {
+                m_containingGroup = nullptr;
+            } else {
+                FindGroupVisitor visitor;
+                m_parent->accept(visitor);
+                m_containingGroup = visitor.hasResult() ? visitor.result() : m_parent->m_containingGroup;
+            }
+        }
+
+        Group* Node::containingGroup() const {
+            return m_containingGroup;
+        }
+
         void Node::pick(const vm::ray3& ray, PickResult& pickResult) {
             doPick(ray, pickResult);
         }
@@ -596,6 +671,10 @@ namespace TrenchBroom {
             return m_issues;
         }
 
+        bool Node::issuesValid() const {
+            return m_issuesValid;
+        }
+
         bool Node::issueHidden(const IssueType type) const {
             return (type & m_hiddenIssues) != 0;
         }
@@ -617,9 +696,52 @@ namespace TrenchBroom {
             }
         }
 
-        void Node::invalidateIssues() const {
+        size_t Node::validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators) {
+            std::vector<Node*> invalidNodes;
+            for (auto* node : nodes) {
+                if (!node->m_issuesValid) {
+                    // the bounds are cached lazily and must not be computed by several threads at once
+                    node->logicalBounds();
+                    invalidNodes.push_back(node);
+                }
+            }
+
+            try {
+                kdl::parallel_for(invalidNodes.size(), [&](const size_t i) {
+                    auto* node = invalidNodes[i];
+                    for (const auto* generator : issueGenerators) {
+                        node->doGenerateIssues(generator, node->m_issues);
+                    }
+                }, 64u);
+            } catch (...) {
+                for (auto* node : invalidNodes) {
+                    node->clearIssues();
+                }
+                throw;
+            }
+
+            for (auto* node : invalidNodes) {
+                for (auto* issue : node->m_issues) {
+                    issue->renumber();
+                }
+                node->m_issuesValid = true;
+            }
+
+            return invalidNodes.size();
+        }
+
+        void Node::invalidateIssues() {
             clearIssues();
-            m_issuesValid = false;
+
+            if (m_issuesValid) {
+                m_issuesValid = false;
+
+                Node* root = this;
+                while (root->m_parent != nullptr) {
+                    root = root->m_parent;
+                }
+                root->doDescendantIssuesWereInvalidated(this);
+            }
         }
 
         void Node::clearIssues() const {
@@ -663,12 +785,19 @@ namespace TrenchBroom {
         void Node::doDescendantWasRemoved(Node* /* oldParent */, Node* /* node */, const size_t /* depth */) {}
         bool Node::doShouldPropagateDescendantEvents() const { return true; }
 
+        void Node::doDescendantIssuesWereInvalidated(Node* /* node */) {}
+
         void Node::doParentWillChange() {}
         void Node::doParentDidChange() {}
         void Node::doAncestorWillChange() {}
         void Node::doAncestorDidChange() {}
 
         void Node::doNodePhysicalBoundsDidChange() {}
+
+        bool Node::doPhysicalBoundsInvalidated() const {
+            return false;
+        }
+
         void Node::doChildPhysicalBoundsDidChange() {}
         void Node::doDescendantPhysicalBoundsDidChange(Node* /* node */) {}
 
@@ -33,6 +33,7 @@ namespace TrenchBroom {
     namespace Model {
         class AttributableNode;
         class ConstNodeVisitor;
+        class Group;
         class Issue;
         class IssueGenerator;
         enum class LockState;
@@ -54,6 +55,15 @@ namespace TrenchBroom {
             VisibilityState m_visibilityState;
             LockState m_lockState;
 
+            /**
+             * The effective visibility and lock state of this node, which take the states of its ancestors into
+             * account, and the group that contains this node. These are updated when the visibility or lock state of
+             * this node or of one of its ancestors changes, or when this node is moved to another parent.
+             */
+            bool m_visible;
+            bool m_editable;
+            Group* m_containingGroup;
+
             size_t m_lineNumber;
             size_t m_lineCount;
 
@@ -83,6 +93,19 @@ namespace TrenchBroom {
              * beyond the bounds specified in the .fgd.
              */
             const vm::bbox3& physicalBounds() const;
+
+            /**
+             * Returns the number of times that the cached bounds of an entity, group or layer were computed since the
+             * program was started. This is meant for profiling: since cached bounds are only invalidated when they
+             * change and recomputed when they are requested, this number should increase by at most one per node and
+             * operation.
+             */
+            static size_t boundsComputationCount();
+        protected:
+            /**
+             * Must be called by nodes that cache their bounds whenever they compute them.
+             */
+            static void countBoundsComputation();
         public: // cloning and snapshots
             Node* clone(const vm::bbox3& worldBounds) const;
             Node* cloneRecursively(const vm::bbox3& worldBounds) const;
@@ -217,15 +240,19 @@ namespace TrenchBroom {
             void nodeWillChange();
             void nodeDidChange();
 
-            void nodePhysicalBoundsDidChange(vm::bbox3 oldBounds);
+            /**
+             * Notifies this node and its ancestors that the physical bounds of this node have changed. The ancestors
+             * only invalidate their cached bounds here, they recompute them when they are requested again.
+             */
+            void nodePhysicalBoundsDidChange();
         private:
             void childWillChange(Node* node);
             void childDidChange(Node* node);
             void descendantWillChange(Node* node);
             void descendantDidChange(Node* node);
 
-            void childPhysicalBoundsDidChange(Node* node, const vm::bbox3& oldBounds);
-            void descendantPhysicalBoundsDidChange(Node* node, const vm::bbox3& oldBounds, size_t depth);
+            void childPhysicalBoundsDidChange(Node* node);
+            void descendantPhysicalBoundsDidChange(Node* node, size_t depth);
         public: // selection
             bool selected() const;
             void select();
@@ -277,6 +304,17 @@ namespace TrenchBroom {
             bool locked() const;
             LockState lockState() const;
             bool setLockState(LockState lockState);
+        private:
+            bool computeVisible() const;
+            bool computeEditable() const;
+            void updateVisible();
+            void updateEditable();
+            void updateContainingGroup();
+        protected:
+            /**
+             * Returns the innermost group that contains this node, or null if this node does not belong to a group.
+             */
+            Group* containingGroup() const;
         public: // picking
             void pick(const vm::ray3& ray, PickResult& result);
             void findNodesContaining(const vm::vec3& point, std::vector<Node*>& result);
@@ -286,11 +324,25 @@ namespace TrenchBroom {
             bool containsLine(size_t lineNumber) const;
         public: // issue management
             const std::vector<Issue*>& issues(const std::vector<IssueGenerator*>& issueGenerators);
+            bool issuesValid() const;
 
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
+
+            /**
+             * Validates the issues of the given nodes, distributing the nodes over several threads. The issue
+             * generators must not modify any shared state. Afterwards, the issues are numbered in the order of the
+             * given nodes, so the result is the same as if the nodes had been validated one after another.
+             *
+             * Returns the number of nodes whose issues were actually generated.
+             */
+            static size_t validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators);
         public: // should only be called from this and from the world
-            void invalidateIssues() const;
+            /**
+             * Discards the issues of this node. If they were valid, the root of this node's tree is notified so that
+             * it can keep track of the nodes that must be revalidated.
+             */
+            void invalidateIssues();
         private:
             void validateIssues(const std::vector<IssueGenerator*>& issueGenerators);
             void clearIssues() const;
@@ -462,6 +514,7 @@ namespace TrenchBroom {
             virtual void doAncestorDidChange();
 
             virtual void doNodePhysicalBoundsDidChange();
+            virtual bool doPhysicalBoundsInvalidated() const;
             virtual void doChildPhysicalBoundsDidChange();
             virtual void doDescendantPhysicalBoundsDidChange(Node* node);
 
@@ -476,6 +529,7 @@ namespace TrenchBroom {
             virtual void doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) = 0;
 
             virtual void doGenerateIssues(const IssueGenerator* generator, std::vector<Issue*>& issues) = 0;
+            virtual void doDescendantIssuesWereInvalidated(Node* node);
 
             virtual void doAccept(NodeVisitor& visitor) = 0;
             virtual void doAccept(ConstNodeVisitor& visitor) const = 0;
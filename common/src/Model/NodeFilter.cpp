@@ -0,0 +1,50 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeFilter.h"
+
+#include "Model/EditorContext.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        NodeFilter::NodeFilter() :
+        m_editorContext(nullptr),
+        m_type(None) {}
+
+        NodeFilter::NodeFilter(const EditorContext& editorContext, const Type type) :
+        m_editorContext(&editorContext),
+        m_type(type) {}
+
+        bool NodeFilter::operator()(const Node* node) const {
+            if (m_type == None) {
+                return true;
+            }
+            if ((m_type & Visible) != 0u && !m_editorContext->visible(node)) {
+                return false;
+            }
+            if ((m_type & Editable) != 0u && !m_editorContext->editable(node)) {
+                return false;
+            }
+            if ((m_type & Selectable) != 0u && !m_editorContext->selectable(node)) {
+                return false;
+            }
+            return true;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_NodeFilter
+#define TrenchBroom_NodeFilter
+
+namespace TrenchBroom {
+    namespace Model {
+        class EditorContext;
+        class Node;
+
+        /**
+         * Restricts the nodes returned by the spatial queries of World to those that are visible, editable (not locked)
+         * or selectable according to an editor context. A default constructed filter accepts every node.
+         */
+        class NodeFilter {
+        public:
+            using Type = unsigned int;
+            static constexpr Type None       = 0u;
+            static constexpr Type Visible    = 1u << 0;
+            static constexpr Type Editable   = 1u << 1;
+            static constexpr Type Selectable = 1u << 2;
+        private:
+            const EditorContext* m_editorContext;
+            Type m_type;
+        public:
+            NodeFilter();
+            NodeFilter(const EditorContext& editorContext, Type type);
+
+            bool operator()(const Node* node) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_NodeFilter) */
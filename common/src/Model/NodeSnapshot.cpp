@@ -26,5 +26,21 @@ namespace TrenchBroom {
         void NodeSnapshot::restore(const vm::bbox3& worldBounds) {
             doRestore(worldBounds);
         }
+
+        size_t NodeSnapshot::memoryUsage() const {
+            return doGetMemoryUsage();
+        }
+
+        void NodeSnapshot::writeData(IO::SpillFile::RecordWriter& writer) const {
+            doWriteData(writer);
+        }
+
+        void NodeSnapshot::releaseData() {
+            doReleaseData();
+        }
+
+        void NodeSnapshot::readData(IO::Reader& reader) {
+            doReadData(reader);
+        }
     }
 }
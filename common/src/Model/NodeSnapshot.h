@@ -21,15 +21,44 @@
 #define TrenchBroom_NodeSnapshot
 
 #include "FloatType.h"
+#include "IO/SpillFile.h"
 
 namespace TrenchBroom {
+    namespace IO {
+        class Reader;
+    }
+
     namespace Model {
         class NodeSnapshot {
         public:
             virtual ~NodeSnapshot();
             void restore(const vm::bbox3& worldBounds);
+
+            /**
+             * Returns an estimate of the number of bytes occupied by this snapshot.
+             */
+            size_t memoryUsage() const;
+
+            /**
+             * Writes the recorded data of this snapshot to the given writer. Afterwards, the data can be released from
+             * memory by calling releaseData(), and it must be read back by calling readData() before this snapshot is
+             * restored. The node itself is referenced by pointer and is not written.
+             */
+            void writeData(IO::SpillFile::RecordWriter& writer) const;
+            void releaseData();
+
+            /**
+             * Reads the data written by writeData() back from the given reader.
+             *
+             * @throws ReaderException if the data cannot be read
+             */
+            void readData(IO::Reader& reader);
         private:
             virtual void doRestore(const vm::bbox3& worldBounds) = 0;
+            virtual size_t doGetMemoryUsage() const = 0;
+            virtual void doWriteData(IO::SpillFile::RecordWriter& writer) const = 0;
+            virtual void doReleaseData() = 0;
+            virtual void doReadData(IO::Reader& reader) = 0;
         };
     }
 }
@@ -1742,6 +1742,28 @@ namespace TrenchBroom {
              */
             Vertex* addFurtherPointToPolyhedron(const vm::vec<T,3>& position, Callback& callback);
 
+            /**
+             * Helper function that adds the points in range [cur, end) to a convex volume.
+             *
+             * Every point is assigned to the conflict list of a face that it is in front of; points that are not in
+             * front of any face are discarded right away. Then, the point furthest from its face is added repeatedly,
+             * and only the points in the conflict lists of the deleted faces are reassigned to the newly created faces.
+             * This is the Quickhull algorithm, and it runs in O(n log n) expected time for n points.
+             *
+             * Assumes that this polyhedron is a convex volume.
+             *
+             * @tparam I the type of the given iterators
+             * @param cur start of the range of points to add
+             * @param end end of the range of points to add
+             * @param callback the callback to inform of lifecycle events
+             */
+            template <typename I> void addPointsToPolyhedron(I cur, I end, Callback& callback);
+
+            /**
+             * Maintains the conflict lists for addPointsToPolyhedron and forwards all events to another callback.
+             */
+            class ConflictListCallback;
+
             /**
              * A seam is a circular sequence of consecutive edges. For each edge of a seam, it must hold that its first
              * vertex is identical to the second vertex of its predecessor.
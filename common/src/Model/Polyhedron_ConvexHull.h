@@ -30,7 +30,10 @@
 #include <vecmath/constants.h>
 #include <vecmath/util.h>
 
+#include <algorithm>
 #include <list>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -49,15 +52,33 @@ namespace TrenchBroom {
         template <typename T, typename FP, typename VP> template <typename I>
         void Polyhedron<T,FP,VP>::addPoints(I cur, I end) {
             Callback c;
-            while (cur != end) {
-                addPoint(*cur++, c);
-            }
+            addPoints(cur, end, c);
         }
 
         template <typename T, typename FP, typename VP> template <typename I>
         void Polyhedron<T,FP,VP>::addPoints(I cur, I end, Callback& callback) {
-            while (cur != end) {
-                addPoint(*cur++, callback);
+            std::vector<vm::vec<T,3>> points(cur, end);
+
+            if (empty() && points.size() > 6u) {
+                // Start with the extreme points along each axis. The initial hull is then as large as possible, and
+                // most of the remaining points are discarded when the conflict lists are built.
+                auto first = std::begin(points);
+                for (size_t i = 0u; i < 3u; ++i) {
+                    const auto compare = [i](const vm::vec<T,3>& lhs, const vm::vec<T,3>& rhs) { return lhs[i] < rhs[i]; };
+                    std::iter_swap(first, std::min_element(first, std::end(points), compare));
+                    ++first;
+                    std::iter_swap(first, std::max_element(first, std::end(points), compare));
+                    ++first;
+                }
+            }
+
+            auto it = std::begin(points);
+            while (it != std::end(points) && !polyhedron()) {
+                addPoint(*it++, callback);
+            }
+
+            if (it != std::end(points)) {
+                addPointsToPolyhedron(it, std::end(points), callback);
             }
         }
 
@@ -388,6 +409,184 @@ namespace TrenchBroom {
             return weave(seam, position, callback);
         }
 
+        template <typename T, typename FP, typename VP>
+        class Polyhedron<T,FP,VP>::ConflictListCallback : public Polyhedron<T,FP,VP>::Callback {
+        private:
+            using PointList = std::vector<vm::vec<T,3>>;
+
+            Callback& m_callback;
+
+            /**
+             * Maps each face to the points which are in front of it and which have not been added yet.
+             */
+            std::unordered_map<Face*, PointList> m_conflicts;
+
+            /**
+             * The faces that may have non-empty conflict lists, in the order in which they should be processed. May
+             * contain faces which were deleted or whose conflict lists were emptied, these are skipped.
+             */
+            std::vector<Face*> m_pendingFaces;
+
+            /**
+             * The faces created or changed since the last call to redistribute.
+             */
+            std::vector<Face*> m_newFaces;
+
+            /**
+             * The points whose faces were deleted or changed since the last call to redistribute.
+             */
+            PointList m_orphans;
+        public:
+            explicit ConflictListCallback(Callback& callback) :
+            m_callback(callback) {}
+
+            /**
+             * Assigns the given point to the conflict list of the first of the given faces that it is in front of.
+             *
+             * @return true if the point was assigned to a face and false if it isn't in front of any of the faces
+             */
+            template <typename C>
+            bool assign(const vm::vec<T,3>& point, C& faces) {
+                for (Face* face : faces) {
+                    if (getPlane(face).point_status(point) == vm::plane_status::above) {
+                        auto& conflicts = m_conflicts[face];
+                        if (conflicts.empty()) {
+                            m_pendingFaces.push_back(face);
+                        }
+                        conflicts.push_back(point);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             * Removes the point that is furthest from its face from the conflict lists and returns it.
+             *
+             * @return a pair of a boolean that indicates whether there was any point left, and the point
+             */
+            std::tuple<bool, vm::vec<T,3>> takeFurthestPoint() {
+                while (!m_pendingFaces.empty()) {
+                    Face* face = m_pendingFaces.back();
+                    const auto it = m_conflicts.find(face);
+                    if (it == std::end(m_conflicts) || it->second.empty()) {
+                        m_pendingFaces.pop_back();
+                        continue;
+                    }
+
+                    auto& conflicts = it->second;
+                    const auto plane = getPlane(face);
+                    const auto furthest = std::max_element(std::begin(conflicts), std::end(conflicts), [&](const auto& lhs, const auto& rhs) {
+                        return plane.point_distance(lhs) < plane.point_distance(rhs);
+                    });
+
+                    const auto result = *furthest;
+                    *furthest = conflicts.back();
+                    conflicts.pop_back();
+                    return std::make_tuple(true, result);
+                }
+                return std::make_tuple(false, vm::vec<T,3>());
+            }
+
+            /**
+             * Assigns the points of the deleted and changed faces to the faces that were created or changed since the
+             * last call. Points that are not in front of any of these faces are inside the polyhedron and are discarded.
+             */
+            void redistribute() {
+                for (const auto& point : m_orphans) {
+                    assign(point, m_newFaces);
+                }
+                m_orphans.clear();
+                m_newFaces.clear();
+            }
+        private:
+            void orphan(Face* face) {
+                const auto it = m_conflicts.find(face);
+                if (it != std::end(m_conflicts)) {
+                    m_orphans.insert(std::end(m_orphans), std::begin(it->second), std::end(it->second));
+                    m_conflicts.erase(it);
+                }
+            }
+
+            void renew(Face* face) {
+                orphan(face);
+                if (std::find(std::begin(m_newFaces), std::end(m_newFaces), face) == std::end(m_newFaces)) {
+                    m_newFaces.push_back(face);
+                }
+            }
+        public:
+            void vertexWasCreated(Vertex* vertex) override {
+                m_callback.vertexWasCreated(vertex);
+            }
+
+            void vertexWillBeDeleted(Vertex* vertex) override {
+                m_callback.vertexWillBeDeleted(vertex);
+            }
+
+            void vertexWasAdded(Vertex* vertex) override {
+                m_callback.vertexWasAdded(vertex);
+            }
+
+            void vertexWillBeRemoved(Vertex* vertex) override {
+                m_callback.vertexWillBeRemoved(vertex);
+            }
+
+            vm::plane<T,3> getPlane(const Face* face) const override {
+                return m_callback.getPlane(face);
+            }
+
+            void faceWasCreated(Face* face) override {
+                renew(face);
+                m_callback.faceWasCreated(face);
+            }
+
+            void faceWillBeDeleted(Face* face) override {
+                m_callback.faceWillBeDeleted(face);
+                orphan(face);
+                m_newFaces.erase(std::remove(std::begin(m_newFaces), std::end(m_newFaces), face), std::end(m_newFaces));
+            }
+
+            void faceDidChange(Face* face) override {
+                renew(face);
+                m_callback.faceDidChange(face);
+            }
+
+            void faceWasFlipped(Face* face) override {
+                renew(face);
+                m_callback.faceWasFlipped(face);
+            }
+
+            void faceWasSplit(Face* original, Face* clone) override {
+                renew(original);
+                renew(clone);
+                m_callback.faceWasSplit(original, clone);
+            }
+
+            void facesWillBeMerged(Face* remaining, Face* toDelete) override {
+                m_callback.facesWillBeMerged(remaining, toDelete);
+                renew(remaining);
+            }
+        };
+
+        template <typename T, typename FP, typename VP> template <typename I>
+        void Polyhedron<T,FP,VP>::addPointsToPolyhedron(I cur, I end, Callback& callback) {
+            assert(polyhedron());
+
+            ConflictListCallback conflicts(callback);
+            while (cur != end) {
+                conflicts.assign(*cur++, m_faces);
+            }
+
+            bool found;
+            vm::vec<T,3> point;
+            std::tie(found, point) = conflicts.takeFurthestPoint();
+            while (found) {
+                addPoint(point, conflicts);
+                conflicts.redistribute();
+                std::tie(found, point) = conflicts.takeFurthestPoint();
+            }
+        }
+
         template <typename T, typename FP, typename VP>
         class Polyhedron<T,FP,VP>::Seam {
         private:
@@ -19,6 +19,7 @@
 
 #include "Snapshot.h"
 
+#include "IO/Reader.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceSnapshot.h"
 #include "Model/Node.h"
@@ -29,11 +30,18 @@
 namespace TrenchBroom {
     namespace Model {
         Snapshot::~Snapshot() {
+            if (m_spillFile != nullptr) {
+                m_spillFile->release(m_spillRecord);
+            }
             kdl::vec_clear_and_delete(m_nodeSnapshots);
             kdl::vec_clear_and_delete(m_brushFaceSnapshots);
         }
 
         void Snapshot::restoreNodes(const vm::bbox3& worldBounds) {
+            if (m_spillFile != nullptr) {
+                readSpilledData();
+            }
+
             for (NodeSnapshot* snapshot : m_nodeSnapshots)
                 snapshot->restore(worldBounds);
         }
@@ -43,6 +51,50 @@ namespace TrenchBroom {
                 snapshot->restore();
         }
 
+        size_t Snapshot::memoryUsage() const {
+            size_t result = sizeof(*this);
+            result += m_nodeSnapshots.capacity() * sizeof(NodeSnapshot*);
+            result += m_brushFaceSnapshots.capacity() * sizeof(BrushFaceSnapshot*);
+            for (const NodeSnapshot* snapshot : m_nodeSnapshots) {
+                result += snapshot->memoryUsage();
+            }
+            for (const BrushFaceSnapshot* snapshot : m_brushFaceSnapshots) {
+                result += snapshot->memoryUsage();
+            }
+            return result;
+        }
+
+        void Snapshot::spill(std::shared_ptr<IO::SpillFile> file) {
+            if (m_spillFile != nullptr || m_nodeSnapshots.empty()) {
+                return;
+            }
+
+            IO::SpillFile::RecordWriter writer;
+            for (const NodeSnapshot* snapshot : m_nodeSnapshots) {
+                snapshot->writeData(writer);
+            }
+            m_spillRecord = file->write(writer);
+            m_spillFile = std::move(file);
+
+            for (NodeSnapshot* snapshot : m_nodeSnapshots) {
+                snapshot->releaseData();
+            }
+        }
+
+        bool Snapshot::spilled() const {
+            return m_spillFile != nullptr;
+        }
+
+        void Snapshot::readSpilledData() {
+            auto reader = m_spillFile->read(m_spillRecord);
+            for (NodeSnapshot* snapshot : m_nodeSnapshots) {
+                snapshot->readData(reader);
+            }
+
+            m_spillFile->release(m_spillRecord);
+            m_spillFile.reset();
+        }
+
         void Snapshot::takeSnapshot(Node* node) {
             NodeSnapshot* snapshot = node->takeSnapshot();
             if (snapshot != nullptr)
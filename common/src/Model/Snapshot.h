@@ -21,7 +21,9 @@
 #define TrenchBroom_Snapshot
 
 #include "FloatType.h"
+#include "IO/SpillFile.h"
 
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
@@ -35,6 +37,12 @@ namespace TrenchBroom {
         private:
             std::vector<NodeSnapshot*> m_nodeSnapshots;
             std::vector<BrushFaceSnapshot*> m_brushFaceSnapshots;
+
+            /**
+             * The file that the data of the node snapshots was moved to, or null if the data is held in memory.
+             */
+            std::shared_ptr<IO::SpillFile> m_spillFile;
+            IO::SpillFile::Record m_spillRecord;
         public:
             template <typename I>
             Snapshot(I cur, I end) {
@@ -46,9 +54,36 @@ namespace TrenchBroom {
 
             ~Snapshot();
 
+            /**
+             * Restores the recorded nodes. If the data of the node snapshots was spilled, it is read back first.
+             *
+             * @throws ReaderException if spilled data cannot be read back
+             */
             void restoreNodes(const vm::bbox3& worldBounds);
             void restoreBrushFaces();
+
+            /**
+             * Returns an estimate of the number of bytes occupied by this snapshot.
+             */
+            size_t memoryUsage() const;
+
+            /**
+             * Moves the data of the node snapshots out of memory and into the given file. The data is read back when
+             * the nodes are restored. The snapshots of brush faces are small and stay in memory. Does nothing if the
+             * data was already spilled.
+             *
+             * If writing the data fails, this snapshot is left unchanged.
+             *
+             * @throws FileSystemException if the data cannot be written
+             */
+            void spill(std::shared_ptr<IO::SpillFile> file);
+
+            /**
+             * Indicates whether the data of the node snapshots was moved to a file.
+             */
+            bool spilled() const;
         private:
+            void readSpilledData();
             void takeSnapshot(Node* node);
             void takeSnapshot(BrushFace* face);
         private:
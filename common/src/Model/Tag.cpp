@@ -135,7 +135,7 @@ namespace TrenchBroom {
                 m_tagMask |= tag.type();
                 m_tags.emplace(tag);
 
-                updateAttributeMask();
+                tagsDidChange();
                 return true;
             }
         }
@@ -150,7 +150,7 @@ namespace TrenchBroom {
             m_tags.erase(it);
             assert(!hasTag(tag));
 
-            updateAttributeMask();
+            tagsDidChange();
             return true;
         }
 
@@ -167,7 +167,7 @@ namespace TrenchBroom {
         void Taggable::clearTags() {
             m_tagMask = 0;
             m_tags.clear();
-            updateAttributeMask();
+            tagsDidChange();
         }
 
         bool Taggable::hasAttribute(const TagAttribute& attribute) const {
@@ -182,6 +182,11 @@ namespace TrenchBroom {
             doAcceptTagVisitor(visitor);
         }
 
+        void Taggable::tagsDidChange() {
+            updateAttributeMask();
+            doTagsDidChange();
+        }
+
         void Taggable::updateAttributeMask() {
             m_attributeMask = 0;
             for (const auto& tagRef : m_tags) {
@@ -192,6 +197,8 @@ namespace TrenchBroom {
             }
         }
 
+        void Taggable::doTagsDidChange() {}
+
         TagMatcherCallback::~TagMatcherCallback() = default;
 
         TagMatcher::~TagMatcher() = default;
@@ -207,6 +214,14 @@ namespace TrenchBroom {
             return false;
         }
 
+        bool TagMatcher::matchesTextureOnly() const {
+            return false;
+        }
+
+        bool TagMatcher::matchesTexture(const std::string& /* textureName */, const Assets::Texture* /* texture */) const {
+            return false;
+        }
+
         SmartTag::SmartTag(const std::string& name, std::vector<TagAttribute> attributes, std::unique_ptr<TagMatcher> matcher) :
         Tag(name, std::move(attributes)),
         m_matcher(std::move(matcher)) {}
@@ -254,5 +269,13 @@ namespace TrenchBroom {
         bool SmartTag::canDisable() const {
             return m_matcher->canDisable();
         }
+
+        bool SmartTag::matchesTextureOnly() const {
+            return m_matcher->matchesTextureOnly();
+        }
+
+        bool SmartTag::matchesTexture(const std::string& textureName, const Assets::Texture* texture) const {
+            return m_matcher->matchesTexture(textureName, texture);
+        }
     }
 }
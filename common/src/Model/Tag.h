@@ -30,6 +30,10 @@
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
     namespace Model {
         class ConstTagVisitor;
         class TagManager;
@@ -264,10 +268,16 @@ namespace TrenchBroom {
              */
             void accept(ConstTagVisitor& visitor) const;
         private:
+            void tagsDidChange();
             void updateAttributeMask();
         private:
             virtual void doAcceptTagVisitor(TagVisitor& visitor) = 0;
             virtual void doAcceptTagVisitor(ConstTagVisitor& visitor) const = 0;
+
+            /**
+             * Called whenever tags were added to or removed from this object.
+             */
+            virtual void doTagsDidChange();
         };
 
         class MapFacade;
@@ -326,6 +336,24 @@ namespace TrenchBroom {
              */
             virtual bool canDisable() const;
 
+            /**
+             * Indicates whether this tag matcher only matches brush faces, and whether the result only depends on the
+             * texture of a face. The tag manager caches the results of such matchers per texture.
+             *
+             * @return true if this matcher only depends on the texture of a face and false otherwise
+             */
+            virtual bool matchesTextureOnly() const;
+
+            /**
+             * Evaluates this tag matcher against a brush face with the given texture. Only called if
+             * `matchesTextureOnly` returns true.
+             *
+             * @param textureName the texture name of the face
+             * @param texture the texture of the face, or null if the texture is missing
+             * @return true if this matcher matches a face with the given texture and false otherwise
+             */
+            virtual bool matchesTexture(const std::string& textureName, const Assets::Texture* texture) const;
+
             /**
              * Returns a new copy of this tag matcher.
              */
@@ -398,6 +426,20 @@ namespace TrenchBroom {
              * @return true if this tag can modify the selection appropriately and false otherwise
              */
             bool canDisable() const;
+
+            /**
+             * Indicates whether the matcher of this tag only depends on the texture of a brush face.
+             */
+            bool matchesTextureOnly() const;
+
+            /**
+             * Indicates whether this smart tag matches a brush face with the given texture. Only valid if
+             * `matchesTextureOnly` returns true.
+             *
+             * @param textureName the texture name of the face
+             * @param texture the texture of the face, or null if the texture is missing
+             */
+            bool matchesTexture(const std::string& textureName, const Assets::Texture* texture) const;
         };
     }
 }
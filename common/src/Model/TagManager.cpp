@@ -20,15 +20,35 @@
 #include "TagManager.h"
 
 #include "Ensure.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/Tag.h"
 #include "Model/TagType.h"
+#include "Model/TagVisitor.h"
 
 #include <algorithm>
+#include <functional>
 #include <stdexcept>
 #include <string>
 
 namespace TrenchBroom {
     namespace Model {
+        class FindBrushFace : public ConstTagVisitor {
+        private:
+            const BrushFace* m_face;
+        public:
+            FindBrushFace() :
+            m_face(nullptr) {}
+
+            const BrushFace* face() const {
+                return m_face;
+            }
+
+            void visit(const BrushFace& face) override {
+                m_face = &face;
+            }
+        };
+
         bool TagManager::TagCmp::operator()(const SmartTag& lhs, const SmartTag& rhs) const {
             return lhs.name() < rhs.name();
         }
@@ -45,6 +65,16 @@ namespace TrenchBroom {
             return lhs < rhs;
         }
 
+        size_t TagManager::TextureTagKeyHash::operator()(const TextureTagKey& key) const {
+            size_t result = 17u;
+            result = result * 31u + std::hash<const std::string*>()(key.first);
+            result = result * 31u + std::hash<const Assets::Texture*>()(key.second);
+            return result;
+        }
+
+        TagManager::TagManager() :
+        m_textureTagTypes(0) {}
+
         const std::vector<SmartTag>& TagManager::smartTags() const {
             return m_smartTags.get_data();
         }
@@ -91,18 +121,68 @@ namespace TrenchBroom {
 
                 it->setIndex(nextIndex);
             }
+
+            m_textureTagTypes = 0;
+            for (const auto& tag : m_smartTags) {
+                if (tag.matchesTextureOnly()) {
+                    m_textureTagTypes |= tag.type();
+                }
+            }
+            clearTextureTagCache();
         }
 
         void TagManager::clearSmartTags() {
             m_smartTags.clear();
+            m_textureTagTypes = 0;
+            clearTextureTagCache();
         }
 
         void TagManager::updateTags(Taggable& taggable) const {
+            FindBrushFace findFace;
+            if (m_textureTagTypes != 0) {
+                taggable.accept(findFace);
+            }
+
+            const auto* face = findFace.face();
+            const auto textureTagsOfFace = face != nullptr ? textureTags(face->attribs()) : TagType::Type(0);
+
             for (const auto& tag : m_smartTags) {
-                tag.update(taggable);
+                if ((tag.type() & m_textureTagTypes) == 0) {
+                    tag.update(taggable);
+                } else if ((tag.type() & textureTagsOfFace) != 0) {
+                    taggable.addTag(tag);
+                } else {
+                    taggable.removeTag(tag);
+                }
             }
         }
 
+        TagType::Type TagManager::textureTags(const BrushFaceAttributes& attribs) const {
+            const auto& textureName = attribs.textureName();
+            const auto* texture = attribs.texture();
+
+            // the texture name is interned, so its address identifies it
+            const auto key = TextureTagKey(&textureName, texture);
+            const auto it = m_textureTagCache.find(key);
+            if (it != std::end(m_textureTagCache)) {
+                return it->second;
+            }
+
+            TagType::Type tags = 0;
+            for (const auto& tag : m_smartTags) {
+                if (tag.matchesTextureOnly() && tag.matchesTexture(textureName, texture)) {
+                    tags |= tag.type();
+                }
+            }
+
+            m_textureTagCache.emplace(key, tags);
+            return tags;
+        }
+
+        void TagManager::clearTextureTagCache() {
+            m_textureTagCache.clear();
+        }
+
         size_t TagManager::freeTagIndex() {
             static const size_t Bits = (sizeof(TagType::Type) * 8);
             const auto index = m_smartTags.size();
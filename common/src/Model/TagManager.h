@@ -21,13 +21,22 @@
 #define TRENCHBROOM_TAGMANAGER_H
 
 #include "Model/Tag.h"
+#include "Model/TagType.h"
 
 #include <kdl/vector_set.h>
 
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
     namespace Model {
+        class BrushFaceAttributes;
+
         /**
          * Manages the tags used in a document and updates smart tags on taggable objects.
          */
@@ -41,7 +50,29 @@ namespace TrenchBroom {
             };
 
             kdl::vector_set<SmartTag, TagCmp> m_smartTags;
+
+            /**
+             * Identifies a texture by its interned name and the texture itself.
+             */
+            using TextureTagKey = std::pair<const std::string*, const Assets::Texture*>;
+
+            struct TextureTagKeyHash {
+                size_t operator()(const TextureTagKey& key) const;
+            };
+
+            /**
+             * The types of the smart tags which only depend on the texture of a brush face.
+             */
+            TagType::Type m_textureTagTypes;
+
+            /**
+             * Caches the result of textureTags per texture name and texture. Since texture names are interned, they
+             * are identified by their address.
+             */
+            mutable std::unordered_map<TextureTagKey, TagType::Type, TextureTagKeyHash> m_textureTagCache;
         public:
+            TagManager();
+
             /**
              * Returns a vector containing all smart tags registered with this manager.
              */
@@ -103,9 +134,31 @@ namespace TrenchBroom {
             /**
              * Update the smart tags of the given taggable object.
              *
+             * The smart tags whose matchers only depend on the texture of a brush face are not evaluated for every
+             * face, but looked up using textureTags.
+             *
+             * This function may be called concurrently for different objects, but only if the textures of all brush
+             * faces among them are already cached, see textureTags.
+             *
              * @param taggable the object to update
              */
             void updateTags(Taggable& taggable) const;
+
+            /**
+             * Returns the types of the smart tags which only depend on the texture of a brush face and which match a
+             * brush face with the given attributes. The result is cached per texture, so the matchers are evaluated
+             * only once per texture.
+             *
+             * @param attribs the attributes of the brush face, which determine its texture name and texture
+             * @return the matching tag types
+             */
+            TagType::Type textureTags(const BrushFaceAttributes& attribs) const;
+
+            /**
+             * Clears the cached results of textureTags. Must be called when the textures were reloaded, since the
+             * surface parameters of a texture may have changed.
+             */
+            void clearTextureTagCache();
         private:
             size_t freeTagIndex();
         };
@@ -64,10 +64,10 @@ namespace TrenchBroom {
         }
 
         TextureNameTagMatcher::TextureNameTagMatcher(const std::string& pattern) :
-        m_pattern(pattern) {}
+        m_matcher(pattern, false) {}
 
         std::unique_ptr<TagMatcher> TextureNameTagMatcher::clone() const {
-            return std::make_unique<TextureNameTagMatcher>(m_pattern);
+            return std::make_unique<TextureNameTagMatcher>(m_matcher.pattern());
         }
 
         bool TextureNameTagMatcher::matches(const Taggable& taggable) const {
@@ -118,13 +118,21 @@ namespace TrenchBroom {
             return true;
         }
 
+        bool TextureNameTagMatcher::matchesTextureOnly() const {
+            return true;
+        }
+
+        bool TextureNameTagMatcher::matchesTexture(const std::string& textureName, const Assets::Texture* /* texture */) const {
+            return matchesTextureName(textureName);
+        }
+
         bool TextureNameTagMatcher::matchesTextureName(std::string_view textureName) const {
             const auto pos = textureName.find_last_of('/');
             if (pos != std::string::npos) {
                 textureName = textureName.substr(pos + 1);
             }
 
-            return kdl::ci::str_matches_glob(textureName, m_pattern);
+            return m_matcher.matches(textureName);
         }
 
         SurfaceParmTagMatcher::SurfaceParmTagMatcher(const std::string& parameter) :
@@ -136,20 +144,21 @@ namespace TrenchBroom {
 
         bool SurfaceParmTagMatcher::matches(const Taggable& taggable) const {
             BrushFaceMatchVisitor visitor([this](const BrushFace& face) {
-                const auto* texture = face.texture();
-                if (texture != nullptr) {
-                    const auto& surfaceParms = texture->surfaceParms();
-                    if (surfaceParms.count(m_parameter) > 0) {
-                        return true;
-                    }
-                }
-                return false;
+                return matchesTexture(face.textureName(), face.texture());
             });
 
             taggable.accept(visitor);
             return visitor.matches();
         }
 
+        bool SurfaceParmTagMatcher::matchesTextureOnly() const {
+            return true;
+        }
+
+        bool SurfaceParmTagMatcher::matchesTexture(const std::string& /* textureName */, const Assets::Texture* texture) const {
+            return texture != nullptr && texture->surfaceParms().count(m_parameter) > 0;
+        }
+
         FlagsTagMatcher::FlagsTagMatcher(const int flags, GetFlags getFlags, SetFlags setFlags, SetFlags unsetFlags, GetFlagNames getFlagNames) :
         m_flags(flags),
         m_getFlags(std::move(getFlags)),
@@ -247,12 +256,12 @@ namespace TrenchBroom {
         }
 
         EntityClassNameTagMatcher::EntityClassNameTagMatcher(const std::string& pattern, const std::string& texture) :
-        m_pattern(pattern),
+        m_matcher(pattern, false),
         m_texture(texture) {}
 
 
         std::unique_ptr<TagMatcher> EntityClassNameTagMatcher::clone() const {
-            return std::make_unique<EntityClassNameTagMatcher>(m_pattern, m_texture);
+            return std::make_unique<EntityClassNameTagMatcher>(m_matcher.pattern(), m_texture);
         }
 
         bool EntityClassNameTagMatcher::matches(const Taggable& taggable) const {
@@ -341,7 +350,7 @@ namespace TrenchBroom {
         }
 
         bool EntityClassNameTagMatcher::matchesClassname(const std::string& classname) const {
-            return kdl::ci::str_matches_glob(classname, m_pattern);
+            return m_matcher.matches(classname);
         }
     }
 }
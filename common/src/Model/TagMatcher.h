@@ -23,6 +23,8 @@
 #include "Model/Tag.h"
 #include "Model/TagVisitor.h"
 
+#include <kdl/glob_matcher.h>
+
 #include <functional>
 #include <memory>
 #include <string>
@@ -70,7 +72,7 @@ namespace TrenchBroom {
 
         class TextureNameTagMatcher : public TagMatcher {
         private:
-            std::string m_pattern;
+            kdl::glob_matcher m_matcher;
         public:
             explicit TextureNameTagMatcher(const std::string& pattern);
             std::unique_ptr<TagMatcher> clone() const override;
@@ -78,6 +80,8 @@ namespace TrenchBroom {
             bool matches(const Taggable& taggable) const override;
             void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
             bool canEnable() const override;
+            bool matchesTextureOnly() const override;
+            bool matchesTexture(const std::string& textureName, const Assets::Texture* texture) const override;
         private:
             bool matchesTextureName(std::string_view textureName) const;
         };
@@ -90,6 +94,8 @@ namespace TrenchBroom {
             std::unique_ptr<TagMatcher> clone() const override;
         private:
             bool matches(const Taggable& taggable) const override;
+            bool matchesTextureOnly() const override;
+            bool matchesTexture(const std::string& textureName, const Assets::Texture* texture) const override;
         };
 
         class FlagsTagMatcher : public TagMatcher {
@@ -127,7 +133,7 @@ namespace TrenchBroom {
 
         class EntityClassNameTagMatcher : public TagMatcher {
         private:
-            std::string m_pattern;
+            kdl::glob_matcher m_matcher;
             /**
              * The texture to set when this tag is enabled.
              */
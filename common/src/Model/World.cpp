@@ -26,6 +26,7 @@
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/CollectNodesWithDescendantSelectionCountVisitor.h"
+#include "Model/Entity.h"
 #include "Model/IssueGenerator.h"
 #include "Model/IssueGeneratorRegistry.h"
 #include "Model/ModelFactoryImpl.h"
@@ -33,10 +34,16 @@
 
 #include <kdl/vector_utils.h>
 
+#include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -45,9 +52,12 @@ namespace TrenchBroom {
         m_factory(std::make_unique<ModelFactoryImpl>(mapFormat)),
         m_defaultLayer(nullptr),
         m_attributableIndex(std::make_unique<AttributableNodeIndex>()),
+        m_updateAttributableIndex(true),
         m_issueGeneratorRegistry(std::make_unique<IssueGeneratorRegistry>()),
         m_nodeTree(std::make_unique<NodeTree>()),
-        m_updateNodeTree(true) {
+        m_updateNodeTree(true),
+        m_deferNodeTreeInsertions(false),
+        m_issueInvalidationCount(0) {
             addOrUpdateAttribute(AttributeNames::Classname, AttributeValues::WorldspawnClassname);
             createDefaultLayer();
         }
@@ -81,6 +91,45 @@ namespace TrenchBroom {
             return *m_attributableIndex;
         }
 
+        void World::disableAttributableIndexUpdates() {
+            m_updateAttributableIndex = false;
+        }
+
+        void World::enableAttributableIndexUpdates() {
+            m_updateAttributableIndex = true;
+            rebuildAttributableIndex();
+        }
+
+        class World::CollectAttributableNodes : public NodeVisitor {
+        private:
+            std::vector<AttributableNode*> m_nodes;
+        public:
+            const std::vector<AttributableNode*>& nodes() const { return m_nodes; }
+        private:
+            void doVisit(World* world) override   { m_nodes.push_back(world); }
+            void doVisit(Layer*) override         {}
+            void doVisit(Group*) override         {}
+            void doVisit(Entity* entity) override { m_nodes.push_back(entity); }
+            void doVisit(Brush*) override         {}
+        };
+
+        void World::rebuildAttributableIndex() {
+            CollectAttributableNodes collect;
+            acceptAndRecurse(collect);
+            const auto& attributables = collect.nodes();
+
+            m_attributableIndex->clear();
+            m_attributableIndex->addAttributableNodes(attributables);
+
+            // every link has a source that refers to its target, so it suffices to resolve the targets of every node
+            for (auto* attributable : attributables) {
+                attributable->clearLinks();
+            }
+            for (auto* attributable : attributables) {
+                attributable->linkToTargets();
+            }
+        }
+
         const std::vector<IssueGenerator*>& World::registeredIssueGenerators() const {
             return m_issueGeneratorRegistry->registeredGenerators();
         }
@@ -99,6 +148,26 @@ namespace TrenchBroom {
             invalidateAllIssues();
         }
 
+        std::vector<Node*> World::takeNodesWithInvalidatedIssues() {
+            // a node can be recorded again if its issues were validated and invalidated before this is called
+            std::vector<Node*> result;
+            result.reserve(m_nodesWithInvalidatedIssues.size());
+
+            std::unordered_set<Node*> visited;
+            for (auto* node : m_nodesWithInvalidatedIssues) {
+                if (visited.insert(node).second) {
+                    result.push_back(node);
+                }
+            }
+
+            m_nodesWithInvalidatedIssues.clear();
+            return result;
+        }
+
+        size_t World::issueInvalidationCount() const {
+            return m_issueInvalidationCount;
+        }
+
         class World::AddNodeToNodeTree : public NodeVisitor {
         private:
             NodeTree& m_nodeTree;
@@ -155,6 +224,7 @@ namespace TrenchBroom {
         };
 
         void World::disableNodeTreeUpdates() {
+            updateChangedNodesInNodeTree();
             m_updateNodeTree = false;
         }
 
@@ -169,6 +239,150 @@ namespace TrenchBroom {
             acceptAndRecurse(collect);
 
             m_nodeTree->clearAndBuild(collect.nodes(), [](const auto* node){ return node->physicalBounds(); });
+            m_nodesWithChangedBounds.clear();
+        }
+
+        World::DeferNodeTreeInsertions::DeferNodeTreeInsertions(World& world) :
+        m_world(world),
+        m_committed(false) {
+            m_world.deferNodeTreeInsertions();
+        }
+
+        World::DeferNodeTreeInsertions::~DeferNodeTreeInsertions() {
+            if (!m_committed) {
+                m_world.abandonDeferredNodeTreeInsertions();
+            }
+        }
+
+        void World::DeferNodeTreeInsertions::commit() {
+            ensure(!m_committed, "deferred node tree insertions were already committed");
+            m_world.endDeferredNodeTreeInsertions();
+            m_committed = true;
+        }
+
+        void World::deferNodeTreeInsertions() {
+            m_deferNodeTreeInsertions = true;
+        }
+
+        void World::endDeferredNodeTreeInsertions() {
+            insertDeferredNodes();
+            m_deferNodeTreeInsertions = false;
+        }
+
+        void World::abandonDeferredNodeTreeInsertions() noexcept {
+            m_deferNodeTreeInsertions = false;
+            m_deferredNodeTreeInsertions.clear();
+
+            // the deferred nodes may be partially inserted, so start over with the nodes that are in the world now
+            try {
+                rebuildNodeTree();
+            } catch (...) {
+                // the node tree stays incomplete, but throwing here would terminate the application
+                m_nodeTree->clear();
+            }
+        }
+
+        void World::insertDeferredNodes() {
+            if (m_deferredNodeTreeInsertions.empty()) {
+                return;
+            }
+
+            using CollectTreeNodes = CollectMatchingNodesVisitor<MatchTreeNodes>;
+
+            CollectTreeNodes collect;
+            Node::acceptAndRecurse(std::begin(m_deferredNodeTreeInsertions), std::end(m_deferredNodeTreeInsertions), collect);
+            m_deferredNodeTreeInsertions.clear();
+
+            const auto& nodes = collect.nodes();
+            if (nodes.size() >= m_nodeTree->size()) {
+                rebuildNodeTree();
+            } else {
+                for (auto* node : nodes) {
+                    // a node is collected twice if it was added to a node that was added before
+                    if (!m_nodeTree->contains(node)) {
+                        m_nodeTree->insert(node->physicalBounds(), node);
+                    }
+                }
+            }
+        }
+
+        void World::updateChangedNodesInNodeTree() const {
+            if (m_nodesWithChangedBounds.empty()) {
+                return;
+            }
+
+            UpdateNodeInNodeTree visitor(*m_nodeTree);
+            // a node is recorded once for every change of its bounds, but it must only be updated once
+            std::unordered_set<Node*> updated;
+            for (auto* node : m_nodesWithChangedBounds) {
+                // nodes whose insertion is deferred will be inserted with their current bounds
+                if (m_nodeTree->contains(node) && updated.insert(node).second) {
+                    node->accept(visitor);
+                }
+            }
+            m_nodesWithChangedBounds.clear();
+        }
+
+        void World::findNodes(const std::function<bool(const vm::bbox3&)>& predicate, std::vector<Node*>& result) const {
+            updateChangedNodesInNodeTree();
+            m_nodeTree->findMatching(predicate, std::back_inserter(result));
+        }
+
+        std::vector<Node*> World::findNodesIntersecting(const vm::bbox3& bounds, const NodeFilter& filter) const {
+            updateChangedNodesInNodeTree();
+
+            std::vector<Node*> result;
+            m_nodeTree->findMatching([&](const vm::bbox3& nodeBounds) { return nodeBounds.intersects(bounds); }, filter, std::back_inserter(result));
+            return result;
+        }
+
+        std::vector<Node*> World::findNodesInside(const vm::bbox3& bounds, const NodeFilter& filter) const {
+            updateChangedNodesInNodeTree();
+
+            std::vector<Node*> result;
+            // inner nodes only need to intersect the given bounds, so the leaves must be checked for containment
+            m_nodeTree->findMatching([&](const vm::bbox3& nodeBounds) { return nodeBounds.intersects(bounds); }, [&](const Node* node) {
+                return bounds.contains(node->physicalBounds()) && filter(node);
+            }, std::back_inserter(result));
+            return result;
+        }
+
+        std::vector<Node*> World::findNodesAt(const vm::vec3& point, const NodeFilter& filter) const {
+            updateChangedNodesInNodeTree();
+
+            std::vector<Node*> result;
+            m_nodeTree->findMatching([&](const vm::bbox3& nodeBounds) { return nodeBounds.contains(point); }, filter, std::back_inserter(result));
+            return result;
+        }
+
+        /**
+         * Returns whether the given bounds are entirely above the given plane, that is, whether the corner of the bounds
+         * that is farthest below the plane is above it.
+         */
+        static bool above(const vm::bbox3& bounds, const vm::plane3& plane) {
+            const auto corner = vm::vec3(
+                plane.normal.x() > 0.0 ? bounds.min.x() : bounds.max.x(),
+                plane.normal.y() > 0.0 ? bounds.min.y() : bounds.max.y(),
+                plane.normal.z() > 0.0 ? bounds.min.z() : bounds.max.z());
+            return plane.point_distance(corner) > 0.0;
+        }
+
+        std::vector<Node*> World::findNodesInFrustum(const std::vector<vm::plane3>& planes, const NodeFilter& filter) const {
+            updateChangedNodesInNodeTree();
+
+            std::vector<Node*> result;
+            m_nodeTree->findMatching([&](const vm::bbox3& nodeBounds) {
+                return std::none_of(std::begin(planes), std::end(planes), [&](const vm::plane3& plane) { return above(nodeBounds, plane); });
+            }, filter, std::back_inserter(result));
+            return result;
+        }
+
+        std::vector<Node*> World::findNearestNodes(const vm::vec3& point, const size_t count, const NodeFilter& filter) const {
+            updateChangedNodesInNodeTree();
+
+            std::vector<Node*> result;
+            m_nodeTree->findNearest(point, count, filter, std::back_inserter(result));
+            return result;
         }
 
         class World::InvalidateAllIssuesVisitor : public NodeVisitor {
@@ -270,22 +484,36 @@ namespace TrenchBroom {
             // In some cases, (e.g. if `node` is a Group), `node` will not be added to the spatial index, but some of its descendants may be.
             // We need to recursively search the `node` being connected and add it or any descendants that need to be added.
             if (m_updateNodeTree) {
-                AddNodeToNodeTree visitor(*m_nodeTree);
-                node->acceptAndRecurse(visitor);
+                if (m_deferNodeTreeInsertions) {
+                    m_deferredNodeTreeInsertions.push_back(node);
+                } else {
+                    AddNodeToNodeTree visitor(*m_nodeTree);
+                    node->acceptAndRecurse(visitor);
+                }
             }
         }
 
         void World::doDescendantWillBeRemoved(Node* node, const size_t /* depth */) {
             if (m_updateNodeTree) {
+                // the removed node might have been added while insertions were deferred
+                insertDeferredNodes();
+                // the removed nodes may be deleted before the node tree is queried again
+                updateChangedNodesInNodeTree();
                 RemoveNodeFromNodeTree visitor(*m_nodeTree);
                 node->acceptAndRecurse(visitor);
             }
         }
 
+        void World::doDescendantWasRemoved(Node* /* oldParent */, Node* node, const size_t /* depth */) {
+            // the removed nodes may be deleted before the recorded nodes are taken
+            kdl::vec_erase_if(m_nodesWithInvalidatedIssues, [&](const Node* recorded) {
+                return recorded == node || recorded->isDescendantOf(node);
+            });
+        }
+
         void World::doDescendantPhysicalBoundsDidChange(Node* node) {
-            if (m_updateNodeTree) {
-                UpdateNodeInNodeTree visitor(*m_nodeTree);
-                node->accept(visitor);
+            if (m_updateNodeTree && node->shouldAddToSpacialIndex()) {
+                m_nodesWithChangedBounds.push_back(node);
             }
         }
 
@@ -294,12 +522,14 @@ namespace TrenchBroom {
         }
 
         void World::doPick(const vm::ray3& ray, PickResult& pickResult) {
+            updateChangedNodesInNodeTree();
             for (auto* node : m_nodeTree->findIntersectors(ray)) {
                 node->pick(ray, pickResult);
             }
         }
 
         void World::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) {
+            updateChangedNodesInNodeTree();
             for (auto* node : m_nodeTree->findContainers(point)) {
                 node->findNodesContaining(point, result);
             }
@@ -309,6 +539,11 @@ namespace TrenchBroom {
             generator->generate(this, issues);
         }
 
+        void World::doDescendantIssuesWereInvalidated(Node* node) {
+            m_nodesWithInvalidatedIssues.push_back(node);
+            ++m_issueInvalidationCount;
+        }
+
         void World::doAccept(NodeVisitor& visitor) {
             visitor.visit(this);
         }
@@ -318,21 +553,27 @@ namespace TrenchBroom {
         }
 
         void World::doFindAttributableNodesWithAttribute(const std::string& name, const std::string& value, std::vector<Model::AttributableNode*>& result) const {
-            kdl::vec_append(result,
-                m_attributableIndex->findAttributableNodes(AttributableNodeIndexQuery::exact(name), value));
+            if (m_updateAttributableIndex) {
+                m_attributableIndex->findAttributableNodes(AttributableNodeIndexQuery::exact(name), value, result);
+            }
         }
 
         void World::doFindAttributableNodesWithNumberedAttribute(const std::string& prefix, const std::string& value, std::vector<Model::AttributableNode*>& result) const {
-            kdl::vec_append(result,
-                m_attributableIndex->findAttributableNodes(AttributableNodeIndexQuery::numbered(prefix), value));
+            if (m_updateAttributableIndex) {
+                m_attributableIndex->findAttributableNodes(AttributableNodeIndexQuery::numbered(prefix), value, result);
+            }
         }
 
         void World::doAddToIndex(AttributableNode* attributable, const std::string& name, const std::string& value) {
-            m_attributableIndex->addAttribute(attributable, name, value);
+            if (m_updateAttributableIndex) {
+                m_attributableIndex->addAttribute(attributable, name, value);
+            }
         }
 
         void World::doRemoveFromIndex(AttributableNode* attributable, const std::string& name, const std::string& value) {
-            m_attributableIndex->removeAttribute(attributable, name, value);
+            if (m_updateAttributableIndex) {
+                m_attributableIndex->removeAttribute(attributable, name, value);
+            }
         }
 
         void World::doAttributesDidChange(const vm::bbox3& /* oldBounds */) {}
@@ -26,7 +26,9 @@
 #include "Model/MapFormat.h"
 #include "Model/ModelFactory.h"
 #include "Model/Node.h"
+#include "Model/NodeFilter.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -45,11 +47,24 @@ namespace TrenchBroom {
             std::unique_ptr<ModelFactory> m_factory;
             Layer* m_defaultLayer;
             std::unique_ptr<AttributableNodeIndex> m_attributableIndex;
+            bool m_updateAttributableIndex;
             std::unique_ptr<IssueGeneratorRegistry> m_issueGeneratorRegistry;
 
             using NodeTree = AABBTree<FloatType, 3, Node*>;
             std::unique_ptr<NodeTree> m_nodeTree;
             bool m_updateNodeTree;
+            bool m_deferNodeTreeInsertions;
+            std::vector<Node*> m_deferredNodeTreeInsertions;
+
+            /**
+             * The nodes whose bounds have changed since the node tree was last updated. Updating the node tree
+             * requires the bounds of the changed nodes, and computing the bounds of an entity is expensive if it has
+             * many children, so the node tree is only updated when it is queried.
+             */
+            mutable std::vector<Node*> m_nodesWithChangedBounds;
+
+            std::vector<Node*> m_nodesWithInvalidatedIssues;
+            size_t m_issueInvalidationCount;
         public:
             World(MapFormat mapFormat);
             ~World() override;
@@ -61,12 +76,44 @@ namespace TrenchBroom {
             void createDefaultLayer();
         public: // index
             const AttributableNodeIndex& attributableNodeIndex() const;
+        private:
+            class CollectAttributableNodes;
+        public: // attributable index bulk updating
+            /**
+             * Stops updating the attributable node index and the links between the attributable nodes of this world
+             * when nodes are added or removed or their attributes change. While updates are disabled, no links are
+             * created, and looking up nodes by their attributes yields nothing.
+             */
+            void disableAttributableIndexUpdates();
+
+            /**
+             * Resumes updating the attributable node index, and rebuilds the index and the links between all
+             * attributable nodes of this world at once.
+             */
+            void enableAttributableIndexUpdates();
+            void rebuildAttributableIndex();
         public: // selection
             // issue generator registration
             const std::vector<IssueGenerator*>& registeredIssueGenerators() const;
             std::vector<IssueQuickFix*> quickFixes(IssueType issueTypes) const;
             void registerIssueGenerator(IssueGenerator* issueGenerator);
             void unregisterAllIssueGenerators();
+        public: // issue tracking
+            /**
+             * Returns the nodes of this world whose issues were valid and have been invalidated since the last call,
+             * in the order in which they were invalidated, and forgets them. Nodes that were removed from this world
+             * in the meantime are not returned.
+             *
+             * Since the issues of a node only depend on the node itself, its children and the nodes it is linked to,
+             * these are exactly the nodes that must be revalidated after a change to keep a list of all issues up to
+             * date.
+             */
+            std::vector<Node*> takeNodesWithInvalidatedIssues();
+
+            /**
+             * Returns the number of times that the valid issues of a node of this world were invalidated.
+             */
+            size_t issueInvalidationCount() const;
         private:
             class AddNodeToNodeTree;
             class RemoveNodeFromNodeTree;
@@ -76,6 +123,89 @@ namespace TrenchBroom {
             void disableNodeTreeUpdates();
             void enableNodeTreeUpdates();
             void rebuildNodeTree();
+
+            /**
+             * Defers adding nodes to the node tree for as long as an instance of this class exists. Spatial queries do
+             * not find the nodes added in the meantime. Call commit() to add the nodes that were added to the world
+             * since the instance was created to the node tree.
+             *
+             * If the instance is destroyed without being committed, e.g. during stack unwinding, the node tree is
+             * rebuilt from scratch instead. The destructor never throws.
+             *
+             * Use this to add many nodes at once: if the number of added nodes is large compared to the number of
+             * nodes already in the node tree, the node tree is rebuilt, which is faster than inserting the added nodes
+             * one by one and yields a balanced tree.
+             */
+            class DeferNodeTreeInsertions {
+            private:
+                World& m_world;
+                bool m_committed;
+            public:
+                explicit DeferNodeTreeInsertions(World& world);
+                ~DeferNodeTreeInsertions();
+
+                DeferNodeTreeInsertions(const DeferNodeTreeInsertions&) = delete;
+                DeferNodeTreeInsertions& operator=(const DeferNodeTreeInsertions&) = delete;
+
+                /**
+                 * Adds the deferred nodes to the node tree and ends the deferral.
+                 *
+                 * @throws NodeTreeException if a deferred node cannot be added to the node tree
+                 */
+                void commit();
+            };
+        private:
+            // call these methods via the DeferNodeTreeInsertions class, it's exception safe
+            void deferNodeTreeInsertions();
+            void endDeferredNodeTreeInsertions();
+            void abandonDeferredNodeTreeInsertions() noexcept;
+            void insertDeferredNodes();
+            void updateChangedNodesInNodeTree() const;
+        public: // spatial queries
+            /**
+             * Appends every entity and brush whose physical bounds satisfy the given predicate to the given vector.
+             *
+             * The predicate is also applied to the bounds of groups of nodes in the node tree, and if it rejects such
+             * bounds, the contained nodes are skipped. Therefore, if the predicate rejects a box, it must also reject
+             * every box contained in it.
+             */
+            void findNodes(const std::function<bool(const vm::bbox3&)>& predicate, std::vector<Node*>& result) const;
+
+            /*
+             * The following queries return the entities and brushes that pass the given filter, judged by their physical
+             * bounds. The filter is applied while the node tree is searched, so rejected nodes do not incur any further
+             * cost.
+             */
+
+            /**
+             * Returns the entities and brushes whose bounds intersect the given bounds.
+             */
+            std::vector<Node*> findNodesIntersecting(const vm::bbox3& bounds, const NodeFilter& filter = NodeFilter()) const;
+
+            /**
+             * Returns the entities and brushes whose bounds are contained in the given bounds.
+             */
+            std::vector<Node*> findNodesInside(const vm::bbox3& bounds, const NodeFilter& filter = NodeFilter()) const;
+
+            /**
+             * Returns the entities and brushes whose bounds contain the given point.
+             */
+            std::vector<Node*> findNodesAt(const vm::vec3& point, const NodeFilter& filter = NodeFilter()) const;
+
+            /**
+             * Returns the entities and brushes whose bounds are not entirely above any of the given planes. For a view
+             * frustum, the normals of the planes must point out of the frustum.
+             *
+             * This test is conservative: a box that is outside of the frustum, but not entirely above any single plane,
+             * is returned.
+             */
+            std::vector<Node*> findNodesInFrustum(const std::vector<vm::plane3>& planes, const NodeFilter& filter = NodeFilter()) const;
+
+            /**
+             * Returns up to the given number of entities and brushes whose bounds are closest to the given point, ordered
+             * by increasing distance. Nodes whose bounds contain the point have a distance of zero.
+             */
+            std::vector<Node*> findNearestNodes(const vm::vec3& point, size_t count, const NodeFilter& filter = NodeFilter()) const;
         private:
             class InvalidateAllIssuesVisitor;
             void invalidateAllIssues();
@@ -91,12 +221,14 @@ namespace TrenchBroom {
 
             void doDescendantWasAdded(Node* node, size_t depth) override;
             void doDescendantWillBeRemoved(Node* node, size_t depth) override;
+            void doDescendantWasRemoved(Node* oldParent, Node* node, size_t depth) override;
             void doDescendantPhysicalBoundsDidChange(Node* node) override;
 
             bool doSelectable() const override;
             void doPick(const vm::ray3& ray, PickResult& pickResult) override;
             void doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) override;
             void doGenerateIssues(const IssueGenerator* generator, std::vector<Issue*>& issues) override;
+            void doDescendantIssuesWereInvalidated(Node* node) override;
             void doAccept(NodeVisitor& visitor) override;
             void doAccept(ConstNodeVisitor& visitor) const override;
             void doFindAttributableNodesWithAttribute(const std::string& name, const std::string& value, std::vector<AttributableNode*>& result) const override;
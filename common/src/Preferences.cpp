@@ -47,6 +47,7 @@ namespace TrenchBroom {
         Preference<Color> PortalFileBorderColor(IO::Path("Renderer/Colors/Portal file border"), Color(1.0f, 1.0f, 1.0f, 0.5f));
         Preference<Color> PortalFileFillColor(IO::Path("Renderer/Colors/Portal file fill"), Color(1.0f, 0.4f, 0.4f, 0.2f));
         Preference<bool>  ShowFPS(IO::Path("Renderer/Show FPS"), false);
+        Preference<bool>  OcclusionCulling(IO::Path("Renderer/Occlusion culling"), false);
 
         Preference<Color>& axisColor(vm::axis::type axis) {
             switch (axis) {
@@ -133,6 +134,9 @@ namespace TrenchBroom {
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
 
+        Preference<int> UndoMemoryBudget(IO::Path("Editor/Undo memory budget"), 1024);
+        Preference<bool> UndoDiscardOverBudget(IO::Path("Editor/Discard undo steps over budget"), false);
+
         Preference<IO::Path>& RendererFontPath() {
             static Preference<IO::Path> fontPath(IO::Path("Renderer/Font name"), IO::Path("fonts/SourceSansPro-Regular.otf"));
             return fontPath;
@@ -205,6 +209,7 @@ namespace TrenchBroom {
                 &PortalFileBorderColor,
                 &PortalFileFillColor,
                 &ShowFPS,
+                &OcclusionCulling,
                 &CompassBackgroundColor,
                 &CompassBackgroundOutlineColor,
                 &CompassAxisOutlineColor,
@@ -260,6 +265,8 @@ namespace TrenchBroom {
                 &TextureMagFilter,
                 &TextureLock,
                 &UVLock,
+                &UndoMemoryBudget,
+                &UndoDiscardOverBudget,
                 &RendererFontPath(),
                 &RendererFontSize,
                 &BrowserFontSize,
@@ -51,6 +51,7 @@ namespace TrenchBroom {
         extern Preference<Color> PortalFileBorderColor;
         extern Preference<Color> PortalFileFillColor;
         extern Preference<bool>  ShowFPS;
+        extern Preference<bool>  OcclusionCulling;
 
         Preference<Color>& axisColor(vm::axis::type axis);
 
@@ -127,6 +128,17 @@ namespace TrenchBroom {
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
 
+        /**
+         * The maximum amount of memory in megabytes that the undo history of a document may occupy, or 0 for no limit.
+         */
+        extern Preference<int> UndoMemoryBudget;
+
+        /**
+         * Whether the oldest undo steps may be discarded when the undo history exceeds its memory budget even after
+         * their snapshots were moved to disk.
+         */
+        extern Preference<bool> UndoDiscardOverBudget;
+
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
 
@@ -169,6 +169,8 @@ namespace TrenchBroom {
             block->nextOfSameSize = nullptr;
             block->prevOfSameSize = nullptr;
 
+            m_freeSize -= needed;
+
             if (block->size == needed) {
                 // lucky case: exact size. we're done
                 block->free = false;
@@ -217,6 +219,8 @@ namespace TrenchBroom {
             assert(block->prevOfSameSize == nullptr);
             assert(block->nextOfSameSize == nullptr);
 
+            m_freeSize += block->size;
+
             Block* left = block->left;
             Block* right = block->right;
 
@@ -314,6 +318,7 @@ namespace TrenchBroom {
 
         AllocationTracker::AllocationTracker(const Index initial_capacity)
                 : m_capacity(0),
+                  m_freeSize(0),
                   m_leftmostBlock(nullptr),
                   m_rightmostBlock(nullptr),
                   m_recycledBlockList(nullptr) {
@@ -325,6 +330,7 @@ namespace TrenchBroom {
 
         AllocationTracker::AllocationTracker()
                 : m_capacity(0),
+                  m_freeSize(0),
                   m_leftmostBlock(nullptr),
                   m_rightmostBlock(nullptr),
                   m_recycledBlockList(nullptr) {}
@@ -355,6 +361,7 @@ namespace TrenchBroom {
             if (m_capacity == 0) {
                 assert(newCapacity > 0);
                 m_capacity = newCapacity;
+                m_freeSize = newCapacity;
 
                 Block* newBlock = obtainBlock();
                 newBlock->pos = 0;
@@ -407,6 +414,46 @@ namespace TrenchBroom {
             }
 
             m_capacity += increase;
+            m_freeSize += increase;
+
+            checkInvariants();
+        }
+
+        void AllocationTracker::shrink(const Index newCapacity) {
+            checkInvariants();
+
+            if (newCapacity >= m_capacity) {
+                throw std::invalid_argument("new capacity must be smaller");
+            }
+
+            Block* lastBlock = m_rightmostBlock;
+            if (!lastBlock->free || lastBlock->pos > newCapacity) {
+                throw std::invalid_argument("shrink() would discard used blocks");
+            }
+
+            const Index decrease = m_capacity - newCapacity;
+            unlinkFromBinList(lastBlock);
+
+            if (lastBlock->pos == newCapacity) {
+                // the whole trailing free block goes away
+                Block* newRightmostBlock = lastBlock->left;
+                if (newRightmostBlock == nullptr) {
+                    assert(newCapacity == 0);
+                    m_leftmostBlock = nullptr;
+                } else {
+                    newRightmostBlock->right = nullptr;
+                }
+                m_rightmostBlock = newRightmostBlock;
+
+                lastBlock->left = nullptr;
+                recycle(lastBlock);
+            } else {
+                lastBlock->size -= decrease;
+                linkToBinList(lastBlock);
+            }
+
+            m_capacity = newCapacity;
+            m_freeSize -= decrease;
 
             checkInvariants();
         }
@@ -421,6 +468,39 @@ namespace TrenchBroom {
             return false;
         }
 
+        AllocationTracker::Index AllocationTracker::freeSize() const {
+            return m_freeSize;
+        }
+
+        AllocationTracker::Index AllocationTracker::usedEnd() const {
+            const Block* block = lastUsedBlock();
+            return block != nullptr ? block->pos + block->size : 0;
+        }
+
+        AllocationTracker::Block* AllocationTracker::lastUsedBlock() const {
+            Block* block = m_rightmostBlock;
+            if (block != nullptr && block->free) {
+                // adjacent free blocks are always merged, so the block to the left must be used
+                block = block->left;
+            }
+            assert(block == nullptr || !block->free);
+            return block;
+        }
+
+        std::vector<AllocationTracker::Range> AllocationTracker::usedRanges() const {
+            std::vector<Range> res;
+            for (Block* block = m_leftmostBlock; block != nullptr; block = block->right) {
+                if (!block->free) {
+                    if (!res.empty() && res.back().pos + res.back().size == block->pos) {
+                        res.back().size += block->size;
+                    } else {
+                        res.emplace_back(block->pos, block->size);
+                    }
+                }
+            }
+            return res;
+        }
+
 // Testing / debugging
 
         std::vector<AllocationTracker::Range> AllocationTracker::freeBlocks() const {
@@ -489,6 +569,14 @@ namespace TrenchBroom {
             }
             assert(m_capacity == totalSize);
 
+            size_t totalFreeSize = 0;
+            for (Block* block = m_leftmostBlock; block != nullptr; block = block->right) {
+                if (block->free) {
+                    totalFreeSize += block->size;
+                }
+            }
+            assert(m_freeSize == totalFreeSize);
+
             // check the size map
             for (const auto& headBlock : m_freeBlockSizeBins) {
                 assert(headBlock != nullptr);
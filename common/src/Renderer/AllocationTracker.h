@@ -69,6 +69,10 @@ namespace TrenchBroom {
              * Always equal to the sum of `size` of all Blocks.
              */
             Index m_capacity;
+            /**
+             * Sum of `size` of all free Blocks.
+             */
+            Index m_freeSize;
 
             /**
              * Points to the Block with pos 0. Used to free all of the blocks in the destructor
@@ -125,6 +129,26 @@ namespace TrenchBroom {
              * tracker is free. Returns false if `capacity() == 0`. Constant time.
              */
             bool hasAllocations() const;
+            /**
+             * Shrinks the managed range to `newCapacity` by cutting off the free space at the end.
+             *
+             * Throws std::invalid_argument unless `newCapacity < capacity()` and `newCapacity >= usedEnd()`.
+             */
+            void shrink(Index newCapacity);
+
+            /**
+             * @return the total size of all free blocks. Constant time.
+             */
+            Index freeSize() const;
+            /**
+             * @return the position one past the end of the used block with the highest position, or 0 if there are no
+             * allocations. Everything from here to `capacity()` is free. Constant time.
+             */
+            Index usedEnd() const;
+            /**
+             * @return the used block with the highest position, or nullptr if there are no allocations. Constant time.
+             */
+            Block* lastUsedBlock() const;
 
             // Testing / debugging
 
@@ -139,6 +163,12 @@ namespace TrenchBroom {
                 bool operator<(const Range &other) const;
             };
 
+            /**
+             * @return the used ranges in ascending order of position, with adjacent used blocks merged into a single
+             * range
+             */
+            std::vector<Range> usedRanges() const;
+
             std::vector<Range> freeBlocks() const;
             std::vector<Range> usedBlocks() const;
             Index largestPossibleAllocation() const;
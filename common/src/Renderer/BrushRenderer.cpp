@@ -28,14 +28,27 @@
 #include "Model/TagAttribute.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/FrameProfiler.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/RenderContext.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <functional>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
+        /**
+         * The number of brushes compact() may move per frame.
+         */
+        static const size_t MaxRelocationsPerFrame = 256u;
+        /**
+         * Arrays smaller than this are not worth defragmenting.
+         */
+        static const size_t MinCompactionCapacity = 1u << 14;
+
         // Filter
 
         BrushRenderer::Filter::Filter() {}
@@ -113,6 +126,9 @@ namespace TrenchBroom {
 
         BrushRenderer::BrushRenderer() :
         m_filter(std::make_unique<NoFilter>()),
+        m_needsCompaction(false),
+        m_compactionStalled(false),
+        m_opaqueIndexRangesValid(false),
         m_showEdges(false),
         m_grayscale(false),
         m_tint(false),
@@ -156,8 +172,11 @@ namespace TrenchBroom {
                 removeBrushFromVbo(brush);
             }
             m_invalidBrushes = m_allBrushes;
+            m_opaqueIndexRangeBrushes.clear();
+            m_opaqueIndexRanges.clear();
 
             assert(m_brushInfo.empty());
+            assert(m_vertexBlockToBrush.empty());
             assert(m_transparentFaces->empty());
             assert(m_opaqueFaces->empty());
         }
@@ -183,6 +202,12 @@ namespace TrenchBroom {
 
         void BrushRenderer::clear() {
             m_brushInfo.clear();
+            m_vertexBlockToBrush.clear();
+            m_needsCompaction = false;
+            m_compactionStalled = false;
+            m_opaqueIndexRangeBrushes.clear();
+            m_opaqueIndexRanges.clear();
+            m_opaqueIndexRangesValid = false;
             m_allBrushes.clear();
             m_invalidBrushes.clear();
 
@@ -258,9 +283,11 @@ namespace TrenchBroom {
             if (!m_allBrushes.empty()) {
                 if (!valid()) {
                     validate();
+                } else {
+                    compact(MaxRelocationsPerFrame);
                 }
                 if (renderContext.showFaces()) {
-                    renderOpaqueFaces(renderBatch);
+                    renderOpaqueFaces(renderContext, renderBatch);
                 }
                 if (renderContext.showEdges() || m_showEdges) {
                     renderEdges(renderBatch);
@@ -279,13 +306,79 @@ namespace TrenchBroom {
             }
         }
 
-        void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch) {
+        void BrushRenderer::renderOpaqueFaces(RenderContext& renderContext, RenderBatch& renderBatch) {
             m_opaqueFaceRenderer.setGrayscale(m_grayscale);
             m_opaqueFaceRenderer.setTint(m_tint);
             m_opaqueFaceRenderer.setTintColor(m_tintColor);
+
+            if (const auto* culler = renderContext.occlusionCuller()) {
+                validateOpaqueIndexRanges();
+                m_opaqueFaceRenderer.setVisibleIndexRanges(visibleOpaqueIndexRanges(*culler));
+            } else {
+                m_opaqueFaceRenderer.setVisibleIndexRanges(nullptr);
+            }
+
             m_opaqueFaceRenderer.render(renderBatch);
         }
 
+        void BrushRenderer::validateOpaqueIndexRanges() {
+            if (m_opaqueIndexRangesValid) {
+                return;
+            }
+
+            const ProfileScope profile("BrushRenderer::validateOpaqueIndexRanges");
+
+            m_opaqueIndexRangeBrushes.clear();
+            m_opaqueIndexRanges.clear();
+            for (const auto& [brush, info] : m_brushInfo) {
+                if (!info.opaqueFaceIndicesKeys.empty()) {
+                    const auto brushIndex = m_opaqueIndexRangeBrushes.size();
+                    m_opaqueIndexRangeBrushes.push_back(brush);
+                    for (const auto& [texture, block] : info.opaqueFaceIndicesKeys) {
+                        m_opaqueIndexRanges.push_back({ texture, AllocationTracker::Range(block->pos, block->size), brushIndex });
+                    }
+                }
+            }
+
+            // sorting the ranges allows merging adjacent ranges, and makes the draw calls independent of the map order
+            std::sort(std::begin(m_opaqueIndexRanges), std::end(m_opaqueIndexRanges),
+                      [](const OpaqueIndexRange& lhs, const OpaqueIndexRange& rhs) {
+                          if (lhs.texture != rhs.texture) {
+                              return std::less<const Assets::Texture*>()(lhs.texture, rhs.texture);
+                          }
+                          return lhs.range < rhs.range;
+                      });
+
+            m_opaqueIndexRangesValid = true;
+        }
+
+        std::shared_ptr<const FaceRenderer::TextureToIndexRangesMap> BrushRenderer::visibleOpaqueIndexRanges(const OcclusionCuller& culler) const {
+            assert(m_opaqueIndexRangesValid);
+            const ProfileScope profile("BrushRenderer::visibleOpaqueIndexRanges");
+
+            std::vector<bool> visible;
+            visible.reserve(m_opaqueIndexRangeBrushes.size());
+            for (const auto* brush : m_opaqueIndexRangeBrushes) {
+                visible.push_back(culler.visible(brush));
+            }
+
+            // the cached ranges are sorted, so the ranges of each texture are collected in order
+            auto result = std::make_shared<FaceRenderer::TextureToIndexRangesMap>();
+            const Assets::Texture* currentTexture = nullptr;
+            std::vector<AllocationTracker::Range>* currentRanges = nullptr;
+            for (const auto& opaqueRange : m_opaqueIndexRanges) {
+                if (visible[opaqueRange.brushIndex]) {
+                    if (currentRanges == nullptr || opaqueRange.texture != currentTexture) {
+                        currentTexture = opaqueRange.texture;
+                        currentRanges = &(*result)[currentTexture];
+                    }
+                    currentRanges->push_back(opaqueRange.range);
+                }
+            }
+
+            return result;
+        }
+
         void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch) {
             m_transparentFaceRenderer.setGrayscale(m_grayscale);
             m_transparentFaceRenderer.setTint(m_tint);
@@ -326,6 +419,7 @@ namespace TrenchBroom {
 
         void BrushRenderer::validate() {
             assert(!valid());
+            const ProfileScope profile("BrushRenderer::validate");
 
             for (auto brush : m_invalidBrushes) {
                 validateBrush(brush);
@@ -333,11 +427,91 @@ namespace TrenchBroom {
             m_invalidBrushes.clear();
             assert(valid());
 
+            validateDrawRanges();
+
             m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
             m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
             m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
         }
 
+        /**
+         * Returns whether the holes below the last used block of the given tracker make up more than a quarter of the
+         * used range. These holes can only be reclaimed by moving the blocks above them.
+         */
+        static bool fragmented(const AllocationTracker& tracker) {
+            if (tracker.capacity() < MinCompactionCapacity) {
+                return false;
+            }
+
+            const auto usedEnd = tracker.usedEnd();
+            const auto usedSize = tracker.capacity() - tracker.freeSize();
+            return (usedEnd - usedSize) > usedEnd / 4u;
+        }
+
+        /**
+         * If less than a quarter of the given array is in use, shrink it to twice the used range. The headroom keeps
+         * the next insertions from expanding the array right away.
+         */
+        template <typename A>
+        static void shrinkIfOversized(A& array) {
+            const auto& tracker = array.allocationTracker();
+            const auto usedEnd = tracker.usedEnd();
+            if (usedEnd > 0u && tracker.capacity() >= MinCompactionCapacity && usedEnd < tracker.capacity() / 4u) {
+                array.shrink(2u * usedEnd);
+            }
+        }
+
+        void BrushRenderer::compact(const size_t maxRelocations) {
+            if (!m_needsCompaction) {
+                return;
+            }
+
+            const ProfileScope profile("BrushRenderer::compact");
+
+            const auto& vertexTracker = m_vertexArray->allocationTracker();
+
+            if (m_compactionStalled || !fragmented(vertexTracker)) {
+                // Shrinking reallocates the VBOs and uploads them in full, so it is done on a frame of its own rather
+                // than on top of the uploads caused by relocating brushes.
+                shrinkIfOversized(*m_vertexArray);
+                shrinkIfOversized(*m_edgeIndices);
+                for (auto& entry : *m_opaqueFaces) {
+                    shrinkIfOversized(*entry.second);
+                }
+                for (auto& entry : *m_transparentFaces) {
+                    shrinkIfOversized(*entry.second);
+                }
+                m_needsCompaction = false;
+                m_compactionStalled = false;
+                return;
+            }
+
+            size_t relocations = 0u;
+            while (relocations < maxRelocations && fragmented(vertexTracker)) {
+                const auto* lastBlock = vertexTracker.lastUsedBlock();
+                assert(lastBlock != nullptr);
+
+                const auto oldPos = lastBlock->pos;
+                const auto* brush = m_vertexBlockToBrush.at(lastBlock);
+                relocateBrush(brush);
+                ++relocations;
+
+                // allocation is best fit, so if there was no hole below the old position that could take the vertices,
+                // they were put right back where they were (or into the free space just before them)
+                const auto it = m_brushInfo.find(brush);
+                if (it != std::end(m_brushInfo) && it->second.vertexHolderKey->pos == oldPos) {
+                    m_compactionStalled = true;
+                    break;
+                }
+            }
+
+            if (relocations > 0u) {
+                m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
+                m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
+                m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            }
+        }
+
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
             assert(vertexCount >= 3);
             const size_t indexCount = 3 * (vertexCount - 2);
@@ -424,6 +598,18 @@ namespace TrenchBroom {
             return false;
         }
 
+        void BrushRenderer::validateDrawRanges() {
+            const ProfileScope profile("BrushRenderer::validateDrawRanges");
+
+            for (auto& entry : *m_opaqueFaces) {
+                entry.second->validateDrawRanges();
+            }
+            for (auto& entry : *m_transparentFaces) {
+                entry.second->validateDrawRanges();
+            }
+            m_edgeIndices->validateDrawRanges();
+        }
+
         void BrushRenderer::validateBrush(const Model::Brush* brush) {
             assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
             assert(m_invalidBrushes.find(brush) != std::end(m_invalidBrushes));
@@ -442,6 +628,7 @@ namespace TrenchBroom {
             }
 
             BrushInfo& info = m_brushInfo[brush];
+            m_opaqueIndexRangesValid = false;
 
             // collect vertices
             auto& brushCache = brush->brushRendererBrushCache();
@@ -453,6 +640,7 @@ namespace TrenchBroom {
             auto [vertBlock, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
             std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
             info.vertexHolderKey = vertBlock;
+            m_vertexBlockToBrush[vertBlock] = brush;
 
             const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
 
@@ -589,6 +777,7 @@ namespace TrenchBroom {
             const BrushInfo& info = it->second;
 
             // update Vbo's
+            m_vertexBlockToBrush.erase(info.vertexHolderKey);
             m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
             if (info.edgeIndicesKey != nullptr) {
                 m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
@@ -614,6 +803,18 @@ namespace TrenchBroom {
             }
 
             m_brushInfo.erase(it);
+            m_needsCompaction = true;
+            m_opaqueIndexRangesValid = false;
+        }
+
+        void BrushRenderer::relocateBrush(const Model::Brush* brush) {
+            assert(m_invalidBrushes.find(brush) == std::end(m_invalidBrushes));
+
+            // validateBrush expects the brush to be invalid
+            m_invalidBrushes.insert(brush);
+            removeBrushFromVbo(brush);
+            validateBrush(brush);
+            m_invalidBrushes.erase(brush);
         }
     }
 }
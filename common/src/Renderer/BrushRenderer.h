@@ -40,6 +40,8 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class OcclusionCuller;
+
         class BrushRenderer {
         public:
             class Filter {
@@ -129,6 +131,38 @@ namespace TrenchBroom {
              * from the VBO later.
              */
             std::unordered_map<const Model::Brush*, BrushInfo> m_brushInfo;
+            /**
+             * Maps the vertex block of every brush in the VBO back to the brush, so that compact() can find the brush
+             * that owns the last block in the vertex array.
+             */
+            std::unordered_map<const AllocationTracker::Block*, const Model::Brush*> m_vertexBlockToBrush;
+            /**
+             * Set whenever brushes are removed from the VBO, cleared once compact() has run out of work.
+             */
+            bool m_needsCompaction;
+            /**
+             * Set when compact() could not move the last brush any further down, so that the next call skips to
+             * shrinking the arrays.
+             */
+            bool m_compactionStalled;
+
+            /**
+             * An opaque face index range of a brush in the VBO, which refers to the brush by its index in
+             * m_opaqueIndexRangeBrushes.
+             */
+            struct OpaqueIndexRange {
+                const Assets::Texture* texture;
+                AllocationTracker::Range range;
+                size_t brushIndex;
+            };
+            /**
+             * Caches the opaque face index ranges of all brushes in the VBO for visibleOpaqueIndexRanges, sorted by
+             * texture and position. Invalidated together with the draw ranges of the index arrays, that is, whenever
+             * brushes are added to or removed from the VBO.
+             */
+            std::vector<const Model::Brush*> m_opaqueIndexRangeBrushes;
+            std::vector<OpaqueIndexRange> m_opaqueIndexRanges;
+            bool m_opaqueIndexRangesValid;
 
             /**
              * If a brush is in the VBO, it's always valid.
@@ -166,6 +200,9 @@ namespace TrenchBroom {
             template <typename FilterT>
             explicit BrushRenderer(const FilterT& filter) :
             m_filter(std::make_unique<FilterT>(filter)),
+            m_needsCompaction(false),
+            m_compactionStalled(false),
+            m_opaqueIndexRangesValid(false),
             m_showEdges(false),
             m_grayscale(false),
             m_tint(false),
@@ -271,7 +308,17 @@ namespace TrenchBroom {
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
-            void renderOpaqueFaces(RenderBatch& renderBatch);
+            void renderOpaqueFaces(RenderContext& renderContext, RenderBatch& renderBatch);
+            /**
+             * Rebuilds the cached opaque index ranges if brushes were added to or removed from the VBO since they were
+             * last built.
+             */
+            void validateOpaqueIndexRanges();
+            /**
+             * Collects the opaque index ranges of the brushes that the given culler considers visible. The ranges of
+             * every texture are sorted by position. Requires the cached opaque index ranges to be valid.
+             */
+            std::shared_ptr<const FaceRenderer::TextureToIndexRangesMap> visibleOpaqueIndexRanges(const OcclusionCuller& culler) const;
             void renderTransparentFaces(RenderBatch& renderBatch);
             void renderEdges(RenderBatch& renderBatch);
 
@@ -280,9 +327,26 @@ namespace TrenchBroom {
              * Only exposed for benchmarking.
              */
             void validate();
+
+            /**
+             * Incrementally defragments the VBOs. Called on frames where no brushes need to be validated.
+             *
+             * Removing brushes leaves holes in the vertex and index arrays, which are only filled again by brushes that
+             * happen to fit. This moves up to `maxRelocations` brushes from the end of the vertex array into the holes
+             * further down. Once the vertex array is compact, the next call releases the free space at the end of the
+             * arrays instead of moving brushes. Shrinking reallocates the VBOs and uploads them in full, so it never
+             * happens on the same frame as any relocations.
+             *
+             * Only exposed for benchmarking.
+             */
+            void compact(size_t maxRelocations);
         private:
             bool shouldDrawFaceInTransparentPass(const Model::Brush* brush, const Model::BrushFace* face) const;
             void validateBrush(const Model::Brush* brush);
+            /**
+             * Builds the draw ranges of all index arrays so that preparing them for rendering only uploads the data.
+             */
+            void validateDrawRanges();
             void addBrush(const Model::Brush* brush);
             void removeBrush(const Model::Brush* brush);
 
@@ -292,6 +356,10 @@ namespace TrenchBroom {
              * The brush's "valid" state is not touched inside here, but the m_brushInfo is updated.
              */
             void removeBrushFromVbo(const Model::Brush* brush);
+            /**
+             * Removes the given brush from the VBO and inserts it again, which moves it into the best fitting holes.
+             */
+            void relocateBrush(const Model::Brush* brush);
         private:
             BrushRenderer(const BrushRenderer& other);
             BrushRenderer& operator=(const BrushRenderer& other);
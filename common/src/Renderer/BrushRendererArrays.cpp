@@ -31,10 +31,10 @@ namespace TrenchBroom {
         // DirtyRangeTracker
 
         DirtyRangeTracker::DirtyRangeTracker(const size_t initial_capacity)
-                : m_dirtyPos(0), m_dirtySize(0), m_capacity(initial_capacity) {}
+                : m_capacity(initial_capacity) {}
 
         DirtyRangeTracker::DirtyRangeTracker()
-                : m_dirtyPos(0), m_dirtySize(0), m_capacity(0) {}
+                : m_capacity(0) {}
 
         void DirtyRangeTracker::expand(const size_t newcap) {
             if (newcap <= m_capacity) {
@@ -56,15 +56,51 @@ namespace TrenchBroom {
                 throw std::invalid_argument("markDirty provided range out of bounds");
             }
 
-            const size_t newPos = std::min(pos, m_dirtyPos);
-            const size_t newEnd = std::max(pos + size, m_dirtyPos + m_dirtySize);
+            if (size == 0) {
+                return;
+            }
+
+            // find the ranges that overlap or touch the new range and replace them with a single range covering all
+            // of them
+            const auto first = std::lower_bound(std::begin(m_dirtyRanges), std::end(m_dirtyRanges), pos,
+                                                [](const Range& range, const size_t p) { return range.pos + range.size < p; });
+            auto last = first;
+            auto merged = Range{pos, size};
+            while (last != std::end(m_dirtyRanges) && last->pos <= pos + size) {
+                const auto end = std::max(merged.pos + merged.size, last->pos + last->size);
+                merged.pos = std::min(merged.pos, last->pos);
+                merged.size = end - merged.pos;
+                ++last;
+            }
 
-            m_dirtyPos = newPos;
-            m_dirtySize = newEnd - newPos;
+            const auto it = m_dirtyRanges.erase(first, last);
+            m_dirtyRanges.insert(it, merged);
+
+            if (m_dirtyRanges.size() > MaxDirtyRanges) {
+                // merge the two neighbouring ranges that are closest to each other
+                size_t minIndex = 0u;
+                size_t minGap = m_capacity;
+                for (size_t i = 0u; i + 1u < m_dirtyRanges.size(); ++i) {
+                    const auto gap = m_dirtyRanges[i + 1u].pos - (m_dirtyRanges[i].pos + m_dirtyRanges[i].size);
+                    if (gap < minGap) {
+                        minGap = gap;
+                        minIndex = i;
+                    }
+                }
+
+                auto& lower = m_dirtyRanges[minIndex];
+                const auto& upper = m_dirtyRanges[minIndex + 1u];
+                lower.size = upper.pos + upper.size - lower.pos;
+                m_dirtyRanges.erase(std::next(std::begin(m_dirtyRanges), static_cast<std::ptrdiff_t>(minIndex + 1u)));
+            }
         }
 
         bool DirtyRangeTracker::clean() const {
-            return m_dirtySize == 0;
+            return m_dirtyRanges.empty();
+        }
+
+        const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::dirtyRanges() const {
+            return m_dirtyRanges;
         }
 
         // IndexHolder
@@ -81,11 +117,48 @@ namespace TrenchBroom {
 
         void IndexHolder::render(const PrimType primType, const size_t offset, size_t count) const {
             const GLsizei renderCount = static_cast<GLsizei>(count);
-            const GLvoid *renderOffset = reinterpret_cast<GLvoid *>(m_vbo->offset() + sizeof(Index) * offset);
+            const GLvoid *renderOffset = indexOffset(offset);
 
             glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
         }
 
+        void IndexHolder::render(const PrimType primType, const std::vector<const GLvoid*>& offsets, const std::vector<GLsizei>& counts) const {
+            assert(offsets.size() == counts.size());
+            if (offsets.empty()) {
+                return;
+            }
+
+            // the offsets are relative to the start of the block, so the block's offset in the VBO must be added
+            const size_t blockOffset = m_vbo->offset();
+            if (blockOffset == 0u) {
+                renderRelativeToBuffer(primType, offsets, counts);
+            } else {
+                std::vector<const GLvoid*> bufferOffsets;
+                bufferOffsets.reserve(offsets.size());
+                for (const auto* offset : offsets) {
+                    bufferOffsets.push_back(reinterpret_cast<const GLvoid*>(blockOffset + reinterpret_cast<size_t>(offset)));
+                }
+                renderRelativeToBuffer(primType, bufferOffsets, counts);
+            }
+        }
+
+        void IndexHolder::renderRelativeToBuffer(const PrimType primType, const std::vector<const GLvoid*>& offsets, const std::vector<GLsizei>& counts) const {
+            if (offsets.size() == 1u) {
+                glAssert(glDrawElements(toGL(primType), counts.front(), glType<Index>(), offsets.front()));
+            } else {
+                const GLsizei drawCount = static_cast<GLsizei>(offsets.size());
+                glAssert(glMultiDrawElements(toGL(primType), counts.data(), glType<Index>(), offsets.data(), drawCount));
+            }
+        }
+
+        const GLvoid* IndexHolder::indexOffset(const size_t offset) const {
+            return reinterpret_cast<GLvoid *>(m_vbo->offset() + sizeof(Index) * offset);
+        }
+
+        const GLvoid* IndexHolder::blockRelativeIndexOffset(const size_t offset) {
+            return reinterpret_cast<const GLvoid*>(sizeof(Index) * offset);
+        }
+
         std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index> &elements) {
             return std::make_shared<IndexHolder>(elements);
         }
@@ -95,13 +168,33 @@ namespace TrenchBroom {
         // BrushIndexArray
 
         BrushIndexArray::BrushIndexArray() : m_indexHolder(),
-                                             m_allocationTracker(0) {}
+                                             m_allocationTracker(0),
+                                             m_drawRangesValid(false) {}
+
+        void BrushIndexArray::updateDrawRanges() {
+            m_drawOffsets.clear();
+            m_drawCounts.clear();
+
+            for (const auto& range : m_allocationTracker.usedRanges()) {
+                m_drawOffsets.push_back(IndexHolder::blockRelativeIndexOffset(range.pos));
+                m_drawCounts.push_back(static_cast<GLsizei>(range.size));
+            }
+            m_drawRangesValid = true;
+        }
+
+        void BrushIndexArray::validateDrawRanges() {
+            if (!m_drawRangesValid) {
+                updateDrawRanges();
+            }
+        }
 
         bool BrushIndexArray::hasValidIndices() const {
             return m_allocationTracker.hasAllocations();
         }
 
         std::pair<AllocationTracker::Block*, GLuint*> BrushIndexArray::getPointerToInsertElementsAt(const size_t elementCount) {
+            m_drawRangesValid = false;
+
             auto block = m_allocationTracker.allocate(elementCount);
             if (block != nullptr) {
                 GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
@@ -126,22 +219,56 @@ namespace TrenchBroom {
             const auto pos = key->pos;
             const auto size = key->size;
             m_allocationTracker.free(key);
+            m_drawRangesValid = false;
 
             m_indexHolder.zeroRange(pos, size);
         }
 
+        void BrushIndexArray::shrink(const size_t newCapacity) {
+            m_allocationTracker.shrink(newCapacity);
+            m_indexHolder.shrink(newCapacity);
+            m_drawRangesValid = false;
+        }
+
+        const AllocationTracker& BrushIndexArray::allocationTracker() const {
+            return m_allocationTracker;
+        }
+
         void BrushIndexArray::render(const PrimType primType) const {
             assert(m_indexHolder.prepared());
-            m_indexHolder.render(primType, 0, m_indexHolder.size());
+            assert(m_drawRangesValid);
+            m_indexHolder.render(primType, m_drawOffsets, m_drawCounts);
+        }
+
+        void BrushIndexArray::render(const PrimType primType, const std::vector<AllocationTracker::Range>& ranges) const {
+            assert(m_indexHolder.prepared());
+
+            std::vector<const GLvoid*> offsets;
+            std::vector<GLsizei> counts;
+            size_t end = 0;
+            for (const auto& range : ranges) {
+                assert(counts.empty() || range.pos >= end);
+                if (!counts.empty() && range.pos == end) {
+                    counts.back() += static_cast<GLsizei>(range.size);
+                } else {
+                    offsets.push_back(IndexHolder::blockRelativeIndexOffset(range.pos));
+                    counts.push_back(static_cast<GLsizei>(range.size));
+                }
+                end = range.pos + range.size;
+            }
+
+            m_indexHolder.render(primType, offsets, counts);
         }
 
         bool BrushIndexArray::prepared() const {
-            return m_indexHolder.prepared();
+            return m_indexHolder.prepared() && m_drawRangesValid;
         }
 
         void BrushIndexArray::prepare(VboManager& vboManager) {
             m_indexHolder.prepare(vboManager);
             assert(m_indexHolder.prepared());
+
+            validateDrawRanges();
         }
 
         void BrushIndexArray::setupIndices() {
@@ -187,6 +314,15 @@ namespace TrenchBroom {
             // us to re-use the space later
         }
 
+        void BrushVertexArray::shrink(const size_t newCapacity) {
+            m_allocationTracker.shrink(newCapacity);
+            m_vertexHolder.shrink(newCapacity);
+        }
+
+        const AllocationTracker& BrushVertexArray::allocationTracker() const {
+            return m_allocationTracker;
+        }
+
         bool BrushVertexArray::setupVertices() {
             return m_vertexHolder.setupVertices();
         }
@@ -30,6 +30,7 @@
 
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <unordered_map>
@@ -37,9 +38,24 @@
 
 namespace TrenchBroom {
     namespace Renderer {
+        /**
+         * Tracks the ranges of an array that were modified since it was last uploaded. Edits far apart from each other
+         * are kept in separate ranges so that uploading them does not also upload everything in between. To bound the
+         * number of uploads, the two ranges with the smallest gap between them are merged once there are more than
+         * MaxDirtyRanges ranges.
+         */
         struct DirtyRangeTracker {
-            size_t m_dirtyPos;
-            size_t m_dirtySize;
+            struct Range {
+                size_t pos;
+                size_t size;
+            };
+
+            static const size_t MaxDirtyRanges = 16u;
+
+            /**
+             * The dirty ranges, sorted by position. They neither overlap nor touch each other.
+             */
+            std::vector<Range> m_dirtyRanges;
             size_t m_capacity;
 
             /**
@@ -55,16 +71,15 @@ namespace TrenchBroom {
             size_t capacity() const;
             void markDirty(size_t pos, size_t size);
             bool clean() const;
+            const std::vector<Range>& dirtyRanges() const;
         };
 
         /**
          * Wrapper around a std::vector<T> and VboBlock.
          *
          * Non-copyable; meant to be held in a std::shared_ptr.
-         * Able to be resized, and handles copying edits made in the local std::vector to the VBO.
-         *
-         * Currently uses a single range to track the modified region which might upload much more than necessary;
-         * it might be worth mapping the VBO and editing it directly.
+         * Able to be resized, and handles copying edits made in the local std::vector to the VBO. Only the ranges
+         * that were modified are uploaded, see DirtyRangeTracker.
          */
         template<typename T>
         class VboHolder {
@@ -140,6 +155,21 @@ namespace TrenchBroom {
                 m_dirtyRange.expand(newSize);
             }
 
+            /**
+             * Discards the elements at and after `newSize` and releases their memory. Since the VBO no longer matches
+             * the snapshot size, the next call to prepare() reallocates the VBO and uploads the whole snapshot.
+             */
+            void shrink(const size_t newSize) {
+                assert(newSize > 0);
+                assert(newSize < m_snapshot.size());
+
+                m_snapshot.resize(newSize);
+                m_snapshot.shrink_to_fit();
+
+                m_dirtyRange = DirtyRangeTracker(newSize);
+                m_dirtyRange.markDirty(0, newSize);
+            }
+
             T* getPointerToWriteElementsTo(const size_t offsetWithinBlock, const size_t elementCount) {
                 assert(offsetWithinBlock + elementCount <= m_snapshot.size());
 
@@ -179,15 +209,11 @@ namespace TrenchBroom {
                 }
 
                 // otherwise, it's an incremental update of the dirty ranges.
-
-                if (!m_dirtyRange.clean()) {
-                    const size_t pos = m_dirtyRange.m_dirtyPos;
-                    const size_t size = m_dirtyRange.m_dirtySize;
-
-                    const size_t bytesFromStart = pos * sizeof(T);
+                for (const auto& range : m_dirtyRange.dirtyRanges()) {
+                    const size_t bytesFromStart = range.pos * sizeof(T);
                     m_vbo->writeArray(bytesFromStart,
-                                      m_snapshot.data() + pos,
-                                      size);
+                                      m_snapshot.data() + range.pos,
+                                      range.size);
                 }
 
                 m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
@@ -222,8 +248,23 @@ namespace TrenchBroom {
             explicit IndexHolder(std::vector<Index>& elements);
             void zeroRange(size_t offsetWithinBlock, size_t count);
             void render(PrimType primType, size_t offset, size_t count) const;
+            /**
+             * Renders the given ranges with a single glMultiDrawElements call. The offsets are given in bytes relative
+             * to the start of this holder's block, as returned by blockRelativeIndexOffset(); the offset of the block
+             * in the VBO is added here.
+             */
+            void render(PrimType primType, const std::vector<const GLvoid*>& offsets, const std::vector<GLsizei>& counts) const;
+            const GLvoid* indexOffset(size_t offset) const;
+
+            /**
+             * Returns the byte offset of the given index relative to the start of the block. Unlike indexOffset(), this
+             * does not require the block to be allocated, so it can be computed before prepare() is called.
+             */
+            static const GLvoid* blockRelativeIndexOffset(size_t offset);
 
             static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
+        private:
+            void renderRelativeToBuffer(PrimType primType, const std::vector<const GLvoid*>& offsets, const std::vector<GLsizei>& counts) const;
         };
 
         /**
@@ -234,6 +275,17 @@ namespace TrenchBroom {
         private:
             IndexHolder m_indexHolder;
             AllocationTracker m_allocationTracker;
+
+            /**
+             * The used ranges of the index array, passed to glMultiDrawElements so that zeroed and free ranges are
+             * skipped when rendering. Rebuilt by validateDrawRanges() whenever the allocations have changed. The offsets
+             * are relative to the start of the index block, which need not be allocated yet.
+             */
+            std::vector<const GLvoid*> m_drawOffsets;
+            std::vector<GLsizei> m_drawCounts;
+            bool m_drawRangesValid;
+
+            void updateDrawRanges();
         public:
             BrushIndexArray();
 
@@ -257,7 +309,24 @@ namespace TrenchBroom {
              */
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Releases the free space at the end of the array, see AllocationTracker::shrink().
+             */
+            void shrink(size_t newCapacity);
+            const AllocationTracker& allocationTracker() const;
+
+            /**
+             * Rebuilds the draw ranges if the allocations have changed since they were last built. This is called by
+             * prepare(), but it does not require an OpenGL context and can be called earlier.
+             */
+            void validateDrawRanges();
+
             void render(const PrimType primType) const;
+            /**
+             * Renders only the given ranges of the index array, which must be sorted by position. Adjacent ranges are
+             * merged.
+             */
+            void render(const PrimType primType, const std::vector<AllocationTracker::Range>& ranges) const;
             bool prepared() const;
             void prepare(VboManager& vboManager);
 
@@ -331,6 +400,12 @@ namespace TrenchBroom {
 
             void deleteVerticesWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Releases the free space at the end of the array, see AllocationTracker::shrink().
+             */
+            void shrink(size_t newCapacity);
+            const AllocationTracker& allocationTracker() const;
+
             // setting up GL attributes
             bool setupVertices();
             void cleanupVertices();
@@ -339,6 +414,104 @@ namespace TrenchBroom {
             bool prepared() const;
             void prepare(VboManager& vboManager);
         };
+
+        /**
+         * Same as BrushVertexArray but for vertices that are rendered directly, without an index array.
+         * Since every vertex in the VBO is drawn, deleteVerticesWithKey() zeroes the deleted vertices so they become
+         * degenerate primitives, like BrushIndexArray::zeroElementsWithKey() does for indices.
+         */
+        template<typename V>
+        class DirectVertexArray {
+        private:
+            VertexHolder<V> m_vertexHolder;
+            AllocationTracker m_allocationTracker;
+        public:
+            DirectVertexArray() :
+            m_vertexHolder(),
+            m_allocationTracker(0) {}
+
+            /**
+             * Returns true if there are any valid vertices to render. Ranges zeroed by deleteVerticesWithKey() do not
+             * count.
+             */
+            bool hasValidVertices() const {
+                return m_allocationTracker.hasAllocations();
+            }
+
+            /**
+             * Call this to request writing the given number of vertices.
+             *
+             * The VboBlock will be expanded if needed to accommodate the allocation.
+             *
+             * Returns a AllocationTracker::Block pointer which can be used later in a call to deleteVerticesWithKey(),
+             * and also a Vertex pointer where the caller should write `vertexCount` Vertex objects.
+             */
+            std::pair<AllocationTracker::Block*, V*> getPointerToInsertVerticesAt(const size_t vertexCount) {
+                auto block = m_allocationTracker.allocate(vertexCount);
+                if (block == nullptr) {
+                    const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
+                                                    m_allocationTracker.capacity() + vertexCount);
+                    m_allocationTracker.expand(newSize);
+                    m_vertexHolder.resize(newSize);
+
+                    block = m_allocationTracker.allocate(vertexCount);
+                    assert(block != nullptr);
+                }
+
+                V* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+                return {block, dest};
+            }
+
+            void deleteVerticesWithKey(AllocationTracker::Block* key) {
+                const auto pos = key->pos;
+                const auto size = key->size;
+                m_allocationTracker.free(key);
+
+                V* dest = m_vertexHolder.getPointerToWriteElementsTo(pos, size);
+                std::fill(dest, dest + size, V());
+            }
+
+            /**
+             * Renders the vertices up to the end of the last allocation. The free space after it is not drawn.
+             */
+            void render(const PrimType primType) const {
+                assert(m_vertexHolder.prepared());
+                const auto count = m_allocationTracker.usedEnd();
+                if (count > 0u) {
+                    glAssert(glDrawArrays(toGL(primType), 0, static_cast<GLsizei>(count)));
+                }
+            }
+
+            /**
+             * Renders only the given ranges of vertices with a single glMultiDrawArrays call.
+             */
+            void render(const PrimType primType, const GLIndices& firsts, const GLCounts& counts) const {
+                assert(m_vertexHolder.prepared());
+                assert(firsts.size() == counts.size());
+                if (!firsts.empty()) {
+                    glAssert(glMultiDrawArrays(toGL(primType), firsts.data(), counts.data(), static_cast<GLsizei>(firsts.size())));
+                }
+            }
+
+            // setting up GL attributes
+            bool setupVertices() {
+                return m_vertexHolder.setupVertices();
+            }
+
+            void cleanupVertices() {
+                m_vertexHolder.cleanupVertices();
+            }
+
+            // uploading the VBO
+            bool prepared() const {
+                return m_vertexHolder.prepared();
+            }
+
+            void prepare(VboManager& vboManager) {
+                m_vertexHolder.prepare(vboManager);
+                assert(m_vertexHolder.prepared());
+            }
+        };
     }
 }
 
@@ -21,13 +21,16 @@
 
 #include "Macros.h"
 #include "Model/AttributableNode.h"
+#include "Model/Brush.h"
 #include "Model/CollectMatchingNodesVisitor.h"
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
 #include "Model/NodeVisitor.h"
 #include "Model/World.h"
 #include "Renderer/ActiveShader.h"
+#include "Renderer/BrushRendererArrays.h"
 #include "Renderer/Camera.h"
+#include "Renderer/FrameProfiler.h"
 #include "Renderer/PrimType.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
@@ -37,9 +40,13 @@
 
 #include <kdl/memory_utils.h>
 
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <set>
 #include <vector>
 
@@ -49,7 +56,10 @@ namespace TrenchBroom {
         m_document(document),
         m_defaultColor(0.5f, 1.0f, 0.5f, 1.0f),
         m_selectedColor(1.0f, 0.0f, 0.0f, 1.0f),
-        m_valid(false) {}
+        m_valid(false),
+        m_graphValid(false) {}
+
+        EntityLinkRenderer::~EntityLinkRenderer() = default;
 
         void EntityLinkRenderer::setDefaultColor(const Color& color) {
             if (color == m_defaultColor)
@@ -71,6 +81,70 @@ namespace TrenchBroom {
 
         void EntityLinkRenderer::invalidate() {
             m_valid = false;
+            m_graphValid = false;
+            m_invalidNodes.clear();
+        }
+
+        class EntityLinkRenderer::CollectLinkedEntitiesVisitor : public Model::NodeVisitor {
+        private:
+            std::unordered_set<const Model::AttributableNode*> m_entities;
+        public:
+            const std::unordered_set<const Model::AttributableNode*>& entities() const {
+                return m_entities;
+            }
+        private:
+            void doVisit(Model::World*) override {}
+            void doVisit(Model::Layer*) override {}
+            void doVisit(Model::Group*) override {}
+            void doVisit(Model::Entity* entity) override {
+                m_entities.insert(entity);
+                stopRecursion();
+            }
+            void doVisit(Model::Brush* brush) override {
+                // the links of a brush entity start at the center of its brushes
+                auto* parent = brush->parent();
+                if (parent != nullptr) {
+                    parent->accept(*this);
+                }
+            }
+        };
+
+        void EntityLinkRenderer::invalidateNodes(const std::vector<Model::Node*>& nodes) {
+            m_valid = false;
+            if (m_graphValid) {
+                CollectLinkedEntitiesVisitor collect;
+                Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), collect);
+                m_invalidNodes.insert(std::begin(collect.entities()), std::end(collect.entities()));
+            }
+        }
+
+        void EntityLinkRenderer::removeNodes(const std::vector<Model::Node*>& nodes) {
+            m_valid = false;
+            if (!m_graphValid) {
+                return;
+            }
+
+            CollectLinkedEntitiesVisitor collect;
+            Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), collect);
+
+            const auto& removedEntities = collect.entities();
+            for (const auto* entity : removedEntities) {
+                m_invalidNodes.erase(entity);
+                removeLinks(entity);
+            }
+
+            // the remaining sources of links to the removed entities must drop these links
+            for (const auto* entity : removedEntities) {
+                const auto it = m_sourcesByTarget.find(entity);
+                if (it != std::end(m_sourcesByTarget)) {
+                    for (const auto* source : it->second) {
+                        if (removedEntities.count(source) == 0u) {
+                            m_invalidNodes.insert(source);
+                        }
+                    }
+                    m_sourcesByTarget.erase(it);
+                }
+            }
         }
 
         void EntityLinkRenderer::doPrepareVertices(VboManager& vboManager) {
@@ -78,15 +152,30 @@ namespace TrenchBroom {
                 validate();
 
                 // Upload the VBO's
-                m_entityLinks.prepare(vboManager);
-                m_entityLinkArrows.prepare(vboManager);
+                if (m_graphValid) {
+                    m_allLinks->prepare(vboManager);
+                    m_allLinkArrows->prepare(vboManager);
+                } else {
+                    m_entityLinks.prepare(vboManager);
+                    m_entityLinkArrows.prepare(vboManager);
+                }
             }
         }
 
         void EntityLinkRenderer::doRender(RenderContext& renderContext) {
             assert(m_valid);
-            renderLines(renderContext);
-            renderArrows(renderContext);
+            const ProfileScope profile("EntityLinkRenderer::render");
+
+            if (m_graphValid) {
+                collectVisibleLinks(renderContext.camera());
+                if (!m_visibleLinkFirsts.empty()) {
+                    renderAllLines(renderContext);
+                    renderAllArrows(renderContext);
+                }
+            } else {
+                renderLines(renderContext);
+                renderArrows(renderContext);
+            }
         }
 
         void EntityLinkRenderer::renderLines(RenderContext& renderContext) {
@@ -117,7 +206,128 @@ namespace TrenchBroom {
             m_entityLinkArrows.render(PrimType::Lines);
         }
 
+        void EntityLinkRenderer::renderAllLines(RenderContext& renderContext) {
+            ActiveShader shader(renderContext.shaderManager(), Shaders::EntityLinkShader);
+            shader.set("CameraPosition", renderContext.camera().position());
+            shader.set("MaxDistance", 6000.0f);
+
+            if (m_allLinks->setupVertices()) {
+                glAssert(glDisable(GL_DEPTH_TEST));
+                shader.set("Alpha", 0.4f);
+                m_allLinks->render(PrimType::Lines, m_visibleLinkFirsts, m_visibleLinkCounts);
+
+                glAssert(glEnable(GL_DEPTH_TEST));
+                shader.set("Alpha", 1.0f);
+                m_allLinks->render(PrimType::Lines, m_visibleLinkFirsts, m_visibleLinkCounts);
+                m_allLinks->cleanupVertices();
+            }
+        }
+
+        void EntityLinkRenderer::renderAllArrows(RenderContext& renderContext) {
+            ActiveShader shader(renderContext.shaderManager(), Shaders::EntityLinkArrowShader);
+            shader.set("CameraPosition", renderContext.camera().position());
+            shader.set("MaxDistance", 6000.0f);
+
+            if (m_allLinkArrows->setupVertices()) {
+                glAssert(glDisable(GL_DEPTH_TEST));
+                shader.set("Alpha", 0.4f);
+                m_allLinkArrows->render(PrimType::Lines, m_visibleArrowFirsts, m_visibleArrowCounts);
+
+                glAssert(glEnable(GL_DEPTH_TEST));
+                shader.set("Alpha", 1.0f);
+                m_allLinkArrows->render(PrimType::Lines, m_visibleArrowFirsts, m_visibleArrowCounts);
+                m_allLinkArrows->cleanupVertices();
+            }
+        }
+
+        /**
+         * Returns whether the given bounds are entirely outside of one of the given frustum planes, whose normals
+         * point out of the frustum.
+         */
+        static bool outsideFrustum(const vm::bbox3f& bounds, const vm::plane3f (&frustumPlanes)[4]) {
+            for (const auto& plane : frustumPlanes) {
+                // the corner of the bounds that is farthest inside the plane
+                const auto corner = vm::vec3f(
+                    plane.normal.x() > 0.0f ? bounds.min.x() : bounds.max.x(),
+                    plane.normal.y() > 0.0f ? bounds.min.y() : bounds.max.y(),
+                    plane.normal.z() > 0.0f ? bounds.min.z() : bounds.max.z());
+                if (plane.point_distance(corner) > 0.0f) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static void addRange(GLIndices& firsts, GLCounts& counts, const AllocationTracker::Block* block) {
+            firsts.push_back(static_cast<GLint>(block->pos));
+            counts.push_back(static_cast<GLsizei>(block->size));
+        }
+
+        /**
+         * Sorts the given ranges and merges adjacent ones to reduce the number of ranges passed to OpenGL.
+         */
+        static void mergeRanges(GLIndices& firsts, GLCounts& counts) {
+            std::vector<std::pair<GLint, GLsizei>> ranges;
+            ranges.reserve(firsts.size());
+            for (size_t i = 0; i < firsts.size(); ++i) {
+                ranges.emplace_back(firsts[i], counts[i]);
+            }
+            std::sort(std::begin(ranges), std::end(ranges));
+
+            firsts.clear();
+            counts.clear();
+            for (const auto& [first, count] : ranges) {
+                if (!firsts.empty() && firsts.back() + counts.back() == first) {
+                    counts.back() += count;
+                } else {
+                    firsts.push_back(first);
+                    counts.push_back(count);
+                }
+            }
+        }
+
+        void EntityLinkRenderer::collectVisibleLinks(const Camera& camera) {
+            m_visibleLinkFirsts.clear();
+            m_visibleLinkCounts.clear();
+            m_visibleArrowFirsts.clear();
+            m_visibleArrowCounts.clear();
+
+            vm::plane3f frustumPlanes[4];
+            camera.frustumPlanes(frustumPlanes[0], frustumPlanes[1], frustumPlanes[2], frustumPlanes[3]);
+
+            for (const auto& entry : m_sourceInfo) {
+                const auto& info = entry.second;
+                if (!outsideFrustum(info.bounds, frustumPlanes)) {
+                    addRange(m_visibleLinkFirsts, m_visibleLinkCounts, info.linkKey);
+                    addRange(m_visibleArrowFirsts, m_visibleArrowCounts, info.arrowKey);
+                }
+            }
+
+            mergeRanges(m_visibleLinkFirsts, m_visibleLinkCounts);
+            mergeRanges(m_visibleArrowFirsts, m_visibleArrowCounts);
+        }
+
         void EntityLinkRenderer::validate() {
+            const ProfileScope profile("EntityLinkRenderer::validate");
+
+            auto document = kdl::mem_lock(m_document);
+            if (document->editorContext().entityLinkMode() == Model::EditorContext::EntityLinkMode_All) {
+                if (m_graphValid) {
+                    validateGraph();
+                } else {
+                    rebuildGraph();
+                }
+
+                // release the memory of the arrays used by the other modes
+                m_entityLinks = VertexArray();
+                m_entityLinkArrows = VertexArray();
+
+                m_valid = true;
+                return;
+            }
+
+            clearGraph();
+
             std::vector<Vertex> links;
             getLinks(links);
 
@@ -131,6 +341,142 @@ namespace TrenchBroom {
             m_valid = true;
         }
 
+        void EntityLinkRenderer::validateGraph() {
+            assert(m_graphValid);
+
+            // the links to an invalid node are stored with their sources, which may be new or former sources
+            CollectLinkedEntitiesVisitor collectSources;
+            for (const auto* node : m_invalidNodes) {
+                Model::Node::accept(std::begin(node->linkSources()), std::end(node->linkSources()), collectSources);
+                Model::Node::accept(std::begin(node->killSources()), std::end(node->killSources()), collectSources);
+            }
+
+            std::unordered_set<const Model::AttributableNode*> sources = collectSources.entities();
+            for (const auto* node : m_invalidNodes) {
+                sources.insert(node);
+
+                const auto it = m_sourcesByTarget.find(node);
+                if (it != std::end(m_sourcesByTarget)) {
+                    sources.insert(std::begin(it->second), std::end(it->second));
+                }
+            }
+            m_invalidNodes.clear();
+
+            auto document = kdl::mem_lock(m_document);
+            const auto& editorContext = document->editorContext();
+            for (const auto* source : sources) {
+                writeLinks(editorContext, source);
+            }
+        }
+
+        void EntityLinkRenderer::rebuildGraph() {
+            clearGraph();
+
+            m_allLinks = std::make_unique<LinkArray>();
+            m_allLinkArrows = std::make_unique<ArrowArray>();
+
+            auto document = kdl::mem_lock(m_document);
+            Model::World* world = document->world();
+            if (world != nullptr) {
+                CollectLinkedEntitiesVisitor collectEntities;
+                world->acceptAndRecurse(collectEntities);
+
+                const auto& editorContext = document->editorContext();
+                for (const auto* entity : collectEntities.entities()) {
+                    writeLinks(editorContext, entity);
+                }
+            }
+
+            m_graphValid = true;
+        }
+
+        void EntityLinkRenderer::clearGraph() {
+            m_sourceInfo.clear();
+            m_sourcesByTarget.clear();
+            m_invalidNodes.clear();
+            m_allLinks.reset();
+            m_allLinkArrows.reset();
+            m_graphValid = false;
+        }
+
+        void EntityLinkRenderer::writeLinks(const Model::EditorContext& editorContext, const Model::AttributableNode* source) {
+            removeLinks(source);
+            if (!editorContext.visible(source)) {
+                return;
+            }
+
+            SourceInfo info;
+            std::vector<Vertex> links;
+
+            const auto addTargets = [&](const std::vector<Model::AttributableNode*>& targets) {
+                for (const auto* target : targets) {
+                    if (editorContext.visible(target)) {
+                        addLink(links, source, target, m_defaultColor, m_selectedColor);
+                        info.targets.push_back(target);
+                    }
+                }
+            };
+            addTargets(source->linkTargets());
+            addTargets(source->killTargets());
+
+            if (links.empty()) {
+                return;
+            }
+
+            std::vector<ArrowVertex> arrows;
+            getArrows(arrows, links);
+
+            // the arrows are at most 9 units away from their lines
+            info.bounds = vm::bbox3f(getVertexComponent<0>(links.front()), getVertexComponent<0>(links.front()));
+            for (const auto& vertex : links) {
+                info.bounds = vm::merge(info.bounds, getVertexComponent<0>(vertex));
+            }
+            info.bounds = info.bounds.expand(9.0f);
+
+            auto [linkKey, linkDest] = m_allLinks->getPointerToInsertVerticesAt(links.size());
+            std::memcpy(linkDest, links.data(), links.size() * sizeof(Vertex));
+            info.linkKey = linkKey;
+
+            auto [arrowKey, arrowDest] = m_allLinkArrows->getPointerToInsertVerticesAt(arrows.size());
+            std::memcpy(arrowDest, arrows.data(), arrows.size() * sizeof(ArrowVertex));
+            info.arrowKey = arrowKey;
+
+            for (const auto* target : info.targets) {
+                m_sourcesByTarget[target].insert(source);
+            }
+            m_sourceInfo.emplace(source, std::move(info));
+        }
+
+        void EntityLinkRenderer::removeLinks(const Model::AttributableNode* source) {
+            const auto it = m_sourceInfo.find(source);
+            if (it == std::end(m_sourceInfo)) {
+                return;
+            }
+
+            const auto& info = it->second;
+            for (const auto* target : info.targets) {
+                const auto targetIt = m_sourcesByTarget.find(target);
+                if (targetIt != std::end(m_sourcesByTarget)) {
+                    targetIt->second.erase(source);
+                    if (targetIt->second.empty()) {
+                        m_sourcesByTarget.erase(targetIt);
+                    }
+                }
+            }
+
+            m_allLinks->deleteVerticesWithKey(info.linkKey);
+            m_allLinkArrows->deleteVerticesWithKey(info.arrowKey);
+            m_sourceInfo.erase(it);
+        }
+
+        void EntityLinkRenderer::addLink(std::vector<Vertex>& links, const Model::AttributableNode* source, const Model::AttributableNode* target, const Color& defaultColor, const Color& selectedColor) {
+            const auto anySelected = source->selected() || source->descendantSelected() || target->selected() || target->descendantSelected();
+            const auto& color = anySelected ? selectedColor : defaultColor;
+
+            links.emplace_back(vm::vec3f(source->linkSourceAnchor()), color);
+            links.emplace_back(vm::vec3f(target->linkTargetAnchor()), color);
+        }
+
         void EntityLinkRenderer::getArrows(std::vector<ArrowVertex>& arrows, const std::vector<Vertex>& links) {
             assert((links.size() % 2) == 0);
             for (size_t i = 0; i < links.size(); i += 2) {
@@ -207,12 +553,7 @@ namespace TrenchBroom {
             virtual void visitEntity(Model::Entity* entity) = 0;
         protected:
             void addLink(const Model::AttributableNode* source, const Model::AttributableNode* target) {
-                const auto anySelected = source->selected() || source->descendantSelected() || target->selected() || target->descendantSelected();
-                const auto& sourceColor = anySelected ? m_selectedColor : m_defaultColor;
-                const auto targetColor = anySelected ? m_selectedColor : m_defaultColor;
-
-                m_links.emplace_back(vm::vec3f(source->linkSourceAnchor()), sourceColor);
-                m_links.emplace_back(vm::vec3f(target->linkTargetAnchor()), targetColor);
+                EntityLinkRenderer::addLink(m_links, source, target, m_defaultColor, m_selectedColor);
             }
         };
 
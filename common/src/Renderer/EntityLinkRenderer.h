@@ -21,21 +21,34 @@
 #define TrenchBroom_EntityLinkRenderer
 
 #include "Color.h"
+#include "Renderer/AllocationTracker.h"
+#include "Renderer/GL.h"
 #include "Renderer/GLVertex.h"
 #include "Renderer/Renderable.h"
 #include "Renderer/VertexArray.h"
 
 #include <vecmath/forward.h>
+#include <vecmath/bbox.h>
 
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Model {
+        class AttributableNode;
+        class EditorContext;
+        class Node;
+    }
+
     namespace View {
         class MapDocument; // FIXME: Renderer should not depend on View
     }
 
     namespace Renderer {
+        class Camera;
+        template <typename V> class DirectVertexArray;
         class RenderBatch;
         class RenderContext;
 
@@ -61,27 +74,89 @@ namespace TrenchBroom {
             VertexArray m_entityLinkArrows;
 
             bool m_valid;
+
+            using LinkArray = DirectVertexArray<Vertex>;
+            using ArrowArray = DirectVertexArray<ArrowVertex>;
+
+            struct SourceInfo {
+                /**
+                 * The targets of the links stored for the source, used to find the sources that link to a node.
+                 */
+                std::vector<const Model::AttributableNode*> targets;
+                AllocationTracker::Block* linkKey;
+                AllocationTracker::Block* arrowKey;
+                /**
+                 * The bounds of the links and their arrows, used to cull links that are outside of the view frustum.
+                 */
+                vm::bbox3f bounds;
+            };
+
+            /**
+             * In "all links" mode, the links of every source are stored in their own block of the VBOs so that they
+             * can be updated when the source or one of its targets changes without collecting all links again.
+             */
+            std::unordered_map<const Model::AttributableNode*, SourceInfo> m_sourceInfo;
+            std::unordered_map<const Model::AttributableNode*, std::unordered_set<const Model::AttributableNode*>> m_sourcesByTarget;
+            std::unordered_set<const Model::AttributableNode*> m_invalidNodes;
+            std::unique_ptr<LinkArray> m_allLinks;
+            std::unique_ptr<ArrowArray> m_allLinkArrows;
+            /**
+             * Whether the link graph above is up to date except for the invalid nodes. This implies that the entity
+             * link mode is "all links".
+             */
+            bool m_graphValid;
+
+            GLIndices m_visibleLinkFirsts;
+            GLCounts m_visibleLinkCounts;
+            GLIndices m_visibleArrowFirsts;
+            GLCounts m_visibleArrowCounts;
         public:
             EntityLinkRenderer(std::weak_ptr<View::MapDocument> document);
+            ~EntityLinkRenderer() override;
 
             void setDefaultColor(const Color& color);
             void setSelectedColor(const Color& color);
 
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
+            /**
+             * Invalidates all links, they will be collected again when the renderer is rendered next.
+             */
             void invalidate();
+            /**
+             * Invalidates the links from and to the entities among the given nodes and their descendants, and the
+             * links from and to the entities containing given brushes. Call this when these nodes were added, changed,
+             * selected, deselected, hidden or shown.
+             */
+            void invalidateNodes(const std::vector<Model::Node*>& nodes);
+            /**
+             * Removes the links from and to the entities among the given nodes and their descendants. Call this when
+             * the given nodes were removed from the map, but before they are deleted.
+             */
+            void removeNodes(const std::vector<Model::Node*>& nodes);
         private:
             void doPrepareVertices(VboManager& vboManager) override;
             void doRender(RenderContext& renderContext) override;
             void renderLines(RenderContext& renderContext);
             void renderArrows(RenderContext& renderContext);
+            void renderAllLines(RenderContext& renderContext);
+            void renderAllArrows(RenderContext& renderContext);
+            void collectVisibleLinks(const Camera& camera);
         private:
             void validate();
 
+            void validateGraph();
+            void rebuildGraph();
+            void clearGraph();
+            void writeLinks(const Model::EditorContext& editorContext, const Model::AttributableNode* source);
+            void removeLinks(const Model::AttributableNode* source);
+
+            static void addLink(std::vector<Vertex>& links, const Model::AttributableNode* source, const Model::AttributableNode* target, const Color& defaultColor, const Color& selectedColor);
             static void getArrows(std::vector<ArrowVertex>& arrows, const std::vector<Vertex>& links);
             static void addArrow(std::vector<ArrowVertex>& arrows, const vm::vec4f& color, const vm::vec3f& arrowPosition, const vm::vec3f& lineDir);
 
             class MatchEntities;
             class CollectEntitiesVisitor;
+            class CollectLinkedEntitiesVisitor;
 
             class CollectLinksVisitor;
             class CollectAllLinksVisitor;
@@ -30,6 +30,7 @@
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
 #include "Renderer/ActiveShader.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/Shaders.h"
@@ -46,7 +47,8 @@ namespace TrenchBroom {
         m_entityModelManager(entityModelManager),
         m_editorContext(editorContext),
         m_applyTinting(false),
-        m_showHiddenEntities(false) {}
+        m_showHiddenEntities(false),
+        m_occlusionCuller(nullptr) {}
 
         EntityModelRenderer::~EntityModelRenderer() {
             clear();
@@ -114,6 +116,10 @@ namespace TrenchBroom {
             m_showHiddenEntities = showHiddenEntities;
         }
 
+        void EntityModelRenderer::setOcclusionCuller(const OcclusionCuller* occlusionCuller) {
+            m_occlusionCuller = occlusionCuller;
+        }
+
         void EntityModelRenderer::render(RenderBatch& renderBatch) {
             renderBatch.add(this);
         }
@@ -140,6 +146,9 @@ namespace TrenchBroom {
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
+                if (m_occlusionCuller != nullptr && !m_occlusionCuller->visible(entity)) {
+                    continue;
+                }
 
                 auto* renderer = entry.second;
 
@@ -38,6 +38,7 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class OcclusionCuller;
         class RenderBatch;
         class TexturedRenderer;
 
@@ -56,6 +57,8 @@ namespace TrenchBroom {
             Color m_tintColor;
 
             bool m_showHiddenEntities;
+
+            const OcclusionCuller* m_occlusionCuller;
         public:
             EntityModelRenderer(Logger& logger, Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext);
             ~EntityModelRenderer() override;
@@ -94,6 +97,12 @@ namespace TrenchBroom {
             bool showHiddenEntities() const;
             void setShowHiddenEntities(bool showHiddenEntities);
 
+            /**
+             * Sets the occlusion culler that determines which models are skipped when this renderer is rendered, or
+             * nullptr to render all models. The culler must stay alive until then.
+             */
+            void setOcclusionCuller(const OcclusionCuller* occlusionCuller);
+
             void render(RenderBatch& renderBatch);
         private:
             void doPrepareVertices(VboManager& vboManager) override;
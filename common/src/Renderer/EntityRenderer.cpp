@@ -19,19 +19,26 @@
 
 #include "EntityRenderer.h"
 
-#include "AttrString.h"
 #include "FloatType.h"
+#include "Macros.h"
 #include "Preferences.h"
 #include "PreferenceManager.h"
 #include "Assets/EntityDefinition.h"
 #include "Assets/EntityModelManager.h"
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
+#include "Renderer/ActiveShader.h"
+#include "Renderer/BrushRendererArrays.h"
 #include "Renderer/Camera.h"
+#include "Renderer/EdgeRenderer.h"
+#include "Renderer/FrameProfiler.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/PrimType.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderService.h"
+#include "Renderer/Shaders.h"
+#include "Renderer/ShaderManager.h"
 #include "Renderer/TextAnchor.h"
 #include "Renderer/GLVertexType.h"
 
@@ -41,6 +48,8 @@
 #include <vecmath/mat_ext.h>
 #include <vecmath/scalar.h>
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 
 namespace TrenchBroom {
@@ -64,11 +73,83 @@ namespace TrenchBroom {
             }
         };
 
+        class EntityRenderer::WireframeBoundsRenderer : public EdgeRenderer {
+        private:
+            class Render : public RenderBase, public DirectRenderable {
+            private:
+                std::shared_ptr<WireframeBoundsArray> m_vertexArray;
+            public:
+                Render(const Params& params, std::shared_ptr<WireframeBoundsArray> vertexArray) :
+                RenderBase(params),
+                m_vertexArray(std::move(vertexArray)) {}
+            private:
+                void doPrepareVertices(VboManager& vboManager) override {
+                    m_vertexArray->prepare(vboManager);
+                }
+
+                void doRender(RenderContext& renderContext) override {
+                    if (m_vertexArray->hasValidVertices()) {
+                        renderEdges(renderContext);
+                    }
+                }
+
+                void doRenderVertices(RenderContext&) override {
+                    m_vertexArray->setupVertices();
+                    m_vertexArray->render(PrimType::Lines);
+                    m_vertexArray->cleanupVertices();
+                }
+            };
+
+            std::shared_ptr<WireframeBoundsArray> m_vertexArray;
+        public:
+            explicit WireframeBoundsRenderer(std::shared_ptr<WireframeBoundsArray> vertexArray) :
+            m_vertexArray(std::move(vertexArray)) {}
+        private:
+            void doRender(RenderBatch& renderBatch, const Params& params) override {
+                renderBatch.addOneShot(new Render(params, m_vertexArray));
+            }
+        };
+
+        class EntityRenderer::SolidBoundsRenderer : public DirectRenderable {
+        private:
+            std::shared_ptr<SolidBoundsArray> m_vertexArray;
+            bool m_applyTinting;
+            Color m_tintColor;
+        public:
+            SolidBoundsRenderer(std::shared_ptr<SolidBoundsArray> vertexArray, const bool applyTinting, const Color& tintColor) :
+            m_vertexArray(std::move(vertexArray)),
+            m_applyTinting(applyTinting),
+            m_tintColor(tintColor) {}
+        private:
+            void doPrepareVertices(VboManager& vboManager) override {
+                m_vertexArray->prepare(vboManager);
+            }
+
+            void doRender(RenderContext& context) override {
+                if (!m_vertexArray->hasValidVertices()) {
+                    return;
+                }
+
+                ActiveShader shader(context.shaderManager(), Shaders::TriangleShader);
+                shader.set("ApplyTinting", m_applyTinting);
+                shader.set("TintColor", m_tintColor);
+                shader.set("UseColor", false);
+                shader.set("Color", Color());
+                shader.set("CameraPosition", context.camera().position());
+
+                m_vertexArray->setupVertices();
+                m_vertexArray->render(PrimType::Quads);
+                m_vertexArray->cleanupVertices();
+            }
+        };
+
         EntityRenderer::EntityRenderer(Logger& logger, Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext) :
         m_entityModelManager(entityModelManager),
         m_editorContext(editorContext),
+        m_pointEntityWireframeBounds(std::make_shared<WireframeBoundsArray>()),
+        m_brushEntityWireframeBounds(std::make_shared<WireframeBoundsArray>()),
+        m_solidBounds(std::make_shared<SolidBoundsArray>()),
         m_modelRenderer(logger, m_entityModelManager, m_editorContext),
-        m_boundsValid(false),
         m_showOverlays(true),
         m_showOccludedOverlays(false),
         m_tint(false),
@@ -78,9 +159,27 @@ namespace TrenchBroom {
         m_showHiddenEntities(false) {}
 
         void EntityRenderer::setEntities(const std::vector<Model::Entity*>& entities) {
+            // start with adding nothing, and removing everything
+            std::unordered_set<const Model::Entity*> toAdd;
+            std::unordered_set<const Model::Entity*> toRemove = m_allEntities;
+
+            // update toAdd and toRemove using the input list
+            for (const auto* entity : entities) {
+                if (toRemove.erase(entity) == 0u) {
+                    toAdd.insert(entity);
+                }
+            }
+
+            for (const auto* entity : toRemove) {
+                removeEntity(entity);
+            }
+            for (const auto* entity : toAdd) {
+                addEntity(entity);
+            }
+
             m_entities = entities;
             m_modelRenderer.setEntities(std::begin(m_entities), std::end(m_entities));
-            invalidate();
+            reloadModels();
         }
 
         void EntityRenderer::invalidate() {
@@ -88,11 +187,28 @@ namespace TrenchBroom {
             reloadModels();
         }
 
+        void EntityRenderer::invalidateEntities(const std::vector<Model::Entity*>& entities) {
+            for (const auto* entity : entities) {
+                // skip entities that are not in the renderer
+                if (m_allEntities.find(entity) == std::end(m_allEntities)) {
+                    assert(m_entityInfo.find(entity) == std::end(m_entityInfo));
+                    continue;
+                }
+                // if it's not in the invalid set, put it in
+                if (m_invalidEntities.insert(entity).second) {
+                    removeEntityFromVbo(entity);
+                }
+            }
+        }
+
         void EntityRenderer::clear() {
             m_entities.clear();
-            m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer();
-            m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer();
-            m_solidBoundsRenderer = TriangleRenderer();
+            m_entityInfo.clear();
+            m_allEntities.clear();
+            m_invalidEntities.clear();
+            m_pointEntityWireframeBounds = std::make_shared<WireframeBoundsArray>();
+            m_brushEntityWireframeBounds = std::make_shared<WireframeBoundsArray>();
+            m_solidBounds = std::make_shared<SolidBoundsArray>();
             m_modelRenderer.clear();
         }
 
@@ -125,11 +241,19 @@ namespace TrenchBroom {
         }
 
         void EntityRenderer::setOverrideBoundsColor(const bool overrideBoundsColor) {
-            m_overrideBoundsColor = overrideBoundsColor;
+            // the cached bounds vertices depend on this setting
+            if (overrideBoundsColor != m_overrideBoundsColor) {
+                m_overrideBoundsColor = overrideBoundsColor;
+                invalidateBounds();
+            }
         }
 
         void EntityRenderer::setBoundsColor(const Color& boundsColor) {
-            m_boundsColor = boundsColor;
+            // the cached bounds vertices of entities without a definition use this color
+            if (boundsColor != m_boundsColor) {
+                m_boundsColor = boundsColor;
+                invalidateBounds();
+            }
         }
 
         void EntityRenderer::setShowOccludedBounds(const bool showOccludedBounds) {
@@ -153,6 +277,7 @@ namespace TrenchBroom {
         }
 
         void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
+            const ProfileScope profile("EntityRenderer::render");
             if (!m_entities.empty()) {
                 renderBounds(renderContext, renderBatch);
                 renderModels(renderContext, renderBatch);
@@ -162,7 +287,7 @@ namespace TrenchBroom {
         }
 
         void EntityRenderer::renderBounds(RenderContext& renderContext, RenderBatch& renderBatch) {
-            if (!m_boundsValid)
+            if (!m_invalidEntities.empty())
                 validateBounds();
 
             if (renderContext.showPointEntityBounds()) {
@@ -177,23 +302,23 @@ namespace TrenchBroom {
         }
 
         void EntityRenderer::renderPointEntityWireframeBounds(RenderBatch& renderBatch) {
+            WireframeBoundsRenderer renderer(m_pointEntityWireframeBounds);
             if (m_showOccludedBounds) {
-                m_pointEntityWireframeBoundsRenderer.renderOnTop(renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
+                renderer.renderOnTop(renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
             }
-            m_pointEntityWireframeBoundsRenderer.render(renderBatch, m_overrideBoundsColor, m_boundsColor);
+            renderer.render(renderBatch, m_overrideBoundsColor, m_boundsColor);
         }
 
         void EntityRenderer::renderBrushEntityWireframeBounds(RenderBatch& renderBatch) {
+            WireframeBoundsRenderer renderer(m_brushEntityWireframeBounds);
             if (m_showOccludedBounds) {
-                m_brushEntityWireframeBoundsRenderer.renderOnTop(renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
+                renderer.renderOnTop(renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
             }
-            m_brushEntityWireframeBoundsRenderer.render(renderBatch, m_overrideBoundsColor, m_boundsColor);
+            renderer.render(renderBatch, m_overrideBoundsColor, m_boundsColor);
         }
 
         void EntityRenderer::renderSolidBounds(RenderBatch& renderBatch) {
-            m_solidBoundsRenderer.setApplyTinting(m_tint);
-            m_solidBoundsRenderer.setTintColor(m_tintColor);
-            renderBatch.add(&m_solidBoundsRenderer);
+            renderBatch.addOneShot(new SolidBoundsRenderer(m_solidBounds, m_tint, m_tintColor));
         }
 
         void EntityRenderer::renderModels(RenderContext& renderContext, RenderBatch& renderBatch) {
@@ -202,26 +327,36 @@ namespace TrenchBroom {
                 m_modelRenderer.setApplyTinting(m_tint);
                 m_modelRenderer.setTintColor(m_tintColor);
                 m_modelRenderer.setShowHiddenEntities(m_showHiddenEntities);
+                m_modelRenderer.setOcclusionCuller(renderContext.occlusionCuller());
                 m_modelRenderer.render(renderBatch);
             }
         }
 
         void EntityRenderer::renderClassnames(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (m_showOverlays && renderContext.showEntityClassnames()) {
+                const ProfileScope profile("EntityRenderer::renderClassnames");
                 Renderer::RenderService renderService(renderContext, renderBatch);
                 renderService.setForegroundColor(m_overlayTextColor);
                 renderService.setBackgroundColor(m_overlayBackgroundColor);
+                if (m_showOccludedOverlays)
+                    renderService.setShowOccludedObjects();
+                else
+                    renderService.setHideOccludedObjects();
 
+                const auto* culler = renderContext.occlusionCuller();
                 for (const Model::Entity* entity : m_entities) {
-                    if (m_showHiddenEntities || m_editorContext.visible(entity)) {
-                        if (entity->group() == nullptr || entity->group() == m_editorContext.currentGroup()) {
-                            if (m_showOccludedOverlays)
-                                renderService.setShowOccludedObjects();
-                            else
-                                renderService.setHideOccludedObjects();
-                            renderService.renderString(entityString(entity), EntityClassnameAnchor(entity));
-                        }
+                    if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
+                        continue;
+                    }
+                    if (entity->group() != nullptr && entity->group() != m_editorContext.currentGroup()) {
+                        continue;
+                    }
+                    if (culler != nullptr && !culler->visible(entity)) {
+                        continue;
                     }
+
+                    // the text renderer culls by distance before it looks up the cached layout of the classname
+                    renderService.renderString(entity->classname(), EntityClassnameAnchor(entity));
                 }
             }
         }
@@ -282,7 +417,7 @@ namespace TrenchBroom {
         }
 
         struct EntityRenderer::BuildColoredSolidBoundsVertices {
-            using Vertex = GLVertexTypes::P3NC4::Vertex;
+            using Vertex = SolidVertex;
 
             std::vector<Vertex>& vertices;
             Color color;
@@ -300,7 +435,7 @@ namespace TrenchBroom {
         };
 
         struct EntityRenderer::BuildColoredWireframeBoundsVertices {
-            using Vertex = GLVertexTypes::P3C4::Vertex;
+            using Vertex = WireframeVertex;
 
             std::vector<Vertex>& vertices;
             Color color;
@@ -315,100 +450,126 @@ namespace TrenchBroom {
             }
         };
 
-        struct EntityRenderer::BuildWireframeBoundsVertices {
-            std::vector<GLVertexTypes::P3::Vertex>& vertices;
-
-            explicit BuildWireframeBoundsVertices(std::vector<GLVertexTypes::P3::Vertex>& i_vertices) :
-            vertices(i_vertices) {}
-
-            void operator()(const vm::vec3& v1, const vm::vec3& v2) {
-                vertices.emplace_back(vm::vec3f(v1));
-                vertices.emplace_back(vm::vec3f(v2));
+        void EntityRenderer::invalidateBounds() {
+            for (const auto* entity : m_allEntities) {
+                // this will also invalidate already invalid entities, which
+                // is unnecessary
+                removeEntityFromVbo(entity);
             }
-        };
+            m_invalidEntities = m_allEntities;
 
-        void EntityRenderer::invalidateBounds() {
-            m_boundsValid = false;
+            assert(m_entityInfo.empty());
         }
 
         void EntityRenderer::validateBounds() {
-            std::vector<GLVertexTypes::P3NC4::Vertex> solidVertices;
-            solidVertices.reserve(36 * m_entities.size());
+            const ProfileScope profile("EntityRenderer::validateBounds");
 
-            if (m_overrideBoundsColor) {
-                using Vertex = GLVertexTypes::P3::Vertex;
-                std::vector<Vertex> pointEntityWireframeVertices;
-                std::vector<Vertex> brushEntityWireframeVertices;
+            std::vector<WireframeVertex> wireframeVertices;
+            std::vector<SolidVertex> solidVertices;
+            wireframeVertices.reserve(24);
+            solidVertices.reserve(24);
 
-                pointEntityWireframeVertices.reserve(24 * m_entities.size());
-                brushEntityWireframeVertices.reserve(24 * m_entities.size());
+            for (const auto* entity : m_invalidEntities) {
+                validateEntityBounds(entity, wireframeVertices, solidVertices);
+            }
+            m_invalidEntities.clear();
+        }
 
-                BuildWireframeBoundsVertices pointEntityWireframeBoundsBuilder(pointEntityWireframeVertices);
-                BuildWireframeBoundsVertices brushEntityWireframeBoundsBuilder(brushEntityWireframeVertices);
+        void EntityRenderer::validateEntityBounds(const Model::Entity* entity, std::vector<WireframeVertex>& wireframeVertices, std::vector<SolidVertex>& solidVertices) {
+            assert(m_allEntities.find(entity) != std::end(m_allEntities));
+            assert(m_entityInfo.find(entity) == std::end(m_entityInfo));
 
-                for (const Model::Entity* entity : m_entities) {
-                    if (m_editorContext.visible(entity)) {
-                        const bool pointEntity = !entity->hasChildren();
-                        if (pointEntity) {
-                            entity->definitionBounds().for_each_edge(pointEntityWireframeBoundsBuilder);
-                        } else {
-                            entity->logicalBounds().for_each_edge(brushEntityWireframeBoundsBuilder);
-                        }
-
-                        if (pointEntity && !entity->hasPointEntityModel()) {
-                            BuildColoredSolidBoundsVertices solidBoundsBuilder(solidVertices, boundsColor(entity));
-                            entity->logicalBounds().for_each_face(solidBoundsBuilder);
-                        }
-                    }
-                }
+            if (!m_editorContext.visible(entity)) {
+                // NOTE: this skips inserting the entity into m_entityInfo
+                return;
+            }
 
-                m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines);
-                m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines);
-            } else {
-                using Vertex = GLVertexTypes::P3C4::Vertex;
-                std::vector<Vertex> pointEntityWireframeVertices;
-                std::vector<Vertex> brushEntityWireframeVertices;
+            wireframeVertices.clear();
+            solidVertices.clear();
 
-                pointEntityWireframeVertices.reserve(24 * m_entities.size());
-                brushEntityWireframeVertices.reserve(24 * m_entities.size());
+            BuildColoredWireframeBoundsVertices wireframeBoundsBuilder(wireframeVertices, boundsColor(entity));
+            BuildColoredSolidBoundsVertices solidBoundsBuilder(solidVertices, boundsColor(entity));
 
-                for (const Model::Entity* entity : m_entities) {
-                    if (m_editorContext.visible(entity)) {
-                        const bool pointEntity = !entity->hasChildren();
-
-                        if (pointEntity && !entity->hasPointEntityModel()) {
-                            BuildColoredSolidBoundsVertices solidBoundsBuilder(solidVertices, boundsColor(entity));
-                            entity->definitionBounds().for_each_face(solidBoundsBuilder);
-                        } else {
-                            BuildColoredWireframeBoundsVertices pointEntityWireframeBoundsBuilder(pointEntityWireframeVertices, boundsColor(entity));
-                            BuildColoredWireframeBoundsVertices brushEntityWireframeBoundsBuilder(brushEntityWireframeVertices, boundsColor(entity));
-
-                            if (pointEntity) {
-                                entity->definitionBounds().for_each_edge(pointEntityWireframeBoundsBuilder);
-                            } else {
-                                entity->logicalBounds().for_each_edge(brushEntityWireframeBoundsBuilder);
-                            }
-                        }
-                    }
+            const bool pointEntity = !entity->hasChildren();
+            const bool solid = pointEntity && !entity->hasPointEntityModel();
+            if (m_overrideBoundsColor) {
+                if (pointEntity) {
+                    entity->definitionBounds().for_each_edge(wireframeBoundsBuilder);
+                } else {
+                    entity->logicalBounds().for_each_edge(wireframeBoundsBuilder);
+                }
+                if (solid) {
+                    entity->logicalBounds().for_each_face(solidBoundsBuilder);
                 }
+            } else {
+                if (solid) {
+                    entity->definitionBounds().for_each_face(solidBoundsBuilder);
+                } else if (pointEntity) {
+                    entity->definitionBounds().for_each_edge(wireframeBoundsBuilder);
+                } else {
+                    entity->logicalBounds().for_each_edge(wireframeBoundsBuilder);
+                }
+            }
+
+            EntityInfo info{nullptr, nullptr, nullptr};
+            if (!wireframeVertices.empty()) {
+                auto& vertexArray = pointEntity ? m_pointEntityWireframeBounds : m_brushEntityWireframeBounds;
+                auto [key, dest] = vertexArray->getPointerToInsertVerticesAt(wireframeVertices.size());
+                std::copy(std::begin(wireframeVertices), std::end(wireframeVertices), dest);
+                if (pointEntity) {
+                    info.pointEntityWireframeKey = key;
+                } else {
+                    info.brushEntityWireframeKey = key;
+                }
+            }
+            if (!solidVertices.empty()) {
+                auto [key, dest] = m_solidBounds->getPointerToInsertVerticesAt(solidVertices.size());
+                std::copy(std::begin(solidVertices), std::end(solidVertices), dest);
+                info.solidKey = key;
+            }
+
+            m_entityInfo.emplace(entity, info);
+        }
+
+        void EntityRenderer::addEntity(const Model::Entity* entity) {
+            assert(m_allEntities.find(entity) == std::end(m_allEntities));
 
-                m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines);
-                m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines);
+            m_allEntities.insert(entity);
+            m_invalidEntities.insert(entity);
+        }
+
+        void EntityRenderer::removeEntity(const Model::Entity* entity) {
+            assertResult(m_allEntities.erase(entity) > 0u);
+
+            if (m_invalidEntities.erase(entity) > 0u) {
+                // invalid entities are not in the VBOs, so we can return now.
+                assert(m_entityInfo.find(entity) == std::end(m_entityInfo));
+                return;
             }
 
-            m_solidBoundsRenderer = TriangleRenderer(VertexArray::move(std::move(solidVertices)), PrimType::Quads);
-            m_boundsValid = true;
+            removeEntityFromVbo(entity);
         }
 
-        AttrString EntityRenderer::entityString(const Model::Entity* entity) const {
-            const auto& classname = entity->classname();
-            // const Model::AttributeValue& targetname = entity->attribute(Model::AttributeNames::Targetname);
+        void EntityRenderer::removeEntityFromVbo(const Model::Entity* entity) {
+            auto it = m_entityInfo.find(entity);
+            if (it == std::end(m_entityInfo)) {
+                // This means EntityRenderer::validateEntityBounds skipped the entity, so it was never
+                // uploaded to the VBOs
+                return;
+            }
+
+            const EntityInfo& info = it->second;
+            if (info.pointEntityWireframeKey != nullptr) {
+                m_pointEntityWireframeBounds->deleteVerticesWithKey(info.pointEntityWireframeKey);
+            }
+            if (info.brushEntityWireframeKey != nullptr) {
+                m_brushEntityWireframeBounds->deleteVerticesWithKey(info.brushEntityWireframeKey);
+            }
+            if (info.solidKey != nullptr) {
+                m_solidBounds->deleteVerticesWithKey(info.solidKey);
+            }
 
-            AttrString str;
-            str.appendCentered(classname);
-            // if (!targetname.empty())
-               // str.appendCentered(targetname);
-            return str;
+            m_entityInfo.erase(it);
         }
 
         const Color& EntityRenderer::boundsColor(const Model::Entity* entity) const {
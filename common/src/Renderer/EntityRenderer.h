@@ -21,13 +21,16 @@
 #define TrenchBroom_EntityRenderer
 
 #include "Color.h"
-#include "Renderer/EdgeRenderer.h"
+#include "Renderer/AllocationTracker.h"
 #include "Renderer/EntityModelRenderer.h"
+#include "Renderer/GLVertexType.h"
 #include "Renderer/Renderable.h"
-#include "Renderer/TriangleRenderer.h"
 
 #include <vecmath/forward.h>
 
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -43,22 +46,46 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
-        class AttrString;
+        template <typename V> class DirectVertexArray;
 
         class EntityRenderer {
         private:
             class EntityClassnameAnchor;
+            class WireframeBoundsRenderer;
+            class SolidBoundsRenderer;
+
+            using WireframeVertex = GLVertexTypes::P3C4::Vertex;
+            using SolidVertex = GLVertexTypes::P3NC4::Vertex;
+            using WireframeBoundsArray = DirectVertexArray<WireframeVertex>;
+            using SolidBoundsArray = DirectVertexArray<SolidVertex>;
 
             Assets::EntityModelManager& m_entityModelManager;
             const Model::EditorContext& m_editorContext;
             std::vector<Model::Entity*> m_entities;
 
-            DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
-            DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
+            struct EntityInfo {
+                AllocationTracker::Block* pointEntityWireframeKey;
+                AllocationTracker::Block* brushEntityWireframeKey;
+                AllocationTracker::Block* solidKey;
+            };
+            /**
+             * Tracks all entities whose bounds are stored in the VBOs, with the information necessary to remove them
+             * from the VBOs later.
+             */
+            std::unordered_map<const Model::Entity*, EntityInfo> m_entityInfo;
+
+            /**
+             * If an entity's bounds are in the VBOs, they are always valid.
+             * If an entity is valid, its bounds might not be in the VBOs if it is hidden.
+             */
+            std::unordered_set<const Model::Entity*> m_allEntities;
+            std::unordered_set<const Model::Entity*> m_invalidEntities;
+
+            std::shared_ptr<WireframeBoundsArray> m_pointEntityWireframeBounds;
+            std::shared_ptr<WireframeBoundsArray> m_brushEntityWireframeBounds;
+            std::shared_ptr<SolidBoundsArray> m_solidBounds;
 
-            TriangleRenderer m_solidBoundsRenderer;
             EntityModelRenderer m_modelRenderer;
-            bool m_boundsValid;
 
             bool m_showOverlays;
             Color m_overlayTextColor;
@@ -76,8 +103,16 @@ namespace TrenchBroom {
         public:
             EntityRenderer(Logger& logger, Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext);
 
+            /**
+             * New entities are invalidated, entities already in the EntityRenderer are not invalidated.
+             */
             void setEntities(const std::vector<Model::Entity*>& entities);
             void invalidate();
+            /**
+             * Marks the bounds of the given entities as invalid so that only their vertices are rewritten the next
+             * time the bounds are rendered. Entities that are not in the EntityRenderer are ignored.
+             */
+            void invalidateEntities(const std::vector<Model::Entity*>& entities);
             void clear();
             void reloadModels();
 
@@ -113,12 +148,15 @@ namespace TrenchBroom {
 
             struct BuildColoredSolidBoundsVertices;
             struct BuildColoredWireframeBoundsVertices;
-            struct BuildWireframeBoundsVertices;
 
             void invalidateBounds();
             void validateBounds();
+            void validateEntityBounds(const Model::Entity* entity, std::vector<WireframeVertex>& wireframeVertices, std::vector<SolidVertex>& solidVertices);
+
+            void addEntity(const Model::Entity* entity);
+            void removeEntity(const Model::Entity* entity);
+            void removeEntityFromVbo(const Model::Entity* entity);
 
-            AttrString entityString(const Model::Entity* entity) const;
             const Color& boundsColor(const Model::Entity* entity) const;
         };
     }
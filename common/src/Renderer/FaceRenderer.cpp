@@ -32,6 +32,10 @@
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderManager.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Renderer {
         struct FaceRenderer::RenderFunc : public TextureRenderFunc {
@@ -62,6 +66,32 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * Renders textures from their layers in the texture arrays they were packed into. Expects the textures to be
+         * sorted by texture array, and binds each texture array when it is first encountered.
+         */
+        struct FaceRenderer::TextureArrayRenderFunc : public TextureRenderFunc {
+            ActiveShader& shader;
+            GLuint boundTextureArrayId;
+
+            explicit TextureArrayRenderFunc(ActiveShader& i_shader) :
+            shader(i_shader),
+            boundTextureArrayId(0) {}
+
+            void before(const Assets::Texture* texture) override {
+                if (texture->textureArrayId() != boundTextureArrayId) {
+                    boundTextureArrayId = texture->textureArrayId();
+                    glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, boundTextureArrayId));
+                }
+                texture->activateLayer();
+                shader.set("TextureLayer", static_cast<float>(texture->textureArrayLayer()));
+            }
+
+            void after(const Assets::Texture* texture) override {
+                texture->deactivateLayer();
+            }
+        };
+
         FaceRenderer::FaceRenderer() :
         m_grayscale(false),
         m_tint(false),
@@ -79,6 +109,7 @@ namespace TrenchBroom {
         IndexedRenderable(other),
         m_vertexArray(other.m_vertexArray),
         m_indexArrayMap(other.m_indexArrayMap),
+        m_visibleIndexRanges(other.m_visibleIndexRanges),
         m_faceColor(other.m_faceColor),
         m_grayscale(other.m_grayscale),
         m_tint(other.m_tint),
@@ -95,6 +126,7 @@ namespace TrenchBroom {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
             swap(left.m_indexArrayMap, right.m_indexArrayMap);
+            swap(left.m_visibleIndexRanges, right.m_visibleIndexRanges);
             swap(left.m_faceColor, right.m_faceColor);
             swap(left.m_grayscale, right.m_grayscale);
             swap(left.m_tint, right.m_tint);
@@ -118,6 +150,10 @@ namespace TrenchBroom {
             m_alpha = alpha;
         }
 
+        void FaceRenderer::setVisibleIndexRanges(std::shared_ptr<const TextureToIndexRangesMap> visibleIndexRanges) {
+            m_visibleIndexRanges = std::move(visibleIndexRanges);
+        }
+
         void FaceRenderer::render(RenderBatch& renderBatch) {
             renderBatch.add(this);
         }
@@ -151,58 +187,118 @@ namespace TrenchBroom {
                 return;
 
             if (m_vertexArray->setupVertices()) {
-                ShaderManager& shaderManager = context.shaderManager();
-                ActiveShader shader(shaderManager, Shaders::FaceShader);
-                PreferenceManager& prefs = PreferenceManager::instance();
-
                 const bool applyTexture = context.showTextures();
-                const bool shadeFaces = context.shadeFaces();
-                const bool showFog = context.showFog();
+
+                // textures that were packed into texture arrays are rendered with a shader that samples the arrays,
+                // sorted so that each texture array is bound only once
+                auto arrayTextures = std::vector<const TextureAndIndices*>();
+                auto textures = std::vector<const TextureAndIndices*>();
+                for (const auto& entry : *m_indexArrayMap) {
+                    const auto* texture = entry.first;
+                    if (applyTexture && texture != nullptr && texture->inTextureArray()) {
+                        arrayTextures.push_back(&entry);
+                    } else {
+                        textures.push_back(&entry);
+                    }
+                }
+                std::sort(std::begin(arrayTextures), std::end(arrayTextures), [](const auto* lhs, const auto* rhs) {
+                    return std::make_pair(lhs->first->textureArrayId(), lhs->first->textureArrayLayer()) <
+                           std::make_pair(rhs->first->textureArrayId(), rhs->first->textureArrayLayer());
+                });
 
                 glAssert(glEnable(GL_TEXTURE_2D));
                 glAssert(glActiveTexture(GL_TEXTURE0));
-                shader.set("Brightness", prefs.get(Preferences::Brightness));
-                shader.set("RenderGrid", context.showGrid());
-                shader.set("GridSize", static_cast<float>(context.gridSize()));
-                shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
-                shader.set("ApplyTexture", applyTexture);
-                shader.set("Texture", 0);
-                shader.set("ApplyTinting", m_tint);
-                if (m_tint)
-                    shader.set("TintColor", m_tintColor);
-                shader.set("GrayScale", m_grayscale);
-                shader.set("CameraPosition", context.camera().position());
-                shader.set("ShadeFaces", shadeFaces);
-                shader.set("ShowFog", showFog);
-                shader.set("Alpha", m_alpha);
-                shader.set("EnableMasked", false);
-
-                RenderFunc func(shader, applyTexture, m_faceColor);
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_FALSE));
                 }
-                for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap) {
-                    if (!brushIndexHolderPtr->hasValidIndices()) {
-                        continue;
-                    }
 
-                    const bool enableMasked = texture != nullptr && texture->masked();
-                    
-                    // set any per-texture uniforms
-                    shader.set("GridColor", gridColorForTexture(texture));
-                    shader.set("EnableMasked", enableMasked);
+                if (!arrayTextures.empty()) {
+                    ActiveShader shader(context.shaderManager(), Shaders::FaceTextureArrayShader);
+                    setupShader(context, shader, applyTexture);
 
-                    func.before(texture);
-                    brushIndexHolderPtr->setupIndices();
-                    brushIndexHolderPtr->render(PrimType::Triangles);
-                    brushIndexHolderPtr->cleanupIndices();
-                    func.after(texture);
+                    TextureArrayRenderFunc func(shader);
+                    renderTextures(shader, func, arrayTextures);
+                    glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY_EXT, 0));
                 }
+
+                if (!textures.empty()) {
+                    ActiveShader shader(context.shaderManager(), Shaders::FaceShader);
+                    setupShader(context, shader, applyTexture);
+
+                    RenderFunc func(shader, applyTexture, m_faceColor);
+                    renderTextures(shader, func, textures);
+                }
+
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_TRUE));
                 }
                 m_vertexArray->cleanupVertices();
             }
         }
+
+        void FaceRenderer::setupShader(RenderContext& context, ActiveShader& shader, const bool applyTexture) const {
+            PreferenceManager& prefs = PreferenceManager::instance();
+
+            shader.set("Brightness", prefs.get(Preferences::Brightness));
+            shader.set("RenderGrid", context.showGrid());
+            shader.set("GridSize", static_cast<float>(context.gridSize()));
+            shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
+            shader.set("ApplyTexture", applyTexture);
+            shader.set("Texture", 0);
+            shader.set("ApplyTinting", m_tint);
+            if (m_tint)
+                shader.set("TintColor", m_tintColor);
+            shader.set("GrayScale", m_grayscale);
+            shader.set("CameraPosition", context.camera().position());
+            shader.set("ShadeFaces", context.shadeFaces());
+            shader.set("ShowFog", context.showFog());
+            shader.set("Alpha", m_alpha);
+            shader.set("EnableMasked", false);
+        }
+
+        void FaceRenderer::renderTextures(ActiveShader& shader, TextureRenderFunc& func, const std::vector<const TextureAndIndices*>& textures) const {
+            // with thousands of textures, the per-texture uniforms add up, so only set them when they change
+            bool lastEnableMasked = false;
+            auto lastGridColor = vm::vec3f::fill(-1.0f);
+            for (const auto* entry : textures) {
+                const auto* texture = entry->first;
+                const auto& brushIndexHolderPtr = entry->second;
+                if (!brushIndexHolderPtr->hasValidIndices()) {
+                    continue;
+                }
+
+                const std::vector<AllocationTracker::Range>* visibleRanges = nullptr;
+                if (m_visibleIndexRanges != nullptr) {
+                    const auto it = m_visibleIndexRanges->find(texture);
+                    if (it == std::end(*m_visibleIndexRanges)) {
+                        continue;
+                    }
+                    visibleRanges = &it->second;
+                }
+
+                const bool enableMasked = texture != nullptr && texture->masked();
+                const auto gridColor = gridColorForTexture(texture);
+
+                // set any per-texture uniforms
+                if (gridColor != lastGridColor) {
+                    shader.set("GridColor", gridColor);
+                    lastGridColor = gridColor;
+                }
+                if (enableMasked != lastEnableMasked) {
+                    shader.set("EnableMasked", enableMasked);
+                    lastEnableMasked = enableMasked;
+                }
+
+                func.before(texture);
+                brushIndexHolderPtr->setupIndices();
+                if (visibleRanges != nullptr) {
+                    brushIndexHolderPtr->render(PrimType::Triangles, *visibleRanges);
+                } else {
+                    brushIndexHolderPtr->render(PrimType::Triangles);
+                }
+                brushIndexHolderPtr->cleanupIndices();
+                func.after(texture);
+            }
+        }
     }
 }
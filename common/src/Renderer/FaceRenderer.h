@@ -21,6 +21,7 @@
 #define TrenchBroom_FaceRenderer
 
 #include "Color.h"
+#include "Renderer/AllocationTracker.h"
 #include "Renderer/Renderable.h"
 
 #include <vecmath/forward.h>
@@ -28,6 +29,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -35,18 +37,28 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class ActiveShader;
         class BrushIndexArray;
         class BrushVertexArray;
         class RenderBatch;
+        class TextureRenderFunc;
 
         class FaceRenderer : public IndexedRenderable {
+        public:
+            /**
+             * Maps each texture to the ranges of its index array that should be rendered, sorted by position.
+             */
+            using TextureToIndexRangesMap = std::unordered_map<const Assets::Texture*, std::vector<AllocationTracker::Range>>;
         private:
             struct RenderFunc;
+            struct TextureArrayRenderFunc;
 
             using TextureToBrushIndicesMap = const std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+            using TextureAndIndices = TextureToBrushIndicesMap::value_type;
 
             std::shared_ptr<BrushVertexArray> m_vertexArray;
             std::shared_ptr<TextureToBrushIndicesMap> m_indexArrayMap;
+            std::shared_ptr<const TextureToIndexRangesMap> m_visibleIndexRanges;
             Color m_faceColor;
             bool m_grayscale;
             bool m_tint;
@@ -65,11 +77,20 @@ namespace TrenchBroom {
             void setTintColor(const Color& color);
             void setAlpha(float alpha);
 
+            /**
+             * Restricts rendering to the given index ranges, e.g. to skip occluded brushes. Textures that are not in
+             * the given map are not rendered at all. If null is passed, all indices are rendered.
+             */
+            void setVisibleIndexRanges(std::shared_ptr<const TextureToIndexRangesMap> visibleIndexRanges);
+
             void render(RenderBatch& renderBatch);
             static vm::vec3f gridColorForTexture(const Assets::Texture* texture);
         private:
             void prepareVerticesAndIndices(VboManager& vboManager) override;
             void doRender(RenderContext& context) override;
+
+            void setupShader(RenderContext& context, ActiveShader& shader, bool applyTexture) const;
+            void renderTextures(ActiveShader& shader, TextureRenderFunc& func, const std::vector<const TextureAndIndices*>& textures) const;
         };
 
         void swap(FaceRenderer& left, FaceRenderer& right);
@@ -0,0 +1,247 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <ostream>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        FrameProfiler& FrameProfiler::instance() {
+            static FrameProfiler instance;
+            return instance;
+        }
+
+        FrameProfiler::FrameProfiler(const size_t capacity) :
+        m_enabled(false),
+        m_capacity(capacity),
+        m_nextFrame(0),
+        m_recording(false),
+        m_frameDepth(0),
+        m_sampleDepth(0) {
+            assert(m_capacity > 0);
+        }
+
+        bool FrameProfiler::enabled() const {
+            return m_enabled;
+        }
+
+        void FrameProfiler::setEnabled(const bool enabled) {
+            m_enabled = enabled;
+        }
+
+        void FrameProfiler::beginFrame() {
+            if (m_frameDepth++ > 0 || !m_enabled) {
+                return;
+            }
+
+            m_recording = true;
+            m_currentFrame.samples.clear();
+            m_currentFrame.start = Clock::now();
+            m_sampleDepth = 0;
+        }
+
+        void FrameProfiler::endFrame() {
+            assert(m_frameDepth > 0);
+            if (--m_frameDepth > 0 || !m_recording) {
+                return;
+            }
+
+            m_recording = false;
+            m_currentFrame.duration = Clock::now() - m_currentFrame.start;
+            if (m_frames.size() < m_capacity) {
+                m_frames.push_back(std::move(m_currentFrame));
+            } else {
+                // reuse the sample storage of the oldest frame
+                std::swap(m_frames[m_nextFrame], m_currentFrame);
+            }
+            m_nextFrame = (m_nextFrame + 1) % m_capacity;
+            m_currentFrame.samples.clear();
+        }
+
+        long FrameProfiler::beginSample(const char* name) {
+            if (!m_recording) {
+                return -1;
+            }
+
+            m_currentFrame.samples.push_back(Sample{name, m_sampleDepth++, Clock::now(), Clock::duration::zero()});
+            return static_cast<long>(m_currentFrame.samples.size() - 1);
+        }
+
+        void FrameProfiler::endSample(const long index) {
+            if (index < 0) {
+                return;
+            }
+            assert(static_cast<size_t>(index) < m_currentFrame.samples.size());
+
+            auto& sample = m_currentFrame.samples[static_cast<size_t>(index)];
+            sample.duration = Clock::now() - sample.start;
+
+            assert(m_sampleDepth > 0);
+            --m_sampleDepth;
+        }
+
+        size_t FrameProfiler::frameCount() const {
+            return m_frames.size();
+        }
+
+        const FrameProfiler::Frame& FrameProfiler::frame(const size_t index) const {
+            assert(index < m_frames.size());
+            if (m_frames.size() < m_capacity) {
+                return m_frames[index];
+            } else {
+                return m_frames[(m_nextFrame + index) % m_capacity];
+            }
+        }
+
+        void FrameProfiler::clear() {
+            m_frames.clear();
+            m_nextFrame = 0;
+        }
+
+        static double toMs(const FrameProfiler::Clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+
+        std::vector<FrameProfiler::Statistics> FrameProfiler::statistics() const {
+            struct Accumulator {
+                size_t frameCount = 0;
+                double min = std::numeric_limits<double>::max();
+                double max = 0.0;
+                double total = 0.0;
+
+                void add(const double value) {
+                    ++frameCount;
+                    min = std::min(min, value);
+                    max = std::max(max, value);
+                    total += value;
+                }
+            };
+
+            std::map<std::string, Accumulator> accumulators;
+            std::map<std::string, double> frameTotals;
+            for (size_t i = 0; i < frameCount(); ++i) {
+                const auto& f = frame(i);
+                accumulators["Frame"].add(toMs(f.duration));
+
+                frameTotals.clear();
+                for (const auto& sample : f.samples) {
+                    frameTotals[sample.name] += toMs(sample.duration);
+                }
+                for (const auto& [name, total] : frameTotals) {
+                    accumulators[name].add(total);
+                }
+            }
+
+            std::vector<Statistics> result;
+            result.reserve(accumulators.size());
+            for (const auto& [name, acc] : accumulators) {
+                result.push_back(Statistics{name, acc.frameCount, acc.min, acc.total / static_cast<double>(acc.frameCount), acc.max});
+            }
+
+            std::stable_sort(std::begin(result), std::end(result), [](const auto& lhs, const auto& rhs) {
+                return lhs.avgMs > rhs.avgMs;
+            });
+            return result;
+        }
+
+        static void writeJsonString(std::ostream& str, const char* value) {
+            str << "\"";
+            for (const char* c = value; *c != '\0'; ++c) {
+                switch (*c) {
+                    case '"':
+                        str << "\\\"";
+                        break;
+                    case '\\':
+                        str << "\\\\";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(*c) >= 0x20) {
+                            str << *c;
+                        }
+                        break;
+                }
+            }
+            str << "\"";
+        }
+
+        static void writeTraceEvent(std::ostream& str, const char* name, const FrameProfiler::Clock::time_point origin,
+                                    const FrameProfiler::Clock::time_point start, const FrameProfiler::Clock::duration duration) {
+            using Microseconds = std::chrono::duration<double, std::micro>;
+
+            str << "{\"name\":";
+            writeJsonString(str, name);
+            str << ",\"cat\":\"render\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+                << ",\"ts\":" << Microseconds(start - origin).count()
+                << ",\"dur\":" << Microseconds(duration).count()
+                << "}";
+        }
+
+        void FrameProfiler::writeChromeTrace(std::ostream& str) const {
+            str << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+            if (frameCount() > 0) {
+                const auto origin = frame(0).start;
+
+                bool first = true;
+                for (size_t i = 0; i < frameCount(); ++i) {
+                    const auto& f = frame(i);
+
+                    str << (first ? "\n" : ",\n");
+                    writeTraceEvent(str, "Frame", origin, f.start, f.duration);
+                    first = false;
+
+                    for (const auto& sample : f.samples) {
+                        str << ",\n";
+                        writeTraceEvent(str, sample.name, origin, sample.start, sample.duration);
+                    }
+                }
+            }
+
+            str << "\n]}\n";
+        }
+
+        FrameScope::FrameScope() :
+        FrameScope(FrameProfiler::instance()) {}
+
+        FrameScope::FrameScope(FrameProfiler& profiler) :
+        m_profiler(profiler) {
+            m_profiler.beginFrame();
+        }
+
+        FrameScope::~FrameScope() {
+            m_profiler.endFrame();
+        }
+
+        ProfileScope::ProfileScope(const char* name) :
+        ProfileScope(FrameProfiler::instance(), name) {}
+
+        ProfileScope::ProfileScope(FrameProfiler& profiler, const char* name) :
+        m_profiler(profiler),
+        m_index(m_profiler.beginSample(name)) {}
+
+        ProfileScope::~ProfileScope() {
+            m_profiler.endSample(m_index);
+        }
+    }
+}
@@ -0,0 +1,170 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_FrameProfiler
+#define TrenchBroom_FrameProfiler
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * Records hierarchical CPU timings of rendered frames.
+         *
+         * A frame is delimited by beginFrame() and endFrame(), usually by means of a FrameScope object, and samples are
+         * recorded using ProfileScope objects while a frame is in progress. The last `capacity` frames are kept in a ring buffer, from which statistics can
+         * be computed or a trace in the Chrome trace event format (chrome://tracing) can be written.
+         *
+         * Nothing is recorded while the profiler is disabled, which is the default. The profiler is not thread safe and
+         * must only be used from the rendering thread.
+         */
+        class FrameProfiler {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            struct Sample {
+                /**
+                 * Must point to a string with static storage duration, such as a string literal.
+                 */
+                const char* name;
+                size_t depth;
+                Clock::time_point start;
+                Clock::duration duration;
+            };
+
+            struct Frame {
+                Clock::time_point start;
+                Clock::duration duration;
+                std::vector<Sample> samples;
+            };
+
+            /**
+             * The time spent in samples with the same name, summed up per frame. The minimum, average and maximum are
+             * taken over all frames in which a sample with the name was recorded.
+             */
+            struct Statistics {
+                std::string name;
+                size_t frameCount;
+                double minMs;
+                double avgMs;
+                double maxMs;
+            };
+
+            static const size_t DefaultCapacity = 300;
+        private:
+            bool m_enabled;
+
+            std::vector<Frame> m_frames;
+            size_t m_capacity;
+            size_t m_nextFrame;
+
+            Frame m_currentFrame;
+            /**
+             * Whether the current frame is being recorded, i.e., whether the profiler was enabled when it began.
+             */
+            bool m_recording;
+            size_t m_frameDepth;
+            size_t m_sampleDepth;
+        public:
+            static FrameProfiler& instance();
+
+            explicit FrameProfiler(size_t capacity = DefaultCapacity);
+
+            bool enabled() const;
+            void setEnabled(bool enabled);
+
+            /**
+             * Starts recording a frame. Nested calls are counted, and only the outermost pair of calls to beginFrame()
+             * and endFrame() delimits a frame.
+             */
+            void beginFrame();
+            void endFrame();
+
+            /**
+             * Starts a sample with the given name and returns its index in the current frame, which must be passed to
+             * endSample. Returns -1 if nothing is recorded because the profiler is disabled or no frame is in progress.
+             */
+            long beginSample(const char* name);
+            void endSample(long index);
+
+            /**
+             * Returns the number of recorded frames, at most `capacity`.
+             */
+            size_t frameCount() const;
+
+            /**
+             * Returns the recorded frame with the given index, where 0 is the oldest recorded frame.
+             */
+            const Frame& frame(size_t index) const;
+
+            /**
+             * Discards all recorded frames.
+             */
+            void clear();
+
+            /**
+             * Computes statistics of all samples in the recorded frames, including one entry named "Frame" for the
+             * frames themselves. The result is sorted by descending average time.
+             */
+            std::vector<Statistics> statistics() const;
+
+            /**
+             * Writes the recorded frames to the given stream in the JSON trace event format that chrome://tracing and
+             * similar tools can load.
+             */
+            void writeChromeTrace(std::ostream& str) const;
+        };
+
+        /**
+         * Records a frame in the given profiler for as long as this object lives.
+         */
+        class FrameScope {
+        private:
+            FrameProfiler& m_profiler;
+        public:
+            FrameScope();
+            explicit FrameScope(FrameProfiler& profiler);
+            ~FrameScope();
+
+            FrameScope(const FrameScope& other) = delete;
+            FrameScope& operator=(const FrameScope& other) = delete;
+        };
+
+        /**
+         * Records a sample in the given profiler for as long as this object lives.
+         */
+        class ProfileScope {
+        private:
+            FrameProfiler& m_profiler;
+            long m_index;
+        public:
+            explicit ProfileScope(const char* name);
+            ProfileScope(FrameProfiler& profiler, const char* name);
+            ~ProfileScope();
+
+            ProfileScope(const ProfileScope& other) = delete;
+            ProfileScope& operator=(const ProfileScope& other) = delete;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_FrameProfiler) */
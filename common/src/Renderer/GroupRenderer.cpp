@@ -217,7 +217,7 @@ namespace TrenchBroom {
             return parentGroup == currentGroup && m_editorContext.visible(group);
         }
 
-        AttrString GroupRenderer::groupString(const Model::Group* group) const {
+        const std::string& GroupRenderer::groupString(const Model::Group* group) const {
             return group->name();
         }
 
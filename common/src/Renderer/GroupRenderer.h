@@ -20,10 +20,10 @@
 #ifndef TrenchBroom_GroupRenderer
 #define TrenchBroom_GroupRenderer
 
-#include "AttrString.h"
 #include "Color.h"
 #include "Renderer/EdgeRenderer.h"
 
+#include <string>
 #include <vector>
 
 namespace TrenchBroom {
@@ -108,7 +108,7 @@ namespace TrenchBroom {
 
             bool shouldRenderGroup(const Model::Group* group) const;
 
-            AttrString groupString(const Model::Group* group) const;
+            const std::string& groupString(const Model::Group* group) const;
             const Color& boundsColor(const Model::Group* group) const;
         };
     }
@@ -29,11 +29,14 @@
 #include "Model/Group.h"
 #include "Model/Layer.h"
 #include "Model/Node.h"
+#include "Model/NodeCollection.h"
 #include "Model/NodeVisitor.h"
 #include "Model/World.h"
 #include "Renderer/BrushRenderer.h"
 #include "Renderer/EntityLinkRenderer.h"
+#include "Renderer/FrameProfiler.h"
 #include "Renderer/ObjectRenderer.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
@@ -124,7 +127,8 @@ namespace TrenchBroom {
         m_defaultRenderer(createDefaultRenderer(m_document)),
         m_selectionRenderer(createSelectionRenderer(m_document)),
         m_lockedRenderer(createLockRenderer(m_document)),
-        m_entityLinkRenderer(std::make_unique<EntityLinkRenderer>(m_document)) {
+        m_entityLinkRenderer(std::make_unique<EntityLinkRenderer>(m_document)),
+        m_occlusionCuller(std::make_unique<OcclusionCuller>()) {
             bindObservers();
             setupRenderers();
         }
@@ -181,8 +185,12 @@ namespace TrenchBroom {
         }
 
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
+            const ProfileScope profile("MapRenderer::render");
+
             commitPendingChanges();
             setupGL(renderBatch);
+            updateOcclusionCuller(renderContext);
+
             renderDefaultOpaque(renderContext, renderBatch);
             renderLockedOpaque(renderContext, renderBatch);
             renderSelectionOpaque(renderContext, renderBatch);
@@ -192,9 +200,13 @@ namespace TrenchBroom {
             renderSelectionTransparent(renderContext, renderBatch);
 
             renderEntityLinks(renderContext, renderBatch);
+
+            // other renderers may render objects that are not in the map, such as tool previews
+            renderContext.setOcclusionCuller(nullptr);
         }
 
         void MapRenderer::commitPendingChanges() {
+            const ProfileScope profile("MapRenderer::commitPendingChanges");
             auto document = kdl::mem_lock(m_document);
             document->commitPendingAssets();
         }
@@ -214,6 +226,19 @@ namespace TrenchBroom {
             renderBatch.addOneShot(new SetupGL());
         }
 
+        void MapRenderer::updateOcclusionCuller(RenderContext& renderContext) {
+            renderContext.setOcclusionCuller(nullptr);
+            if (!renderContext.render3D() || !renderContext.showFaces() || !pref(Preferences::OcclusionCulling)) {
+                return;
+            }
+
+            auto document = kdl::mem_lock(m_document);
+            if (const auto* world = document->world()) {
+                m_occlusionCuller->update(renderContext.camera(), *world, document->editorContext());
+                renderContext.setOcclusionCuller(m_occlusionCuller.get());
+            }
+        }
+
         void MapRenderer::renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
             m_defaultRenderer->setShowOverlays(renderContext.render3D());
             m_defaultRenderer->renderOpaque(renderContext, renderBatch);
@@ -394,7 +419,6 @@ namespace TrenchBroom {
                                              collect.lockedNodes().entities(),
                                              collect.lockedNodes().brushes());
             }
-            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::invalidateRenderers(Renderer renderers) {
@@ -406,6 +430,18 @@ namespace TrenchBroom {
                 m_lockedRenderer->invalidate();
         }
 
+        void MapRenderer::invalidateEntitiesInRenderers(Renderer renderers, const std::vector<Model::Entity*>& entities) {
+            if ((renderers & Renderer_Default) != 0) {
+                m_defaultRenderer->invalidateEntities(entities);
+            }
+            if ((renderers & Renderer_Selection) != 0) {
+                m_selectionRenderer->invalidateEntities(entities);
+            }
+            if ((renderers& Renderer_Locked) != 0) {
+                m_lockedRenderer->invalidateEntities(entities);
+            }
+        }
+
         void MapRenderer::invalidateBrushesInRenderers(Renderer renderers, const std::vector<Model::Brush*>& brushes) {
             if ((renderers & Renderer_Default) != 0) {
                 m_defaultRenderer->invalidateBrushes(brushes);
@@ -488,21 +524,32 @@ namespace TrenchBroom {
             updateRenderers(Renderer_All);
         }
 
-        void MapRenderer::nodesWereAdded(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodesWereAdded(const std::vector<Model::Node*>& nodes) {
             updateRenderers(Renderer_Default);
+            m_entityLinkRenderer->invalidateNodes(nodes);
         }
 
-        void MapRenderer::nodesWereRemoved(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodesWereRemoved(const std::vector<Model::Node*>& nodes) {
             updateRenderers(Renderer_Default);
+            m_entityLinkRenderer->removeNodes(nodes);
         }
 
-        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>& nodes) {
             invalidateRenderers(Renderer_Selection);
-            invalidateEntityLinkRenderer();
+
+            // changed entities may be unselected, e.g. a brush entity whose brushes were changed
+            Model::NodeCollection changedNodes;
+            changedNodes.addNodes(nodes);
+            if (changedNodes.hasEntities()) {
+                invalidateEntitiesInRenderers(Renderer_Default_Locked, changedNodes.entities());
+            }
+
+            m_entityLinkRenderer->invalidateNodes(nodes);
         }
 
-        void MapRenderer::nodeVisibilityDidChange(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodeVisibilityDidChange(const std::vector<Model::Node*>& nodes) {
             invalidateRenderers(Renderer_All);
+            m_entityLinkRenderer->invalidateNodes(nodes);
         }
 
         void MapRenderer::nodeLockingDidChange(const std::vector<Model::Node*>&) {
@@ -511,10 +558,12 @@ namespace TrenchBroom {
 
         void MapRenderer::groupWasOpened(Model::Group*) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::groupWasClosed(Model::Group*) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::brushFacesDidChange(const std::vector<Model::BrushFace*>&) {
@@ -524,6 +573,10 @@ namespace TrenchBroom {
         void MapRenderer::selectionDidChange(const View::Selection& selection) {
             updateRenderers(Renderer_All); // need to update locked objects also because a selected object may have been reparented into a locked layer before deselection
 
+            // only the colors of the links from and to the selected and deselected entities change
+            m_entityLinkRenderer->invalidateNodes(selection.selectedNodes());
+            m_entityLinkRenderer->invalidateNodes(selection.deselectedNodes());
+
             // selecting faces needs to invalidate the brushes
             if (!selection.selectedBrushFaces().empty()
                 || !selection.deselectedBrushFaces().empty()) {
@@ -42,6 +42,7 @@ namespace TrenchBroom {
     namespace Model {
         class Brush;
         class BrushFace;
+        class Entity;
         class Group;
         class Layer;
         class Node;
@@ -50,6 +51,7 @@ namespace TrenchBroom {
     namespace Renderer {
         class EntityLinkRenderer;
         class ObjectRenderer;
+        class OcclusionCuller;
         class RenderBatch;
         class RenderContext;
 
@@ -67,6 +69,7 @@ namespace TrenchBroom {
             std::unique_ptr<ObjectRenderer> m_selectionRenderer;
             std::unique_ptr<ObjectRenderer> m_lockedRenderer;
             std::unique_ptr<EntityLinkRenderer> m_entityLinkRenderer;
+            std::unique_ptr<OcclusionCuller> m_occlusionCuller;
         public:
             explicit MapRenderer(std::weak_ptr<View::MapDocument> document);
             ~MapRenderer();
@@ -85,6 +88,11 @@ namespace TrenchBroom {
         private:
             void commitPendingChanges();
             void setupGL(RenderBatch& renderBatch);
+            /**
+             * Updates the occlusion culler and sets it on the given context if occlusion culling is enabled and the
+             * context renders the 3D view with faces.
+             */
+            void updateOcclusionCuller(RenderContext& renderContext);
             void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderSelectionOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -118,6 +126,7 @@ namespace TrenchBroom {
              */
             void updateRenderers(Renderer renderers);
             void invalidateRenderers(Renderer renderers);
+            void invalidateEntitiesInRenderers(Renderer renderers, const std::vector<Model::Entity*>& entities);
             void invalidateBrushesInRenderers(Renderer renderers, const std::vector<Model::Brush*>& brushes);
             void invalidateEntityLinkRenderer();
             void reloadEntityModels();
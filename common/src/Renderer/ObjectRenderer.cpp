@@ -35,6 +35,10 @@ namespace TrenchBroom {
             m_brushRenderer.invalidate();
         }
 
+        void ObjectRenderer::invalidateEntities(const std::vector<Model::Entity*>& entities) {
+            m_entityRenderer.invalidateEntities(entities);
+        }
+
         void ObjectRenderer::invalidateBrushes(const std::vector<Model::Brush*>& brushes) {
             m_brushRenderer.invalidateBrushes(brushes);
         }
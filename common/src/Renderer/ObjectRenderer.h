@@ -59,6 +59,7 @@ namespace TrenchBroom {
         public: // object management
             void setObjects(const std::vector<Model::Group*>& groups, const std::vector<Model::Entity*>& entities, const std::vector<Model::Brush*>& brushes);
             void invalidate();
+            void invalidateEntities(const std::vector<Model::Entity*>& entities);
             void invalidateBrushes(const std::vector<Model::Brush*>& brushes);
             void clear();
             void reloadModels();
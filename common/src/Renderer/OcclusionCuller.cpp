@@ -0,0 +1,334 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OcclusionCuller.h"
+
+#include "Assets/Texture.h"
+#include "Model/AssortNodesVisitor.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/EditorContext.h"
+#include "Model/TagAttribute.h"
+#include "Model/World.h"
+#include "Renderer/Camera.h"
+#include "Renderer/FrameProfiler.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr float FarDepth = std::numeric_limits<float>::max();
+
+        OcclusionCuller::OcclusionCuller(const size_t width, const size_t height) :
+        m_width(width),
+        m_height(height),
+        m_viewProjection(vm::mat4x4f::identity()),
+        m_depthBuffer(width * height, FarDepth),
+        m_occluderCount(0) {
+            assert(m_width > 0 && m_height > 0);
+        }
+
+        size_t OcclusionCuller::width() const {
+            return m_width;
+        }
+
+        size_t OcclusionCuller::height() const {
+            return m_height;
+        }
+
+        void OcclusionCuller::begin(const vm::mat4x4f& viewProjection) {
+            m_viewProjection = viewProjection;
+            std::fill(std::begin(m_depthBuffer), std::end(m_depthBuffer), FarDepth);
+            m_occluderCount = 0;
+        }
+
+        /**
+         * Transforms the given point to clip coordinates. Returns false if the point is behind the near plane.
+         */
+        static bool toClip(const vm::mat4x4f& viewProjection, const vm::vec3& point, vm::vec4f& clip) {
+            clip = viewProjection * vm::vec4f(vm::vec3f(point), 1.0f);
+            return clip.w() > 0.0f && clip.z() >= -clip.w();
+        }
+
+        /**
+         * Returns the index of the pixel that contains the given screen coordinate, clamped to [-1, size].
+         */
+        static long pixelIndex(const float coord, const size_t size) {
+            const auto clamped = std::clamp(std::floor(coord), -1.0f, static_cast<float>(size));
+            return static_cast<long>(clamped);
+        }
+
+        bool OcclusionCuller::addOccluder(const std::vector<vm::vec3>& polygon) {
+            if (polygon.size() < 3) {
+                return false;
+            }
+
+            const auto width = static_cast<float>(m_width);
+            const auto height = static_cast<float>(m_height);
+
+            m_screenPolygon.clear();
+            auto maxDepth = -FarDepth;
+            auto minScreen = vm::vec2f::fill(FarDepth);
+            auto maxScreen = vm::vec2f::fill(-FarDepth);
+            for (const auto& point : polygon) {
+                vm::vec4f clip;
+                if (!toClip(m_viewProjection, point, clip)) {
+                    return false;
+                }
+
+                const auto screen = vm::vec2f(
+                    (clip.x() / clip.w() + 1.0f) * 0.5f * width,
+                    (clip.y() / clip.w() + 1.0f) * 0.5f * height);
+                m_screenPolygon.push_back(screen);
+                minScreen = vm::vec2f(std::min(minScreen.x(), screen.x()), std::min(minScreen.y(), screen.y()));
+                maxScreen = vm::vec2f(std::max(maxScreen.x(), screen.x()), std::max(maxScreen.y(), screen.y()));
+                maxDepth = std::max(maxDepth, clip.z() / clip.w());
+            }
+
+            auto area = 0.0f;
+            for (size_t i = 0; i < m_screenPolygon.size(); ++i) {
+                const auto& p1 = m_screenPolygon[i];
+                const auto& p2 = m_screenPolygon[(i + 1) % m_screenPolygon.size()];
+                area += p1.x() * p2.y() - p1.y() * p2.x();
+            }
+            if (area == 0.0f) {
+                return false;
+            }
+            const auto orientation = area > 0.0f ? 1.0f : -1.0f;
+
+            // the grid points are the pixel corners, pixel (x, y) spans from grid point (x, y) to (x + 1, y + 1)
+            const auto minX = std::max(0l, pixelIndex(std::ceil(minScreen.x()), m_width));
+            const auto maxX = std::min(static_cast<long>(m_width), pixelIndex(maxScreen.x(), m_width));
+            const auto minY = std::max(0l, pixelIndex(std::ceil(minScreen.y()), m_height));
+            const auto maxY = std::min(static_cast<long>(m_height), pixelIndex(maxScreen.y(), m_height));
+            if (minX >= maxX || minY >= maxY) {
+                return false;
+            }
+
+            const auto inside = [&](const float x, const float y) {
+                for (size_t i = 0; i < m_screenPolygon.size(); ++i) {
+                    const auto& p1 = m_screenPolygon[i];
+                    const auto& p2 = m_screenPolygon[(i + 1) % m_screenPolygon.size()];
+                    const auto edge = (p2.x() - p1.x()) * (y - p1.y()) - (p2.y() - p1.y()) * (x - p1.x());
+                    if (edge * orientation < 0.0f) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            const auto rowSize = static_cast<size_t>(maxX - minX + 1);
+            m_previousRow.assign(rowSize, false);
+            m_currentRow.assign(rowSize, false);
+
+            auto written = false;
+            for (long y = minY; y <= maxY; ++y) {
+                for (long x = minX; x <= maxX; ++x) {
+                    m_currentRow[static_cast<size_t>(x - minX)] = inside(static_cast<float>(x), static_cast<float>(y));
+                }
+
+                if (y > minY) {
+                    // a pixel is covered if all of its corners are inside of the polygon, since the polygon is convex
+                    for (long x = minX; x < maxX; ++x) {
+                        const auto i = static_cast<size_t>(x - minX);
+                        if (m_previousRow[i] && m_previousRow[i + 1] && m_currentRow[i] && m_currentRow[i + 1]) {
+                            auto& pixel = depth(static_cast<size_t>(x), static_cast<size_t>(y - 1));
+                            pixel = std::min(pixel, maxDepth);
+                            written = true;
+                        }
+                    }
+                }
+
+                std::swap(m_previousRow, m_currentRow);
+            }
+
+            return written;
+        }
+
+        bool OcclusionCuller::visible(const vm::bbox3& bounds) const {
+            auto minDepth = FarDepth;
+            auto minScreen = vm::vec2f::fill(FarDepth);
+            auto maxScreen = vm::vec2f::fill(-FarDepth);
+            size_t cornersBehind = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                const auto corner = vm::vec3(
+                    (i & 1u) ? bounds.max.x() : bounds.min.x(),
+                    (i & 2u) ? bounds.max.y() : bounds.min.y(),
+                    (i & 4u) ? bounds.max.z() : bounds.min.z());
+
+                vm::vec4f clip;
+                if (!toClip(m_viewProjection, corner, clip)) {
+                    ++cornersBehind;
+                    continue;
+                }
+
+                const auto screen = vm::vec2f(
+                    (clip.x() / clip.w() + 1.0f) * 0.5f * static_cast<float>(m_width),
+                    (clip.y() / clip.w() + 1.0f) * 0.5f * static_cast<float>(m_height));
+                minScreen = vm::vec2f(std::min(minScreen.x(), screen.x()), std::min(minScreen.y(), screen.y()));
+                maxScreen = vm::vec2f(std::max(maxScreen.x(), screen.x()), std::max(maxScreen.y(), screen.y()));
+                minDepth = std::min(minDepth, clip.z() / clip.w());
+            }
+
+            if (cornersBehind == 8) {
+                return false;
+            } else if (cornersBehind > 0) {
+                // the box reaches behind the near plane, so its projection is unbounded
+                return true;
+            }
+
+            // every pixel that the projection of the box touches
+            const auto minX = std::max(0l, pixelIndex(minScreen.x(), m_width));
+            const auto maxX = std::min(static_cast<long>(m_width) - 1, pixelIndex(maxScreen.x(), m_width));
+            const auto minY = std::max(0l, pixelIndex(minScreen.y(), m_height));
+            const auto maxY = std::min(static_cast<long>(m_height) - 1, pixelIndex(maxScreen.y(), m_height));
+
+            for (long y = minY; y <= maxY; ++y) {
+                for (long x = minX; x <= maxX; ++x) {
+                    if (depth(static_cast<size_t>(x), static_cast<size_t>(y)) >= minDepth) {
+                        return true;
+                    }
+                }
+            }
+
+            // the box is either outside of the view or behind the occluders
+            return false;
+        }
+
+        void OcclusionCuller::update(const Camera& camera, const Model::World& world, const Model::EditorContext& editorContext) {
+            const ProfileScope profile("OcclusionCuller::update");
+
+            begin(camera.projectionMatrix() * camera.viewMatrix());
+
+            // with an empty depth buffer, this finds every node in the view
+            std::vector<Model::Node*> nodes;
+            world.findNodes([&](const vm::bbox3& bounds) { return visible(bounds); }, nodes);
+
+            for (const auto* brush : selectOccluders(camera, world, editorContext, nodes)) {
+                addOccluder(brush);
+            }
+
+            nodes.clear();
+            world.findNodes([&](const vm::bbox3& bounds) { return visible(bounds); }, nodes);
+
+            m_visibleNodes.clear();
+            m_visibleNodes.insert(std::begin(nodes), std::end(nodes));
+        }
+
+        bool OcclusionCuller::visible(const Model::Node* node) const {
+            return m_visibleNodes.count(node) > 0u;
+        }
+
+        size_t OcclusionCuller::occluderCount() const {
+            return m_occluderCount;
+        }
+
+        size_t OcclusionCuller::visibleNodeCount() const {
+            return m_visibleNodes.size();
+        }
+
+        /**
+         * Returns whether the given brush is opaque and large enough to hide other objects. Brush entities can move
+         * in game and selected brushes can move in the editor, so only unselected world brushes are considered.
+         */
+        static bool isOccluder(const Model::Brush* brush, const Model::World& world, const Model::EditorContext& editorContext) {
+            if (brush->entity() != &world || brush->selected() || !editorContext.visible(brush)) {
+                return false;
+            }
+            if (brush->hasAttribute(Model::TagAttributes::Transparency)) {
+                return false;
+            }
+
+            const auto size = brush->logicalBounds().size();
+            const auto largeAxes = (size.x() >= OcclusionCuller::MinOccluderSize ? 1 : 0)
+                                 + (size.y() >= OcclusionCuller::MinOccluderSize ? 1 : 0)
+                                 + (size.z() >= OcclusionCuller::MinOccluderSize ? 1 : 0);
+            if (largeAxes < 2) {
+                return false;
+            }
+
+            for (const auto* face : brush->faces()) {
+                if (!editorContext.visible(face) || face->hasAttribute(Model::TagAttributes::Transparency)) {
+                    return false;
+                }
+                // masked textures have holes
+                const auto* texture = face->texture();
+                if (texture != nullptr && texture->masked()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        std::vector<const Model::Brush*> OcclusionCuller::selectOccluders(const Camera& camera, const Model::World& world, const Model::EditorContext& editorContext, const std::vector<Model::Node*>& candidates) const {
+            Model::CollectBrushesVisitor collect;
+            Model::Node::accept(std::begin(candidates), std::end(candidates), collect);
+
+            std::vector<const Model::Brush*> result;
+            for (const auto* brush : collect.brushes()) {
+                if (isOccluder(brush, world, editorContext)) {
+                    result.push_back(brush);
+                }
+            }
+
+            // the closest brushes hide the most, the bounds break ties so that the order does not depend on the tree
+            const auto position = vm::vec3(camera.position());
+            const auto key = [&](const Model::Brush* brush) {
+                const auto& bounds = brush->logicalBounds();
+                return std::make_tuple(vm::squared_distance(bounds.center(), position), bounds.min, bounds.max);
+            };
+
+            const auto count = std::min(result.size(), MaxOccluders);
+            std::partial_sort(std::begin(result), std::next(std::begin(result), static_cast<long>(count)), std::end(result),
+                [&](const auto* lhs, const auto* rhs) { return key(lhs) < key(rhs); });
+            result.resize(count);
+
+            return result;
+        }
+
+        void OcclusionCuller::addOccluder(const Model::Brush* brush) {
+            auto added = false;
+            for (const auto* face : brush->faces()) {
+                added |= addOccluder(face->vertexPositions());
+            }
+            if (added) {
+                ++m_occluderCount;
+            }
+        }
+
+        float& OcclusionCuller::depth(const size_t x, const size_t y) {
+            assert(x < m_width && y < m_height);
+            return m_depthBuffer[y * m_width + x];
+        }
+
+        float OcclusionCuller::depth(const size_t x, const size_t y) const {
+            assert(x < m_width && y < m_height);
+            return m_depthBuffer[y * m_width + x];
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_OcclusionCuller
+#define TrenchBroom_OcclusionCuller
+
+#include "FloatType.h"
+
+#include <vecmath/forward.h>
+#include <vecmath/mat.h>
+#include <vecmath/vec.h>
+
+#include <unordered_set>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class Brush;
+        class EditorContext;
+        class Node;
+        class World;
+    }
+
+    namespace Renderer {
+        class Camera;
+
+        /**
+         * Determines which entities and brushes are hidden behind large world brushes from the point of view of a
+         * camera, so that the renderers can skip them.
+         *
+         * The faces of the occluders are rasterized into a small depth buffer on the CPU. A pixel only receives the
+         * depth of a face if the face covers the entire pixel, and it receives the largest depth of the face, so the
+         * depth buffer never claims that a point is hidden if it is visible. A bounding box is occluded if every pixel
+         * that its projection touches has a depth less than the smallest depth of the box. Boxes that reach behind
+         * the near plane are always visible, and boxes that are entirely behind it are never visible.
+         *
+         * Only faces that are entirely in front of the near plane are rasterized, and the occluders are chosen and
+         * ordered deterministically, so that the result only depends on the camera and the map.
+         */
+        class OcclusionCuller {
+        public:
+            static const size_t DefaultWidth = 256;
+            static const size_t DefaultHeight = 144;
+            /**
+             * The maximum number of brushes that are rasterized per frame. The brushes closest to the camera are used.
+             */
+            static const size_t MaxOccluders = 256;
+            /**
+             * A world brush must be at least this large along two axes to be used as an occluder.
+             */
+            static constexpr FloatType MinOccluderSize = 64.0;
+        private:
+            size_t m_width;
+            size_t m_height;
+            vm::mat4x4f m_viewProjection;
+            std::vector<float> m_depthBuffer;
+
+            std::vector<vm::vec2f> m_screenPolygon;
+            std::vector<bool> m_previousRow;
+            std::vector<bool> m_currentRow;
+
+            size_t m_occluderCount;
+            std::unordered_set<const Model::Node*> m_visibleNodes;
+        public:
+            explicit OcclusionCuller(size_t width = DefaultWidth, size_t height = DefaultHeight);
+
+            size_t width() const;
+            size_t height() const;
+
+            /**
+             * Clears the depth buffer and sets the transformation from world coordinates to clip coordinates.
+             */
+            void begin(const vm::mat4x4f& viewProjection);
+
+            /**
+             * Rasterizes the given convex polygon into the depth buffer. Returns false if the polygon was skipped
+             * because it is degenerate, reaches behind the near plane, or does not cover any pixel entirely.
+             */
+            bool addOccluder(const std::vector<vm::vec3>& polygon);
+
+            /**
+             * Returns whether any part of the given box may be visible, given the occluders added since begin() was
+             * called. Boxes outside of the view are not visible.
+             */
+            bool visible(const vm::bbox3& bounds) const;
+
+            /**
+             * Computes the entities and brushes of the given world that may be visible from the given camera.
+             */
+            void update(const Camera& camera, const Model::World& world, const Model::EditorContext& editorContext);
+
+            /**
+             * Returns whether the given node may be visible according to the last call to update(). Only entities and
+             * brushes of the world passed to update() can be visible.
+             */
+            bool visible(const Model::Node* node) const;
+
+            size_t occluderCount() const;
+            size_t visibleNodeCount() const;
+        private:
+            std::vector<const Model::Brush*> selectOccluders(const Camera& camera, const Model::World& world, const Model::EditorContext& editorContext, const std::vector<Model::Node*>& candidates) const;
+            void addOccluder(const Model::Brush* brush);
+
+            float& depth(size_t x, size_t y);
+            float depth(size_t x, size_t y) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_OcclusionCuller) */
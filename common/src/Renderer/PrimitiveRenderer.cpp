@@ -159,6 +159,9 @@ namespace TrenchBroom {
             }
         }
 
+        PrimitiveRenderer::PrimitiveRenderer(const PrimitiveRendererUploadPolicy uploadPolicy) :
+        m_uploadPolicy(uploadPolicy) {}
+
         void PrimitiveRenderer::renderLine(const Color& color, const float lineWidth, const PrimitiveRendererOcclusionPolicy occlusionPolicy, const vm::vec3f& start, const vm::vec3f& end) {
             m_lineMeshes[LineRenderAttributes(color, lineWidth, occlusionPolicy)].addLine(Vertex(start), Vertex(end));
         }
@@ -249,7 +252,7 @@ namespace TrenchBroom {
             for (auto& entry : m_lineMeshes) {
                 const LineRenderAttributes& attributes = entry.first;
                 IndexRangeMapBuilder<Vertex::Type>& mesh = entry.second;
-                IndexRangeRenderer& renderer = m_lineMeshRenderers.insert(std::make_pair(attributes, IndexRangeRenderer(mesh))).first->second;
+                IndexRangeRenderer& renderer = m_lineMeshRenderers.insert(std::make_pair(attributes, makeRenderer(mesh))).first->second;
                 renderer.prepare(vboManager);
             }
         }
@@ -258,11 +261,19 @@ namespace TrenchBroom {
             for (auto& entry : m_triangleMeshes) {
                 const TriangleRenderAttributes& attributes = entry.first;
                 IndexRangeMapBuilder<Vertex::Type>& mesh = entry.second;
-                IndexRangeRenderer& renderer = m_triangleMeshRenderers.insert(std::make_pair(attributes, IndexRangeRenderer(mesh))).first->second;
+                IndexRangeRenderer& renderer = m_triangleMeshRenderers.insert(std::make_pair(attributes, makeRenderer(mesh))).first->second;
                 renderer.prepare(vboManager);
             }
         }
 
+        IndexRangeRenderer PrimitiveRenderer::makeRenderer(IndexRangeMapBuilder<Vertex::Type>& mesh) const {
+            if (m_uploadPolicy == PrimitiveRendererUploadPolicy::Stream) {
+                return IndexRangeRenderer(VertexArray::stream(std::move(mesh.vertices())), mesh.indices());
+            } else {
+                return IndexRangeRenderer(mesh);
+            }
+        }
+
         void PrimitiveRenderer::doRender(RenderContext& renderContext) {
             renderLines(renderContext);
             renderTriangles(renderContext);
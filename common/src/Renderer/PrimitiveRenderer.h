@@ -44,11 +44,22 @@ namespace TrenchBroom {
             ShowBackfaces
         };
 
+        /**
+         * Controls whether the vertices are uploaded into buffers of their own, or streamed into the VBO manager's
+         * streaming buffer. Only renderers that are rendered in a single frame may stream their vertices.
+         */
+        enum class PrimitiveRendererUploadPolicy {
+            Persistent,
+            Stream
+        };
+
         class PrimitiveRenderer : public DirectRenderable {
         public:
         private:
             using Vertex = GLVertexTypes::P3::Vertex;
 
+            PrimitiveRendererUploadPolicy m_uploadPolicy;
+
             class LineRenderAttributes {
             private:
                 Color m_color;
@@ -85,6 +96,8 @@ namespace TrenchBroom {
             using TriangleMeshRendererMap = std::map<TriangleRenderAttributes, IndexRangeRenderer>;
             TriangleMeshRendererMap m_triangleMeshRenderers;
         public:
+            explicit PrimitiveRenderer(PrimitiveRendererUploadPolicy uploadPolicy = PrimitiveRendererUploadPolicy::Persistent);
+
             void renderLine(const Color& color, float lineWidth, PrimitiveRendererOcclusionPolicy occlusionPolicy, const vm::vec3f& start, const vm::vec3f& end);
             void renderLines(const Color& color, float lineWidth, PrimitiveRendererOcclusionPolicy occlusionPolicy, const std::vector<vm::vec3f>& positions);
             void renderLineStrip(const Color& color, float lineWidth, PrimitiveRendererOcclusionPolicy occlusionPolicy, const std::vector<vm::vec3f>& positions);
@@ -102,6 +115,7 @@ namespace TrenchBroom {
             void doPrepareVertices(VboManager& vboManager) override;
             void prepareLines(VboManager& vboManager);
             void prepareTriangles(VboManager& vboManager);
+            IndexRangeRenderer makeRenderer(IndexRangeMapBuilder<Vertex::Type>& mesh) const;
 
             void doRender(RenderContext& renderContext) override;
             void renderLines(RenderContext& renderContext);
@@ -20,6 +20,7 @@
 #include "RenderBatch.h"
 
 #include "Ensure.h"
+#include "Renderer/FrameProfiler.h"
 #include "Renderer/Renderable.h"
 #include "Renderer/VboManager.h"
 
@@ -88,6 +89,8 @@ namespace TrenchBroom {
         }
 
         void RenderBatch::render(RenderContext& renderContext) {
+            const ProfileScope profile("RenderBatch::render");
+
             prepareRenderables();
             renderRenderables(renderContext);
         }
@@ -98,6 +101,7 @@ namespace TrenchBroom {
         }
 
         void RenderBatch::prepareRenderables() {
+            const ProfileScope profile("RenderBatch::prepareRenderables");
             for (DirectRenderable* renderable : m_directRenderables) {
                 renderable->prepareVertices(m_vboManager);
             }
@@ -107,6 +111,7 @@ namespace TrenchBroom {
         }
 
         void RenderBatch::renderRenderables(RenderContext& renderContext) {
+            const ProfileScope profile("RenderBatch::renderRenderables");
             for (Renderable* renderable : m_batch)
                 renderable->render(renderContext);
         }
@@ -43,7 +43,8 @@ namespace TrenchBroom {
         m_gridSize(4),
         m_hideSelection(false),
         m_tintSelection(true),
-        m_showSelectionGuide(ShowSelectionGuide::Hide) {}
+        m_showSelectionGuide(ShowSelectionGuide::Hide),
+        m_occlusionCuller(nullptr) {}
 
         bool RenderContext::render2D() const {
             return m_renderMode == RenderMode::Render2D;
@@ -173,6 +174,14 @@ namespace TrenchBroom {
             m_gridSize = gridSize;
         }
 
+        const OcclusionCuller* RenderContext::occlusionCuller() const {
+            return m_occlusionCuller;
+        }
+
+        void RenderContext::setOcclusionCuller(const OcclusionCuller* occlusionCuller) {
+            m_occlusionCuller = occlusionCuller;
+        }
+
         bool RenderContext::hideSelection() const {
             return m_hideSelection;
         }
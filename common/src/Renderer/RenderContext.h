@@ -27,6 +27,7 @@ namespace TrenchBroom {
     namespace Renderer {
         class Camera;
         class FontManager;
+        class OcclusionCuller;
         class ShaderManager;
 
         enum class RenderMode {
@@ -74,6 +75,8 @@ namespace TrenchBroom {
             bool m_tintSelection;
 
             ShowSelectionGuide m_showSelectionGuide;
+
+            const OcclusionCuller* m_occlusionCuller;
         public:
             RenderContext(RenderMode renderMode, const Camera& camera, FontManager& fontManager, ShaderManager& shaderManager);
 
@@ -124,6 +127,13 @@ namespace TrenchBroom {
             FloatType gridSize() const;
             void setGridSize(FloatType gridSize);
 
+            /**
+             * Returns the occlusion culler that determines which nodes are hidden behind other geometry in the current
+             * frame, or nullptr if occlusion culling is disabled.
+             */
+            const OcclusionCuller* occlusionCuller() const;
+            void setOcclusionCuller(const OcclusionCuller* occlusionCuller);
+
             bool hideSelection() const;
             void setHideSelection();
 
@@ -70,7 +70,7 @@ namespace TrenchBroom {
         m_renderBatch(renderBatch),
         m_textRenderer(std::make_unique<TextRenderer>(makeRenderServiceFont())),
         m_pointHandleRenderer(std::make_unique<PointHandleRenderer>()),
-        m_primitiveRenderer(std::make_unique<PrimitiveRenderer>()),
+        m_primitiveRenderer(std::make_unique<PrimitiveRenderer>(PrimitiveRendererUploadPolicy::Stream)),
         m_foregroundColor(1.0f, 1.0f, 1.0f, 1.0f),
         m_backgroundColor(0.0f, 0.0f, 0.0f, 1.0f),
         m_lineWidth(1.0f),
@@ -130,11 +130,15 @@ namespace TrenchBroom {
         }
 
         void RenderService::renderString(const std::string& string, const vm::vec3f& position) {
-            renderString(AttrString(string), position);
+            renderString(string, SimpleTextAnchor(position, TextAlignment::Bottom, vm::vec2f(0.0f, 16.0f)));
         }
 
         void RenderService::renderString(const std::string& string, const TextAnchor& position) {
-            renderString(AttrString(string), position);
+            if (m_occlusionPolicy != PrimitiveRendererOcclusionPolicy::Hide) {
+                m_textRenderer->renderStringOnTop(m_renderContext, m_foregroundColor, m_backgroundColor, string, position);
+            } else {
+                m_textRenderer->renderString(m_renderContext, m_foregroundColor, m_backgroundColor, string, position);
+            }
         }
 
         void RenderService::renderHeadsUp(const std::string& string) {
@@ -27,7 +27,8 @@ namespace TrenchBroom {
             const ShaderConfig VaryingPUniformCShader     = ShaderConfig("Varying Position / Uniform Color", { "VaryingPUniformC.vertsh" },     { "VaryingPC.fragsh" });
             const ShaderConfig MiniMapEdgeShader          = ShaderConfig("MiniMap Edges",                    { "MiniMapEdge.vertsh" },          { "MiniMapEdge.fragsh" });
             const ShaderConfig EntityModelShader          = ShaderConfig("Entity Model",                     { "EntityModel.vertsh" },          { "EntityModel.fragsh" });
-            const ShaderConfig FaceShader                 = ShaderConfig("Face",                             { "Face.vertsh" },                 { "Grid.fragsh", "Face.fragsh" });
+            const ShaderConfig FaceShader                 = ShaderConfig("Face",                             { "Face.vertsh" },                 { "Grid.fragsh", "Face.fragsh", "FaceTexture.fragsh" });
+            const ShaderConfig FaceTextureArrayShader     = ShaderConfig("Face Texture Array",               { "Face.vertsh" },                 { "Grid.fragsh", "Face.fragsh", "FaceTextureArray.fragsh" });
             const ShaderConfig ColoredTextShader          = ShaderConfig("Colored Text",                     { "ColoredText.vertsh" },          { "Text.fragsh" });
             const ShaderConfig TextShader                 = ShaderConfig("Text",                             { "Text.vertsh" },                 { "Text.fragsh" });
             const ShaderConfig TextBackgroundShader       = ShaderConfig("Text Background",                  { "TextBackground.vertsh" },       { "TextBackground.fragsh" });
@@ -23,6 +23,7 @@
 #include "Renderer/ActiveShader.h"
 #include "Renderer/Camera.h"
 #include "Renderer/FontManager.h"
+#include "Renderer/FrameProfiler.h"
 #include "Renderer/PrimType.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
@@ -43,14 +44,11 @@ namespace TrenchBroom {
         const size_t TextRenderer::RectCornerSegments = 3;
         const float TextRenderer::RectCornerRadius = 3.0f;
 
-        TextRenderer::Entry::Entry(std::vector<vm::vec2f>& i_vertices, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
-        size(i_size),
+        TextRenderer::Entry::Entry(std::shared_ptr<const TextureFont::Layout> i_layout, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
+        layout(std::move(i_layout)),
         offset(i_offset),
         textColor(i_textColor),
-        backgroundColor(i_backgroundColor) {
-            using std::swap;
-            swap(vertices, i_vertices);
-        }
+        backgroundColor(i_backgroundColor) {}
 
         TextRenderer::EntryCollection::EntryCollection() :
         textVertexCount(0),
@@ -70,46 +68,75 @@ namespace TrenchBroom {
             renderString(renderContext, textColor, backgroundColor, string, position, true);
         }
 
-        void TextRenderer::renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, const bool onTop) {
+        void TextRenderer::renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const std::string& string, const TextAnchor& position) {
+            renderString(renderContext, textColor, backgroundColor, string, position, false);
+        }
 
-            const Camera& camera = renderContext.camera();
-            const float distance = camera.perpendicularDistanceTo(position.position(camera));
-            if (distance <= 0.0f)
+        void TextRenderer::renderStringOnTop(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const std::string& string, const TextAnchor& position) {
+            renderString(renderContext, textColor, backgroundColor, string, position, true);
+        }
+
+        void TextRenderer::renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, const bool onTop) {
+            // cull by distance and zoom before looking at the string at all
+            const float distance = distanceTo(renderContext, position);
+            if (!isVisible(renderContext, distance, onTop))
                 return;
 
-            if (!isVisible(renderContext, string, position, distance, onTop))
+            renderLayout(renderContext, textColor, backgroundColor, font(renderContext).layout(string), position, distance, onTop);
+        }
+
+        void TextRenderer::renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const std::string& string, const TextAnchor& position, const bool onTop) {
+            const float distance = distanceTo(renderContext, position);
+            if (!isVisible(renderContext, distance, onTop))
                 return;
 
-            FontManager& fontManager = renderContext.fontManager();
-            TextureFont& font = fontManager.font(m_fontDescriptor);
+            renderLayout(renderContext, textColor, backgroundColor, font(renderContext).layout(string), position, distance, onTop);
+        }
+
+        void TextRenderer::renderLayout(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, std::shared_ptr<const TextureFont::Layout> layout, const TextAnchor& position, const float distance, const bool onTop) {
+            if (!isVisible(renderContext, round(layout->size), position))
+                return;
 
-            std::vector<vm::vec2f> vertices = font.quads(string, true);
+            const Camera& camera = renderContext.camera();
             const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-            const vm::vec2f size = font.measure(string);
-            const vm::vec3f offset = position.offset(camera, size);
+            const vm::vec3f offset = position.offset(camera, layout->size);
 
             if (onTop)
-                addEntry(m_entriesOnTop, Entry(vertices, size, offset,
+                addEntry(m_entriesOnTop, Entry(std::move(layout), offset,
                                                Color(textColor, alphaFactor * textColor.a()),
                                                Color(backgroundColor, alphaFactor * backgroundColor.a())));
             else
-                addEntry(m_entries, Entry(vertices, size, offset,
+                addEntry(m_entries, Entry(std::move(layout), offset,
                                           Color(textColor, alphaFactor * textColor.a()),
                                           Color(backgroundColor, alphaFactor * backgroundColor.a())));
         }
 
-        bool TextRenderer::isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, const float distance, const bool onTop) const {
+        TextureFont& TextRenderer::font(RenderContext& renderContext) const {
+            FontManager& fontManager = renderContext.fontManager();
+            return fontManager.font(m_fontDescriptor);
+        }
+
+        float TextRenderer::distanceTo(RenderContext& renderContext, const TextAnchor& position) const {
+            const Camera& camera = renderContext.camera();
+            return camera.perpendicularDistanceTo(position.position(camera));
+        }
+
+        bool TextRenderer::isVisible(RenderContext& renderContext, const float distance, const bool onTop) const {
+            if (distance <= 0.0f)
+                return false;
             if (!onTop) {
                 if (renderContext.render3D() && distance > m_maxViewDistance)
                     return false;
                 if (renderContext.render2D() && renderContext.camera().zoom() < m_minZoomFactor)
                     return false;
             }
+            return true;
+        }
 
+        bool TextRenderer::isVisible(RenderContext& renderContext, const vm::vec2f& size, const TextAnchor& position) const {
             const Camera& camera = renderContext.camera();
             const Camera::Viewport& viewport = camera.viewport();
 
-            const vm::vec2f size = stringSize(renderContext, string);
             const vm::vec2f offset = vm::vec2f(position.offset(camera, size)) - m_inset;
             const vm::vec2f actualSize = size + 2.0f * m_inset;
 
@@ -136,22 +163,18 @@ namespace TrenchBroom {
 
         void TextRenderer::addEntry(EntryCollection& collection, const Entry& entry) {
             collection.entries.push_back(entry);
-            collection.textVertexCount += entry.vertices.size();
+            collection.textVertexCount += entry.layout->quads.size() / 2;
             collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
         }
 
-        vm::vec2f TextRenderer::stringSize(RenderContext& renderContext, const AttrString& string) const {
-            FontManager& fontManager = renderContext.fontManager();
-            TextureFont& font = fontManager.font(m_fontDescriptor);
-            return round(font.measure(string));
-        }
-
         void TextRenderer::doPrepareVertices(VboManager& vboManager) {
             prepare(m_entries, false, vboManager);
             prepare(m_entriesOnTop, true, vboManager);
         }
 
         void TextRenderer::prepare(EntryCollection& collection, const bool onTop, VboManager& vboManager) {
+            const ProfileScope profile("TextRenderer::prepare");
+
             std::vector<TextVertex> textVertices;
             textVertices.reserve(collection.textVertexCount);
 
@@ -162,16 +185,16 @@ namespace TrenchBroom {
                 addEntry(entry, onTop, textVertices, rectVertices);
             }
 
-            collection.textArray = VertexArray::move(std::move(textVertices));
-            collection.rectArray = VertexArray::move(std::move(rectVertices));
+            collection.textArray = VertexArray::stream(std::move(textVertices));
+            collection.rectArray = VertexArray::stream(std::move(rectVertices));
 
             collection.textArray.prepare(vboManager);
             collection.rectArray.prepare(vboManager);
         }
 
         void TextRenderer::addEntry(const Entry& entry, const bool /* onTop */, std::vector<TextVertex>& textVertices, std::vector<RectVertex>& rectVertices) {
-            const std::vector<vm::vec2f>& stringVertices = entry.vertices;
-            const vm::vec2f& stringSize = entry.size;
+            const std::vector<vm::vec2f>& stringVertices = entry.layout->quads;
+            const vm::vec2f& stringSize = entry.layout->size;
 
             const vm::vec3f& offset = entry.offset;
 
@@ -192,6 +215,8 @@ namespace TrenchBroom {
         }
 
         void TextRenderer::doRender(RenderContext& renderContext) {
+            const ProfileScope profile("TextRenderer::render");
+
             const Camera::Viewport& viewport = renderContext.camera().viewport();
             const vm::mat4x4f projection = vm::ortho_matrix(
                 0.0f, 1.0f,
@@ -23,12 +23,15 @@
 #include "Color.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/TextureFont.h"
 #include "Renderer/VertexArray.h"
 #include "Renderer/GLVertexType.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace TrenchBroom {
@@ -46,13 +49,12 @@ namespace TrenchBroom {
             static const float RectCornerRadius;
 
             struct Entry {
-                std::vector<vm::vec2f> vertices;
-                vm::vec2f size;
+                std::shared_ptr<const TextureFont::Layout> layout;
                 vm::vec3f offset;
                 Color textColor;
                 Color backgroundColor;
 
-                Entry(std::vector<vm::vec2f>& i_vertices, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
+                Entry(std::shared_ptr<const TextureFont::Layout> i_layout, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
             };
 
             using EntryList = std::vector<Entry>;
@@ -83,14 +85,24 @@ namespace TrenchBroom {
 
             void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position);
             void renderStringOnTop(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position);
+
+            /**
+             * Renders a single line string. The layouts of such strings are cached by the font, so this is the
+             * preferred way to render labels that are drawn every frame.
+             */
+            void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const std::string& string, const TextAnchor& position);
+            void renderStringOnTop(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const std::string& string, const TextAnchor& position);
         private:
             void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, bool onTop);
+            void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const std::string& string, const TextAnchor& position, bool onTop);
+            void renderLayout(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, std::shared_ptr<const TextureFont::Layout> layout, const TextAnchor& position, float distance, bool onTop);
 
-            bool isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, float distance, bool onTop) const;
+            TextureFont& font(RenderContext& renderContext) const;
+            float distanceTo(RenderContext& renderContext, const TextAnchor& position) const;
+            bool isVisible(RenderContext& renderContext, float distance, bool onTop) const;
+            bool isVisible(RenderContext& renderContext, const vm::vec2f& size, const TextAnchor& position) const;
             float computeAlphaFactor(const RenderContext& renderContext, float distance, bool onTop) const;
             void addEntry(EntryCollection& collection, const Entry& entry);
-
-            vm::vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
         private:
             void doPrepareVertices(VboManager& vboManager) override;
             void prepare(EntryCollection& collection, bool onTop, VboManager& vboManager);
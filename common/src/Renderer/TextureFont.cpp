@@ -28,10 +28,13 @@
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <cassert>
 #include <string>
 
 namespace TrenchBroom {
     namespace Renderer {
+        const size_t TextureFont::MaxCachedLayouts = 4096;
+
         TextureFont::TextureFont(std::unique_ptr<FontTexture> texture, const std::vector<FontGlyph>& glyphs, const int lineHeight, const unsigned char firstChar, const unsigned char charCount) :
         m_texture(std::move(texture)),
         m_glyphs(glyphs),
@@ -172,6 +175,40 @@ namespace TrenchBroom {
             return measureString.size();
         }
 
+        std::shared_ptr<const TextureFont::Layout> TextureFont::layout(const AttrString& string) const {
+            auto layout = std::make_shared<Layout>();
+            layout->quads = quads(string, true);
+            layout->size = measure(string);
+            return layout;
+        }
+
+        std::shared_ptr<const TextureFont::Layout> TextureFont::layout(const std::string& string) {
+            auto it = m_layoutCache.find(string);
+            if (it != std::end(m_layoutCache)) {
+                auto& cachedLayout = it->second;
+                m_layoutCacheOrder.splice(std::begin(m_layoutCacheOrder), m_layoutCacheOrder, cachedLayout.orderPosition);
+                return cachedLayout.layout;
+            }
+
+            if (m_layoutCache.size() >= MaxCachedLayouts) {
+                // evict the least recently used layout; if it is still referenced, it stays alive through its
+                // shared pointer
+                const auto lru = m_layoutCache.find(*m_layoutCacheOrder.back());
+                assert(lru != std::end(m_layoutCache));
+                m_layoutCacheOrder.pop_back();
+                m_layoutCache.erase(lru);
+            }
+
+            auto layout = std::make_shared<Layout>();
+            layout->quads = quads(string, true);
+            layout->size = measure(string);
+
+            it = m_layoutCache.emplace(string, CachedLayout{ std::move(layout), std::end(m_layoutCacheOrder) }).first;
+            m_layoutCacheOrder.push_front(&it->first);
+            it->second.orderPosition = std::begin(m_layoutCacheOrder);
+            return it->second.layout;
+        }
+
         std::vector<vm::vec2f> TextureFont::quads(const std::string& string, const bool clockwise, const vm::vec2f& offset) const {
             std::vector<vm::vec2f> result;
             result.reserve(string.length() * 4 * 2);
@@ -21,27 +21,53 @@
 #define TrenchBroom_Font
 
 #include "Macros.h"
+#include "Renderer/AttrString.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <list>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
-        class AttrString;
         class FontGlyph;
         class FontTexture;
 
         class TextureFont {
+        public:
+            /**
+             * The glyph quads of a string laid out at the origin in clockwise order, together with its size.
+             */
+            struct Layout {
+                std::vector<vm::vec2f> quads;
+                vm::vec2f size;
+            };
         private:
+            static const size_t MaxCachedLayouts;
+
             std::unique_ptr<FontTexture> m_texture;
             std::vector<FontGlyph> m_glyphs;
             int m_lineHeight;
 
             unsigned char m_firstChar;
             unsigned char m_charCount;
+
+            /**
+             * The cached layouts of single line strings. The most recently used string is at the front of
+             * m_layoutCacheOrder, which points to the keys of m_layoutCache, and the least recently used one is evicted
+             * when the cache is full.
+             */
+            struct CachedLayout {
+                std::shared_ptr<const Layout> layout;
+                std::list<const std::string*>::iterator orderPosition;
+            };
+
+            std::unordered_map<std::string, CachedLayout> m_layoutCache;
+            std::list<const std::string*> m_layoutCacheOrder;
         public:
             TextureFont(std::unique_ptr<FontTexture> texture, const std::vector<FontGlyph>& glyphs, int lineHeight, unsigned char firstChar, unsigned char charCount);
             ~TextureFont();
@@ -51,6 +77,21 @@ namespace TrenchBroom {
             std::vector<vm::vec2f> quads(const AttrString& string, bool clockwise, const vm::vec2f& offset = vm::vec2f::zero()) const;
             vm::vec2f measure(const AttrString& string) const;
 
+            /**
+             * Returns the layout of the given string. Attributed strings are not cached; use the overload for single
+             * line strings for labels that are rendered every frame.
+             */
+            std::shared_ptr<const Layout> layout(const AttrString& string) const;
+
+            /**
+             * Returns the layout of the given single line string, computing it only if it isn't cached yet. Labels such
+             * as entity classnames are rendered every frame, but there are only few distinct ones, so this avoids
+             * laying them out again and again. The lookup does not copy the string.
+             *
+             * The returned layout remains valid even if it is evicted from the cache later.
+             */
+            std::shared_ptr<const Layout> layout(const std::string& string);
+
             std::vector<vm::vec2f> quads(const std::string& string, bool clockwise, const vm::vec2f& offset = vm::vec2f::zero()) const;
             vm::vec2f measure(const std::string& string) const;
 
@@ -25,15 +25,23 @@
 
 namespace TrenchBroom {
     namespace Renderer {
-        Vbo::Vbo(GLenum type, const size_t capacity, const GLenum usage) :
+        Vbo::Vbo(VboManager& vboManager, GLenum type, const size_t capacity, const GLenum usage) :
+        m_vboManager(vboManager),
         m_type(type),
-        m_capacity(capacity) {
+        m_capacity(capacity),
+        m_usage(usage) {
             assert(m_type == GL_ELEMENT_ARRAY_BUFFER
                    || m_type == GL_ARRAY_BUFFER);
 
             glAssert(glGenBuffers(1, &m_bufferId));
             glAssert(glBindBuffer(m_type, m_bufferId));
-            glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, usage));
+            glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, m_usage));
+        }
+
+        void Vbo::orphan() {
+            assert(m_bufferId != 0);
+            glAssert(glBindBuffer(m_type, m_bufferId));
+            glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, m_usage));
         }
 
         void Vbo::free() {
@@ -38,17 +38,26 @@ namespace TrenchBroom {
             /**
              * e.g. GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
              */
+            VboManager& m_vboManager;
             GLenum m_type;
             size_t m_capacity;
+            GLenum m_usage;
             GLuint m_bufferId;
 
             /**
              * Immediately creates and binds to a buffer of the given type and capacity.
              * The contents are initially unspecified.
              */
-            Vbo(GLenum type, size_t capacity, GLenum usage);
+            Vbo(VboManager& vboManager, GLenum type, size_t capacity, GLenum usage);
             ~Vbo();
 
+            /**
+             * Replaces the storage of the underlying OpenGL buffer with new, uninitialized storage of the same size.
+             * Draw calls that were already issued keep using the old storage, so the buffer can be rewritten without
+             * waiting for them to complete.
+             */
+            void orphan();
+
             /**
              * Deletes the underlying OpenGL buffer with glDeleteBuffers.
              * Must be called before the destructor.
@@ -99,6 +108,7 @@ namespace TrenchBroom {
                 glAssert(glBindBuffer(m_type, m_bufferId));
                 glAssert(glBufferSubData(m_type, offset, sizei, ptr));
 
+                m_vboManager.countUploadedBytes(size);
                 return size;
             }
         };
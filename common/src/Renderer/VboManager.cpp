@@ -24,6 +24,7 @@
 #include "Macros.h"
 
 #include <algorithm> // for std::max
+#include <cassert>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -52,13 +53,27 @@ namespace TrenchBroom {
 
         // VboManager
 
+        const size_t VboManager::InitialStreamingVboSize = 1024u * 1024u;
+        const size_t VboManager::StreamingAlignment = 16u;
+
         VboManager::VboManager() :
         m_peakVboCount(0u),
         m_currentVboCount(0u),
-        m_currentVboSize(0u) {}
+        m_currentVboSize(0u),
+        m_streamingVbo(nullptr),
+        m_streamingOffset(0u),
+        m_uploadedBytes(0u),
+        m_streamedBytes(0u),
+        m_lastFrameUploadedBytes(0u),
+        m_lastFrameStreamedBytes(0u) {}
+
+        VboManager::~VboManager() {
+            assert(m_streamingVbo == nullptr);
+            assert(m_retiredStreamingVbos.empty());
+        }
 
         Vbo* VboManager::allocateVbo(VboType type, const size_t capacity, const VboUsage usage) {
-            auto* result = new Vbo(typeToOpenGL(type), capacity, usageToOpenGL(usage));
+            auto* result = new Vbo(*this, typeToOpenGL(type), capacity, usageToOpenGL(usage));
 
             m_currentVboSize += capacity;
             m_currentVboCount++;
@@ -75,6 +90,59 @@ namespace TrenchBroom {
             delete vbo;
         }
 
+        std::pair<Vbo*, size_t> VboManager::allocateStreamingRange(const size_t size) {
+            auto offset = (m_streamingOffset + StreamingAlignment - 1u) / StreamingAlignment * StreamingAlignment;
+            if (m_streamingVbo == nullptr || offset + size > m_streamingVbo->capacity()) {
+                size_t capacity = InitialStreamingVboSize;
+                if (m_streamingVbo != nullptr) {
+                    // the current buffer still holds data for this frame, keep it alive until the next one
+                    m_retiredStreamingVbos.push_back(m_streamingVbo);
+                    capacity = 2u * m_streamingVbo->capacity();
+                }
+
+                m_streamingVbo = allocateVbo(VboType::ArrayBuffer, std::max(capacity, size), VboUsage::DynamicDraw);
+                offset = 0u;
+            }
+
+            m_streamingOffset = offset + size;
+            m_streamedBytes += size;
+            return { m_streamingVbo, offset };
+        }
+
+        void VboManager::beginFrame() {
+            for (auto* vbo : m_retiredStreamingVbos) {
+                destroyVbo(vbo);
+            }
+            m_retiredStreamingVbos.clear();
+
+            if (m_streamingVbo != nullptr && m_streamingOffset > 0u) {
+                m_streamingVbo->orphan();
+            }
+            m_streamingOffset = 0u;
+
+            m_lastFrameUploadedBytes = m_uploadedBytes;
+            m_lastFrameStreamedBytes = m_streamedBytes;
+            m_uploadedBytes = 0u;
+            m_streamedBytes = 0u;
+        }
+
+        void VboManager::destroyStreamingVbos() {
+            for (auto* vbo : m_retiredStreamingVbos) {
+                destroyVbo(vbo);
+            }
+            m_retiredStreamingVbos.clear();
+
+            if (m_streamingVbo != nullptr) {
+                destroyVbo(m_streamingVbo);
+                m_streamingVbo = nullptr;
+            }
+            m_streamingOffset = 0u;
+        }
+
+        void VboManager::countUploadedBytes(const size_t bytes) {
+            m_uploadedBytes += bytes;
+        }
+
         size_t VboManager::peakVboCount() const {
             return m_peakVboCount;
         }
@@ -86,5 +154,13 @@ namespace TrenchBroom {
         size_t VboManager::currentVboSize() const {
             return m_currentVboSize;
         }
+
+        size_t VboManager::lastFrameUploadedBytes() const {
+            return m_lastFrameUploadedBytes;
+        }
+
+        size_t VboManager::lastFrameStreamedBytes() const {
+            return m_lastFrameStreamedBytes;
+        }
     }
 }
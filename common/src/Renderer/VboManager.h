@@ -23,6 +23,8 @@
 #include "Renderer/GL.h"
 
 #include <cstddef> // for size_t
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -40,11 +42,29 @@ namespace TrenchBroom {
 
         class VboManager {
         private:
+            static const size_t InitialStreamingVboSize;
+            static const size_t StreamingAlignment;
+
             size_t m_peakVboCount;
             size_t m_currentVboCount;
             size_t m_currentVboSize;
+
+            Vbo* m_streamingVbo;
+            size_t m_streamingOffset;
+            /**
+             * Streaming buffers that ran out of space during the current frame. Their contents are still needed
+             * until the frame is rendered, so they are destroyed when the next frame begins.
+             */
+            std::vector<Vbo*> m_retiredStreamingVbos;
+
+            size_t m_uploadedBytes;
+            size_t m_streamedBytes;
+            size_t m_lastFrameUploadedBytes;
+            size_t m_lastFrameStreamedBytes;
         public:
             VboManager();
+            ~VboManager();
+
             /**
             * Immediately creates and binds to an OpenGL buffer of the given type and capacity.
             * The contents are initially unspecified. See Vbo class.
@@ -52,9 +72,49 @@ namespace TrenchBroom {
             Vbo* allocateVbo(VboType type, size_t capacity, VboUsage usage = VboUsage::StaticDraw);
             void destroyVbo(Vbo* vbo);
 
+            /**
+             * Sub-allocates a range of the given size from the streaming buffer, which holds transient vertex data
+             * that is rendered once in the current frame. Returns the buffer and the byte offset of the range.
+             *
+             * The range remains valid until beginFrame() is called. The buffer is owned by this manager and must not
+             * be destroyed by the caller.
+             */
+            std::pair<Vbo*, size_t> allocateStreamingRange(size_t size);
+
+            /**
+             * Recycles the streaming buffer and resets the per frame upload statistics. Must be called exactly once at
+             * the start of every frame, before any transient data of that frame is prepared, so that everything
+             * streamed during a frame stays valid until the frame has been rendered completely.
+             *
+             * Instead of waiting for the GPU with fences, the streaming buffer is orphaned so that the driver can hand
+             * out fresh storage while the previous frame is still in flight.
+             */
+            void beginFrame();
+
+            /**
+             * Destroys the streaming buffers. This must be called while the OpenGL context is current before this
+             * manager is destroyed, since the destructor cannot rely on a current context and does not issue any
+             * OpenGL calls.
+             */
+            void destroyStreamingVbos();
+
+            /**
+             * Records that the given number of bytes was uploaded into a buffer owned by this manager.
+             */
+            void countUploadedBytes(size_t bytes);
+
             size_t peakVboCount() const;
             size_t currentVboCount() const;
             size_t currentVboSize() const;
+
+            /**
+             * The number of bytes uploaded into all buffers during the previous frame, including streamed bytes.
+             */
+            size_t lastFrameUploadedBytes() const;
+            /**
+             * The number of bytes uploaded into the streaming buffer during the previous frame.
+             */
+            size_t lastFrameStreamedBytes() const;
         };
     }
 }
@@ -30,6 +30,7 @@
 #include <kdl/vector_utils.h>
 
 #include <memory>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
@@ -62,7 +63,9 @@ namespace TrenchBroom {
             private:
                 VboManager* m_vboManager;
                 Vbo* m_vbo;
+                size_t m_offset;
                 size_t m_vertexCount;
+                bool m_streaming;
             public:
                 size_t vertexCount() const override {
                     return m_vertexCount;
@@ -75,15 +78,19 @@ namespace TrenchBroom {
                 void prepare(VboManager& vboManager) override {
                     if (m_vertexCount > 0 && m_vbo == nullptr) {
                         m_vboManager = &vboManager;
-                        m_vbo = vboManager.allocateVbo(VboType::ArrayBuffer, sizeInBytes());;
-                        m_vbo->writeBuffer(0, doGetVertices());
+                        if (m_streaming) {
+                            std::tie(m_vbo, m_offset) = vboManager.allocateStreamingRange(sizeInBytes());
+                        } else {
+                            m_vbo = vboManager.allocateVbo(VboType::ArrayBuffer, sizeInBytes());
+                        }
+                        m_vbo->writeBuffer(m_offset, doGetVertices());
                     }
                 }
 
                 void setup() override {
                     ensure(m_vbo != nullptr, "block is null");
                     m_vbo->bind();
-                    VertexSpec::setup(m_vbo->offset());
+                    VertexSpec::setup(m_vbo->offset() + m_offset);
                 }
 
                 void cleanup() override {
@@ -91,15 +98,18 @@ namespace TrenchBroom {
                     m_vbo->unbind();
                 }
             protected:
-                Holder(const size_t vertexCount) :
+                Holder(const size_t vertexCount, const bool streaming) :
                 m_vboManager(nullptr),
                 m_vbo(nullptr),
-                m_vertexCount(vertexCount) {}
+                m_offset(0),
+                m_vertexCount(vertexCount),
+                m_streaming(streaming) {}
 
                 ~Holder() override {
                     // TODO: Revisit this revisiting OpenGL resource management. We should not store the VboManager,
                     // since it represents a safe time to delete the OpenGL buffer object.
-                    if (m_vbo != nullptr) {
+                    // Streamed vertices live in a buffer owned by the VboManager.
+                    if (m_vbo != nullptr && !m_streaming) {
                         m_vboManager->destroyVbo(m_vbo);
                         m_vbo = nullptr;
                     }
@@ -117,11 +127,11 @@ namespace TrenchBroom {
                 VertexList m_vertices;
             public:
                 ByValueHolder(const VertexList& vertices) :
-                Holder<VertexSpec>(vertices.size()),
+                Holder<VertexSpec>(vertices.size(), false),
                 m_vertices(vertices) {}
 
-                ByValueHolder(VertexList&& vertices) :
-                Holder<VertexSpec>(vertices.size()),
+                ByValueHolder(VertexList&& vertices, const bool streaming = false) :
+                Holder<VertexSpec>(vertices.size(), streaming),
                 m_vertices(std::move(vertices)) {}
 
                 void prepare(VboManager& vboManager) override {
@@ -142,7 +152,7 @@ namespace TrenchBroom {
                 const VertexList& m_vertices;
             public:
                 ByRefHolder(const VertexList& vertices) :
-                Holder<VertexSpec>(vertices.size()),
+                Holder<VertexSpec>(vertices.size(), false),
                 m_vertices(vertices) {}
             private:
                 const VertexList& doGetVertices() const override {
@@ -184,6 +194,23 @@ namespace TrenchBroom {
                 return VertexArray(std::make_shared<ByValueHolder<typename GLVertex<Attrs...>::Type>>(std::move(vertices)));
             }
 
+            /**
+             * Creates a new vertex array by moving the contents of the given vertices. When the vertex array is
+             * prepared, the vertices are uploaded into the streaming buffer of the given VBO manager instead of a
+             * buffer of their own.
+             *
+             * Use this for transient geometry such as tool feedback that is rendered only once. The vertex array must
+             * not be rendered after the frame in which it was prepared, see VboManager::beginFrame.
+             *
+             * @tparam Attrs the vertex attribute types
+             * @param vertices the vertices to move
+             * @return the vertex array
+             */
+            template <typename... Attrs>
+            static VertexArray stream(std::vector<GLVertex<Attrs...>>&& vertices) {
+                return VertexArray(std::make_shared<ByValueHolder<typename GLVertex<Attrs...>::Type>>(std::move(vertices), true));
+            }
+
             /**
              * Creates a new vertex array by referencing the contents of the given vertices. After this operation, the
              * given vector of vertices is left unchanged. Since this vertex array will only store a reference to the
@@ -1536,6 +1536,25 @@ namespace TrenchBroom {
                     [](ActionExecutionContext&) {
                         return true;
                     }));
+            helpMenu.addSeparator();
+            helpMenu.addItem(createMenuAction(IO::Path("Menu/Help/Profile Rendering"), QObject::tr("Profile Rendering"), 0,
+                [](ActionExecutionContext& context) {
+                    context.frame()->toggleRenderProfiler();
+                },
+                [](ActionExecutionContext& context) {
+                    return context.hasDocument();
+                },
+                [](ActionExecutionContext& context) {
+                    return context.hasDocument() && context.frame()->renderProfilerEnabled();
+                }));
+            helpMenu.addItem(createMenuAction(IO::Path("Menu/Help/Export Render Profile..."), QObject::tr("Export Render Profile..."), 0,
+                [](ActionExecutionContext& context) {
+                    context.frame()->exportRenderProfile();
+                },
+                [](ActionExecutionContext& context) {
+                    return context.hasDocument();
+                }));
+            helpMenu.addSeparator();
             helpMenu.addItem(createMenuAction(IO::Path("Menu/File/About TrenchBroom"), QObject::tr("About TrenchBroom"), 0,
                 [](ActionExecutionContext&) {
                     auto& app = TrenchBroomApp::instance();
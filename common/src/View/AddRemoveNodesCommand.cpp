@@ -21,6 +21,7 @@
 
 #include "Ensure.h"
 #include "Macros.h"
+#include "Model/EstimateMemoryUsageVisitor.h"
 #include "Model/Node.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -116,5 +117,15 @@ namespace TrenchBroom {
         bool AddRemoveNodesCommand::doCollateWith(UndoableCommand*) {
             return false;
         }
+
+        size_t AddRemoveNodesCommand::doGetMemoryUsage() const {
+            // the command owns the nodes that are currently detached from the document
+            size_t result = sizeof(*this) + name().capacity();
+            result += Model::estimateMemoryUsage(m_nodesToAdd) + Model::estimateMemoryUsage(m_nodesToRemove);
+            for (const auto& entry : m_nodesToAdd) {
+                result += Model::estimateMemoryUsage(entry.second);
+            }
+            return result;
+        }
     }
 }
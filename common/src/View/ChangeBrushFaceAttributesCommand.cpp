@@ -71,5 +71,13 @@ namespace TrenchBroom {
             ChangeBrushFaceAttributesCommand* other = static_cast<ChangeBrushFaceAttributesCommand*>(command);
             return m_request.collateWith(other->m_request);
         }
+
+        size_t ChangeBrushFaceAttributesCommand::doGetMemoryUsage() const {
+            size_t result = sizeof(*this) + name().capacity();
+            if (m_snapshot != nullptr) {
+                result += m_snapshot->memoryUsage();
+            }
+            return result;
+        }
     }
 }
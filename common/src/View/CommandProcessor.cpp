@@ -19,8 +19,10 @@
 
 #include "CommandProcessor.h"
 
+#include "Ensure.h"
 #include "Exceptions.h"
 #include "Notifier.h"
+#include "IO/SpillFile.h"
 #include "View/Command.h"
 #include "View/UndoableCommand.h"
 
@@ -29,6 +31,7 @@
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
+#include <iterator>
 
 #include <QDateTime>
 
@@ -142,6 +145,20 @@ namespace TrenchBroom {
             bool doCollateWith(UndoableCommand*) override {
                 return false;
             }
+
+            size_t doGetMemoryUsage() const override {
+                size_t result = sizeof(*this) + name().capacity();
+                for (const auto& command : m_commands) {
+                    result += command->memoryUsage();
+                }
+                return result;
+            }
+
+            void doSpill(const std::shared_ptr<IO::SpillFile>& file) override {
+                for (auto& command : m_commands) {
+                    command->spill(file);
+                }
+            }
         };
 
         const Command::CommandType CommandProcessor::TransactionCommand::Type = Command::freeType();
@@ -149,6 +166,10 @@ namespace TrenchBroom {
         CommandProcessor::CommandProcessor(MapDocumentCommandFacade* document, const std::chrono::milliseconds collationInterval) :
         m_document(document),
         m_collationInterval(collationInterval),
+        m_undoMemoryBudget(0u),
+        m_undoMemoryUsage(0u),
+        m_discardUndoOverBudget(false),
+        m_spilledCommandCount(0u),
         m_lastCommandTimestamp(std::chrono::time_point<std::chrono::system_clock>()) {}
 
         CommandProcessor::~CommandProcessor() = default;
@@ -177,6 +198,32 @@ namespace TrenchBroom {
             }
         }
 
+        size_t CommandProcessor::undoMemoryBudget() const {
+            return m_undoMemoryBudget;
+        }
+
+        void CommandProcessor::setUndoMemoryBudget(const size_t budget) {
+            m_undoMemoryBudget = budget;
+            if (m_transactionStack.empty()) {
+                enforceUndoMemoryBudget();
+            }
+        }
+
+        bool CommandProcessor::discardUndoOverBudget() const {
+            return m_discardUndoOverBudget;
+        }
+
+        void CommandProcessor::setDiscardUndoOverBudget(const bool discardUndoOverBudget) {
+            m_discardUndoOverBudget = discardUndoOverBudget;
+            if (m_transactionStack.empty()) {
+                enforceUndoMemoryBudget();
+            }
+        }
+
+        size_t CommandProcessor::undoMemoryUsage() const {
+            return m_undoMemoryUsage;
+        }
+
         void CommandProcessor::startTransaction(const std::string& name) {
             m_transactionStack.push_back(TransactionState(name));
         }
@@ -206,6 +253,8 @@ namespace TrenchBroom {
             if (result->success()) {
                 m_undoStack.clear();
                 m_redoStack.clear();
+                clearMemoryUsage();
+                m_spilledCommandCount = 0u;
             }
             return result;
         }
@@ -241,6 +290,7 @@ namespace TrenchBroom {
                 auto result = executeCommand(command.get());
                 if (result->success()) {
                     assertResult(pushToUndoStack(std::move(command), false, true))
+                    enforceUndoMemoryBudget();
                 }
                 return result;
             }
@@ -281,6 +331,8 @@ namespace TrenchBroom {
             clearRepeatStack();
             m_undoStack.clear();
             m_redoStack.clear();
+            clearMemoryUsage();
+            m_spilledCommandCount = 0u;
             m_lastCommandTimestamp = std::chrono::time_point<std::chrono::system_clock>();
         }
 
@@ -290,8 +342,11 @@ namespace TrenchBroom {
                 return SubmitAndStoreResult(std::move(commandResult), false);
             }
 
+            clearRedoStack();
             const auto commandStored = storeCommand(std::move(command), collate, repeatable);
-            m_redoStack.clear();
+            if (m_transactionStack.empty()) {
+                enforceUndoMemoryBudget();
+            }
             return SubmitAndStoreResult(std::move(commandResult), commandStored);
         }
 
@@ -354,6 +409,7 @@ namespace TrenchBroom {
 
                 if (m_transactionStack.empty()) {
                     pushToUndoStack(std::move(command), false, true);
+                    enforceUndoMemoryBudget();
                 } else {
                     pushTransactionCommand(std::move(command), false);
                 }
@@ -379,6 +435,8 @@ namespace TrenchBroom {
             if (collatable(collate, timestamp)) {
                 auto& lastCommand = m_undoStack.back();
                 if (lastCommand->collateWith(command.get())) {
+                    removeMemoryUsage(lastCommand.get());
+                    addMemoryUsage(lastCommand.get());
                     return false;
                 }
             }
@@ -387,6 +445,7 @@ namespace TrenchBroom {
                 pushToRepeatStack(command.get());
             }
 
+            addMemoryUsage(command.get());
             m_undoStack.push_back(std::move(command));
             return true;
         }
@@ -397,6 +456,8 @@ namespace TrenchBroom {
 
             auto lastCommand = kdl::vec_pop_back(m_undoStack);
             popFromRepeatStack(lastCommand.get());
+            removeMemoryUsage(lastCommand.get());
+            m_spilledCommandCount = std::min(m_spilledCommandCount, m_undoStack.size());
             return lastCommand;
         }
 
@@ -406,6 +467,7 @@ namespace TrenchBroom {
 
         void CommandProcessor::pushToRedoStack(std::unique_ptr<UndoableCommand> command) {
             assert(m_transactionStack.empty());
+            addMemoryUsage(command.get());
             m_redoStack.push_back(std::move(command));
         }
 
@@ -413,7 +475,90 @@ namespace TrenchBroom {
             assert(m_transactionStack.empty());
             assert(!m_redoStack.empty());
 
-            return kdl::vec_pop_back(m_redoStack);
+            auto command = kdl::vec_pop_back(m_redoStack);
+            removeMemoryUsage(command.get());
+            return command;
+        }
+
+        void CommandProcessor::clearRedoStack() {
+            for (const auto& command : m_redoStack) {
+                removeMemoryUsage(command.get());
+            }
+            m_redoStack.clear();
+        }
+
+        void CommandProcessor::addMemoryUsage(const UndoableCommand* command) {
+            const auto memoryUsage = command->memoryUsage();
+            m_commandMemoryUsage[command] = memoryUsage;
+            m_undoMemoryUsage += memoryUsage;
+        }
+
+        void CommandProcessor::removeMemoryUsage(const UndoableCommand* command) {
+            const auto it = m_commandMemoryUsage.find(command);
+            ensure(it != std::end(m_commandMemoryUsage), "memory usage was recorded for command");
+            assert(m_undoMemoryUsage >= it->second);
+
+            m_undoMemoryUsage -= it->second;
+            m_commandMemoryUsage.erase(it);
+        }
+
+        void CommandProcessor::clearMemoryUsage() {
+            m_commandMemoryUsage.clear();
+            m_undoMemoryUsage = 0u;
+        }
+
+        void CommandProcessor::enforceUndoMemoryBudget() {
+            assert(m_transactionStack.empty());
+
+            if (m_undoMemoryBudget == 0u || m_undoStack.empty()) {
+                return;
+            }
+
+            // never spill or remove the most recently executed command, it is the most likely to be undone
+            const auto lastIndex = m_undoStack.size() - 1u;
+            while (m_undoMemoryUsage > m_undoMemoryBudget && m_spilledCommandCount < lastIndex) {
+                if (!spillCommand(m_undoStack[m_spilledCommandCount].get())) {
+                    break;
+                }
+                ++m_spilledCommandCount;
+            }
+
+            if (m_undoMemoryUsage <= m_undoMemoryBudget || !m_discardUndoOverBudget) {
+                return;
+            }
+
+            auto it = std::begin(m_undoStack);
+            const auto last = std::prev(std::end(m_undoStack));
+            while (m_undoMemoryUsage > m_undoMemoryBudget && it != last) {
+                removeMemoryUsage(it->get());
+                kdl::vec_erase(m_repeatStack, it->get());
+                ++it;
+            }
+
+            const auto removedCount = static_cast<size_t>(std::distance(std::begin(m_undoStack), it));
+            m_undoStack.erase(std::begin(m_undoStack), it);
+            m_spilledCommandCount -= std::min(m_spilledCommandCount, removedCount);
+        }
+
+        bool CommandProcessor::spillCommand(UndoableCommand* command) {
+            // if spilling fails, the snapshots stay in memory
+            try {
+                if (m_spillFile == nullptr) {
+                    m_spillFile = std::make_shared<IO::SpillFile>();
+                }
+            } catch (const FileSystemException&) {
+                return false;
+            }
+
+            removeMemoryUsage(command);
+            auto result = true;
+            try {
+                command->spill(m_spillFile);
+            } catch (const FileSystemException&) {
+                result = false;
+            }
+            addMemoryUsage(command);
+            return result;
         }
 
         void CommandProcessor::pushToRepeatStack(UndoableCommand* command) {
@@ -25,9 +25,14 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
+    namespace IO {
+        class SpillFile;
+    }
+
     namespace View {
         class Command;
         class CommandResult;
@@ -50,6 +55,13 @@ namespace TrenchBroom {
          *
          * The command processor supports nested transactions. Each transaction can be committed or rolled back
          * individually. Committing a nested transaction adds it as a command to the containing transaction.
+         *
+         * The memory occupied by the command history can be limited by setting a memory budget. The command processor
+         * keeps track of the estimated memory usage of all commands on the undo and redo stacks. If a new command is
+         * stored and the usage exceeds the budget, the snapshots of the oldest commands on the undo stack are spilled
+         * to a temporary file until the usage fits into the budget again, and they are read back when the commands are
+         * undone. Only if that is not enough and discarding commands is enabled, the oldest commands are removed from
+         * the undo stack. The most recently executed command is never spilled or removed.
          */
         class CommandProcessor {
         private:
@@ -81,6 +93,42 @@ namespace TrenchBroom {
              */
             std::vector<UndoableCommand*> m_repeatStack;
 
+            /**
+             * The maximum number of bytes that the commands on the undo and redo stacks may occupy, or 0 if the
+             * command history is not limited.
+             */
+            size_t m_undoMemoryBudget;
+
+            /**
+             * The estimated number of bytes occupied by the commands on the undo and redo stacks.
+             */
+            size_t m_undoMemoryUsage;
+
+            /**
+             * The memory usage that was added to m_undoMemoryUsage for each command on the undo and redo stacks. The
+             * estimate of a command can change while it is stored, e.g. when it transfers ownership of nodes on undo,
+             * so exactly the recorded amount is subtracted again when the command leaves the stacks.
+             */
+            std::unordered_map<const UndoableCommand*, size_t> m_commandMemoryUsage;
+
+            /**
+             * Indicates whether the oldest commands are removed from the undo stack if spilling their snapshots does
+             * not suffice to meet the memory budget.
+             */
+            bool m_discardUndoOverBudget;
+
+            /**
+             * The temporary file that the snapshots of old commands are spilled to. It is created when it is first
+             * needed, and it is shared with the spilled snapshots so that they can be read back even after the command
+             * processor is destroyed.
+             */
+            std::shared_ptr<IO::SpillFile> m_spillFile;
+
+            /**
+             * The number of commands at the bottom of the undo stack that have been spilled.
+             */
+            size_t m_spilledCommandCount;
+
             /**
              * The time stamp of when the last command was executed.
              */
@@ -167,6 +215,36 @@ namespace TrenchBroom {
              */
             const std::string& redoCommandName() const;
 
+            /**
+             * Returns the maximum number of bytes that the command history may occupy, or 0 if it is not limited.
+             */
+            size_t undoMemoryBudget() const;
+
+            /**
+             * Sets the maximum number of bytes that the command history may occupy. Pass 0 to disable the limit. If the
+             * current usage exceeds the given budget, the budget is enforced immediately.
+             *
+             * @param budget the memory budget in bytes
+             */
+            void setUndoMemoryBudget(size_t budget);
+
+            /**
+             * Indicates whether the oldest commands are removed from the undo stack if the memory budget cannot be met
+             * by spilling snapshots. This is disabled by default, so that no undo history is lost.
+             */
+            bool discardUndoOverBudget() const;
+
+            /**
+             * Sets whether the oldest commands are removed from the undo stack if the memory budget cannot be met by
+             * spilling snapshots.
+             */
+            void setDiscardUndoOverBudget(bool discardUndoOverBudget);
+
+            /**
+             * Returns the estimated number of bytes occupied by the commands on the undo and redo stacks.
+             */
+            size_t undoMemoryUsage() const;
+
             /**
              * Starts a new transaction. If a transaction is currently executing, then the newly started transaction
              * becomes a nested transaction and will be added as a command to its parent transaction upon commit.
@@ -412,6 +490,47 @@ namespace TrenchBroom {
              */
             std::unique_ptr<UndoableCommand> popFromRedoStack();
 
+            /**
+             * Clears the redo stack and updates the memory usage accordingly.
+             */
+            void clearRedoStack();
+
+            /**
+             * Adds the current memory usage of the given command to the memory usage of the command history and records
+             * it for the given command.
+             *
+             * @param command the command that was stored on the undo or redo stack
+             */
+            void addMemoryUsage(const UndoableCommand* command);
+
+            /**
+             * Subtracts the memory usage that was recorded for the given command from the memory usage of the command
+             * history.
+             *
+             * @param command the command that was removed from the undo or redo stack
+             */
+            void removeMemoryUsage(const UndoableCommand* command);
+
+            /**
+             * Forgets the memory usage of all commands on the undo and redo stacks.
+             */
+            void clearMemoryUsage();
+
+            /**
+             * Spills the snapshots of the oldest commands on the undo stack until the memory usage of the command
+             * history fits into the memory budget, or until only the most recent command remains unspilled. If the
+             * usage still exceeds the budget and discarding commands is enabled, the oldest commands are then removed
+             * from the undo stack until the usage fits, or until only one command remains on the undo stack.
+             */
+            void enforceUndoMemoryBudget();
+
+            /**
+             * Spills the snapshots of the given command and updates its recorded memory usage.
+             *
+             * @return false if the spill file could not be created or written, and true otherwise
+             */
+            bool spillCommand(UndoableCommand* command);
+
             /**
              * Pushes the given command onto the repeat stack unless it is a repeat delimiter.
              *
@@ -29,6 +29,10 @@
 
 #include <kdl/memory_utils.h>
 
+#include <vecmath/vec.h>
+
+#include <utility>
+
 namespace TrenchBroom {
     namespace View {
         CreateComplexBrushTool::CreateComplexBrushTool(std::weak_ptr<MapDocument> document) :
@@ -39,8 +43,22 @@ namespace TrenchBroom {
             return *m_polyhedron;
         }
 
-        void CreateComplexBrushTool::update(const Model::Polyhedron3& polyhedron) {
-            *m_polyhedron = polyhedron;
+        void CreateComplexBrushTool::update(Model::Polyhedron3 polyhedron) {
+            *m_polyhedron = std::move(polyhedron);
+            polyhedronDidChange();
+        }
+
+        void CreateComplexBrushTool::addPoint(const vm::vec3& point) {
+            m_polyhedron->addPoint(point);
+            polyhedronDidChange();
+        }
+
+        void CreateComplexBrushTool::addPoints(const std::vector<vm::vec3>& points) {
+            m_polyhedron->addPoints(std::begin(points), std::end(points));
+            polyhedronDidChange();
+        }
+
+        void CreateComplexBrushTool::polyhedronDidChange() {
             if (m_polyhedron->closed()) {
                 auto document = kdl::mem_lock(m_document);
                 const auto game = document->game();
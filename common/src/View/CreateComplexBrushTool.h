@@ -20,10 +20,14 @@
 #ifndef TrenchBroom_CreateComplexBrushTool
 #define TrenchBroom_CreateComplexBrushTool
 
+#include "FloatType.h"
 #include "Model/Polyhedron3.h"
 #include "View/CreateBrushToolBase.h"
 
+#include <vecmath/forward.h>
+
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     namespace View {
@@ -34,8 +38,17 @@ namespace TrenchBroom {
             CreateComplexBrushTool(std::weak_ptr<MapDocument> document);
 
             const Model::Polyhedron3& polyhedron() const;
-            void update(const Model::Polyhedron3& polyhedron);
+            void update(Model::Polyhedron3 polyhedron);
+
+            /**
+             * Adds the given point(s) to the current polyhedron in place and updates the brush preview. This avoids
+             * copying the polyhedron and rebuilding its hull from scratch for each added point.
+             */
+            void addPoint(const vm::vec3& point);
+            void addPoints(const std::vector<vm::vec3>& points);
         private:
+            void polyhedronDidChange();
+
             bool doActivate() override;
             bool doDeactivate() override;
             void doBrushWasCreated() override;
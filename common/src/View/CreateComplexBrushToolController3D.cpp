@@ -43,6 +43,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <utility>
 
 namespace TrenchBroom {
     namespace View {
@@ -128,12 +129,9 @@ namespace TrenchBroom {
                 const auto  bottomLeft3 = unswizzle(vm::vec3(bottomLeft2,  swizzledPlane.zAt(bottomLeft2)),  axis);
                 const auto bottomRight3 = unswizzle(vm::vec3(bottomRight2, swizzledPlane.zAt(bottomRight2)), axis);
 
-                Model::Polyhedron3 polyhedron = m_oldPolyhedron;
-                polyhedron.addPoint(topLeft3);
-                polyhedron.addPoint(bottomLeft3);
-                polyhedron.addPoint(bottomRight3);
-                polyhedron.addPoint(topRight3);
-                m_tool->update(polyhedron);
+                auto polyhedron = m_oldPolyhedron;
+                polyhedron.addPoints({ topLeft3, bottomLeft3, bottomRight3, topRight3 });
+                m_tool->update(std::move(polyhedron));
             }
         };
 
@@ -186,7 +184,7 @@ namespace TrenchBroom {
                 const auto points = face->vertexPositions() + snappedRayDelta;
 
                 polyhedron.addPoints(points);
-                m_tool->update(polyhedron);
+                m_tool->update(std::move(polyhedron));
 
                 return DR_Continue;
             }
@@ -232,9 +230,7 @@ namespace TrenchBroom {
             const Model::BrushFace* face = Model::hitToFace(hit);
             const vm::vec3 snapped = grid.snap(hit.hitPoint(), face->boundary());
 
-            Model::Polyhedron3 polyhedron = m_tool->polyhedron();
-            polyhedron.addPoint(snapped);
-            m_tool->update(polyhedron);
+            m_tool->addPoint(snapped);
 
             return true;
         }
@@ -250,12 +246,8 @@ namespace TrenchBroom {
             if (!hit.isMatch())
                 return false;
 
-            Model::Polyhedron3 polyhedron = m_tool->polyhedron();
             const Model::BrushFace* face = Model::hitToFace(hit);
-
-            for (const Model::BrushVertex* vertex : face->vertices())
-                polyhedron.addPoint(vertex->position());
-            m_tool->update(polyhedron);
+            m_tool->addPoints(face->vertexPositions());
 
             return true;
         }
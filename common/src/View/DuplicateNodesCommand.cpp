@@ -19,6 +19,7 @@
 
 #include "DuplicateNodesCommand.h"
 
+#include "Model/EstimateMemoryUsageVisitor.h"
 #include "Model/Node.h"
 #include "Model/NodeVisitor.h"
 #include "View/MapDocumentCommandFacade.h"
@@ -118,5 +119,19 @@ namespace TrenchBroom {
         bool DuplicateNodesCommand::doCollateWith(UndoableCommand*) {
             return false;
         }
+
+        size_t DuplicateNodesCommand::doGetMemoryUsage() const {
+            size_t result = sizeof(*this) + name().capacity();
+            result += (m_previouslySelectedNodes.capacity() + m_nodesToSelect.capacity()) * sizeof(Model::Node*);
+            result += Model::estimateMemoryUsage(m_addedNodes);
+
+            // the command owns the duplicates while it is undone
+            if (state() == CommandState::Default) {
+                for (const auto& entry : m_addedNodes) {
+                    result += Model::estimateMemoryUsage(entry.second);
+                }
+            }
+            return result;
+        }
     }
 }
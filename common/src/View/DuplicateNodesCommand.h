@@ -58,6 +58,8 @@ namespace TrenchBroom {
 
             bool doCollateWith(UndoableCommand* command) override;
 
+            size_t doGetMemoryUsage() const override;
+
             deleteCopyAndMove(DuplicateNodesCommand)
         };
     }
@@ -45,7 +45,6 @@
 
 #include <kdl/overload.h>
 #include <kdl/skip_iterator.h>
-#include <kdl/string_compare.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/forward.h>
@@ -80,7 +79,8 @@ namespace TrenchBroom {
         m_logger(logger),
         m_group(false),
         m_hideUnused(false),
-        m_sortOrder(Assets::EntityDefinitionSortOrder::Name) {
+        m_sortOrder(Assets::EntityDefinitionSortOrder::Name),
+        m_filterMatcher(kdl::glob_matcher::substring("", false)) {
             const vm::quatf hRotation = vm::quatf(vm::vec3f::pos_z(), vm::to_radians(-30.0f));
             const vm::quatf vRotation = vm::quatf(vm::vec3f::pos_y(), vm::to_radians(20.0f));
             m_rotation = vRotation * hRotation;
@@ -124,6 +124,7 @@ namespace TrenchBroom {
                 return;
             }
             m_filterText = filterText;
+            m_filterMatcher = kdl::glob_matcher::substring(m_filterText, false);
             invalidate();
             update();
         }
@@ -185,7 +186,7 @@ namespace TrenchBroom {
 
         void EntityBrowserView::addEntityToLayout(Layout& layout, const Assets::PointEntityDefinition* definition, const Renderer::FontDescriptor& font) {
             if ((!m_hideUnused || definition->usageCount() > 0) &&
-                (m_filterText.empty() || kdl::ci::str_contains(definition->name(), m_filterText))) {
+                (m_filterText.empty() || m_filterMatcher.matches(definition->name()))) {
 
                 const auto maxCellWidth = layout.maxCellWidth();
                 const auto actualFont = fontManager().selectFontSize(font, definition->name(), maxCellWidth, 5);
@@ -24,6 +24,8 @@
 #include "Renderer/GLVertexType.h"
 #include "View/CellView.h"
 
+#include <kdl/glob_matcher.h>
+
 #include <vecmath/forward.h>
 #include <vecmath/quat.h>
 #include <vecmath/bbox.h>
@@ -79,6 +81,7 @@ namespace TrenchBroom {
             bool m_hideUnused;
             Assets::EntityDefinitionSortOrder m_sortOrder;
             std::string m_filterText;
+            kdl::glob_matcher m_filterMatcher;
         public:
             EntityBrowserView(QScrollBar* scrollBar,
                               GLContextManager& contextManager,
@@ -26,7 +26,9 @@
 #include "Renderer/Shader.h"
 #include "Renderer/ShaderProgram.h"
 #include "Renderer/Vbo.h"
+#include "Renderer/VboManager.h"
 
+#include <cassert>
 #include <sstream>
 #include <string>
 
@@ -38,6 +40,7 @@ namespace TrenchBroom {
 
         GLContextManager::GLContextManager() :
         m_initialized(false),
+        m_viewCount(0u),
         m_vboManager(std::make_unique<Renderer::VboManager>()),
         m_fontManager(std::make_unique<Renderer::FontManager>()),
         m_shaderManager(std::make_unique<Renderer::ShaderManager>()) {}
@@ -72,6 +75,17 @@ namespace TrenchBroom {
             return false;
         }
 
+        void GLContextManager::addView() {
+            ++m_viewCount;
+        }
+
+        void GLContextManager::removeView() {
+            assert(m_viewCount > 0u);
+            if (--m_viewCount == 0u) {
+                m_vboManager->destroyStreamingVbos();
+            }
+        }
+
         Renderer::VboManager& GLContextManager::vboManager() {
             return *m_vboManager;
         }
@@ -40,6 +40,7 @@ namespace TrenchBroom {
             static std::string GLVersion;
         private:
             bool m_initialized;
+            size_t m_viewCount;
 
             std::string m_glVendor;
             std::string m_glRenderer;
@@ -55,6 +56,19 @@ namespace TrenchBroom {
             bool initialized() const;
             bool initialize();
 
+            /**
+             * Registers a render view whose OpenGL context shares its objects with the other views of this manager.
+             * Must be called once per view when its context has been initialized.
+             */
+            void addView();
+
+            /**
+             * Unregisters a render view. Must be called while the view's context is current, before the context is
+             * destroyed. When the last view is removed, the streaming buffers of the VBO manager are destroyed, since
+             * no context can be relied on to be current once this manager is destroyed.
+             */
+            void removeView();
+
             Renderer::VboManager& vboManager();
             Renderer::FontManager& fontManager();
             Renderer::ShaderManager& shaderManager();
@@ -74,10 +74,12 @@ namespace TrenchBroom {
 
         void IssueBrowser::bindObservers() {
             auto document = kdl::mem_lock(m_document);
+            document->documentWillBeClearedNotifier.addObserver(this, &IssueBrowser::documentWillBeCleared);
             document->documentWasSavedNotifier.addObserver(this, &IssueBrowser::documentWasSaved);
             document->documentWasNewedNotifier.addObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
             document->documentWasLoadedNotifier.addObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
             document->nodesWereAddedNotifier.addObserver(this, &IssueBrowser::nodesWereAdded);
+            document->nodesWillBeRemovedNotifier.addObserver(this, &IssueBrowser::nodesWillBeRemoved);
             document->nodesWereRemovedNotifier.addObserver(this, &IssueBrowser::nodesWereRemoved);
             document->nodesDidChangeNotifier.addObserver(this, &IssueBrowser::nodesDidChange);
             document->brushFacesDidChangeNotifier.addObserver(this, &IssueBrowser::brushFacesDidChange);
@@ -86,16 +88,23 @@ namespace TrenchBroom {
         void IssueBrowser::unbindObservers() {
             if (!kdl::mem_expired(m_document)) {
                 auto document = kdl::mem_lock(m_document);
+                document->documentWillBeClearedNotifier.removeObserver(this, &IssueBrowser::documentWillBeCleared);
                 document->documentWasSavedNotifier.removeObserver(this, &IssueBrowser::documentWasSaved);
                 document->documentWasNewedNotifier.removeObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
                 document->documentWasLoadedNotifier.removeObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
                 document->nodesWereAddedNotifier.removeObserver(this, &IssueBrowser::nodesWereAdded);
+                document->nodesWillBeRemovedNotifier.removeObserver(this, &IssueBrowser::nodesWillBeRemoved);
                 document->nodesWereRemovedNotifier.removeObserver(this, &IssueBrowser::nodesWereRemoved);
                 document->nodesDidChangeNotifier.removeObserver(this, &IssueBrowser::nodesDidChange);
                 document->brushFacesDidChangeNotifier.removeObserver(this, &IssueBrowser::brushFacesDidChange);
             }
         }
 
+        void IssueBrowser::documentWillBeCleared(MapDocument*) {
+            // discards the nodes that are still waiting to be validated
+            m_view->reload();
+        }
+
         void IssueBrowser::documentWasNewedOrLoaded(MapDocument*) {
 			updateFilterFlags();
             m_view->reload();
@@ -105,20 +114,24 @@ namespace TrenchBroom {
             m_view->update();
         }
 
-        void IssueBrowser::nodesWereAdded(const std::vector<Model::Node*>&) {
-            m_view->reload();
+        void IssueBrowser::nodesWereAdded(const std::vector<Model::Node*>& nodes) {
+            m_view->nodesWereAdded(nodes);
+        }
+
+        void IssueBrowser::nodesWillBeRemoved(const std::vector<Model::Node*>& nodes) {
+            m_view->nodesWillBeRemoved(nodes);
         }
 
         void IssueBrowser::nodesWereRemoved(const std::vector<Model::Node*>&) {
-            m_view->reload();
+            m_view->updateInvalidatedIssues();
         }
 
         void IssueBrowser::nodesDidChange(const std::vector<Model::Node*>&) {
-            m_view->reload();
+            m_view->updateInvalidatedIssues();
         }
 
         void IssueBrowser::brushFacesDidChange(const std::vector<Model::BrushFace*>&) {
-            m_view->reload();
+            m_view->updateInvalidatedIssues();
         }
 
         void IssueBrowser::issueIgnoreChanged(Model::Issue*) {
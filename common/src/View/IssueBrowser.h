@@ -61,9 +61,11 @@ namespace TrenchBroom {
         private:
             void bindObservers();
             void unbindObservers();
+            void documentWillBeCleared(MapDocument* document);
             void documentWasNewedOrLoaded(MapDocument* document);
             void documentWasSaved(MapDocument* document);
             void nodesWereAdded(const std::vector<Model::Node*>& nodes);
+            void nodesWillBeRemoved(const std::vector<Model::Node*>& nodes);
             void nodesWereRemoved(const std::vector<Model::Node*>& nodes);
             void nodesDidChange(const std::vector<Model::Node*>& nodes);
             void brushFacesDidChange(const std::vector<Model::BrushFace*>& faces);
@@ -20,9 +20,10 @@
 #include "IssueBrowserView.h"
 
 #include "Ensure.h"
-#include "Model/CollectMatchingIssuesVisitor.h"
+#include "Model/CollectNodesVisitor.h"
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
+#include "Model/Node.h"
 #include "Model/World.h"
 #include "View/MapDocument.h"
 
@@ -30,6 +31,8 @@
 #include <kdl/vector_utils.h>
 #include <kdl/vector_set.h>
 
+#include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 #include <QHBoxLayout>
@@ -37,6 +40,7 @@
 #include <QMenu>
 #include <QHeaderView>
 #include <QItemSelectionModel>
+#include <QTimer>
 
 namespace TrenchBroom {
     namespace View {
@@ -45,7 +49,11 @@ namespace TrenchBroom {
         m_document(document),
         m_hiddenGenerators(0),
         m_showHiddenIssues(false),
-        m_valid(false) {
+        m_valid(false),
+        m_nextPendingNode(0),
+        m_validationGeneration(0),
+        m_validationScheduled(false),
+        m_revalidatedNodeCount(0) {
             createGui();
             bindEvents();
         }
@@ -133,11 +141,160 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
             Model::World* world = document->world();
             if (world != nullptr) {
+                // all nodes are considered below
+                world->takeNodesWithInvalidatedIssues();
+
+                // Show the issues of the nodes that are already validated right away, and validate the remaining
+                // nodes in batches.
+                Model::CollectNodesVisitor collectNodes;
+                world->acceptAndRecurse(collectNodes);
+
                 const std::vector<Model::IssueGenerator*>& issueGenerators = world->registeredIssueGenerators();
-                Model::CollectMatchingIssuesVisitor<IssueVisible> visitor(issueGenerators, IssueVisible(m_hiddenGenerators, m_showHiddenIssues));
-                world->acceptAndRecurse(visitor);
+                const IssueVisible visible(m_hiddenGenerators, m_showHiddenIssues);
+
+                std::vector<Model::Issue*> issues;
+                for (Model::Node* node : collectNodes.nodes()) {
+                    if (node->issuesValid()) {
+                        for (Model::Issue* issue : node->issues(issueGenerators)) {
+                            if (visible(issue)) {
+                                issues.push_back(issue);
+                            }
+                        }
+                    } else {
+                        m_pendingNodes.push_back(node);
+                    }
+                }
 
-                std::vector<Model::Issue*> issues = visitor.issues();
+                kdl::vec_sort(issues, IssueCmp());
+                m_tableModel->setIssues(std::move(issues));
+
+                if (!m_pendingNodes.empty()) {
+                    validateNextBatch(m_validationGeneration);
+                }
+            } else {
+                m_tableModel->setIssues({});
+            }
+        }
+
+        void IssueBrowserView::nodesWereAdded(const std::vector<Model::Node*>& nodes) {
+            if (!m_valid) {
+                return;
+            }
+
+            Model::CollectNodesVisitor collectNodes;
+            Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), collectNodes);
+            kdl::vec_append(m_pendingNodes, collectNodes.nodes());
+
+            updateInvalidatedIssues();
+            scheduleValidation();
+        }
+
+        void IssueBrowserView::nodesWillBeRemoved(const std::vector<Model::Node*>& nodes) {
+            if (!m_valid) {
+                return;
+            }
+
+            Model::CollectNodesVisitor collectNodes;
+            Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), collectNodes);
+            const std::unordered_set<Model::Node*> removedNodes(std::begin(collectNodes.nodes()), std::end(collectNodes.nodes()));
+
+            m_tableModel->removeIssues(removedNodes);
+
+            // the removed nodes may be deleted before they are validated
+            m_pendingNodes.erase(std::begin(m_pendingNodes), std::next(std::begin(m_pendingNodes), static_cast<std::ptrdiff_t>(m_nextPendingNode)));
+            m_nextPendingNode = 0;
+            kdl::vec_erase_if(m_pendingNodes, [&](Model::Node* node) { return removedNodes.count(node) > 0; });
+        }
+
+        void IssueBrowserView::updateInvalidatedIssues() {
+            if (!m_valid) {
+                return;
+            }
+
+            auto document = kdl::mem_lock(m_document);
+            Model::World* world = document->world();
+            if (world == nullptr) {
+                return;
+            }
+
+            const std::vector<Model::Node*> nodes = world->takeNodesWithInvalidatedIssues();
+            if (!nodes.empty()) {
+                // the issues of these nodes have already been deleted
+                m_tableModel->removeIssues(std::unordered_set<Model::Node*>(std::begin(nodes), std::end(nodes)));
+                kdl::vec_append(m_pendingNodes, nodes);
+                scheduleValidation();
+            }
+        }
+
+        size_t IssueBrowserView::revalidatedNodeCount() const {
+            return m_revalidatedNodeCount;
+        }
+
+        void IssueBrowserView::scheduleValidation() {
+            if (!m_validationScheduled && m_nextPendingNode < m_pendingNodes.size()) {
+                m_validationScheduled = true;
+                QTimer::singleShot(0, this, [this, generation = m_validationGeneration]() { validateNextBatch(generation); });
+            }
+        }
+
+        void IssueBrowserView::validateNextBatch(const size_t generation) {
+            if (generation != m_validationGeneration) {
+                return;
+            }
+            m_validationScheduled = false;
+
+            auto document = kdl::mem_lock(m_document);
+            Model::World* world = document->world();
+            if (world == nullptr) {
+                return;
+            }
+
+            // A node can be pending more than once if it was validated elsewhere and invalidated again.
+            std::vector<Model::Node*> batch;
+            std::unordered_set<Model::Node*> visited;
+            while (m_nextPendingNode < m_pendingNodes.size() && batch.size() < ValidationBatchSize) {
+                Model::Node* node = m_pendingNodes[m_nextPendingNode++];
+                if (!node->issuesValid() && visited.insert(node).second) {
+                    batch.push_back(node);
+                }
+            }
+
+            if (m_nextPendingNode == m_pendingNodes.size()) {
+                m_pendingNodes.clear();
+                m_nextPendingNode = 0;
+            }
+
+            const std::vector<Model::IssueGenerator*>& issueGenerators = world->registeredIssueGenerators();
+            m_revalidatedNodeCount += Model::Node::validateIssues(batch, issueGenerators);
+
+            const IssueVisible visible(m_hiddenGenerators, m_showHiddenIssues);
+            std::vector<Model::Issue*> issues;
+            for (Model::Node* node : batch) {
+                for (Model::Issue* issue : node->issues(issueGenerators)) {
+                    if (visible(issue)) {
+                        issues.push_back(issue);
+                    }
+                }
+            }
+            addIssues(std::move(issues));
+
+            scheduleValidation();
+        }
+
+        void IssueBrowserView::addIssues(std::vector<Model::Issue*> issues) {
+            if (issues.empty()) {
+                return;
+            }
+
+            kdl::vec_sort(issues, IssueCmp());
+
+            // Freshly validated issues are numbered after all existing ones and can be put on top of the list. This
+            // does not hold for the issues of nodes that were validated elsewhere in the meantime.
+            const auto& existingIssues = m_tableModel->issues();
+            if (existingIssues.empty() || IssueCmp()(issues.back(), existingIssues.front())) {
+                m_tableModel->prependIssues(issues);
+            } else {
+                issues = kdl::vec_concat(issues, existingIssues);
                 kdl::vec_sort(issues, IssueCmp());
                 m_tableModel->setIssues(std::move(issues));
             }
@@ -261,6 +418,11 @@ namespace TrenchBroom {
         void IssueBrowserView::invalidate() {
             m_valid = false;
 
+            m_pendingNodes.clear();
+            m_nextPendingNode = 0;
+            ++m_validationGeneration;
+            m_validationScheduled = false;
+
             QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
         }
 
@@ -276,14 +438,54 @@ namespace TrenchBroom {
 
         IssueBrowserModel::IssueBrowserModel(QObject* parent)
         : QAbstractTableModel(parent),
-          m_issues() {}
+          m_issues(),
+          m_issueNodes() {}
 
         void IssueBrowserModel::setIssues(std::vector<Model::Issue*> issues) {
             beginResetModel();
             m_issues = std::move(issues);
+            m_issueNodes = kdl::vec_transform(m_issues, [](const Model::Issue* issue) { return issue->node(); });
             endResetModel();
         }
 
+        void IssueBrowserModel::prependIssues(const std::vector<Model::Issue*>& issues) {
+            if (issues.empty()) {
+                return;
+            }
+
+            beginInsertRows(QModelIndex(), 0, static_cast<int>(issues.size()) - 1);
+            m_issues.insert(std::begin(m_issues), std::begin(issues), std::end(issues));
+            m_issueNodes.insert(std::begin(m_issueNodes), issues.size(), nullptr);
+            std::transform(std::begin(issues), std::end(issues), std::begin(m_issueNodes), [](const Model::Issue* issue) { return issue->node(); });
+            endInsertRows();
+        }
+
+        void IssueBrowserModel::removeIssues(const std::unordered_set<Model::Node*>& nodes) {
+            // Remove runs of adjacent rows back to front, so that the rows of the remaining runs keep their indices.
+            // The issues themselves must not be accessed here because they may already have been deleted.
+            const auto removed = [&](const size_t row) { return nodes.count(m_issueNodes[row]) > 0; };
+
+            auto last = m_issues.size();
+            while (last > 0) {
+                if (!removed(last - 1)) {
+                    --last;
+                    continue;
+                }
+
+                auto first = last - 1;
+                while (first > 0 && removed(first - 1)) {
+                    --first;
+                }
+
+                beginRemoveRows(QModelIndex(), static_cast<int>(first), static_cast<int>(last - 1));
+                m_issues.erase(std::next(std::begin(m_issues), static_cast<std::ptrdiff_t>(first)), std::next(std::begin(m_issues), static_cast<std::ptrdiff_t>(last)));
+                m_issueNodes.erase(std::next(std::begin(m_issueNodes), static_cast<std::ptrdiff_t>(first)), std::next(std::begin(m_issueNodes), static_cast<std::ptrdiff_t>(last)));
+                endRemoveRows();
+
+                last = first;
+            }
+        }
+
         const std::vector<Model::Issue*>& IssueBrowserModel::issues() {
             return m_issues;
         }
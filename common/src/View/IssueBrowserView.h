@@ -23,6 +23,7 @@
 #include "Model/IssueType.h"
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include <QWidget>
@@ -35,6 +36,7 @@ namespace TrenchBroom {
     namespace Model {
         class Issue;
         class IssueQuickFix;
+        class Node;
     }
 
     namespace View {
@@ -44,6 +46,12 @@ namespace TrenchBroom {
         class IssueBrowserView : public QWidget {
             Q_OBJECT
         private:
+            /**
+             * The number of nodes whose issues are validated before the view is updated and control is returned to
+             * the event loop.
+             */
+            static const size_t ValidationBatchSize = 4096;
+
             std::weak_ptr<MapDocument> m_document;
 
             Model::IssueType m_hiddenGenerators;
@@ -51,6 +59,18 @@ namespace TrenchBroom {
 
             bool m_valid;
 
+            /**
+             * The nodes whose issues have not been validated yet. They are validated in batches, and the issues of
+             * each batch are added to the view as soon as the batch is done. Reloading the view discards the pending
+             * nodes and increments the generation, which stops the batch that is still scheduled.
+             */
+            std::vector<Model::Node*> m_pendingNodes;
+            size_t m_nextPendingNode;
+            size_t m_validationGeneration;
+            bool m_validationScheduled;
+
+            size_t m_revalidatedNodeCount;
+
             QTableView* m_tableView;
             IssueBrowserModel* m_tableModel;
         public:
@@ -63,11 +83,36 @@ namespace TrenchBroom {
             void setShowHiddenIssues(bool show);
             void reload();
             void deselectAll();
+
+            /**
+             * Incrementally updates the view after the given nodes were added to the document. Their issues and the
+             * issues that were invalidated by adding them are validated in the background.
+             */
+            void nodesWereAdded(const std::vector<Model::Node*>& nodes);
+
+            /**
+             * Removes the issues of the given nodes and their descendants from the view.
+             */
+            void nodesWillBeRemoved(const std::vector<Model::Node*>& nodes);
+
+            /**
+             * Replaces the issues of the nodes whose issues were invalidated since the last update. Only these nodes
+             * are revalidated.
+             */
+            void updateInvalidatedIssues();
+
+            /**
+             * Returns the number of nodes whose issues were generated by this view.
+             */
+            size_t revalidatedNodeCount() const;
         private:
             class IssueVisible;
             class IssueCmp;
 
             void updateIssues();
+            void scheduleValidation();
+            void validateNextBatch(size_t generation);
+            void addIssues(std::vector<Model::Issue*> issues);
 
             std::vector<Model::Issue*> collectIssues(const QList<QModelIndex>& indices) const;
             std::vector<Model::IssueQuickFix*> collectQuickFixes(const QList<QModelIndex>& indices) const;
@@ -93,15 +138,22 @@ namespace TrenchBroom {
         /**
          * Trivial QAbstractTableModel subclass, when the issues list changes,
          * it just refreshes the entire list with beginResetModel()/endResetModel().
+         * Newly validated issues can be prepended without resetting the model.
          */
         class IssueBrowserModel : public QAbstractTableModel {
             Q_OBJECT
         private:
             std::vector<Model::Issue*> m_issues;
+            /**
+             * The node of each issue, which allows removing the rows of a node after its issues were deleted.
+             */
+            std::vector<Model::Node*> m_issueNodes;
         public:
             explicit IssueBrowserModel(QObject* parent);
 
             void setIssues(std::vector<Model::Issue*> issues);
+            void prependIssues(const std::vector<Model::Issue*>& issues);
+            void removeIssues(const std::unordered_set<Model::Node*>& nodes);
             const std::vector<Model::Issue*>& issues();
         public: // QAbstractTableModel overrides
             int rowCount(const QModelIndex& parent) const override;
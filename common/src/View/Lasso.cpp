@@ -57,6 +57,28 @@ namespace TrenchBroom {
             return selects(polygon.center(), plane, box);
         }
 
+        bool Lasso::mayContain(const vm::bbox3& bounds) const {
+            const auto plane = this->plane();
+            const auto box = this->box();
+
+            // The projection of a box onto the lasso plane is contained in the convex hull of the projections of its
+            // corners, provided that all corners are in front of the camera.
+            auto projectedBounds = vm::bbox2::builder();
+            for (size_t i = 0u; i < 8u; ++i) {
+                const auto corner = vm::vec3(
+                    (i & 1u) ? bounds.max.x() : bounds.min.x(),
+                    (i & 2u) ? bounds.max.y() : bounds.min.y(),
+                    (i & 4u) ? bounds.max.z() : bounds.min.z());
+                const auto projected = project(corner, plane);
+                if (vm::is_nan(projected)) {
+                    return true;
+                }
+                projectedBounds.add(vm::vec2(projected));
+            }
+
+            return projectedBounds.bounds().intersects(box);
+        }
+
         vm::vec3 Lasso::project(const vm::vec3& point, const vm::plane3& plane) const {
             const auto ray = vm::ray3(m_camera.pickRay(vm::vec3f(point)));
             const auto hitDistance = vm::intersect_ray_plane(ray, plane);
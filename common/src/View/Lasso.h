@@ -60,6 +60,16 @@ namespace TrenchBroom {
             bool selects(const H& h) const {
                 return selects(h, plane(), box());
             }
+
+            /**
+             * Indicates whether this lasso may select any point within the given bounds. This is a conservative test,
+             * i.e., it may return true even if no point within the bounds is selected, but it never returns false if
+             * any point is selected.
+             *
+             * @param bounds the bounds to test
+             * @return false if no point within the given bounds can be selected by this lasso
+             */
+            bool mayContain(const vm::bbox3& bounds) const;
         private:
             bool selects(const vm::vec3& point, const vm::plane3& plane, const vm::bbox2& box) const;
             bool selects(const vm::segment3& edge, const vm::plane3& plane, const vm::bbox2& box) const;
@@ -37,17 +37,16 @@
 #include "Model/AttributeValueWithDoubleQuotationMarksIssueGenerator.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/CollectAttributableNodesVisitor.h"
-#include "Model/CollectContainedNodesVisitor.h"
 #include "Model/CollectMatchingBrushFacesVisitor.h"
 #include "Model/CollectNodesVisitor.h"
 #include "Model/CollectSelectableNodesVisitor.h"
 #include "Model/CollectSelectableBrushFacesVisitor.h"
 #include "Model/CollectSelectableNodesWithFilePositionVisitor.h"
 #include "Model/CollectSelectedNodesVisitor.h"
-#include "Model/CollectTouchingNodesVisitor.h"
 #include "Model/ComputeNodeBoundsVisitor.h"
 #include "Model/EditorContext.h"
 #include "Model/EmptyAttributeNameIssueGenerator.h"
@@ -55,6 +54,7 @@
 #include "Model/EmptyBrushEntityIssueGenerator.h"
 #include "Model/EmptyGroupIssueGenerator.h"
 #include "Model/Entity.h"
+#include "Model/FindTouchingNodes.h"
 #include "Model/LinkSourceIssueGenerator.h"
 #include "Model/LinkTargetIssueGenerator.h"
 #include "Model/Game.h"
@@ -121,6 +121,7 @@
 #include <kdl/collection_utils.h>
 #include <kdl/map_utils.h>
 #include <kdl/memory_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/polygon.h>
@@ -587,10 +588,7 @@ namespace TrenchBroom {
         void MapDocument::selectTouching(const bool del) {
             const std::vector<Model::Brush*>& brushes = m_selectedNodes.brushes();
 
-            Model::CollectTouchingNodesVisitor<std::vector<Model::Brush*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
-
-            const std::vector<Model::Node*> nodes = visitor.nodes();
+            const std::vector<Model::Node*> nodes = Model::findTouchingNodes(*m_world, brushes, editorContext());
 
             Transaction transaction(this, "Select Touching");
             if (del)
@@ -603,10 +601,7 @@ namespace TrenchBroom {
         void MapDocument::selectInside(const bool del) {
             const std::vector<Model::Brush*>& brushes = m_selectedNodes.brushes();
 
-            Model::CollectContainedNodesVisitor<std::vector<Model::Brush*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
-
-            const std::vector<Model::Node*> nodes = visitor.nodes();
+            const std::vector<Model::Node*> nodes = Model::findContainedNodes(*m_world, brushes, editorContext());
 
             Transaction transaction(this, "Select Inside");
             if (del)
@@ -2037,18 +2032,42 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * Initializes the tags of the given brushes and their faces in parallel. The textures of all faces must already
+         * be cached by the given tag manager, see Model::TagManager::textureTags.
+         */
+        static void initializeBrushTags(const std::vector<Model::Brush*>& brushes, Model::TagManager& tagManager) {
+            kdl::parallel_for(brushes.size(), [&](const size_t i) {
+                brushes[i]->initializeTags(tagManager);
+            }, 256u);
+        }
+
+        /**
+         * Initializes the tags of all nodes except for brushes, which are collected so that their tags can be
+         * initialized in parallel afterwards. The texture tags of their faces are cached while collecting them.
+         */
         class MapDocument::InitializeNodeTagsVisitor : public Model::NodeVisitor {
         private:
             Model::TagManager& m_tagManager;
+            std::vector<Model::Brush*> m_brushes;
         public:
             explicit InitializeNodeTagsVisitor(Model::TagManager& tagManager) :
             m_tagManager(tagManager) {}
+
+            const std::vector<Model::Brush*>& brushes() const {
+                return m_brushes;
+            }
         private:
             void doVisit(Model::World* world)   override { initializeNodeTags(world); }
             void doVisit(Model::Layer* layer)   override { initializeNodeTags(layer); }
             void doVisit(Model::Group* group)   override { initializeNodeTags(group); }
             void doVisit(Model::Entity* entity) override { initializeNodeTags(entity); }
-            void doVisit(Model::Brush* brush)   override { initializeNodeTags(brush); }
+            void doVisit(Model::Brush* brush)   override {
+                for (const auto* face : brush->faces()) {
+                    m_tagManager.textureTags(face->attribs());
+                }
+                m_brushes.push_back(brush);
+            }
 
             void initializeNodeTags(Model::Node* node) {
                 node->initializeTags(m_tagManager);
@@ -2056,14 +2075,18 @@ namespace TrenchBroom {
         };
 
         void MapDocument::initializeNodeTags(MapDocument* document) {
+            m_tagManager->clearTextureTagCache();
+
             InitializeNodeTagsVisitor visitor(*m_tagManager);
             auto* world = document->world();
             world->acceptAndRecurse(visitor);
+            initializeBrushTags(visitor.brushes(), *m_tagManager);
         }
 
         void MapDocument::initializeNodeTags(const std::vector<Model::Node*>& nodes) {
             InitializeNodeTagsVisitor visitor(*m_tagManager);
             Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), visitor);
+            initializeBrushTags(visitor.brushes(), *m_tagManager);
         }
 
         void MapDocument::clearNodeTags(const std::vector<Model::Node*>& nodes) {
@@ -2087,20 +2110,34 @@ namespace TrenchBroom {
         class MapDocument::InitializeFaceTagsVisitor : public Model::NodeVisitor {
         private:
             Model::TagManager& m_tagManager;
+            std::vector<Model::Brush*> m_brushes;
         public:
             explicit InitializeFaceTagsVisitor(Model::TagManager& tagManager) :
                 m_tagManager(tagManager) {}
+
+            const std::vector<Model::Brush*>& brushes() const {
+                return m_brushes;
+            }
         private:
             void doVisit(Model::World*) override         {}
             void doVisit(Model::Layer*) override         {}
             void doVisit(Model::Group*) override         {}
             void doVisit(Model::Entity*) override        {}
-            void doVisit(Model::Brush* brush)   override { brush->initializeTags(m_tagManager); }
+            void doVisit(Model::Brush* brush)   override {
+                for (const auto* face : brush->faces()) {
+                    m_tagManager.textureTags(face->attribs());
+                }
+                m_brushes.push_back(brush);
+            }
         };
 
         void MapDocument::updateAllFaceTags() {
+            // the textures may have been reloaded
+            m_tagManager->clearTextureTagCache();
+
             InitializeFaceTagsVisitor visitor(*m_tagManager);
             m_world->acceptAndRecurse(visitor);
+            initializeBrushTags(visitor.brushes(), *m_tagManager);
         }
 
         bool MapDocument::persistent() const {
@@ -53,6 +53,7 @@
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -67,10 +68,13 @@ namespace TrenchBroom {
 
         MapDocumentCommandFacade::MapDocumentCommandFacade() :
         m_commandProcessor(std::make_unique<CommandProcessor>(this)) {
+            updateUndoMemoryBudget();
             bindObservers();
         }
 
-        MapDocumentCommandFacade::~MapDocumentCommandFacade() = default;
+        MapDocumentCommandFacade::~MapDocumentCommandFacade() {
+            unbindObservers();
+        }
 
         void MapDocumentCommandFacade::performSelect(const std::vector<Model::Node*>& nodes) {
             selectionWillChangeNotifier();
@@ -277,11 +281,18 @@ namespace TrenchBroom {
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
 
             std::vector<Model::Node*> addedNodes;
-            for (const auto& entry : nodes) {
-                Model::Node* parent = entry.first;
-                const std::vector<Model::Node*>& children = entry.second;
-                parent->addChildren(children);
-                kdl::vec_append(addedNodes, children);
+            {
+                // the node tree is updated once all nodes are added, which is much faster when pasting many nodes
+                Model::World::DeferNodeTreeInsertions deferInsertions(*m_world);
+
+                for (const auto& entry : nodes) {
+                    Model::Node* parent = entry.first;
+                    const std::vector<Model::Node*>& children = entry.second;
+                    parent->addChildren(children);
+                    kdl::vec_append(addedNodes, children);
+                }
+
+                deferInsertions.commit();
             }
 
             setEntityDefinitions(addedNodes);
@@ -895,7 +906,12 @@ namespace TrenchBroom {
                 Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
                 Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
 
+                // textures are not written to disk, so they must be set again on nodes restored from a spilled snapshot
+                const bool spilled = snapshot->spilled();
                 snapshot->restoreNodes(m_worldBounds);
+                if (spilled) {
+                    setTextures(nodes);
+                }
 
                 invalidateSelectionBounds();
             }
@@ -980,6 +996,14 @@ namespace TrenchBroom {
             m_commandProcessor->transactionUndoneNotifier.addObserver(transactionUndoneNotifier);
             documentWasNewedNotifier.addObserver(this, &MapDocumentCommandFacade::documentWasNewed);
             documentWasLoadedNotifier.addObserver(this, &MapDocumentCommandFacade::documentWasLoaded);
+
+            PreferenceManager& prefs = PreferenceManager::instance();
+            prefs.preferenceDidChangeNotifier.addObserver(this, &MapDocumentCommandFacade::preferenceDidChange);
+        }
+
+        void MapDocumentCommandFacade::unbindObservers() {
+            PreferenceManager& prefs = PreferenceManager::instance();
+            prefs.preferenceDidChangeNotifier.removeObserver(this, &MapDocumentCommandFacade::preferenceDidChange);
         }
 
         void MapDocumentCommandFacade::documentWasNewed(MapDocument*) {
@@ -990,6 +1014,18 @@ namespace TrenchBroom {
             m_commandProcessor->clear();
         }
 
+        void MapDocumentCommandFacade::preferenceDidChange(const IO::Path& path) {
+            if (path == Preferences::UndoMemoryBudget.path() || path == Preferences::UndoDiscardOverBudget.path()) {
+                updateUndoMemoryBudget();
+            }
+        }
+
+        void MapDocumentCommandFacade::updateUndoMemoryBudget() {
+            const auto undoMemoryBudget = static_cast<size_t>(std::max(0, pref(Preferences::UndoMemoryBudget)));
+            m_commandProcessor->setDiscardUndoOverBudget(pref(Preferences::UndoDiscardOverBudget));
+            m_commandProcessor->setUndoMemoryBudget(undoMemoryBudget * 1024u * 1024u);
+        }
+
         bool MapDocumentCommandFacade::doCanUndoCommand() const {
             return m_commandProcessor->canUndo();
         }
@@ -128,8 +128,11 @@ namespace TrenchBroom {
             void decModificationCount(size_t delta = 1);
         private: // notification
             void bindObservers();
+            void unbindObservers();
             void documentWasNewed(MapDocument* document);
             void documentWasLoaded(MapDocument* document);
+            void preferenceDidChange(const IO::Path& path);
+            void updateUndoMemoryBudget();
         private: // implement MapDocument interface
             bool doCanUndoCommand() const override;
             bool doCanRedoCommand() const override;
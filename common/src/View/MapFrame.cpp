@@ -36,6 +36,7 @@
 #include "Model/Group.h"
 #include "Model/Layer.h"
 #include "Model/Node.h"
+#include "Renderer/FrameProfiler.h"
 #include "View/Actions.h"
 #include "View/Autosaver.h"
 #if !defined __APPLE__
@@ -72,6 +73,8 @@
 #include <vecmath/vec_io.h>
 
 #include <cassert>
+#include <fstream>
+#include <iomanip>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -1475,6 +1478,48 @@ namespace TrenchBroom {
             return m_mapView->currentViewMaximized();
         }
 
+        void MapFrame::toggleRenderProfiler() {
+            auto& profiler = Renderer::FrameProfiler::instance();
+            if (profiler.enabled()) {
+                profiler.setEnabled(false);
+            } else {
+                profiler.clear();
+                profiler.setEnabled(true);
+            }
+        }
+
+        bool MapFrame::renderProfilerEnabled() const {
+            return Renderer::FrameProfiler::instance().enabled();
+        }
+
+        void MapFrame::exportRenderProfile() {
+            const auto& profiler = Renderer::FrameProfiler::instance();
+            if (profiler.frameCount() == 0) {
+                QMessageBox::information(this, "", tr("No frames have been profiled yet. Enable render profiling and interact with the map views first."));
+                return;
+            }
+
+            const QString fileName = QFileDialog::getSaveFileName(this, tr("Export Render Profile"), "render_profile.json", "Chrome trace files (*.json)");
+            if (fileName.isEmpty()) {
+                return;
+            }
+
+            const IO::Path path = IO::pathFromQString(fileName);
+            std::ofstream stream(path.asString().c_str());
+            if (!stream.good()) {
+                QMessageBox::critical(this, "", QString::fromStdString("Could not open " + path.asString() + " for writing"));
+                return;
+            }
+            profiler.writeChromeTrace(stream);
+
+            logger().info() << "Exported render profile of " << profiler.frameCount() << " frames to " << path;
+            for (const auto& entry : profiler.statistics()) {
+                logger().info() << std::fixed << std::setprecision(3)
+                                << entry.name << ": min " << entry.minMs << " ms, avg " << entry.avgMs << " ms, max " << entry.maxMs << " ms"
+                                << " (" << entry.frameCount << " frames)";
+            }
+        }
+
         void MapFrame::showCompileDialog() {
             if (m_compilationDialog == nullptr) {
                 m_compilationDialog = new CompilationDialog(this);
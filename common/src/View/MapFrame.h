@@ -336,6 +336,10 @@ namespace TrenchBroom {
             void toggleMaximizeCurrentView();
             bool currentViewMaximized();
 
+            void toggleRenderProfiler();
+            bool renderProfilerEnabled() const;
+            void exportRenderProfile();
+
             void showCompileDialog();
             void compilationDialogWillClose();
 
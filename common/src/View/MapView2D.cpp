@@ -24,7 +24,7 @@
 #include "Assets/EntityDefinitionManager.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
-#include "Model/CollectContainedNodesVisitor.h"
+#include "Model/FindTouchingNodes.h"
 #include "Model/HitAdapter.h"
 #include "Model/PickResult.h"
 #include "Model/PointFile.h"
@@ -222,9 +222,7 @@ namespace TrenchBroom {
             Transaction transaction(document, "Select Tall");
             document->deleteObjects();
 
-            Model::CollectContainedNodesVisitor<std::vector<Model::Brush*>::const_iterator> visitor(std::begin(tallBrushes), std::end(tallBrushes), document->editorContext());
-            document->world()->acceptAndRecurse(visitor);
-            document->select(visitor.nodes());
+            document->select(Model::findContainedNodes(*document->world(), tallBrushes, document->editorContext()));
 
             kdl::vec_clear_and_delete(tallBrushes);
         }
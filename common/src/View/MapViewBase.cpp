@@ -46,6 +46,7 @@
 #include "Renderer/Compass.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/FontManager.h"
+#include "Renderer/FrameProfiler.h"
 #include "Renderer/MapRenderer.h"
 #include "Renderer/PrimitiveRenderer.h"
 #include "Renderer/RenderBatch.h"
@@ -847,6 +848,8 @@ namespace TrenchBroom {
         }
 
         void MapViewBase::doRender() {
+            const Renderer::FrameScope frame;
+
             doPreRender();
 
             const IO::Path& fontPath = pref(Preferences::RendererFontPath());
@@ -877,16 +880,28 @@ namespace TrenchBroom {
 
             Renderer::RenderBatch renderBatch(vboManager());
 
-            doRenderGrid(renderContext, renderBatch);
-            doRenderMap(m_renderer, renderContext, renderBatch);
-            doRenderTools(m_toolBox, renderContext, renderBatch);
-            doRenderExtras(renderContext, renderBatch);
-
-            renderCoordinateSystem(renderContext, renderBatch);
-            renderPointFile(renderContext, renderBatch);
-            renderPortalFile(renderContext, renderBatch);
-            renderCompass(renderBatch);
-            renderFPS(renderContext, renderBatch);
+            {
+                const Renderer::ProfileScope profile("MapViewBase::renderGrid");
+                doRenderGrid(renderContext, renderBatch);
+            }
+            {
+                const Renderer::ProfileScope profile("MapViewBase::renderMap");
+                doRenderMap(m_renderer, renderContext, renderBatch);
+            }
+            {
+                const Renderer::ProfileScope profile("MapViewBase::renderTools");
+                doRenderTools(m_toolBox, renderContext, renderBatch);
+            }
+            {
+                const Renderer::ProfileScope profile("MapViewBase::renderExtras");
+                doRenderExtras(renderContext, renderBatch);
+
+                renderCoordinateSystem(renderContext, renderBatch);
+                renderPointFile(renderContext, renderBatch);
+                renderPortalFile(renderContext, renderBatch);
+                renderCompass(renderBatch);
+                renderFPS(renderContext, renderBatch);
+            }
 
             renderBatch.render(renderContext);
         }
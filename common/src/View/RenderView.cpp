@@ -82,6 +82,7 @@ namespace TrenchBroom {
         RenderView::RenderView(GLContextManager& contextManager, QWidget* parent) :
         QOpenGLWidget(parent),
         m_glContext(&contextManager),
+        m_addedToContextManager(false),
         m_framesRendered(0),
         m_maxFrameTimeMsecs(0),
         m_lastFPSCounterUpdate(0) {
@@ -107,7 +108,9 @@ namespace TrenchBroom {
                     std::to_string(maxFrameTime) + "ms. " +
                     std::to_string(m_glContext->vboManager().currentVboCount()) + " current VBOs (" +
                     std::to_string(m_glContext->vboManager().peakVboCount()) + " peak) totalling " +
-                    std::to_string(m_glContext->vboManager().currentVboSize() / 1024u) + " KiB";
+                    std::to_string(m_glContext->vboManager().currentVboSize() / 1024u) + " KiB, " +
+                    std::to_string(m_glContext->vboManager().lastFrameUploadedBytes() / 1024u) + " KiB uploaded (" +
+                    std::to_string(m_glContext->vboManager().lastFrameStreamedBytes() / 1024u) + " KiB streamed) last frame";
 
 
             });
@@ -118,7 +121,13 @@ namespace TrenchBroom {
             setFocusPolicy(Qt::StrongFocus); // accept focus by clicking or tab
         }
 
-        RenderView::~RenderView() = default;
+        RenderView::~RenderView() {
+            if (m_addedToContextManager) {
+                // the context manager may release OpenGL resources shared by all views
+                makeCurrent();
+                m_glContext->removeView();
+            }
+        }
 
         void RenderView::keyPressEvent(QKeyEvent* event) {
             m_eventRecorder.recordEvent(event);
@@ -158,6 +167,8 @@ namespace TrenchBroom {
         void RenderView::paintGL() {
             if (TrenchBroom::View::isReportingCrash()) return;
 
+            // the transient vertices of the previous frame have been rendered already
+            vboManager().beginFrame();
             render();
 
             // Update stats
@@ -275,6 +286,11 @@ namespace TrenchBroom {
         }
 
         bool RenderView::doInitializeGL() {
+            // a view is initialized again when it is moved to another window, but it is only added once
+            if (!m_addedToContextManager) {
+                m_glContext->addView();
+                m_addedToContextManager = true;
+            }
             return m_glContext->initialize();
         }
 
@@ -48,6 +48,7 @@ namespace TrenchBroom {
         private:
             Color m_focusColor;
             GLContextManager* m_glContext;
+            bool m_addedToContextManager;
             InputEventRecorder m_eventRecorder;
         private: // FPS counter
             // stats since the last counter update
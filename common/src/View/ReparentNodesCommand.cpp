@@ -19,6 +19,7 @@
 
 #include "ReparentNodesCommand.h"
 
+#include "Model/EstimateMemoryUsageVisitor.h"
 #include "Model/ModelUtils.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -54,5 +55,10 @@ namespace TrenchBroom {
         bool ReparentNodesCommand::doCollateWith(UndoableCommand*) {
             return false;
         }
+
+        size_t ReparentNodesCommand::doGetMemoryUsage() const {
+            // the reparented nodes remain in the document and are not counted here
+            return sizeof(*this) + name().capacity() + Model::estimateMemoryUsage(m_nodesToAdd) + Model::estimateMemoryUsage(m_nodesToRemove);
+        }
     }
 }
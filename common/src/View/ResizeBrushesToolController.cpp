@@ -140,7 +140,7 @@ namespace TrenchBroom {
                 }
             }
 
-            return Renderer::DirectEdgeRenderer(Renderer::VertexArray::move(std::move(vertices)), Renderer::PrimType::Lines);
+            return Renderer::DirectEdgeRenderer(Renderer::VertexArray::stream(std::move(vertices)), Renderer::PrimType::Lines);
         }
 
         bool ResizeBrushesToolController::doCancel() {
@@ -62,6 +62,20 @@ namespace TrenchBroom {
             m_snapshot.reset();
         }
 
+        size_t SnapshotCommand::doGetMemoryUsage() const {
+            size_t result = sizeof(*this) + name().capacity();
+            if (m_snapshot != nullptr) {
+                result += m_snapshot->memoryUsage();
+            }
+            return result;
+        }
+
+        void SnapshotCommand::doSpill(const std::shared_ptr<IO::SpillFile>& file) {
+            if (m_snapshot != nullptr) {
+                m_snapshot->spill(file);
+            }
+        }
+
         std::unique_ptr<Model::Snapshot> SnapshotCommand::doTakeSnapshot(MapDocumentCommandFacade *document) const {
             const auto& nodes = document->selectedNodes().nodes();
             return std::make_unique<Model::Snapshot>(std::begin(nodes), std::end(nodes));
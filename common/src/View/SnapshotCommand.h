@@ -45,6 +45,9 @@ namespace TrenchBroom {
             void takeSnapshot(MapDocumentCommandFacade* document);
             std::unique_ptr<CommandResult> restoreSnapshot(MapDocumentCommandFacade* document);
             void deleteSnapshot();
+
+            size_t doGetMemoryUsage() const override;
+            void doSpill(const std::shared_ptr<IO::SpillFile>& file) override;
         private:
             virtual std::unique_ptr<Model::Snapshot> doTakeSnapshot(MapDocumentCommandFacade* document) const;
 
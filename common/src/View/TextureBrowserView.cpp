@@ -63,6 +63,7 @@ namespace TrenchBroom {
         m_group(false),
         m_hideUnused(false),
         m_sortOrder(TextureSortOrder::Name),
+        m_filterMatcher(kdl::glob_matcher::substring("", false)),
         m_selectedTexture(nullptr) {
             auto doc = kdl::mem_lock(m_document);
             doc->textureManager().usageCountDidChange.addObserver(this, &TextureBrowserView::usageCountDidChange);
@@ -108,6 +109,7 @@ namespace TrenchBroom {
                 return;
             }
             m_filterText = filterText;
+            m_filterMatcher = kdl::glob_matcher::substring(m_filterText, false);
             invalidate();
             update();
         }
@@ -227,12 +229,12 @@ namespace TrenchBroom {
         };
 
         struct TextureBrowserView::MatchName {
-            std::string pattern;
+            const kdl::glob_matcher& matcher;
 
-            explicit MatchName(const std::string& i_pattern) : pattern(i_pattern) {}
+            explicit MatchName(const kdl::glob_matcher& i_matcher) : matcher(i_matcher) {}
 
             bool operator()(const Assets::Texture* texture) const {
-                return !kdl::ci::str_contains(texture->name(), pattern);
+                return !matcher.matches(texture->name());
             }
         };
 
@@ -267,7 +269,7 @@ namespace TrenchBroom {
             if (m_hideUnused)
                 kdl::vec_erase_if(textures, MatchUsageCount());
             if (!m_filterText.empty())
-                kdl::vec_erase_if(textures, MatchName(m_filterText));
+                kdl::vec_erase_if(textures, MatchName(m_filterMatcher));
         }
 
         void TextureBrowserView::sortTextures(std::vector<Assets::Texture*>& textures) const {
@@ -351,12 +353,10 @@ namespace TrenchBroom {
         void TextureBrowserView::renderTextures(Layout& layout, const float y, const float height) {
             using TextureVertex = Renderer::GLVertexTypes::P2T2::Vertex;
 
-            Renderer::ActiveShader shader(shaderManager(), Renderer::Shaders::TextureBrowserShader);
-            shader.set("ApplyTinting", false);
-            shader.set("Texture", 0);
-            shader.set("Brightness", pref(Preferences::Brightness));
-
-            size_t num = 0;
+            // collect the quads of all visible textures into one vertex array so that it is uploaded and set up only
+            // once, then bind each texture and draw its quad
+            std::vector<TextureVertex> vertices;
+            std::vector<const Assets::Texture*> textures;
 
             for (size_t i = 0; i < layout.size(); ++i) {
                 const Group& group = layout[i];
@@ -367,28 +367,47 @@ namespace TrenchBroom {
                             for (size_t k = 0; k < row.size(); ++k) {
                                 const Cell& cell = row[k];
                                 const LayoutBounds& bounds = cell.itemBounds();
-                                const Assets::Texture* texture = cellData(cell).texture;
 
-                                Renderer::VertexArray vertexArray = Renderer::VertexArray::move(std::vector<TextureVertex>({
-                                    TextureVertex(vm::vec2f(bounds.left(),  height - (bounds.top() - y)),    vm::vec2f(0.0f, 0.0f)),
-                                    TextureVertex(vm::vec2f(bounds.left(),  height - (bounds.bottom() - y)), vm::vec2f(0.0f, 1.0f)),
-                                    TextureVertex(vm::vec2f(bounds.right(), height - (bounds.bottom() - y)), vm::vec2f(1.0f, 1.0f)),
-                                    TextureVertex(vm::vec2f(bounds.right(), height - (bounds.top() - y)),    vm::vec2f(1.0f, 0.0f))
-                                }));
+                                vertices.emplace_back(vm::vec2f(bounds.left(),  height - (bounds.top() - y)),    vm::vec2f(0.0f, 0.0f));
+                                vertices.emplace_back(vm::vec2f(bounds.left(),  height - (bounds.bottom() - y)), vm::vec2f(0.0f, 1.0f));
+                                vertices.emplace_back(vm::vec2f(bounds.right(), height - (bounds.bottom() - y)), vm::vec2f(1.0f, 1.0f));
+                                vertices.emplace_back(vm::vec2f(bounds.right(), height - (bounds.top() - y)),    vm::vec2f(1.0f, 0.0f));
+                                textures.push_back(cellData(cell).texture);
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (textures.empty()) {
+                return;
+            }
 
-                                shader.set("GrayScale", texture->overridden());
-                                texture->activate();
+            Renderer::ActiveShader shader(shaderManager(), Renderer::Shaders::TextureBrowserShader);
+            shader.set("ApplyTinting", false);
+            shader.set("Texture", 0);
+            shader.set("Brightness", pref(Preferences::Brightness));
 
-                                vertexArray.prepare(vboManager());
-                                vertexArray.render(Renderer::PrimType::Quads);
+            Renderer::VertexArray vertexArray = Renderer::VertexArray::move(std::move(vertices));
+            vertexArray.prepare(vboManager());
 
-                                texture->deactivate();
+            if (vertexArray.setup()) {
+                bool grayScale = textures.front()->overridden();
+                shader.set("GrayScale", grayScale);
 
-                                ++num;
-                            }
-                        }
+                for (size_t i = 0; i < textures.size(); ++i) {
+                    const Assets::Texture* texture = textures[i];
+                    if (texture->overridden() != grayScale) {
+                        grayScale = texture->overridden();
+                        shader.set("GrayScale", grayScale);
                     }
+
+                    texture->activate();
+                    vertexArray.render(Renderer::PrimType::Quads, static_cast<GLint>(4 * i), 4);
+                    texture->deactivate();
                 }
+
+                vertexArray.cleanup();
             }
         }
 
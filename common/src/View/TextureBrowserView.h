@@ -24,6 +24,8 @@
 #include "Renderer/GLVertexType.h"
 #include "View/CellView.h"
 
+#include <kdl/glob_matcher.h>
+
 #include <map>
 #include <memory>
 #include <string>
@@ -68,6 +70,7 @@ namespace TrenchBroom {
             bool m_hideUnused;
             TextureSortOrder m_sortOrder;
             std::string m_filterText;
+            kdl::glob_matcher m_filterMatcher;
 
             Assets::Texture* m_selectedTexture;
         public:
@@ -232,7 +232,7 @@ namespace TrenchBroom {
         }
 
         void UVOriginTool::renderLineHandles(const InputState& inputState, Renderer::RenderContext&, Renderer::RenderBatch& renderBatch) {
-            Renderer::DirectEdgeRenderer edgeRenderer(Renderer::VertexArray::move(getHandleVertices(inputState)), Renderer::PrimType::Lines);
+            Renderer::DirectEdgeRenderer edgeRenderer(Renderer::VertexArray::stream(getHandleVertices(inputState)), Renderer::PrimType::Lines);
             edgeRenderer.renderOnTop(renderBatch, 0.25f);
         }
 
@@ -299,7 +299,7 @@ namespace TrenchBroom {
 
             const Color edgeColor(1.0f, 1.0f, 1.0f, 1.0f); // TODO: make this a preference
 
-            Renderer::DirectEdgeRenderer edgeRenderer(Renderer::VertexArray::move(std::move(edgeVertices)), Renderer::PrimType::LineLoop);
+            Renderer::DirectEdgeRenderer edgeRenderer(Renderer::VertexArray::stream(std::move(edgeVertices)), Renderer::PrimType::LineLoop);
             edgeRenderer.renderOnTop(renderBatch, edgeColor, 2.5f);
         }
 
@@ -316,7 +316,7 @@ namespace TrenchBroom {
             const auto length = 32.0f / m_helper.cameraZoom();
 
             using Vertex = Renderer::GLVertexTypes::P3C4::Vertex;
-            Renderer::DirectEdgeRenderer edgeRenderer(Renderer::VertexArray::move(std::vector<Vertex>({
+            Renderer::DirectEdgeRenderer edgeRenderer(Renderer::VertexArray::stream(std::vector<Vertex>({
                 Vertex(center, pref(Preferences::XAxisColor)),
                 Vertex(center + length * xAxis, pref(Preferences::XAxisColor)),
                 Vertex(center, pref(Preferences::YAxisColor)),
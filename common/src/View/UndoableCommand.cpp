@@ -60,6 +60,14 @@ namespace TrenchBroom {
             return doCollateWith(command);
         }
 
+        size_t UndoableCommand::memoryUsage() const {
+            return doGetMemoryUsage();
+        }
+
+        void UndoableCommand::spill(const std::shared_ptr<IO::SpillFile>& file) {
+            doSpill(file);
+        }
+
         bool UndoableCommand::doIsRepeatDelimiter() const {
             return false;
         }
@@ -68,6 +76,12 @@ namespace TrenchBroom {
             throw CommandProcessorException("Command is not repeatable");
         }
 
+        size_t UndoableCommand::doGetMemoryUsage() const {
+            return sizeof(*this) + name().capacity();
+        }
+
+        void UndoableCommand::doSpill(const std::shared_ptr<IO::SpillFile>& /* file */) {}
+
         size_t UndoableCommand::documentModificationCount() const {
             throw CommandProcessorException("Command does not modify the document");
         }
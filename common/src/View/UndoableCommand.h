@@ -27,6 +27,10 @@
 #include <string>
 
 namespace TrenchBroom {
+    namespace IO {
+        class SpillFile;
+    }
+
     namespace View {
         class MapDocumentCommandFacade;
 
@@ -43,6 +47,21 @@ namespace TrenchBroom {
             std::unique_ptr<UndoableCommand> repeat(MapDocumentCommandFacade* document) const;
 
             virtual bool collateWith(UndoableCommand* command);
+
+            /**
+             * Returns an estimate of the number of bytes occupied by this command while it is stored in the command
+             * history, including any snapshots it holds.
+             */
+            size_t memoryUsage() const;
+
+            /**
+             * Moves the data that this command needs to be undone, such as its snapshots, out of memory and into the
+             * given file if the command supports this. The data is read back when the command is undone. Commands that
+             * own nodes keep them in memory.
+             *
+             * @throws FileSystemException if the data cannot be written
+             */
+            void spill(const std::shared_ptr<IO::SpillFile>& file);
         private:
             virtual std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade* document) = 0;
 
@@ -51,6 +70,9 @@ namespace TrenchBroom {
             virtual std::unique_ptr<UndoableCommand> doRepeat(MapDocumentCommandFacade* document) const;
 
             virtual bool doCollateWith(UndoableCommand* command) = 0;
+
+            virtual size_t doGetMemoryUsage() const;
+            virtual void doSpill(const std::shared_ptr<IO::SpillFile>& file);
         public: // this method is just a service for DocumentCommand and should never be called from anywhere else
             virtual size_t documentModificationCount() const;
 
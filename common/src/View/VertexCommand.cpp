@@ -167,6 +167,20 @@ namespace TrenchBroom {
             m_snapshot.reset();
         }
 
+        size_t VertexCommand::doGetMemoryUsage() const {
+            size_t result = sizeof(*this) + name().capacity();
+            if (m_snapshot != nullptr) {
+                result += m_snapshot->memoryUsage();
+            }
+            return result;
+        }
+
+        void VertexCommand::doSpill(const std::shared_ptr<IO::SpillFile>& file) {
+            if (m_snapshot != nullptr) {
+                m_snapshot->spill(file);
+            }
+        }
+
         bool VertexCommand::canCollateWith(const VertexCommand& other) const {
             return m_brushes == other.m_brushes;
         }
@@ -97,6 +97,9 @@ namespace TrenchBroom {
         private:
             void takeSnapshot();
             void deleteSnapshot();
+
+            size_t doGetMemoryUsage() const override;
+            void doSpill(const std::shared_ptr<IO::SpillFile>& file) override;
         protected:
             bool canCollateWith(const VertexCommand& other) const;
         private:
@@ -29,10 +29,17 @@
 
 #include <kdl/vector_set.h>
 
+#include <vecmath/bbox.h>
+#include <vecmath/intersection.h>
+#include <vecmath/polygon.h>
 #include <vecmath/segment.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <iterator>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -43,6 +50,42 @@ namespace TrenchBroom {
     namespace View {
         class Grid;
 
+        /**
+         * Returns the point at which the given handle is stored in the spatial hash of a handle manager.
+         */
+        inline vm::vec3 handleAnchor(const vm::vec3& handle) {
+            return handle;
+        }
+
+        inline vm::vec3 handleAnchor(const vm::segment3& handle) {
+            return handle.center();
+        }
+
+        inline vm::vec3 handleAnchor(const vm::polygon3& handle) {
+            return handle.center();
+        }
+
+        /**
+         * Returns the bounds of the given handle, that is, the smallest box that contains every point at which the
+         * handle can be picked.
+         */
+        inline vm::bbox3 handleBounds(const vm::vec3& handle) {
+            return vm::bbox3(handle, handle);
+        }
+
+        inline vm::bbox3 handleBounds(const vm::segment3& handle) {
+            return vm::merge(vm::bbox3(handle.start(), handle.start()), handle.end());
+        }
+
+        inline vm::bbox3 handleBounds(const vm::polygon3& handle) {
+            const auto center = handle.center();
+            auto result = vm::bbox3(center, center);
+            for (const auto& vertex : handle) {
+                result = vm::merge(result, vertex);
+            }
+            return result;
+        }
+
         class VertexHandleManagerBase {
         public:
             virtual ~VertexHandleManagerBase();
@@ -67,7 +110,7 @@ namespace TrenchBroom {
              *
              * @param brush the brush whose handles to add
              */
-            virtual void addHandles(const Model::Brush* brush) = 0;
+            virtual void addHandles(Model::Brush* brush) = 0;
 
             /**
              * Removes all handles of the given range of brushes from this handle manager.
@@ -89,7 +132,7 @@ namespace TrenchBroom {
              *
              * @param brush the brush whose handles to remove
              */
-            virtual void removeHandles(const Model::Brush* brush) = 0;
+            virtual void removeHandles(Model::Brush* brush) = 0;
         };
 
         template <typename H>
@@ -106,6 +149,11 @@ namespace TrenchBroom {
             struct HandleInfo {
                 size_t count;
                 bool selected;
+                /**
+                 * The brushes that contributed this handle, if known. Contains one entry per call to add with a
+                 * brush, so a brush may appear more than once.
+                 */
+                std::vector<Model::Brush*> brushes;
 
                 HandleInfo() :
                 count(0),
@@ -161,18 +209,60 @@ namespace TrenchBroom {
             using HandleMap = std::map<H, HandleInfo>;
             using HandleEntry = typename HandleMap::value_type;
 
+            /**
+             * Integer coordinates of a cell of the spatial hash.
+             */
+            struct CellKey {
+                long x;
+                long y;
+                long z;
+
+                bool operator==(const CellKey& other) const {
+                    return x == other.x && y == other.y && z == other.z;
+                }
+            };
+
+            struct CellKeyHash {
+                size_t operator()(const CellKey& key) const {
+                    // the usual large primes for spatial hashing, see Teschner et al., "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+                    return static_cast<size_t>(key.x * 73856093L) ^ static_cast<size_t>(key.y * 19349663L) ^ static_cast<size_t>(key.z * 83492791L);
+                }
+            };
+
+            /**
+             * A cell of the spatial hash. Each handle is stored in the cell that contains its anchor point. The cell
+             * bounds contain the bounds of every handle that was ever stored in the cell, so they may be larger than
+             * necessary after handles were removed, but they are never too small.
+             */
+            struct Cell {
+                vm::bbox3 bounds;
+                std::vector<HandleEntry*> entries;
+            };
+
+            using CellMap = std::unordered_map<CellKey, Cell, CellKeyHash>;
+
             /**
              * Maps a handle position to its info.
              */
             HandleMap m_handles;
 
+            /**
+             * Spatial hash over the entries of m_handles. The entries are referenced by pointer, which is safe because
+             * std::map never moves its nodes.
+             */
+            CellMap m_cells;
+            FloatType m_cellSize;
+
             /**
              * The total number of selected handles, not counting duplicates.
              */
             size_t m_selectedHandleCount;
         public:
-            VertexHandleManagerBaseT() :
-            m_selectedHandleCount(0) {}
+            explicit VertexHandleManagerBaseT(const FloatType cellSize = static_cast<FloatType>(64.0)) :
+            m_cellSize(cellSize),
+            m_selectedHandleCount(0) {
+                assert(m_cellSize > static_cast<FloatType>(0.0));
+            }
 
             virtual ~VertexHandleManagerBaseT() {}
         public:
@@ -303,7 +393,17 @@ namespace TrenchBroom {
              * @param handle the handle to add
              */
             void add(const Handle& handle) {
-                m_handles[handle].inc(); // unknown value gets value constructed, which for HandleInfo means its default constructor is called
+                doAdd(handle);
+            }
+
+            /**
+             * Adds the given handle to this manager and records the given brush as being incident to it.
+             *
+             * @param handle the handle to add
+             * @param brush the brush which the handle belongs to
+             */
+            void add(const Handle& handle, Model::Brush* brush) {
+                doAdd(handle).brushes.push_back(brush);
             }
 
             /**
@@ -313,13 +413,57 @@ namespace TrenchBroom {
              * @return true if the given handle was contained in this manager (and therefore removed) and false otherwise
              */
             bool remove(const Handle& handle) {
+                return doRemove(handle, nullptr);
+            }
+
+            /**
+             * Removes the given handle from this manager and forgets that the given brush is incident to it.
+             *
+             * @param handle the handle to remove
+             * @param brush the brush which the handle belongs to
+             * @return true if the given handle was contained in this manager (and therefore removed) and false otherwise
+             */
+            bool remove(const Handle& handle, Model::Brush* brush) {
+                return doRemove(handle, brush);
+            }
+
+            /**
+             * Removes all handles from this manager.
+             */
+            void clear() {
+                m_cells.clear();
+                m_handles.clear();
+                m_selectedHandleCount = 0;
+            }
+        private:
+            HandleInfo& doAdd(const Handle& handle) {
+                // unknown value gets value constructed, which for HandleInfo means its default constructor is called
+                const auto [it, inserted] = m_handles.try_emplace(handle);
+                if (inserted) {
+                    insertIntoCell(*it);
+                }
+
+                HandleInfo& info = it->second;
+                info.inc();
+                return info;
+            }
+
+            bool doRemove(const Handle& handle, Model::Brush* brush) {
                 const auto it = m_handles.find(handle);
                 if (it != std::end(m_handles)) {
                     HandleInfo& info = it->second;
                     info.dec();
 
+                    if (brush != nullptr) {
+                        const auto bIt = std::find(std::begin(info.brushes), std::end(info.brushes), brush);
+                        if (bIt != std::end(info.brushes)) {
+                            info.brushes.erase(bIt);
+                        }
+                    }
+
                     if (info.count == 0) {
                         deselect(info);
+                        removeFromCell(*it);
                         m_handles.erase(it);
                     }
                     return true;
@@ -327,15 +471,7 @@ namespace TrenchBroom {
 
                 return false;
             }
-
-            /**
-             * Removes all handles from this manager.
-             */
-            void clear() {
-                m_handles.clear();
-                m_selectedHandleCount = 0;
-            }
-
+        public:
             /**
              * Selects the given range of handles.
              *
@@ -420,16 +556,140 @@ namespace TrenchBroom {
                 }
             }
         private:
+            static constexpr FloatType CloseHandleEpsilon = static_cast<FloatType>(0.001 * 0.001);
+
             template <typename F>
             void forEachCloseHandle(const H& handle, F fun) {
-                static const auto epsilon = 0.001 * 0.001;
-                for (auto& entry : m_handles) {
-                    if (compare(handle, entry.first, epsilon) == 0) {
-                        fun(entry.second);
+                const auto anchor = handleAnchor(handle);
+                const auto bounds = vm::bbox3(anchor, anchor).expand(CloseHandleEpsilon);
+                forEachCell(bounds, [&](const Cell& cell) {
+                    for (HandleEntry* entry : cell.entries) {
+                        if (compare(handle, entry->first, CloseHandleEpsilon) == 0) {
+                            fun(entry->second);
+                        }
+                    }
+                });
+            }
+
+            CellKey cellKey(const vm::vec3& point) const {
+                return CellKey{
+                    static_cast<long>(std::floor(point.x() / m_cellSize)),
+                    static_cast<long>(std::floor(point.y() / m_cellSize)),
+                    static_cast<long>(std::floor(point.z() / m_cellSize))
+                };
+            }
+
+            void insertIntoCell(HandleEntry& entry) {
+                const auto key = cellKey(handleAnchor(entry.first));
+                const auto bounds = handleBounds(entry.first);
+
+                const auto [it, inserted] = m_cells.try_emplace(key);
+                Cell& cell = it->second;
+                cell.bounds = inserted ? bounds : vm::merge(cell.bounds, bounds);
+                cell.entries.push_back(&entry);
+            }
+
+            void removeFromCell(HandleEntry& entry) {
+                const auto it = m_cells.find(cellKey(handleAnchor(entry.first)));
+                assert(it != std::end(m_cells));
+
+                auto& entries = it->second.entries;
+                const auto eIt = std::find(std::begin(entries), std::end(entries), &entry);
+                assert(eIt != std::end(entries));
+
+                *eIt = entries.back();
+                entries.pop_back();
+
+                if (entries.empty()) {
+                    m_cells.erase(it);
+                }
+            }
+
+            /**
+             * Calls the given function for every non-empty cell whose key range overlaps with the given bounds.
+             */
+            template <typename F>
+            void forEachCell(const vm::bbox3& bounds, F fun) const {
+                const auto min = cellKey(bounds.min);
+                const auto max = cellKey(bounds.max);
+
+                // if the key range is larger than the number of non-empty cells, it's cheaper to test every cell
+                const auto rangeSize =
+                    static_cast<double>(max.x - min.x + 1) *
+                    static_cast<double>(max.y - min.y + 1) *
+                    static_cast<double>(max.z - min.z + 1);
+                if (rangeSize > static_cast<double>(m_cells.size())) {
+                    for (const auto& [key, cell] : m_cells) {
+                        if (key.x >= min.x && key.x <= max.x &&
+                            key.y >= min.y && key.y <= max.y &&
+                            key.z >= min.z && key.z <= max.z) {
+                            fun(cell);
+                        }
+                    }
+                } else {
+                    for (long x = min.x; x <= max.x; ++x) {
+                        for (long y = min.y; y <= max.y; ++y) {
+                            for (long z = min.z; z <= max.z; ++z) {
+                                const auto it = m_cells.find(CellKey{x, y, z});
+                                if (it != std::end(m_cells)) {
+                                    fun(it->second);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        protected:
+            /**
+             * Calls the given function for every handle in every cell that passes the given cell test. The cell test
+             * is given the bounds of a cell and must return true if the cell may contain handles of interest.
+             *
+             * @tparam C the type of the cell test
+             * @tparam F the type of the function to call for each handle
+             * @param cellTest the cell test
+             * @param fun the function to call
+             */
+            template <typename C, typename F>
+            void forEachHandleInCells(const C& cellTest, F fun) const {
+                for (const auto& [key, cell] : m_cells) {
+                    if (cellTest(cell.bounds)) {
+                        for (const HandleEntry* entry : cell.entries) {
+                            fun(entry->first);
+                        }
                     }
                 }
             }
 
+            /**
+             * Calls the given function for every handle whose cell may be hit by the given pick ray, taking into
+             * account that handles are picked using spheres whose radii depend on the camera.
+             *
+             * @tparam F the type of the function to call for each handle
+             * @param pickRay the pick ray
+             * @param camera the camera
+             * @param handleRadius the handle radius
+             * @param fun the function to call
+             */
+            template <typename F>
+            void forEachHandleNearRay(const vm::ray3& pickRay, const Renderer::Camera& camera, const FloatType handleRadius, F fun) const {
+                forEachHandleInCells([&](const vm::bbox3& bounds) {
+                    // Camera::pickPointHandle uses a sphere of radius 2 * handleRadius * scaling, where the scaling
+                    // factor is linear in the distance to the camera, so its maximum is attained at a corner
+                    auto maxScaling = 0.0f;
+                    for (size_t i = 0u; i < 8u; ++i) {
+                        const auto corner = vm::vec3(
+                            (i & 1u) ? bounds.max.x() : bounds.min.x(),
+                            (i & 2u) ? bounds.max.y() : bounds.min.y(),
+                            (i & 4u) ? bounds.max.z() : bounds.min.z());
+                        maxScaling = std::max(maxScaling, std::abs(camera.perspectiveScalingFactor(vm::vec3f(corner))));
+                    }
+
+                    const auto radius = static_cast<FloatType>(2.0) * handleRadius * static_cast<FloatType>(maxScaling);
+                    const auto expanded = bounds.expand(radius);
+                    return expanded.contains(pickRay.origin) || !vm::is_nan(vm::intersect_ray_bbox(pickRay, expanded));
+                }, fun);
+            }
+        private:
             void select(HandleInfo& info) {
                 if (info.select()) {
                     assert(selectedHandleCount() < totalHandleCount());
@@ -471,7 +731,101 @@ namespace TrenchBroom {
                     }
                 }
             }
+
+            /**
+             * Returns all handles whose bounds intersect with the given bounds.
+             *
+             * @param bounds the bounds to test
+             * @return a list of the handles within the given bounds
+             */
+            HandleList findHandles(const vm::bbox3& bounds) const {
+                HandleList result;
+                forEachHandleInCells(
+                    [&](const vm::bbox3& cellBounds) { return cellBounds.intersects(bounds); },
+                    [&](const Handle& handle) {
+                        if (handleBounds(handle).intersects(bounds)) {
+                            result.push_back(handle);
+                        }
+                    });
+                return result;
+            }
+
+            /**
+             * Returns all handles which are selected by the given lasso. Cells which the lasso cannot select from are
+             * skipped entirely.
+             *
+             * @tparam L the type of the lasso, which is a template parameter only to avoid including its header here
+             * @param lasso the lasso
+             * @return a list of the handles selected by the given lasso
+             */
+            template <typename L>
+            HandleList findHandles(const L& lasso) const {
+                HandleList result;
+                forEachHandleInCells(
+                    [&](const vm::bbox3& cellBounds) { return lasso.mayContain(cellBounds); },
+                    [&](const Handle& handle) {
+                        if (lasso.selects(handle)) {
+                            result.push_back(handle);
+                        }
+                    });
+                return result;
+            }
         public:
+            /**
+             * Finds and returns all brushes which were added to this manager via addHandles and which are incident to
+             * the given handle. This is a lookup in the spatial hash and does not depend on the number of brushes.
+             *
+             * @param handle the handle
+             * @return a set of all brushes that are incident to the given handle
+             */
+            std::vector<Model::Brush*> findIncidentBrushes(const Handle& handle) const {
+                kdl::vector_set<Model::Brush*> result;
+                findIncidentBrushes(handle, std::inserter(result, std::end(result)));
+                return result.release_data();
+            }
+
+            /**
+             * Finds and returns all brushes which were added to this manager via addHandles and which are incident to
+             * any handle in the given range.
+             *
+             * @tparam I the type of range iterators for the range of handles
+             * @param hBegin the beginning of the range of handles
+             * @param hEnd the end of the range of handles
+             * @return a set containing all incident brushes
+             */
+            template <typename I>
+            std::vector<Model::Brush*> findIncidentBrushes(I hBegin, I hEnd) const {
+                kdl::vector_set<Model::Brush*> result;
+                auto out = std::inserter(result, std::end(result));
+                for (auto hCur = hBegin; hCur != hEnd; ++hCur) {
+                    findIncidentBrushes(*hCur, out);
+                }
+                return result.release_data();
+            }
+
+            /**
+             * Finds all brushes which were added to this manager via addHandles and which are incident to the given
+             * handle.
+             *
+             * @tparam O an output iterator to append the resulting brushes to
+             * @param handle the handle
+             * @param out an output iterator that accepts the incident brushes
+             */
+            template <typename O>
+            void findIncidentBrushes(const Handle& handle, O out) const {
+                const auto anchor = handleAnchor(handle);
+                const auto bounds = vm::bbox3(anchor, anchor).expand(CloseHandleEpsilon);
+                forEachCell(bounds, [&](const Cell& cell) {
+                    for (const HandleEntry* entry : cell.entries) {
+                        for (Model::Brush* brush : entry->second.brushes) {
+                            if (isIncident(handle, brush)) {
+                                out++ = brush;
+                            }
+                        }
+                    }
+                });
+            }
+
             /**
              * Finds and returns all brushes in the given range which are incident to the given handle.
              *
@@ -558,8 +912,8 @@ namespace TrenchBroom {
              */
             void pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
-            void addHandles(const Model::Brush* brush) override;
-            void removeHandles(const Model::Brush* brush) override;
+            void addHandles(Model::Brush* brush) override;
+            void removeHandles(Model::Brush* brush) override;
 
             Model::HitType::Type hitType() const override;
         private:
@@ -603,8 +957,8 @@ namespace TrenchBroom {
              */
             void pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
-            void addHandles(const Model::Brush* brush) override;
-            void removeHandles(const Model::Brush* brush) override;
+            void addHandles(Model::Brush* brush) override;
+            void removeHandles(Model::Brush* brush) override;
 
             Model::HitType::Type hitType() const override;
         private:
@@ -649,8 +1003,8 @@ namespace TrenchBroom {
              */
             void pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
-            void addHandles(const Model::Brush* brush) override;
-            void removeHandles(const Model::Brush* brush) override;
+            void addHandles(Model::Brush* brush) override;
+            void removeHandles(Model::Brush* brush) override;
 
             Model::HitType::Type hitType() const override;
         private:
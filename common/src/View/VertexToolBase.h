@@ -123,27 +123,18 @@ namespace TrenchBroom {
                 return result;
             }
 
-            // FIXME: use vector_set
+            /*
+             * The handle managers only contain handles of the selected brushes, and they keep track of which brush
+             * contributed which handle, so there is no need to search the selected brushes here.
+             */
             template <typename M, typename H2>
             std::vector<Model::Brush*> findIncidentBrushes(const M& manager, const H2& handle) const {
-                const std::vector<Model::Brush*>& brushes = selectedBrushes();
-                return manager.findIncidentBrushes(handle, std::begin(brushes), std::end(brushes));
+                return manager.findIncidentBrushes(handle);
             }
 
-            // FIXME: use vector_set
             template <typename M, typename I>
             std::vector<Model::Brush*> findIncidentBrushes(const M& manager, I cur, I end) const {
-                const std::vector<Model::Brush*>& brushes = selectedBrushes();
-                kdl::vector_set<Model::Brush*> result;
-                auto out = std::inserter(result, std::end(result));
-
-                while (cur != end) {
-                    const auto& handle = *cur;
-                    manager.findIncidentBrushes(handle, std::begin(brushes), std::end(brushes), out);
-                    ++cur;
-                }
-
-                return result.release_data();
+                return manager.findIncidentBrushes(cur, end);
             }
 
             virtual void pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const = 0;
@@ -182,10 +173,7 @@ namespace TrenchBroom {
             void select(const Lasso& lasso, const bool modifySelection) {
                 using HandleList = std::vector<H>;
 
-                const HandleList allHandles = handleManager().allHandles();
-                HandleList selectedHandles;
-
-                lasso.selected(std::begin(allHandles), std::end(allHandles), std::back_inserter(selectedHandles));
+                const HandleList selectedHandles = handleManager().findHandles(lasso);
                 if (!modifySelection) {
                     handleManager().deselectAll();
                 }
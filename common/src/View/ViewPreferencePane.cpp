@@ -34,6 +34,7 @@
 #include <QCheckBox>
 #include <QComboBox>
 #include <QLabel>
+#include <QSpinBox>
 
 #include <array>
 #include <string>
@@ -116,6 +117,9 @@ namespace TrenchBroom {
             m_showAxes = new QCheckBox();
             m_showAxes->setToolTip("Toggle showing the coordinate system axes in the 3D editing view.");
 
+            m_occlusionCulling = new QCheckBox();
+            m_occlusionCulling->setToolTip("Skip rendering objects that are hidden behind large world brushes in the 3D editing view.");
+
             m_textureModeCombo = new QComboBox();
             m_textureModeCombo->setToolTip("Sets the texture filtering mode in the editing views.");
             for (const auto& textureMode : TextureModes) {
@@ -145,6 +149,16 @@ namespace TrenchBroom {
             m_rendererFontSizeCombo->addItems({ "8", "9", "10", "11", "12", "13", "14", "15", "16", "17", "18", "19", "20", "22", "24", "26", "28", "32", "36", "40", "48", "56", "64", "72" });
             m_rendererFontSizeCombo->setValidator(new QIntValidator(1, 96));
 
+            m_undoMemoryBudgetSpinBox = new QSpinBox();
+            m_undoMemoryBudgetSpinBox->setRange(0, 65536);
+            m_undoMemoryBudgetSpinBox->setSingleStep(64);
+            m_undoMemoryBudgetSpinBox->setSuffix(" MB");
+            m_undoMemoryBudgetSpinBox->setSpecialValueText("Unlimited");
+            m_undoMemoryBudgetSpinBox->setToolTip("Sets the amount of memory the undo history of a map may use. The oldest steps are moved to disk when it is exceeded.");
+
+            m_undoDiscardOverBudget = new QCheckBox();
+            m_undoDiscardOverBudget->setToolTip("Discard the oldest undo steps if the undo history still exceeds its memory budget after moving them to disk.");
+
             auto* layout = new FormWithSectionsLayout();
             layout->setContentsMargins(0, LayoutConstants::MediumVMargin, 0, 0);
             layout->setVerticalSpacing(2);
@@ -160,6 +174,7 @@ namespace TrenchBroom {
             layout->addRow("Grid", m_gridAlphaSlider);
             layout->addRow("FOV", m_fovSlider);
             layout->addRow("Show axes", m_showAxes);
+            layout->addRow("Occlusion culling", m_occlusionCulling);
             layout->addRow("Texture mode", m_textureModeCombo);
 
             layout->addSection("Colors");
@@ -173,6 +188,10 @@ namespace TrenchBroom {
             layout->addSection("Fonts");
             layout->addRow("Renderer Font Size", m_rendererFontSizeCombo);
 
+            layout->addSection("Undo History");
+            layout->addRow("Memory budget", m_undoMemoryBudgetSpinBox);
+            layout->addRow("Discard over budget", m_undoDiscardOverBudget);
+
             viewBox->setMinimumWidth(400);
             viewBox->setLayout(layout);
 
@@ -185,6 +204,7 @@ namespace TrenchBroom {
             connect(m_gridAlphaSlider, &SliderWithLabel::valueChanged, this, &ViewPreferencePane::gridAlphaChanged);
             connect(m_fovSlider, &SliderWithLabel::valueChanged, this, &ViewPreferencePane::fovChanged);
             connect(m_showAxes, &QCheckBox::stateChanged, this, &ViewPreferencePane::showAxesChanged);
+            connect(m_occlusionCulling, &QCheckBox::stateChanged, this, &ViewPreferencePane::occlusionCullingChanged);
             connect(m_backgroundColorButton, &ColorButton::colorChanged, this, &ViewPreferencePane::backgroundColorChanged);
             connect(m_gridColorButton, &ColorButton::colorChanged, this, &ViewPreferencePane::gridColorChanged);
             connect(m_edgeColorButton, &ColorButton::colorChanged, this, &ViewPreferencePane::edgeColorChanged);
@@ -192,6 +212,8 @@ namespace TrenchBroom {
             connect(m_textureModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ViewPreferencePane::textureModeChanged);
             connect(m_textureBrowserIconSizeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ViewPreferencePane::textureBrowserIconSizeChanged);
             connect(m_rendererFontSizeCombo, &QComboBox::currentTextChanged, this, &ViewPreferencePane::rendererFontSizeChanged);
+            connect(m_undoMemoryBudgetSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &ViewPreferencePane::undoMemoryBudgetChanged);
+            connect(m_undoDiscardOverBudget, &QCheckBox::stateChanged, this, &ViewPreferencePane::undoDiscardOverBudgetChanged);
         }
 
         bool ViewPreferencePane::doCanResetToDefaults() {
@@ -205,6 +227,7 @@ namespace TrenchBroom {
             prefs.resetToDefault(Preferences::GridAlpha);
             prefs.resetToDefault(Preferences::CameraFov);
             prefs.resetToDefault(Preferences::ShowAxes);
+            prefs.resetToDefault(Preferences::OcclusionCulling);
             prefs.resetToDefault(Preferences::TextureMinFilter);
             prefs.resetToDefault(Preferences::TextureMagFilter);
             prefs.resetToDefault(Preferences::BackgroundColor);
@@ -213,6 +236,8 @@ namespace TrenchBroom {
             prefs.resetToDefault(Preferences::Theme);
             prefs.resetToDefault(Preferences::TextureBrowserIconSize);
             prefs.resetToDefault(Preferences::RendererFontSize);
+            prefs.resetToDefault(Preferences::UndoMemoryBudget);
+            prefs.resetToDefault(Preferences::UndoDiscardOverBudget);
         }
 
         void ViewPreferencePane::doUpdateControls() {
@@ -225,6 +250,7 @@ namespace TrenchBroom {
             m_textureModeCombo->setCurrentIndex(int(textureModeIndex));
 
             m_showAxes->setChecked(pref(Preferences::ShowAxes));
+            m_occlusionCulling->setChecked(pref(Preferences::OcclusionCulling));
 
             m_backgroundColorButton->setColor(toQColor(pref(Preferences::BackgroundColor)));
             m_gridColorButton->setColor(toQColor(pref(Preferences::GridColor2D)));
@@ -249,6 +275,8 @@ namespace TrenchBroom {
             }
 
             m_rendererFontSizeCombo->setCurrentText(QString::asprintf("%i", pref(Preferences::RendererFontSize)));
+            m_undoMemoryBudgetSpinBox->setValue(pref(Preferences::UndoMemoryBudget));
+            m_undoDiscardOverBudget->setChecked(pref(Preferences::UndoDiscardOverBudget));
         }
 
         bool ViewPreferencePane::doValidate() {
@@ -303,6 +331,12 @@ namespace TrenchBroom {
             prefs.set(Preferences::ShowAxes, value);
         }
 
+        void ViewPreferencePane::occlusionCullingChanged(const int state) {
+            const auto value = state == Qt::Checked;
+            auto& prefs = PreferenceManager::instance();
+            prefs.set(Preferences::OcclusionCulling, value);
+        }
+
         void ViewPreferencePane::textureModeChanged(const int value) {
             const auto index = static_cast<size_t>(value);
             assert(index < TextureModes.size());
@@ -373,5 +407,16 @@ namespace TrenchBroom {
                 prefs.set(Preferences::RendererFontSize, value);
             }
         }
+
+        void ViewPreferencePane::undoMemoryBudgetChanged(const int value) {
+            auto& prefs = PreferenceManager::instance();
+            prefs.set(Preferences::UndoMemoryBudget, value);
+        }
+
+        void ViewPreferencePane::undoDiscardOverBudgetChanged(const int state) {
+            const auto value = state == Qt::Checked;
+            auto& prefs = PreferenceManager::instance();
+            prefs.set(Preferences::UndoDiscardOverBudget, value);
+        }
     }
 }
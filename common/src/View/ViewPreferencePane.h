@@ -24,6 +24,7 @@
 
 class QCheckBox;
 class QComboBox;
+class QSpinBox;
 
 namespace TrenchBroom {
     namespace View {
@@ -38,6 +39,7 @@ namespace TrenchBroom {
             SliderWithLabel* m_gridAlphaSlider;
             SliderWithLabel* m_fovSlider;
             QCheckBox* m_showAxes;
+            QCheckBox* m_occlusionCulling;
             QComboBox* m_textureModeCombo;
             ColorButton* m_backgroundColorButton;
             ColorButton* m_gridColorButton;
@@ -45,6 +47,8 @@ namespace TrenchBroom {
             QComboBox* m_themeCombo;
             QComboBox* m_textureBrowserIconSizeCombo;
             QComboBox* m_rendererFontSizeCombo;
+            QSpinBox* m_undoMemoryBudgetSpinBox;
+            QCheckBox* m_undoDiscardOverBudget;
         public:
             explicit ViewPreferencePane(QWidget* parent = nullptr);
        private:
@@ -66,6 +70,7 @@ namespace TrenchBroom {
             void gridAlphaChanged(int value);
             void fovChanged(int value);
             void showAxesChanged(int state);
+            void occlusionCullingChanged(int state);
             void textureModeChanged(int index);
             void backgroundColorChanged(const QColor& color);
             void gridColorChanged(const QColor& color);
@@ -73,6 +78,8 @@ namespace TrenchBroom {
             void themeChanged(int index);
             void textureBrowserIconSizeChanged(int index);
             void rendererFontSizeChanged(const QString& text);
+            void undoMemoryBudgetChanged(int value);
+            void undoDiscardOverBudgetChanged(int state);
         };
     }
 }
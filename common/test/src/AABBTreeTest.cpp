@@ -25,8 +25,10 @@
 #include <vecmath/ray.h>
 #include "AABBTree.h"
 
+#include <iterator>
 #include <set>
 #include <sstream>
+#include <vector>
 
 namespace TrenchBroom {
     using AABB = AABBTree<double, 3, size_t>;
@@ -445,6 +447,45 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         return BOX(VEC(static_cast<double>(min), -1.0, -1.0), VEC(static_cast<double>(max), 1.0, 1.0));
     }
 
+    TEST_CASE("AABBTreeTest.clearAndBuild", "[AABBTreeTest]") {
+        std::vector<BOX> boxes;
+        std::vector<size_t> data;
+        for (size_t i = 0u; i < 100u; ++i) {
+            const auto x = static_cast<double>(i % 10u) * 4.0;
+            const auto y = static_cast<double>(i / 10u) * 4.0;
+            boxes.push_back(BOX(VEC(x, y, 0.0), VEC(x + 2.0, y + 2.0, 2.0)));
+            data.push_back(i);
+        }
+
+        AABB tree;
+        tree.insert(BOX(VEC(-8.0, -8.0, -8.0), VEC(-4.0, -4.0, -4.0)), 1000u);
+
+        tree.clearAndBuild(data, [&](const size_t i) { return boxes[i]; });
+        ASSERT_EQ(100u, tree.size());
+        ASSERT_FALSE(tree.contains(1000u));
+        ASSERT_EQ(BOX(VEC(0.0, 0.0, 0.0), VEC(38.0, 38.0, 2.0)), tree.bounds());
+
+        // the tree is balanced
+        ASSERT_EQ(8u, tree.height());
+
+        for (size_t i = 0u; i < 100u; ++i) {
+            assertTreeContains(tree, boxes[i], i);
+        }
+
+        // the tree can be modified after it was built
+        ASSERT_TRUE(tree.remove(42u));
+        tree.insert(boxes[42u], 42u);
+        assertTreeContains(tree, boxes[42u], 42u);
+
+        // duplicates are rejected and leave the tree empty
+        ASSERT_THROW(tree.clearAndBuild(std::vector<size_t>({ 1u, 2u, 1u }), [&](const size_t i) { return boxes[i]; }), NodeTreeException);
+        ASSERT_TRUE(tree.empty());
+        ASSERT_EQ(0u, tree.size());
+
+        tree.clearAndBuild(std::vector<size_t>(), [&](const size_t i) { return boxes[i]; });
+        ASSERT_TRUE(tree.empty());
+    }
+
     TEST_CASE("AABBTreeTest.findIntersectorsOfEmptyTree", "[AABBTreeTest]") {
         AABB tree;
         assertIntersectors(tree, RAY(VEC::zero(), VEC::pos_x()), {});
@@ -489,6 +530,76 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x()), { 2u });
     }
 
+    TEST_CASE("AABBTreeTest.findMatching", "[AABBTreeTest]") {
+        AABB tree;
+
+        std::set<AABB::DataType> actual;
+        tree.findMatching([](const BOX&) { return true; }, std::inserter(actual, std::end(actual)));
+        ASSERT_TRUE(actual.empty());
+
+        tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(+6.0, -1.0, -1.0), VEC(+8.0, +1.0, +1.0)), 3u);
+
+        tree.findMatching([](const BOX& box) { return box.max.x() > 0.0; }, std::inserter(actual, std::end(actual)));
+        ASSERT_EQ(std::set<AABB::DataType>({ 2u, 3u }), actual);
+
+        actual.clear();
+        size_t testedBoxes = 0u;
+
+        // the subtree containing 2 and 3 is skipped
+        tree.findMatching([&](const BOX& box) { ++testedBoxes; return box.min.x() < 0.0; }, std::inserter(actual, std::end(actual)));
+        ASSERT_EQ(std::set<AABB::DataType>({ 1u }), actual);
+        ASSERT_EQ(3u, testedBoxes);
+    }
+
+    TEST_CASE("AABBTreeTest.findMatchingWithFilter", "[AABBTreeTest]") {
+        AABB tree;
+        tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(+6.0, -1.0, -1.0), VEC(+8.0, +1.0, +1.0)), 3u);
+
+        std::set<AABB::DataType> actual;
+        tree.findMatching([](const BOX& box) { return box.max.x() > 0.0; }, [](const size_t data) { return data != 2u; }, std::inserter(actual, std::end(actual)));
+        ASSERT_EQ(std::set<AABB::DataType>({ 3u }), actual);
+    }
+
+    TEST_CASE("AABBTreeTest.findNearest", "[AABBTreeTest]") {
+        const auto acceptAll = [](const size_t) { return true; };
+
+        AABB tree;
+
+        std::vector<AABB::DataType> actual;
+        tree.findNearest(VEC(0.0, 0.0, 0.0), 2u, acceptAll, std::back_inserter(actual));
+        ASSERT_TRUE(actual.empty());
+
+        tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(+3.0, -1.0, -1.0), VEC(+5.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(+6.0, -1.0, -1.0), VEC(+8.0, +1.0, +1.0)), 3u);
+        tree.insert(BOX(VEC(-1.0, +9.0, -1.0), VEC(+1.0, 11.0, +1.0)), 4u);
+
+        tree.findNearest(VEC(0.0, 0.0, 0.0), 2u, acceptAll, std::back_inserter(actual));
+        ASSERT_EQ(std::vector<AABB::DataType>({ 1u, 2u }), actual);
+
+        actual.clear();
+        tree.findNearest(VEC(7.0, 0.0, 0.0), 1u, acceptAll, std::back_inserter(actual));
+        ASSERT_EQ(std::vector<AABB::DataType>({ 3u }), actual);
+
+        // filtered items do not count
+        actual.clear();
+        tree.findNearest(VEC(0.0, 0.0, 0.0), 2u, [](const size_t data) { return data != 2u; }, std::back_inserter(actual));
+        ASSERT_EQ(std::vector<AABB::DataType>({ 1u, 3u }), actual);
+
+        // fewer items than requested
+        actual.clear();
+        tree.findNearest(VEC(0.0, 0.0, 0.0), 10u, acceptAll, std::back_inserter(actual));
+        ASSERT_EQ(std::vector<AABB::DataType>({ 1u, 2u, 3u, 4u }), actual);
+
+        actual.clear();
+        tree.findNearest(VEC(0.0, 0.0, 0.0), 0u, acceptAll, std::back_inserter(actual));
+        ASSERT_TRUE(actual.empty());
+    }
+
     void assertTree(const std::string& exp, const AABB& actual) {
         std::stringstream str;
         actual.print(str);
@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static Texture* makeTexture(const std::string& name, const size_t width, const size_t height, const size_t mipmapCount, const TextureType type = TextureType::Opaque) {
+            auto buffers = std::vector<std::vector<unsigned char>>();
+            for (size_t level = 0; level < mipmapCount; ++level) {
+                const auto mipSize = sizeAtMipLevel(width, height, level);
+                buffers.emplace_back(mipSize.x() * mipSize.y() * 4u, static_cast<unsigned char>(0));
+            }
+            return new Texture(name, width, height, Color(), std::move(buffers), GL_RGBA, type);
+        }
+
+        TEST_CASE("TextureCollectionTest.textureArrayGroupsBySizeAndType", "[TextureCollectionTest]") {
+            auto* small1 = makeTexture("small1", 64, 64, 4);
+            auto* large1 = makeTexture("large1", 128, 64, 4);
+            auto* small2 = makeTexture("small2", 64, 64, 4);
+            auto* large2 = makeTexture("large2", 128, 64, 4);
+            auto* masked1 = makeTexture("masked1", 64, 64, 4, TextureType::Masked);
+            auto* masked2 = makeTexture("masked2", 64, 64, 1, TextureType::Masked);
+            auto textures = std::vector<Texture*>({ small1, large1, small2, large2, masked1, masked2 });
+
+            const auto groups = TextureCollection::textureArrayGroups(textures, 256u);
+            ASSERT_EQ(3u, groups.size());
+            ASSERT_EQ(std::vector<Texture*>({ small1, small2 }), groups[0]);
+            ASSERT_EQ(std::vector<Texture*>({ masked1, masked2 }), groups[1]);
+            ASSERT_EQ(std::vector<Texture*>({ large1, large2 }), groups[2]);
+
+            kdl::vec_clear_and_delete(textures);
+        }
+
+        TEST_CASE("TextureCollectionTest.textureArrayGroupsSkipsUnpackableTextures", "[TextureCollectionTest]") {
+            // a single texture of its size, textures that rely on generated mipmaps, textures without data, and large
+            // textures are not packed
+            auto* single = makeTexture("single", 32, 32, 4);
+            auto* generated1 = makeTexture("generated1", 64, 64, 1);
+            auto* generated2 = makeTexture("generated2", 64, 64, 1);
+            auto* empty1 = new Texture("empty1", 64, 64);
+            auto* empty2 = new Texture("empty2", 64, 64);
+            auto* huge1 = makeTexture("huge1", 512, 512, 4);
+            auto* huge2 = makeTexture("huge2", 512, 512, 4);
+            auto textures = std::vector<Texture*>({ single, generated1, generated2, empty1, empty2, huge1, huge2 });
+
+            ASSERT_TRUE(TextureCollection::textureArrayGroups(textures, 256u).empty());
+
+            kdl::vec_clear_and_delete(textures);
+        }
+
+        TEST_CASE("TextureCollectionTest.textureArrayGroupsRespectsMaxLayers", "[TextureCollectionTest]") {
+            auto textures = std::vector<Texture*>();
+            for (size_t i = 0; i < 5u; ++i) {
+                textures.push_back(makeTexture("texture" + std::to_string(i), 64, 64, 4));
+            }
+
+            // the last texture would be alone in its texture array, so it is not packed
+            const auto groups = TextureCollection::textureArrayGroups(textures, 2u);
+            ASSERT_EQ(2u, groups.size());
+            ASSERT_EQ(std::vector<Texture*>({ textures[0], textures[1] }), groups[0]);
+            ASSERT_EQ(std::vector<Texture*>({ textures[2], textures[3] }), groups[1]);
+
+            ASSERT_TRUE(TextureCollection::textureArrayGroups(textures, 1u).empty());
+
+            kdl::vec_clear_and_delete(textures);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "IO/Reader.h"
+#include "IO/SpillFile.h"
+
+#include <vecmath/vec.h>
+
+#include <cstdint>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST_CASE("SpillFileTest.writeAndReadRecords", "[SpillFileTest]") {
+            SpillFile file;
+
+            SpillFile::RecordWriter writer1;
+            writer1.write<int32_t>(-7);
+            writer1.writeString("some text");
+            writer1.writeVec(vm::vec3f(1.0f, 2.0f, 3.0f));
+            const auto record1 = file.write(writer1);
+
+            SpillFile::RecordWriter writer2;
+            writer2.write<uint64_t>(12345u);
+            const auto record2 = file.write(writer2);
+
+            // records can be read in any order
+            auto reader2 = file.read(record2);
+            ASSERT_EQ(12345u, reader2.readSize<uint64_t>());
+            ASSERT_TRUE(reader2.eof());
+
+            auto reader1 = file.read(record1);
+            ASSERT_EQ(-7, reader1.readInt<int32_t>());
+            ASSERT_EQ(std::string("some text"), reader1.readString(reader1.readSize<uint64_t>()));
+            ASSERT_EQ(vm::vec3f(1.0f, 2.0f, 3.0f), reader1.readVec<float, 3>());
+            ASSERT_TRUE(reader1.eof());
+
+            file.release(record1);
+            file.release(record2);
+        }
+
+        TEST_CASE("SpillFileTest.reuseAfterRelease", "[SpillFileTest]") {
+            SpillFile file;
+
+            SpillFile::RecordWriter writer1;
+            writer1.writeString("first");
+            const auto record1 = file.write(writer1);
+            file.release(record1);
+
+            // once all records are released, the file is written from the beginning again
+            SpillFile::RecordWriter writer2;
+            writer2.writeString("second");
+            const auto record2 = file.write(writer2);
+            ASSERT_EQ(0u, record2.position);
+
+            auto reader2 = file.read(record2);
+            ASSERT_EQ(std::string("second"), reader2.readString(reader2.readSize<uint64_t>()));
+            file.release(record2);
+        }
+    }
+}
@@ -167,6 +167,58 @@ namespace TrenchBroom {
         }
 
 
+        TEST_CASE("EntityAttributeIndexTest.addAttributableNodes", "[EntityAttributeIndexTest]") {
+            AttributableNodeIndex index;
+
+            Entity* entity1 = new Entity();
+            entity1->addOrUpdateAttribute("target", "somevalue");
+            entity1->addOrUpdateAttribute("killtarget", "somevalue");
+
+            Entity* entity2 = new Entity();
+            entity2->addOrUpdateAttribute("target2", "somevalue");
+
+            index.addAttributableNodes({ entity1, entity2 });
+
+            // a node which matches several times is only found once
+            const auto found = findNumberedExact(index, "target", "somevalue");
+            ASSERT_EQ(2u, found.size());
+            ASSERT_COLLECTIONS_EQUIVALENT(std::vector<AttributableNode*>({ entity1, entity2 }), found);
+            ASSERT_COLLECTIONS_EQUIVALENT(std::vector<AttributableNode*>({ entity1 }), findExactExact(index, "killtarget", "somevalue"));
+
+            // the results are appended
+            std::vector<AttributableNode*> result({ entity2 });
+            index.findAttributableNodes(AttributableNodeIndexQuery::exact("target"), "somevalue", result);
+            ASSERT_EQ(std::vector<AttributableNode*>({ entity2, entity1 }), result);
+
+            index.clear();
+            ASSERT_TRUE(findNumberedExact(index, "target", "somevalue").empty());
+            ASSERT_TRUE(index.allNames().empty());
+
+            delete entity1;
+            delete entity2;
+        }
+
+        TEST_CASE("EntityAttributeIndexTest.findWithWildcardCharacters", "[EntityAttributeIndexTest]") {
+            AttributableNodeIndex index;
+
+            Entity* entity1 = new Entity();
+            entity1->addOrUpdateAttribute("target", "some*");
+
+            Entity* entity2 = new Entity();
+            entity2->addOrUpdateAttribute("target", "somevalue");
+
+            index.addAttributableNode(entity1);
+            index.addAttributableNode(entity2);
+
+            // names and values are never interpreted as patterns
+            ASSERT_EQ(std::vector<AttributableNode*>({ entity1 }), findExactExact(index, "target", "some*"));
+            ASSERT_TRUE(findExactExact(index, "target", "some?alue").empty());
+            ASSERT_TRUE(findExactExact(index, "t*", "somevalue").empty());
+
+            delete entity1;
+            delete entity2;
+        }
+
         TEST_CASE("EntityAttributeIndexTest.addRemoveFloatProperty", "[EntityAttributeIndexTest]") {
             AttributableNodeIndex index;
 
@@ -215,5 +267,26 @@ namespace TrenchBroom {
 
             ASSERT_COLLECTIONS_EQUIVALENT(std::vector<std::string>{ "somevalue", "somevalue2" }, index.allValuesForNames(AttributableNodeIndexQuery::exact("test")));
         }
+
+        TEST_CASE("EntityAttributeIndexTest.allValuesForNumberedAndPrefixNames", "[EntityAttributeIndexTest]") {
+            AttributableNodeIndex index;
+
+            Entity* entity1 = new Entity();
+            entity1->addOrUpdateAttribute("target", "value1");
+            entity1->addOrUpdateAttribute("target2", "value2");
+            entity1->addOrUpdateAttribute("targetname", "value3");
+
+            Entity* entity2 = new Entity();
+            entity2->addOrUpdateAttribute("target13", "value4");
+
+            index.addAttributableNode(entity1);
+            index.addAttributableNode(entity2);
+
+            ASSERT_COLLECTIONS_EQUIVALENT(std::vector<std::string>{ "value1", "value2", "value4" }, index.allValuesForNames(AttributableNodeIndexQuery::numbered("target")));
+            ASSERT_COLLECTIONS_EQUIVALENT(std::vector<std::string>{ "value1", "value2", "value3", "value4" }, index.allValuesForNames(AttributableNodeIndexQuery::prefix("target")));
+
+            delete entity1;
+            delete entity2;
+        }
     }
 }
@@ -131,6 +131,48 @@ namespace TrenchBroom {
             ASSERT_EQ(source, sources.front());
         }
 
+        TEST_CASE("AttributableNodeLinkTest.testBulkLoadLinks", "[AttributableNodeLinkTest]") {
+            World world(MapFormat::Standard);
+            world.disableAttributableIndexUpdates();
+
+            Entity* source = world.createEntity();
+            Entity* target1 = world.createEntity();
+            Entity* target2 = world.createEntity();
+            Entity* removed = world.createEntity();
+
+            source->addOrUpdateAttribute(AttributeNames::Target + "1", "target_name");
+            source->addOrUpdateAttribute(AttributeNames::Killtarget, "other_name");
+            target1->addOrUpdateAttribute(AttributeNames::Targetname, "target_name");
+            target2->addOrUpdateAttribute(AttributeNames::Targetname, "other_name");
+            removed->addOrUpdateAttribute(AttributeNames::Targetname, "target_name");
+
+            world.defaultLayer()->addChild(source);
+            world.defaultLayer()->addChild(target1);
+            world.defaultLayer()->addChild(target2);
+            world.defaultLayer()->addChild(removed);
+            world.defaultLayer()->removeChild(removed);
+            delete removed;
+
+            // no links are created while updates are disabled
+            ASSERT_TRUE(source->linkTargets().empty());
+            ASSERT_TRUE(source->killTargets().empty());
+
+            world.enableAttributableIndexUpdates();
+
+            ASSERT_EQ(std::vector<AttributableNode*>({ target1 }), source->linkTargets());
+            ASSERT_EQ(std::vector<AttributableNode*>({ source }), target1->linkSources());
+            ASSERT_EQ(std::vector<AttributableNode*>({ target2 }), source->killTargets());
+            ASSERT_EQ(std::vector<AttributableNode*>({ source }), target2->killSources());
+            ASSERT_TRUE(target1->killSources().empty());
+            ASSERT_TRUE(target2->linkSources().empty());
+
+            // links are maintained again
+            target2->addOrUpdateAttribute(AttributeNames::Targetname, "target_name");
+            ASSERT_TRUE(source->killTargets().empty());
+            ASSERT_EQ(2u, source->linkTargets().size());
+            ASSERT_TRUE(kdl::vec_contains(source->linkTargets(), target2));
+        }
+
         TEST_CASE("AttributableNodeLinkTest.testRemoveLinkByChangingSource", "[AttributableNodeLinkTest]") {
             World world(MapFormat::Standard);
             Entity* source = world.createEntity();
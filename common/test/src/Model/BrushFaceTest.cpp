@@ -46,6 +46,7 @@
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
 
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -74,6 +75,53 @@ namespace TrenchBroom {
             ASSERT_THROW(new BrushFace(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs)), GeometryException);
         }
 
+        TEST_CASE("BrushFaceTest.attributesCopyOnWrite", "[BrushFaceTest]") {
+            BrushFaceAttributes original("some_texture");
+            original.setXOffset(16.0f);
+            original.setSurfaceFlags(4);
+
+            BrushFaceAttributes copy(original);
+            ASSERT_EQ(original, copy);
+
+            copy.setXOffset(32.0f);
+            ASSERT_FLOAT_EQ(16.0f, original.xOffset());
+            ASSERT_FLOAT_EQ(32.0f, copy.xOffset());
+            ASSERT_EQ(4, copy.surfaceFlags());
+            ASSERT_FALSE(original == copy);
+
+            BrushFaceAttributes interned(original);
+            interned.intern();
+            ASSERT_EQ(original, interned);
+
+            // modifying an interned block must not affect other users of the block
+            BrushFaceAttributes other(original);
+            other.intern();
+            other.setYScale(2.0f);
+            ASSERT_FLOAT_EQ(1.0f, interned.yScale());
+            ASSERT_FLOAT_EQ(2.0f, other.yScale());
+
+            const BrushFaceAttributes renamed("other_texture", original);
+            ASSERT_EQ(std::string("other_texture"), renamed.textureName());
+            ASSERT_FLOAT_EQ(16.0f, renamed.xOffset());
+            ASSERT_EQ(&original.textureName(), &BrushFaceAttributes("some_texture").textureName());
+        }
+
+        TEST_CASE("BrushFaceTest.internNaNAttributes", "[BrushFaceTest]") {
+            BrushFaceAttributes first("some_texture");
+            first.setXOffset(std::numeric_limits<float>::quiet_NaN());
+            first.intern();
+
+            const auto count = BrushFaceAttributes::memoryStats().internedValueCount;
+
+            // NaN never compares equal to itself, but the pool must still find the block
+            for (size_t i = 0u; i < 8u; ++i) {
+                BrushFaceAttributes other("some_texture");
+                other.setXOffset(std::numeric_limits<float>::quiet_NaN());
+                other.intern();
+                ASSERT_EQ(count, BrushFaceAttributes::memoryStats().internedValueCount);
+            }
+        }
+
         TEST_CASE("BrushFaceTest.textureUsageCount", "[BrushFaceTest]") {
             const vm::vec3 p0(0.0,  0.0, 4.0);
             const vm::vec3 p1(1.0,  0.0, 4.0);
@@ -42,6 +42,7 @@
 #include <kdl/vector_utils.h>
 
 #include <vecmath/vec.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 #include <vecmath/ray.h>
@@ -3431,6 +3432,72 @@ namespace TrenchBroom {
             delete cube;
         }
 
+        TEST_CASE("BrushTest.snapshotRestoresFaces", "[BrushTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Brush* cube = builder.createCube(128.0, "some_texture");
+            BrushFace* firstFace = cube->faces().front();
+            firstFace->setXOffset(16.0f);
+            firstFace->select();
+
+            const auto originalBounds = cube->logicalBounds();
+            auto* snapshot = cube->takeSnapshot();
+
+            cube->transform(vm::translation_matrix(vm::vec3(32.0, 0.0, 0.0)), false, worldBounds);
+            for (BrushFace* face : cube->faces()) {
+                face->setXOffset(8.0f);
+            }
+            ASSERT_NE(originalBounds, cube->logicalBounds());
+
+            snapshot->restore(worldBounds);
+            ASSERT_EQ(originalBounds, cube->logicalBounds());
+
+            const BrushFace* restoredFace = cube->faces().front();
+            ASSERT_EQ(std::string("some_texture"), restoredFace->textureName());
+            ASSERT_FLOAT_EQ(16.0f, restoredFace->xOffset());
+            ASSERT_TRUE(restoredFace->selected());
+
+            delete snapshot;
+            delete cube;
+        }
+
+        TEST_CASE("BrushTest.snapshotRestoresTexCoordSystems", "[BrushTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Valve);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Brush* cube = builder.createCube(128.0, "some_texture");
+
+            std::vector<vm::vec3> originalXAxes;
+            for (const BrushFace* face : cube->faces()) {
+                originalXAxes.push_back(face->textureXAxis());
+            }
+
+            // the snapshot shares the texture coordinate systems with the faces, which must copy them when they
+            // are changed
+            auto* snapshot = cube->takeSnapshot();
+            cube->transform(vm::rotation_matrix(0.0, 0.0, vm::to_radians(45.0)), true, worldBounds);
+
+            std::vector<vm::vec3> transformedXAxes;
+            for (const BrushFace* face : cube->faces()) {
+                transformedXAxes.push_back(face->textureXAxis());
+            }
+            ASSERT_NE(originalXAxes, transformedXAxes);
+
+            snapshot->restore(worldBounds);
+
+            std::vector<vm::vec3> restoredXAxes;
+            for (const BrushFace* face : cube->faces()) {
+                restoredXAxes.push_back(face->textureXAxis());
+            }
+            ASSERT_EQ(originalXAxes, restoredXAxes);
+
+            delete snapshot;
+            delete cube;
+        }
+
         TEST_CASE("BrushTest.resizePastWorldBounds", "[BrushTest]") {
             const vm::bbox3 worldBounds(8192.0);
             World world(MapFormat::Standard);
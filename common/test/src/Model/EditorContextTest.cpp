@@ -23,6 +23,7 @@
 
 #include "Model/BrushBuilder.h"
 #include "Model/EditorContext.h"
+#include "Model/Tag.h"
 #include "Model/LockState.h"
 #include "Model/VisibilityState.h"
 #include "Model/World.h"
@@ -813,5 +814,76 @@ namespace TrenchBroom {
             context.popGroup();
             context.popGroup();
         }
+
+        TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.testInheritedStatesAfterReparenting") {
+            Group* group;
+            Entity* entity;
+            Brush* brush;
+            std::tie(group, entity, brush) = createGroupedBrushEntity();
+
+            auto* otherLayer = world->createLayer("other");
+            world->addChild(otherLayer);
+
+            world->defaultLayer()->setVisibilityState(VisibilityState::Visibility_Hidden);
+            world->defaultLayer()->setLockState(LockState::Lock_Locked);
+            ASSERT_FALSE(brush->visible());
+            ASSERT_FALSE(brush->editable());
+
+            // explicit states of intermediate nodes take precedence over the layer's state
+            entity->setVisibilityState(VisibilityState::Visibility_Shown);
+            ASSERT_TRUE(brush->visible());
+            entity->setVisibilityState(VisibilityState::Visibility_Inherited);
+            ASSERT_FALSE(brush->visible());
+
+            // moving a node updates the states and the containing group of all of its descendants
+            group->removeChild(entity);
+            ASSERT_TRUE(brush->visible());
+            ASSERT_TRUE(brush->editable());
+            ASSERT_EQ(nullptr, brush->group());
+
+            otherLayer->addChild(entity);
+            ASSERT_TRUE(brush->visible());
+            ASSERT_TRUE(brush->editable());
+
+            otherLayer->setVisibilityState(VisibilityState::Visibility_Hidden);
+            otherLayer->setLockState(LockState::Lock_Locked);
+            ASSERT_FALSE(brush->visible());
+            ASSERT_FALSE(brush->editable());
+
+            otherLayer->removeChild(entity);
+            group->addChild(entity);
+            ASSERT_EQ(group, entity->group());
+            ASSERT_EQ(group, brush->group());
+            ASSERT_FALSE(context.visible(brush));
+            ASSERT_FALSE(context.editable(brush));
+
+            world->defaultLayer()->setVisibilityState(VisibilityState::Visibility_Inherited);
+            world->defaultLayer()->setLockState(LockState::Lock_Inherited);
+            ASSERT_TRUE(context.visible(brush));
+            ASSERT_TRUE(context.editable(brush));
+        }
+
+        TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.testBrushWithHiddenFaceTagsVisible") {
+            auto* brush = createTopLevelBrush();
+
+            Tag tag("tag", {});
+            tag.setIndex(0);
+            context.setHiddenTags(tag.type());
+            ASSERT_TRUE(context.visible(brush));
+
+            for (auto* face : brush->faces()) {
+                face->addTag(tag);
+            }
+            ASSERT_FALSE(context.visible(brush));
+
+            brush->faces().front()->removeTag(tag);
+            ASSERT_TRUE(context.visible(brush));
+
+            brush->faces().front()->addTag(tag);
+            ASSERT_FALSE(context.visible(brush));
+
+            brush->clearTags();
+            ASSERT_TRUE(context.visible(brush));
+        }
     }
 }
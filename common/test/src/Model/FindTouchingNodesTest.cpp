@@ -0,0 +1,190 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CollectContainedNodesVisitor.h"
+#include "Model/CollectTouchingNodesVisitor.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/FindTouchingNodes.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class FindTouchingNodesTest {
+        protected:
+            const vm::bbox3 worldBounds;
+            World world;
+            EditorContext editorContext;
+        public:
+            FindTouchingNodesTest() :
+            worldBounds(8192.0),
+            world(MapFormat::Standard) {}
+
+            Brush* createBrush(const vm::bbox3& bounds) {
+                BrushBuilder builder(&world, worldBounds);
+                return builder.createCuboid(bounds, "texture");
+            }
+
+            Brush* addBrush(const vm::bbox3& bounds, Node* parent = nullptr) {
+                auto* brush = createBrush(bounds);
+                (parent != nullptr ? parent : world.defaultLayer())->addChild(brush);
+                return brush;
+            }
+
+            std::vector<Node*> collectTouchingNodes(const std::vector<Brush*>& brushes) {
+                CollectTouchingNodesVisitor<std::vector<Brush*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext);
+                world.acceptAndRecurse(visitor);
+                return visitor.nodes();
+            }
+
+            std::vector<Node*> collectContainedNodes(const std::vector<Brush*>& brushes) {
+                CollectContainedNodesVisitor<std::vector<Brush*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext);
+                world.acceptAndRecurse(visitor);
+                return visitor.nodes();
+            }
+        };
+
+        TEST_CASE_METHOD(FindTouchingNodesTest, "FindTouchingNodesTest.findTouchingNodes") {
+            auto* brush1 = addBrush(vm::bbox3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(64.0, 64.0, 64.0)));
+            auto* brush2 = addBrush(vm::bbox3(vm::vec3(32.0, 0.0, 0.0), vm::vec3(96.0, 64.0, 64.0)));
+            auto* brush3 = addBrush(vm::bbox3(vm::vec3(128.0, 0.0, 0.0), vm::vec3(192.0, 64.0, 64.0)));
+
+            ASSERT_EQ(std::vector<Node*>{}, findTouchingNodes(world, std::vector<Brush*>{}, editorContext));
+            ASSERT_EQ(std::vector<Node*>{ brush2 }, findTouchingNodes(world, std::vector<Brush*>{ brush1 }, editorContext));
+            CHECK_THAT(findTouchingNodes(world, std::vector<Brush*>{ brush2 }, editorContext), Catch::UnorderedEquals(std::vector<Node*>{ brush1 }));
+            ASSERT_EQ(std::vector<Node*>{}, findTouchingNodes(world, std::vector<Brush*>{ brush3 }, editorContext));
+
+            // the query brushes are never returned
+            ASSERT_EQ(std::vector<Node*>{}, findTouchingNodes(world, std::vector<Brush*>{ brush1, brush2 }, editorContext));
+
+            // the query brushes need not be part of the world
+            auto* query = createBrush(vm::bbox3(vm::vec3(80.0, 16.0, 16.0), vm::vec3(144.0, 48.0, 48.0)));
+            CHECK_THAT(findTouchingNodes(world, std::vector<Brush*>{ query }, editorContext), Catch::UnorderedEquals(std::vector<Node*>{ brush2, brush3 }));
+            delete query;
+        }
+
+        TEST_CASE_METHOD(FindTouchingNodesTest, "FindTouchingNodesTest.findTouchingGroups") {
+            auto* group = new Group("group");
+            world.defaultLayer()->addChild(group);
+
+            auto* groupedBrush1 = addBrush(vm::bbox3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(64.0, 64.0, 64.0)), group);
+            auto* groupedBrush2 = addBrush(vm::bbox3(vm::vec3(192.0, 0.0, 0.0), vm::vec3(256.0, 64.0, 64.0)), group);
+
+            // touches the bounds of the group, but none of its brushes
+            auto* brush = addBrush(vm::bbox3(vm::vec3(96.0, 0.0, 0.0), vm::vec3(160.0, 64.0, 64.0)));
+            ASSERT_EQ(std::vector<Node*>{ group }, findTouchingNodes(world, std::vector<Brush*>{ brush }, editorContext));
+
+            // the brushes of an open group are selectable, but the group itself is not
+            group->open();
+            ASSERT_EQ(std::vector<Node*>{}, findTouchingNodes(world, std::vector<Brush*>{ brush }, editorContext));
+            ASSERT_EQ(std::vector<Node*>{}, findTouchingNodes(world, std::vector<Brush*>{ groupedBrush1 }, editorContext));
+
+            auto* query = createBrush(vm::bbox3(vm::vec3(32.0, 0.0, 0.0), vm::vec3(224.0, 64.0, 64.0)));
+            CHECK_THAT(findTouchingNodes(world, std::vector<Brush*>{ query }, editorContext), Catch::UnorderedEquals(std::vector<Node*>{ groupedBrush1, groupedBrush2, brush }));
+            delete query;
+        }
+
+        TEST_CASE_METHOD(FindTouchingNodesTest, "FindTouchingNodesTest.findContainedNodes") {
+            auto* brush1 = addBrush(vm::bbox3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(64.0, 64.0, 64.0)));
+            auto* brush2 = addBrush(vm::bbox3(vm::vec3(16.0, 16.0, 16.0), vm::vec3(48.0, 48.0, 48.0)));
+            auto* brush3 = addBrush(vm::bbox3(vm::vec3(32.0, 32.0, 32.0), vm::vec3(96.0, 96.0, 96.0)));
+
+            auto* group = new Group("group");
+            world.defaultLayer()->addChild(group);
+            addBrush(vm::bbox3(vm::vec3(8.0, 8.0, 8.0), vm::vec3(24.0, 24.0, 24.0)), group);
+
+            CHECK_THAT(findContainedNodes(world, std::vector<Brush*>{ brush1 }, editorContext), Catch::UnorderedEquals(std::vector<Node*>{ group, brush2 }));
+            ASSERT_EQ(std::vector<Node*>{}, findContainedNodes(world, std::vector<Brush*>{ brush3 }, editorContext));
+
+            // a query brush can contain another query brush, but not itself
+            CHECK_THAT(findContainedNodes(world, std::vector<Brush*>{ brush1, brush2 }, editorContext), Catch::UnorderedEquals(std::vector<Node*>{ group, brush2 }));
+        }
+
+        TEST_CASE_METHOD(FindTouchingNodesTest, "FindTouchingNodesTest.matchesVisitors") {
+            auto* entity = new Entity();
+            entity->addOrUpdateAttribute("origin", "100 100 8");
+            world.defaultLayer()->addChild(entity);
+
+            auto* outerGroup = new Group("outer");
+            world.defaultLayer()->addChild(outerGroup);
+            auto* innerGroup = new Group("inner");
+            outerGroup->addChild(innerGroup);
+
+            auto* brushEntity = new Entity();
+            world.defaultLayer()->addChild(brushEntity);
+
+            std::vector<Brush*> brushes;
+            for (size_t x = 0; x < 12; ++x) {
+                for (size_t y = 0; y < 12; ++y) {
+                    const auto min = vm::vec3(static_cast<FloatType>(x) * 48.0, static_cast<FloatType>(y) * 40.0, static_cast<FloatType>((x + y) % 3) * 16.0);
+                    const auto bounds = vm::bbox3(min, min + vm::vec3(32.0 + static_cast<FloatType>(y % 4) * 8.0, 32.0, 32.0 + static_cast<FloatType>(x % 5) * 8.0));
+
+                    Node* parent = world.defaultLayer();
+                    switch ((x * 12 + y) % 7) {
+                        case 1: parent = outerGroup; break;
+                        case 2: parent = innerGroup; break;
+                        case 3: parent = brushEntity; break;
+                        default: break;
+                    }
+                    brushes.push_back(addBrush(bounds, parent));
+                }
+            }
+
+            // rebuilding changes the shape of the node tree, but not the result
+            world.rebuildNodeTree();
+
+            const auto queries = std::vector<std::vector<Brush*>>{
+                { brushes[0] },
+                { brushes[13], brushes[14], brushes[70] },
+                { brushes[4], brushes[50], brushes[51], brushes[52], brushes[100], brushes[143] },
+            };
+
+            for (const auto& query : queries) {
+                CHECK_THAT(findTouchingNodes(world, query, editorContext), Catch::UnorderedEquals(collectTouchingNodes(query)));
+                CHECK_THAT(findContainedNodes(world, query, editorContext), Catch::UnorderedEquals(collectContainedNodes(query)));
+            }
+
+            auto* bigQuery = createBrush(vm::bbox3(vm::vec3(64.0, 64.0, -16.0), vm::vec3(320.0, 320.0, 80.0)));
+            CHECK_THAT(findTouchingNodes(world, std::vector<Brush*>{ bigQuery }, editorContext), Catch::UnorderedEquals(collectTouchingNodes({ bigQuery })));
+            CHECK_THAT(findContainedNodes(world, std::vector<Brush*>{ bigQuery }, editorContext), Catch::UnorderedEquals(collectContainedNodes({ bigQuery })));
+
+            outerGroup->open();
+            for (const auto& query : queries) {
+                CHECK_THAT(findTouchingNodes(world, query, editorContext), Catch::UnorderedEquals(collectTouchingNodes(query)));
+                CHECK_THAT(findContainedNodes(world, query, editorContext), Catch::UnorderedEquals(collectContainedNodes(query)));
+            }
+            delete bigQuery;
+        }
+    }
+}
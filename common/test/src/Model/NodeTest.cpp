@@ -28,9 +28,14 @@
 #include "Model/BrushFaceAttributes.h"
 #include "Model/CollectTouchingNodesVisitor.h"
 #include "Model/EditorContext.h"
+#include "Model/EmptyAttributeValueIssueGenerator.h"
+#include "Model/Entity.h"
 #include "Model/Group.h"
+#include "Model/Issue.h"
 #include "Model/Layer.h"
+#include "Model/LinkTargetIssueGenerator.h"
 #include "Model/MapFormat.h"
+#include "Model/MissingClassnameIssueGenerator.h"
 #include "Model/Node.h"
 #include "Model/NodeVisitor.h"
 #include "Model/Object.h"
@@ -43,6 +48,7 @@
 #include <vecmath/ray.h>
 #include <vecmath/mat_ext.h>
 
+#include <memory>
 #include <vector>
 #include <variant>
 
@@ -476,6 +482,122 @@ namespace TrenchBroom {
             ASSERT_TRUE(grandChild1_1->isDescendantOf(std::vector<Node*>{ &root, child1, child2, grandChild1_1, grandChild1_2 }));
         }
 
+        TEST_CASE("NodeTest.validateIssues", "[NodeTest]") {
+            World world(Model::MapFormat::Standard);
+
+            auto missingClassname = std::make_unique<MissingClassnameIssueGenerator>();
+            auto emptyAttributeValue = std::make_unique<EmptyAttributeValueIssueGenerator>();
+            const std::vector<IssueGenerator*> issueGenerators{ missingClassname.get(), emptyAttributeValue.get() };
+
+            std::vector<Node*> nodes;
+            for (size_t i = 0; i < 1000; ++i) {
+                auto* entity = new Entity();
+                if (i % 2 == 0) {
+                    entity->addOrUpdateAttribute("classname", "info_null");
+                }
+                if (i % 3 == 0) {
+                    entity->addOrUpdateAttribute("target", "");
+                }
+                world.defaultLayer()->addChild(entity);
+                nodes.push_back(entity);
+            }
+
+            Node::validateIssues(nodes, issueGenerators);
+
+            size_t lastSeqId = 0;
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                Node* node = nodes[i];
+                ASSERT_TRUE(node->issuesValid());
+
+                const auto& issues = node->issues(issueGenerators);
+                const size_t expectedCount = (i % 2 == 0 ? 0u : 1u) + (i % 3 == 0 ? 1u : 0u);
+                ASSERT_EQ(expectedCount, issues.size());
+
+                // the issues are numbered in the order of the nodes and generators
+                for (const auto* issue : issues) {
+                    ASSERT_LT(lastSeqId, issue->seqId());
+                    lastSeqId = issue->seqId();
+                }
+            }
+
+            // validating again does not generate any new issues
+            Node::validateIssues(nodes, issueGenerators);
+            ASSERT_EQ(lastSeqId, nodes.back()->issues(issueGenerators).back()->seqId());
+        }
+
+        TEST_CASE("NodeTest.trackInvalidatedIssues", "[NodeTest]") {
+            World world(Model::MapFormat::Standard);
+
+            auto linkTarget = std::make_unique<LinkTargetIssueGenerator>();
+            auto missingClassname = std::make_unique<MissingClassnameIssueGenerator>();
+            const std::vector<IssueGenerator*> issueGenerators{ linkTarget.get(), missingClassname.get() };
+
+            auto* source = new Entity();
+            source->addOrUpdateAttribute("classname", "trigger_once");
+            source->addOrUpdateAttribute("target", "door");
+
+            auto* target = new Entity();
+            target->addOrUpdateAttribute("classname", "func_door");
+
+            auto* other = new Entity();
+
+            Layer* layer = world.defaultLayer();
+            layer->addChild(source);
+            layer->addChild(target);
+            layer->addChild(other);
+
+            const std::vector<Node*> allNodes{ &world, layer, source, target, other };
+            Node::validateIssues(allNodes, issueGenerators);
+            world.takeNodesWithInvalidatedIssues();
+
+            ASSERT_EQ(1u, source->issues(issueGenerators).size());
+            ASSERT_EQ(1u, other->issues(issueGenerators).size());
+
+            const auto invalidationCount = world.issueInvalidationCount();
+
+            // only the linked nodes are affected, but not their parents
+            target->addOrUpdateAttribute("targetname", "door");
+            CHECK_THAT(world.takeNodesWithInvalidatedIssues(), Catch::UnorderedEquals(std::vector<Node*>{ source, target }));
+            ASSERT_EQ(invalidationCount + 2u, world.issueInvalidationCount());
+
+            Node::validateIssues({ source, target }, issueGenerators);
+            ASSERT_TRUE(source->issues(issueGenerators).empty());
+
+            // a node that was invalidated more than once is only returned once
+            other->addOrUpdateAttribute("classname", "info_null");
+            other->issues(issueGenerators);
+            other->addOrUpdateAttribute("classname", "info_notnull");
+            ASSERT_EQ(std::vector<Node*>{ other }, world.takeNodesWithInvalidatedIssues());
+
+            // nodes that are not validated are not tracked
+            other->addOrUpdateAttribute("targetname", "other");
+            ASSERT_TRUE(world.takeNodesWithInvalidatedIssues().empty());
+
+            // removed nodes are forgotten, but their parent is invalidated
+            other->issues(issueGenerators);
+            layer->removeChild(other);
+            ASSERT_EQ(std::vector<Node*>{ layer }, world.takeNodesWithInvalidatedIssues());
+            delete other;
+
+            // adding a node only affects its parent, but not its other ancestors
+            const vm::bbox3 worldBounds(8192.0);
+            BrushBuilder builder(&world, worldBounds);
+            auto* brush = builder.createCube(64.0, "none");
+            source->addChild(brush);
+
+            Node::validateIssues({ layer, source, brush }, issueGenerators);
+            world.takeNodesWithInvalidatedIssues();
+
+            auto* child = new Entity();
+            layer->addChild(child);
+            ASSERT_EQ(std::vector<Node*>{ layer }, world.takeNodesWithInvalidatedIssues());
+
+            // moving a brush affects its entity because the entity's bounds change
+            Node::validateIssues({ layer }, issueGenerators);
+            brush->transform(vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0)), false, worldBounds);
+            CHECK_THAT(world.takeNodesWithInvalidatedIssues(), Catch::UnorderedEquals(std::vector<Node*>{ brush, source }));
+        }
+
         // Visitors
 
         TEST_CASE("CollectTouchingNodesVisitor", "[NodeVisitorTest]") {
@@ -512,6 +512,42 @@ TEST_CASE("PolyhedronTest.testWeaveSimpleCap", "[PolyhedronTest]") {
             ASSERT_TRUE(hasQuadOf(p, p2, p6, p8, p4));
         }
 
+        TEST_CASE("PolyhedronTest.convexHullOfCubeWithInteriorPoints", "[PolyhedronTest]") {
+            const std::vector<vm::vec3d> corners {
+                vm::vec3d(-8.0, -8.0, -8.0),
+                vm::vec3d(-8.0, -8.0, +8.0),
+                vm::vec3d(-8.0, +8.0, -8.0),
+                vm::vec3d(-8.0, +8.0, +8.0),
+                vm::vec3d(+8.0, -8.0, -8.0),
+                vm::vec3d(+8.0, -8.0, +8.0),
+                vm::vec3d(+8.0, +8.0, -8.0),
+                vm::vec3d(+8.0, +8.0, +8.0),
+            };
+
+            // points on a regular grid covering the cube, including its corners
+            std::vector<vm::vec3d> points;
+            for (int x = -8; x <= 8; x += 4) {
+                for (int y = -8; y <= 8; y += 4) {
+                    for (int z = -8; z <= 8; z += 4) {
+                        points.emplace_back(double(x), double(y), double(z));
+                    }
+                }
+            }
+
+            Polyhedron3d p;
+            p.addPoints(std::begin(points), std::end(points));
+
+            ASSERT_TRUE(p.closed());
+            ASSERT_EQ(8u, p.vertexCount());
+            ASSERT_EQ(6u, p.faceCount());
+            ASSERT_TRUE(hasVertices(p, corners));
+
+            Polyhedron3d q(corners);
+            q.addPoints(std::begin(points), std::end(points));
+            ASSERT_EQ(8u, q.vertexCount());
+            ASSERT_TRUE(hasVertices(q, corners));
+        }
+
         TEST_CASE("PolyhedronTest.initEmpty", "[PolyhedronTest]") {
             Polyhedron3d p;
             ASSERT_TRUE(p.empty());
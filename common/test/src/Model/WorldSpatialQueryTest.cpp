@@ -0,0 +1,215 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Exceptions.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Entity.h"
+#include "Model/EditorContext.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/LockState.h"
+#include "Model/MapFormat.h"
+#include "Model/NodeFilter.h"
+#include "Model/VisibilityState.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class WorldSpatialQueryTest {
+        protected:
+            const vm::bbox3 worldBounds;
+            World world;
+            EditorContext editorContext;
+            Brush* brush1;
+            Brush* brush2;
+            Brush* brush3;
+        public:
+            WorldSpatialQueryTest() :
+            worldBounds(8192.0),
+            world(MapFormat::Standard) {
+                brush1 = addBrush(vm::bbox3(vm::vec3(0.0, 0.0, 0.0), vm::vec3(64.0, 64.0, 64.0)));
+                brush2 = addBrush(vm::bbox3(vm::vec3(128.0, 0.0, 0.0), vm::vec3(192.0, 64.0, 64.0)));
+                brush3 = addBrush(vm::bbox3(vm::vec3(32.0, 32.0, 32.0), vm::vec3(160.0, 48.0, 48.0)));
+            }
+
+            Brush* addBrush(const vm::bbox3& bounds) {
+                BrushBuilder builder(&world, worldBounds);
+                auto* brush = builder.createCuboid(bounds, "texture");
+                world.defaultLayer()->addChild(brush);
+                return brush;
+            }
+        };
+
+        TEST_CASE_METHOD(WorldSpatialQueryTest, "WorldSpatialQueryTest.findNodesIntersecting") {
+            CHECK_THAT(world.findNodesIntersecting(vm::bbox3(vm::vec3(56.0, 8.0, 8.0), vm::vec3(72.0, 16.0, 16.0))), Catch::UnorderedEquals(std::vector<Node*>{ brush1 }));
+            CHECK_THAT(world.findNodesIntersecting(vm::bbox3(vm::vec3(56.0, 40.0, 40.0), vm::vec3(136.0, 44.0, 44.0))), Catch::UnorderedEquals(std::vector<Node*>{ brush1, brush2, brush3 }));
+            ASSERT_EQ(std::vector<Node*>{}, world.findNodesIntersecting(vm::bbox3(vm::vec3(-64.0, -64.0, -64.0), vm::vec3(-32.0, -32.0, -32.0))));
+        }
+
+        TEST_CASE_METHOD(WorldSpatialQueryTest, "WorldSpatialQueryTest.findNodesInside") {
+            CHECK_THAT(world.findNodesInside(vm::bbox3(vm::vec3(-1.0, -1.0, -1.0), vm::vec3(170.0, 65.0, 65.0))), Catch::UnorderedEquals(std::vector<Node*>{ brush1, brush3 }));
+            CHECK_THAT(world.findNodesInside(vm::bbox3(vm::vec3(-1.0, -1.0, -1.0), vm::vec3(200.0, 65.0, 65.0))), Catch::UnorderedEquals(std::vector<Node*>{ brush1, brush2, brush3 }));
+            ASSERT_EQ(std::vector<Node*>{}, world.findNodesInside(vm::bbox3(vm::vec3(8.0, 8.0, 8.0), vm::vec3(16.0, 16.0, 16.0))));
+        }
+
+        TEST_CASE_METHOD(WorldSpatialQueryTest, "WorldSpatialQueryTest.findNodesAt") {
+            CHECK_THAT(world.findNodesAt(vm::vec3(40.0, 40.0, 40.0)), Catch::UnorderedEquals(std::vector<Node*>{ brush1, brush3 }));
+            ASSERT_EQ(std::vector<Node*>{ brush2 }, world.findNodesAt(vm::vec3(170.0, 8.0, 8.0)));
+            ASSERT_EQ(std::vector<Node*>{}, world.findNodesAt(vm::vec3(100.0, 8.0, 8.0)));
+        }
+
+        TEST_CASE_METHOD(WorldSpatialQueryTest, "WorldSpatialQueryTest.findNodesInFrustum") {
+            // a box from x = 100 to x = 140 with outward normals
+            const auto planes = std::vector<vm::plane3>{
+                vm::plane3(vm::vec3(100.0, 0.0, 0.0), vm::vec3::neg_x()),
+                vm::plane3(vm::vec3(140.0, 0.0, 0.0), vm::vec3::pos_x())
+            };
+            CHECK_THAT(world.findNodesInFrustum(planes), Catch::UnorderedEquals(std::vector<Node*>{ brush2, brush3 }));
+            ASSERT_EQ(std::vector<Node*>{}, world.findNodesInFrustum({ vm::plane3(vm::vec3(256.0, 0.0, 0.0), vm::vec3::neg_x()) }));
+        }
+
+        TEST_CASE_METHOD(WorldSpatialQueryTest, "WorldSpatialQueryTest.findNearestNodes") {
+            ASSERT_EQ(std::vector<Node*>({ brush2, brush3 }), world.findNearestNodes(vm::vec3(256.0, 40.0, 40.0), 2u));
+            ASSERT_EQ(std::vector<Node*>({ brush1 }), world.findNearestNodes(vm::vec3(-64.0, 0.0, 0.0), 1u));
+            ASSERT_EQ(3u, world.findNearestNodes(vm::vec3(-64.0, 0.0, 0.0), 10u).size());
+            ASSERT_EQ(std::vector<Node*>{}, world.findNearestNodes(vm::vec3(-64.0, 0.0, 0.0), 0u));
+        }
+
+        TEST_CASE_METHOD(WorldSpatialQueryTest, "WorldSpatialQueryTest.deferNodeTreeInsertions") {
+            const auto bounds = vm::bbox3(vm::vec3(-256.0, -256.0, -256.0), vm::vec3(256.0, 256.0, 256.0));
+
+            auto* entity = world.createEntity();
+
+            BrushBuilder builder(&world, worldBounds);
+            auto* brush4 = builder.createCuboid(vm::bbox3(vm::vec3(0.0, 128.0, 0.0), vm::vec3(64.0, 192.0, 64.0)), "texture");
+            auto* brush5 = builder.createCuboid(vm::bbox3(vm::vec3(0.0, -192.0, 0.0), vm::vec3(64.0, -128.0, 64.0)), "texture");
+            auto* brush6 = builder.createCuboid(vm::bbox3(vm::vec3(128.0, 128.0, 0.0), vm::vec3(192.0, 192.0, 64.0)), "texture");
+
+            {
+                World::DeferNodeTreeInsertions deferInsertions(world);
+
+                world.defaultLayer()->addChild(entity);
+                world.defaultLayer()->addChild(brush4);
+                world.defaultLayer()->addChild(brush5);
+
+                // the bounds of the entity change while its insertion is deferred
+                entity->addChild(brush6);
+
+                // existing nodes can still be moved
+                brush1->transform(vm::translation_matrix(vm::vec3(0.0, 0.0, 128.0)), false, worldBounds);
+
+                CHECK_THAT(world.findNodesIntersecting(bounds), Catch::UnorderedEquals(std::vector<Node*>{ brush1, brush2, brush3 }));
+
+                deferInsertions.commit();
+            }
+
+            CHECK_THAT(world.findNodesIntersecting(bounds), Catch::UnorderedEquals(std::vector<Node*>{ brush1, brush2, brush3, brush4, brush5, entity, brush6 }));
+            CHECK_THAT(world.findNodesAt(vm::vec3(160.0, 160.0, 32.0)), Catch::UnorderedEquals(std::vector<Node*>{ entity, brush6 }));
+            ASSERT_EQ(std::vector<Node*>{ brush1 }, world.findNodesAt(vm::vec3(32.0, 32.0, 160.0)));
+
+            // nodes are inserted immediately again
+            auto* brush7 = addBrush(vm::bbox3(vm::vec3(-192.0, 0.0, 0.0), vm::vec3(-128.0, 64.0, 64.0)));
+            ASSERT_EQ(std::vector<Node*>{ brush7 }, world.findNodesAt(vm::vec3(-160.0, 32.0, 32.0)));
+        }
+
+        TEST_CASE_METHOD(WorldSpatialQueryTest, "WorldSpatialQueryTest.abandonDeferredNodeTreeInsertions") {
+            BrushBuilder builder(&world, worldBounds);
+            auto* brush4 = builder.createCuboid(vm::bbox3(vm::vec3(0.0, 128.0, 0.0), vm::vec3(64.0, 192.0, 64.0)), "texture");
+
+            try {
+                World::DeferNodeTreeInsertions deferInsertions(world);
+                world.defaultLayer()->addChild(brush4);
+                throw Exception("adding nodes failed");
+            } catch (const Exception&) {}
+
+            // the node tree is rebuilt when the deferral is abandoned, and nodes are inserted immediately again
+            ASSERT_EQ(std::vector<Node*>{ brush4 }, world.findNodesAt(vm::vec3(32.0, 160.0, 32.0)));
+
+            auto* brush5 = addBrush(vm::bbox3(vm::vec3(-192.0, 0.0, 0.0), vm::vec3(-128.0, 64.0, 64.0)));
+            ASSERT_EQ(std::vector<Node*>{ brush5 }, world.findNodesAt(vm::vec3(-160.0, 32.0, 32.0)));
+        }
+
+        TEST_CASE_METHOD(WorldSpatialQueryTest, "WorldSpatialQueryTest.transformNestedGroups") {
+            auto* outerGroup = world.createGroup("outer");
+            auto* innerGroup = world.createGroup("inner");
+            auto* entity = world.createEntity();
+            world.defaultLayer()->addChild(outerGroup);
+            outerGroup->addChild(innerGroup);
+            outerGroup->addChild(entity);
+
+            BrushBuilder builder(&world, worldBounds);
+            std::vector<Node*> brushes;
+            for (size_t i = 0u; i < 8u; ++i) {
+                const auto x = 64.0 * static_cast<FloatType>(i);
+                auto* brush = builder.createCuboid(vm::bbox3(vm::vec3(x, 256.0, 0.0), vm::vec3(x + 32.0, 288.0, 32.0)), "texture");
+                if (i % 2u == 0u) {
+                    innerGroup->addChild(brush);
+                } else {
+                    entity->addChild(brush);
+                }
+                brushes.push_back(brush);
+            }
+
+            ASSERT_EQ(vm::bbox3(vm::vec3(0.0, 256.0, 0.0), vm::vec3(480.0, 288.0, 32.0)), outerGroup->physicalBounds());
+            ASSERT_EQ(std::vector<Node*>{ brushes[0] }, world.findNodesAt(vm::vec3(16.0, 272.0, 16.0)));
+
+            // no bounds are computed while the brushes are transformed
+            const auto count = Node::boundsComputationCount();
+            outerGroup->transform(vm::translation_matrix(vm::vec3(0.0, 0.0, 512.0)), false, worldBounds);
+            ASSERT_EQ(count, Node::boundsComputationCount());
+
+            // the bounds of both groups and of the entity are computed once when they are requested
+            ASSERT_EQ(vm::bbox3(vm::vec3(0.0, 256.0, 512.0), vm::vec3(480.0, 288.0, 544.0)), outerGroup->physicalBounds());
+            ASSERT_EQ(count + 3u, Node::boundsComputationCount());
+
+            ASSERT_EQ(std::vector<Node*>{ brushes[0] }, world.findNodesAt(vm::vec3(16.0, 272.0, 528.0)));
+            CHECK_THAT(world.findNodesAt(vm::vec3(80.0, 272.0, 528.0)), Catch::UnorderedEquals(std::vector<Node*>{ entity, brushes[1] }));
+            ASSERT_EQ(std::vector<Node*>{}, world.findNodesAt(vm::vec3(16.0, 272.0, 16.0)));
+        }
+
+        TEST_CASE_METHOD(WorldSpatialQueryTest, "WorldSpatialQueryTest.filters") {
+            const auto bounds = vm::bbox3(vm::vec3(-256.0, -256.0, -256.0), vm::vec3(256.0, 256.0, 256.0));
+
+            brush1->setVisibilityState(VisibilityState::Visibility_Hidden);
+            brush2->setLockState(LockState::Lock_Locked);
+
+            CHECK_THAT(world.findNodesIntersecting(bounds), Catch::UnorderedEquals(std::vector<Node*>{ brush1, brush2, brush3 }));
+            CHECK_THAT(world.findNodesIntersecting(bounds, NodeFilter(editorContext, NodeFilter::Visible)), Catch::UnorderedEquals(std::vector<Node*>{ brush2, brush3 }));
+            CHECK_THAT(world.findNodesIntersecting(bounds, NodeFilter(editorContext, NodeFilter::Editable)), Catch::UnorderedEquals(std::vector<Node*>{ brush1, brush3 }));
+            ASSERT_EQ(std::vector<Node*>{ brush3 }, world.findNodesIntersecting(bounds, NodeFilter(editorContext, NodeFilter::Visible | NodeFilter::Editable)));
+            ASSERT_EQ(std::vector<Node*>{ brush3 }, world.findNodesInside(bounds, NodeFilter(editorContext, NodeFilter::Selectable)));
+
+            // filtered nodes do not count towards the number of nearest nodes
+            ASSERT_EQ(std::vector<Node*>{ brush3 }, world.findNearestNodes(vm::vec3(-64.0, 0.0, 0.0), 1u, NodeFilter(editorContext, NodeFilter::Visible | NodeFilter::Editable)));
+        }
+    }
+}
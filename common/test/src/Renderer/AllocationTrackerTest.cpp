@@ -246,6 +246,94 @@ namespace TrenchBroom {
             }
         }
 
+        TEST_CASE("AllocationTrackerTest.freeSizeAndUsedEnd", "[AllocationTrackerTest]") {
+            AllocationTracker t(500);
+            EXPECT_EQ(500u, t.freeSize());
+            EXPECT_EQ(0u, t.usedEnd());
+            EXPECT_EQ(nullptr, t.lastUsedBlock());
+
+            AllocationTracker::Block* blocks[4];
+            for (size_t i = 0; i < 4; ++i) {
+                blocks[i] = t.allocate(100);
+            }
+            EXPECT_EQ(100u, t.freeSize());
+            EXPECT_EQ(400u, t.usedEnd());
+            EXPECT_EQ(blocks[3], t.lastUsedBlock());
+
+            t.free(blocks[1]);
+            EXPECT_EQ(200u, t.freeSize());
+            EXPECT_EQ(blocks[3], t.lastUsedBlock());
+
+            // merges with the free space at the end
+            t.free(blocks[3]);
+            EXPECT_EQ(300u, t.freeSize());
+            EXPECT_EQ(200u, t.largestPossibleAllocation());
+            EXPECT_EQ(300u, t.usedEnd());
+            EXPECT_EQ(blocks[2], t.lastUsedBlock());
+
+            t.expand(600);
+            EXPECT_EQ(400u, t.freeSize());
+            EXPECT_EQ(300u, t.usedEnd());
+        }
+
+        TEST_CASE("AllocationTrackerTest.usedRanges", "[AllocationTrackerTest]") {
+            AllocationTracker t(500);
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{}), t.usedRanges());
+
+            AllocationTracker::Block* blocks[5];
+            for (size_t i = 0; i < 5; ++i) {
+                blocks[i] = t.allocate(100);
+            }
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{{0, 500}}), t.usedRanges());
+
+            t.free(blocks[1]);
+            t.free(blocks[4]);
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{{0, 100}, {200, 200}}), t.usedRanges());
+        }
+
+        TEST_CASE("AllocationTrackerTest.shrink", "[AllocationTrackerTest]") {
+            AllocationTracker t(500);
+
+            AllocationTracker::Block* blocks[3];
+            for (size_t i = 0; i < 3; ++i) {
+                blocks[i] = t.allocate(100);
+            }
+            t.free(blocks[1]);
+
+            // can't shrink into used blocks or grow
+            EXPECT_ANY_THROW(t.shrink(250));
+            EXPECT_ANY_THROW(t.shrink(500));
+            EXPECT_EQ(500u, t.capacity());
+
+            t.shrink(400);
+            EXPECT_EQ(400u, t.capacity());
+            EXPECT_EQ(200u, t.freeSize());
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{{100, 100}, {300, 100}}), t.freeBlocks());
+
+            // removes the trailing free block entirely
+            t.shrink(300);
+            EXPECT_EQ(300u, t.capacity());
+            EXPECT_EQ(100u, t.freeSize());
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{{100, 100}}), t.freeBlocks());
+            EXPECT_EQ(nullptr, t.allocate(101));
+
+            // the tracker can grow again after shrinking
+            t.expand(450);
+            AllocationTracker::Block* block = t.allocate(100);
+            ASSERT_NE(nullptr, block);
+            EXPECT_EQ(100u, block->pos);
+
+            t.free(blocks[0]);
+            t.free(blocks[2]);
+            t.free(block);
+            EXPECT_FALSE(t.hasAllocations());
+
+            t.shrink(0);
+            EXPECT_EQ(0u, t.capacity());
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{}), t.freeBlocks());
+            EXPECT_EQ(nullptr, t.allocate(1));
+        }
+
         static constexpr size_t NumBrushes = 64'000;
 
         // between 12 and 140, inclusive.
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Renderer/BrushRendererArrays.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static void assertRange(const DirtyRangeTracker::Range& range, const size_t pos, const size_t size) {
+            ASSERT_EQ(pos, range.pos);
+            ASSERT_EQ(size, range.size);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.constructor", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100);
+            ASSERT_EQ(100u, t.capacity());
+            ASSERT_TRUE(t.clean());
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.expand", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100);
+            t.expand(200);
+            ASSERT_EQ(200u, t.capacity());
+            ASSERT_EQ(1u, t.dirtyRanges().size());
+            assertRange(t.dirtyRanges()[0], 100, 100);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.markDirtyKeepsDistantRangesApart", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(1000);
+            t.markDirty(500, 10);
+            t.markDirty(100, 10);
+            ASSERT_EQ(2u, t.dirtyRanges().size());
+            assertRange(t.dirtyRanges()[0], 100, 10);
+            assertRange(t.dirtyRanges()[1], 500, 10);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.markDirtyMergesTouchingRanges", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(1000);
+            t.markDirty(100, 10);
+            t.markDirty(500, 10);
+            t.markDirty(110, 5);
+            ASSERT_EQ(2u, t.dirtyRanges().size());
+            assertRange(t.dirtyRanges()[0], 100, 15);
+
+            t.markDirty(90, 430);
+            ASSERT_EQ(1u, t.dirtyRanges().size());
+            assertRange(t.dirtyRanges()[0], 90, 430);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.markDirtyLimitsRangeCount", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(10000);
+            for (size_t i = 0; i < DirtyRangeTracker::MaxDirtyRanges; ++i) {
+                t.markDirty(i * 100, 10);
+            }
+            ASSERT_EQ(DirtyRangeTracker::MaxDirtyRanges, t.dirtyRanges().size());
+
+            // the new range is closest to the first one, so these two are merged
+            t.markDirty(15, 10);
+            ASSERT_EQ(DirtyRangeTracker::MaxDirtyRanges, t.dirtyRanges().size());
+            assertRange(t.dirtyRanges()[0], 0, 25);
+            assertRange(t.dirtyRanges()[1], 100, 10);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.markDirtyOutOfBounds", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100);
+            ASSERT_THROW(t.markDirty(95, 10), std::invalid_argument);
+        }
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Renderer/FrameProfiler.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static void recordFrame(FrameProfiler& profiler) {
+            const FrameScope frame(profiler);
+            const ProfileScope outer(profiler, "outer");
+            {
+                const ProfileScope inner(profiler, "inner");
+            }
+            {
+                const ProfileScope inner(profiler, "inner");
+            }
+        }
+
+        TEST_CASE("FrameProfilerTest.disabledByDefault", "[FrameProfilerTest]") {
+            FrameProfiler profiler;
+            ASSERT_FALSE(profiler.enabled());
+
+            recordFrame(profiler);
+            ASSERT_EQ(0u, profiler.frameCount());
+        }
+
+        TEST_CASE("FrameProfilerTest.recordSamples", "[FrameProfilerTest]") {
+            FrameProfiler profiler;
+            profiler.setEnabled(true);
+
+            // samples outside of a frame are ignored
+            {
+                const ProfileScope scope(profiler, "ignored");
+            }
+
+            recordFrame(profiler);
+            ASSERT_EQ(1u, profiler.frameCount());
+
+            const auto& frame = profiler.frame(0);
+            ASSERT_EQ(3u, frame.samples.size());
+            ASSERT_EQ(std::string("outer"), frame.samples[0].name);
+            ASSERT_EQ(0u, frame.samples[0].depth);
+            ASSERT_EQ(std::string("inner"), frame.samples[1].name);
+            ASSERT_EQ(1u, frame.samples[1].depth);
+            ASSERT_EQ(1u, frame.samples[2].depth);
+            ASSERT_TRUE(frame.samples[0].duration >= frame.samples[1].duration);
+        }
+
+        TEST_CASE("FrameProfilerTest.nestedFrames", "[FrameProfilerTest]") {
+            FrameProfiler profiler;
+            profiler.setEnabled(true);
+
+            profiler.beginFrame();
+            recordFrame(profiler);
+            profiler.endFrame();
+
+            ASSERT_EQ(1u, profiler.frameCount());
+            ASSERT_EQ(3u, profiler.frame(0).samples.size());
+        }
+
+        TEST_CASE("FrameProfilerTest.frameScopeEndsFrameOnException", "[FrameProfilerTest]") {
+            FrameProfiler profiler;
+            profiler.setEnabled(true);
+
+            try {
+                const FrameScope frame(profiler);
+                throw std::runtime_error("error");
+            } catch (const std::runtime_error&) {}
+
+            ASSERT_EQ(1u, profiler.frameCount());
+        }
+
+        TEST_CASE("FrameProfilerTest.ringBuffer", "[FrameProfilerTest]") {
+            FrameProfiler profiler(3);
+            profiler.setEnabled(true);
+
+            for (size_t i = 0; i < 5; ++i) {
+                recordFrame(profiler);
+            }
+            ASSERT_EQ(3u, profiler.frameCount());
+
+            // the frames are ordered from oldest to newest
+            ASSERT_TRUE(profiler.frame(0).start <= profiler.frame(1).start);
+            ASSERT_TRUE(profiler.frame(1).start <= profiler.frame(2).start);
+
+            profiler.clear();
+            ASSERT_EQ(0u, profiler.frameCount());
+        }
+
+        TEST_CASE("FrameProfilerTest.statistics", "[FrameProfilerTest]") {
+            FrameProfiler profiler;
+            profiler.setEnabled(true);
+
+            for (size_t i = 0; i < 4; ++i) {
+                recordFrame(profiler);
+            }
+
+            const auto statistics = profiler.statistics();
+            ASSERT_EQ(3u, statistics.size());
+            ASSERT_EQ("Frame", statistics.front().name);
+
+            for (const auto& entry : statistics) {
+                ASSERT_EQ(4u, entry.frameCount);
+                ASSERT_TRUE(entry.minMs <= entry.avgMs);
+                ASSERT_TRUE(entry.avgMs <= entry.maxMs);
+            }
+        }
+
+        TEST_CASE("FrameProfilerTest.writeChromeTrace", "[FrameProfilerTest]") {
+            FrameProfiler profiler;
+
+            std::stringstream empty;
+            profiler.writeChromeTrace(empty);
+            ASSERT_EQ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n]}\n", empty.str());
+
+            profiler.setEnabled(true);
+            profiler.beginFrame();
+            {
+                const ProfileScope scope(profiler, "a \"quoted\" name");
+            }
+            profiler.endFrame();
+
+            std::stringstream str;
+            profiler.writeChromeTrace(str);
+
+            const auto trace = str.str();
+            ASSERT_TRUE(trace.find("{\"name\":\"Frame\",\"cat\":\"render\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":0,") != std::string::npos);
+            ASSERT_TRUE(trace.find("{\"name\":\"a \\\"quoted\\\" name\"") != std::string::npos);
+        }
+    }
+}
@@ -0,0 +1,180 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/EditorContext.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/VisibilityState.h"
+#include "Model/World.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        // with the identity transformation, the world coordinates are the normalized device coordinates
+        static std::vector<vm::vec3> makeQuad(const FloatType size, const FloatType z) {
+            return {
+                vm::vec3(-size, -size, z),
+                vm::vec3(+size, -size, z),
+                vm::vec3(+size, +size, z),
+                vm::vec3(-size, +size, z)
+            };
+        }
+
+        TEST_CASE("OcclusionCullerTest.emptyDepthBuffer", "[OcclusionCullerTest]") {
+            OcclusionCuller culler(64, 64);
+            culler.begin(vm::mat4x4f::identity());
+
+            ASSERT_TRUE(culler.visible(vm::bbox3(vm::vec3(-0.5, -0.5, 0.0), vm::vec3(0.5, 0.5, 0.5))));
+
+            // outside of the view
+            ASSERT_FALSE(culler.visible(vm::bbox3(vm::vec3(1.5, -0.5, 0.0), vm::vec3(2.0, 0.5, 0.5))));
+
+            // entirely behind the near plane
+            ASSERT_FALSE(culler.visible(vm::bbox3(vm::vec3(-0.5, -0.5, -3.0), vm::vec3(0.5, 0.5, -2.0))));
+        }
+
+        TEST_CASE("OcclusionCullerTest.addOccluder", "[OcclusionCullerTest]") {
+            OcclusionCuller culler(64, 64);
+            culler.begin(vm::mat4x4f::identity());
+
+            // degenerate
+            ASSERT_FALSE(culler.addOccluder({ vm::vec3(0.0, 0.0, 0.0), vm::vec3(0.5, 0.0, 0.0), vm::vec3(1.0, 0.0, 0.0) }));
+            // behind the near plane
+            ASSERT_FALSE(culler.addOccluder(makeQuad(0.5, -2.0)));
+            // smaller than a pixel
+            ASSERT_FALSE(culler.addOccluder(makeQuad(0.001, 0.0)));
+
+            ASSERT_TRUE(culler.addOccluder(makeQuad(0.5, 0.0)));
+
+            // behind the occluder
+            ASSERT_FALSE(culler.visible(vm::bbox3(vm::vec3(-0.25, -0.25, 0.5), vm::vec3(0.25, 0.25, 0.6))));
+            // in front of the occluder
+            ASSERT_TRUE(culler.visible(vm::bbox3(vm::vec3(-0.25, -0.25, -0.5), vm::vec3(0.25, 0.25, -0.4))));
+            // touching the occluder
+            ASSERT_TRUE(culler.visible(vm::bbox3(vm::vec3(-0.25, -0.25, 0.0), vm::vec3(0.25, 0.25, 0.1))));
+            // partially behind the occluder
+            ASSERT_TRUE(culler.visible(vm::bbox3(vm::vec3(-0.25, -0.25, 0.5), vm::vec3(0.75, 0.25, 0.6))));
+            // reaching behind the near plane
+            ASSERT_TRUE(culler.visible(vm::bbox3(vm::vec3(-0.25, -0.25, -2.0), vm::vec3(0.25, 0.25, 0.6))));
+
+            // the depth buffer is cleared
+            culler.begin(vm::mat4x4f::identity());
+            ASSERT_TRUE(culler.visible(vm::bbox3(vm::vec3(-0.25, -0.25, 0.5), vm::vec3(0.25, 0.25, 0.6))));
+        }
+
+        TEST_CASE("OcclusionCullerTest.occluderCoversWholePixels", "[OcclusionCullerTest]") {
+            OcclusionCuller culler(4, 4);
+            culler.begin(vm::mat4x4f::identity());
+
+            // covers the centers of the pixels in the middle, but none of them entirely
+            ASSERT_FALSE(culler.addOccluder(makeQuad(0.4, 0.0)));
+            ASSERT_TRUE(culler.visible(vm::bbox3(vm::vec3(-0.1, -0.1, 0.5), vm::vec3(0.1, 0.1, 0.6))));
+
+            // covers the four pixels in the middle entirely
+            ASSERT_TRUE(culler.addOccluder(makeQuad(0.5, 0.0)));
+            ASSERT_FALSE(culler.visible(vm::bbox3(vm::vec3(-0.1, -0.1, 0.5), vm::vec3(0.1, 0.1, 0.6))));
+        }
+
+        class OcclusionCullerWorldTest {
+        protected:
+            const vm::bbox3 worldBounds;
+            Model::World world;
+            Model::EditorContext editorContext;
+            const PerspectiveCamera camera;
+        public:
+            OcclusionCullerWorldTest() :
+            worldBounds(8192.0),
+            world(Model::MapFormat::Standard),
+            camera(90.0f, 1.0f, 4096.0f, Camera::Viewport(0, 0, 1024, 768), vm::vec3f::zero(), vm::vec3f::pos_x(), vm::vec3f::pos_z()) {}
+
+            Model::Brush* addBrush(const vm::bbox3& bounds) {
+                Model::BrushBuilder builder(&world, worldBounds);
+                auto* brush = builder.createCuboid(bounds, "texture");
+                world.defaultLayer()->addChild(brush);
+                return brush;
+            }
+        };
+
+        TEST_CASE_METHOD(OcclusionCullerWorldTest, "OcclusionCullerTest.update", "[OcclusionCullerTest]") {
+            auto* wall = addBrush(vm::bbox3(vm::vec3(64.0, -512.0, -512.0), vm::vec3(80.0, 512.0, 512.0)));
+            auto* inFront = addBrush(vm::bbox3(vm::vec3(32.0, -8.0, -8.0), vm::vec3(40.0, 8.0, 8.0)));
+            auto* behindWall = addBrush(vm::bbox3(vm::vec3(256.0, -16.0, -16.0), vm::vec3(288.0, 16.0, 16.0)));
+            auto* behindCamera = addBrush(vm::bbox3(vm::vec3(-288.0, -16.0, -16.0), vm::vec3(-256.0, 16.0, 16.0)));
+
+            OcclusionCuller culler;
+            culler.update(camera, world, editorContext);
+
+            ASSERT_EQ(1u, culler.occluderCount());
+            ASSERT_TRUE(culler.visible(wall));
+            ASSERT_TRUE(culler.visible(inFront));
+            ASSERT_FALSE(culler.visible(behindWall));
+            ASSERT_FALSE(culler.visible(behindCamera));
+            ASSERT_EQ(2u, culler.visibleNodeCount());
+
+            // hidden brushes do not occlude
+            wall->setVisibilityState(Model::VisibilityState::Visibility_Hidden);
+            culler.update(camera, world, editorContext);
+
+            ASSERT_EQ(0u, culler.occluderCount());
+            ASSERT_TRUE(culler.visible(behindWall));
+        }
+
+        TEST_CASE_METHOD(OcclusionCullerWorldTest, "OcclusionCullerTest.updateIsDeterministic", "[OcclusionCullerTest]") {
+            std::vector<Model::Brush*> brushes;
+            for (size_t i = 0; i < 16; ++i) {
+                const auto x = 64.0 + 128.0 * static_cast<FloatType>(i);
+                brushes.push_back(addBrush(vm::bbox3(vm::vec3(x, -64.0 * static_cast<FloatType>(i + 1), -256.0), vm::vec3(x + 16.0, 0.0, 256.0))));
+                brushes.push_back(addBrush(vm::bbox3(vm::vec3(x + 32.0, -32.0, -32.0), vm::vec3(x + 64.0, 32.0, 32.0))));
+            }
+
+            OcclusionCuller culler;
+            culler.update(camera, world, editorContext);
+
+            std::vector<bool> expected;
+            for (const auto* brush : brushes) {
+                expected.push_back(culler.visible(brush));
+            }
+
+            // rebuilding the node tree changes its shape, but not the result
+            world.rebuildNodeTree();
+            for (size_t i = 0; i < 3; ++i) {
+                culler.update(camera, world, editorContext);
+
+                std::vector<bool> actual;
+                for (const auto* brush : brushes) {
+                    actual.push_back(culler.visible(brush));
+                }
+                ASSERT_EQ(expected, actual);
+            }
+        }
+    }
+}
@@ -109,6 +109,9 @@ namespace TrenchBroom {
         class TestCommand : public UndoableCommand {
         private:
             bool m_isRepeatDelimiter;
+            std::optional<size_t> m_memoryUsage;
+            std::optional<size_t> m_spilledMemoryUsage;
+            bool m_spilled = false;
 
             mutable std::vector<TestCommandCall> m_expectedCalls;
         public:
@@ -171,7 +174,39 @@ namespace TrenchBroom {
                 return expectedCall.returnCanCollate;
             }
 
+            size_t doGetMemoryUsage() const override {
+                return m_memoryUsage ? *m_memoryUsage : sizeof(*this) + name().capacity();
+            }
+
+            void doSpill(const std::shared_ptr<IO::SpillFile>&) override {
+                m_spilled = true;
+                if (m_spilledMemoryUsage) {
+                    m_memoryUsage = m_spilledMemoryUsage;
+                }
+            }
+
         public:
+            /**
+             * Overrides the memory usage reported by this command.
+             */
+            void setMemoryUsage(const size_t memoryUsage) {
+                m_memoryUsage = memoryUsage;
+            }
+
+            /**
+             * Sets the memory usage reported by this command after it was spilled.
+             */
+            void setSpilledMemoryUsage(const size_t memoryUsage) {
+                m_spilledMemoryUsage = memoryUsage;
+            }
+
+            /**
+             * Returns whether this command was asked to spill its data.
+             */
+            bool spilled() const {
+                return m_spilled;
+            }
+
             /**
              * Sets an expectation that doPerformDo() should be called.
              * When called, it will return the given `returnSuccess` value.
@@ -833,5 +868,168 @@ namespace TrenchBroom {
             ASSERT_EQ(commandName1, commandProcessor.undoCommandName());
             ASSERT_EQ(commandName2, commandProcessor.redoCommandName());
         }
+
+        TEST_CASE("CommandProcessorTest.undoMemoryBudget", "[CommandProcessorTest]") {
+            /*
+             * Execute three commands with a memory budget that fits only two of them. The oldest command cannot free
+             * any memory by spilling, so it is removed from the undo stack if discarding is enabled.
+             */
+
+            CommandProcessor commandProcessor(nullptr);
+            commandProcessor.setDiscardUndoOverBudget(true);
+
+            auto command1 = TestCommand::create("test command 1", false);
+            auto command2 = TestCommand::create("test command 2", false);
+            auto command3 = TestCommand::create("test command 3", false);
+            auto* command2Ptr = command2.get();
+            auto* command3Ptr = command3.get();
+
+            const auto commandSize = command1->memoryUsage();
+            commandProcessor.setUndoMemoryBudget(2u * commandSize);
+
+            command1->expectDo(true);
+            command1->expectCollate(command2Ptr, false);
+            command2->expectDo(true);
+            command2->expectCollate(command3Ptr, false);
+            command2->expectUndo(true);
+            command3->expectDo(true);
+            command3->expectUndo(true);
+
+            commandProcessor.executeAndStore(std::move(command1));
+            commandProcessor.executeAndStore(std::move(command2));
+            ASSERT_EQ(2u * commandSize, commandProcessor.undoMemoryUsage());
+
+            commandProcessor.executeAndStore(std::move(command3));
+            ASSERT_EQ(2u * commandSize, commandProcessor.undoMemoryUsage());
+
+            ASSERT_EQ(std::string("test command 3"), commandProcessor.undoCommandName());
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_EQ(std::string("test command 2"), commandProcessor.undoCommandName());
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_FALSE(commandProcessor.canUndo());
+
+            // the undone commands are now on the redo stack
+            ASSERT_EQ(2u * commandSize, commandProcessor.undoMemoryUsage());
+        }
+
+        TEST_CASE("CommandProcessorTest.undoMemoryBudgetKeepsCommands", "[CommandProcessorTest]") {
+            /*
+             * Execute three commands with a memory budget that fits only two of them. Without discarding enabled, all
+             * commands are kept even though the budget is exceeded.
+             */
+
+            CommandProcessor commandProcessor(nullptr);
+
+            auto command1 = TestCommand::create("test command 1", false);
+            auto command2 = TestCommand::create("test command 2", false);
+            auto* command1Ptr = command1.get();
+            auto* command2Ptr = command2.get();
+
+            command1->setMemoryUsage(100u);
+            command2->setMemoryUsage(100u);
+            commandProcessor.setUndoMemoryBudget(150u);
+
+            command1->expectDo(true);
+            command1->expectCollate(command2Ptr, false);
+            command1->expectUndo(true);
+            command2->expectDo(true);
+            command2->expectUndo(true);
+
+            commandProcessor.executeAndStore(std::move(command1));
+            commandProcessor.executeAndStore(std::move(command2));
+            ASSERT_EQ(200u, commandProcessor.undoMemoryUsage());
+
+            // the oldest command was asked to spill, the most recent one was not
+            ASSERT_TRUE(command1Ptr->spilled());
+            ASSERT_FALSE(command2Ptr->spilled());
+
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_FALSE(commandProcessor.canUndo());
+        }
+
+        TEST_CASE("CommandProcessorTest.undoMemoryBudgetSpillsCommands", "[CommandProcessorTest]") {
+            /*
+             * Execute three commands with a memory budget that fits only two of them. The oldest command frees its
+             * memory by spilling and remains on the undo stack.
+             */
+
+            CommandProcessor commandProcessor(nullptr);
+            commandProcessor.setDiscardUndoOverBudget(true);
+
+            auto command1 = TestCommand::create("test command 1", false);
+            auto command2 = TestCommand::create("test command 2", false);
+            auto command3 = TestCommand::create("test command 3", false);
+            auto* command1Ptr = command1.get();
+            auto* command2Ptr = command2.get();
+            auto* command3Ptr = command3.get();
+
+            command1->setMemoryUsage(100u);
+            command1->setSpilledMemoryUsage(10u);
+            command2->setMemoryUsage(100u);
+            command2->setSpilledMemoryUsage(10u);
+            command3->setMemoryUsage(100u);
+            command3->setSpilledMemoryUsage(10u);
+            commandProcessor.setUndoMemoryBudget(250u);
+
+            command1->expectDo(true);
+            command1->expectCollate(command2Ptr, false);
+            command1->expectUndo(true);
+            command2->expectDo(true);
+            command2->expectCollate(command3Ptr, false);
+            command2->expectUndo(true);
+            command3->expectDo(true);
+            command3->expectUndo(true);
+
+            commandProcessor.executeAndStore(std::move(command1));
+            commandProcessor.executeAndStore(std::move(command2));
+            ASSERT_EQ(200u, commandProcessor.undoMemoryUsage());
+            ASSERT_FALSE(command1Ptr->spilled());
+
+            commandProcessor.executeAndStore(std::move(command3));
+            ASSERT_EQ(210u, commandProcessor.undoMemoryUsage());
+            ASSERT_TRUE(command1Ptr->spilled());
+            ASSERT_FALSE(command2Ptr->spilled());
+            ASSERT_FALSE(command3Ptr->spilled());
+
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_FALSE(commandProcessor.canUndo());
+        }
+
+        TEST_CASE("CommandProcessorTest.undoMemoryUsageChangesWhileStored", "[CommandProcessorTest]") {
+            /*
+             * The memory usage of a command shrinks while it is on the undo stack. Undoing it must subtract exactly the
+             * amount that was added when it was stored.
+             */
+
+            CommandProcessor commandProcessor(nullptr);
+
+            auto command1 = TestCommand::create("test command 1", false);
+            auto command2 = TestCommand::create("test command 2", false);
+            auto* command2Ptr = command2.get();
+
+            command1->setMemoryUsage(100u);
+            command2->setMemoryUsage(1000u);
+
+            command1->expectDo(true);
+            command1->expectCollate(command2Ptr, false);
+            command2->expectDo(true);
+            command2->expectUndo(true);
+
+            commandProcessor.executeAndStore(std::move(command1));
+            commandProcessor.executeAndStore(std::move(command2));
+            ASSERT_EQ(1100u, commandProcessor.undoMemoryUsage());
+
+            command2Ptr->setMemoryUsage(10u);
+            ASSERT_TRUE(commandProcessor.undo()->success());
+
+            // command 2 is now accounted with its new usage on the redo stack
+            ASSERT_EQ(110u, commandProcessor.undoMemoryUsage());
+
+            commandProcessor.clear();
+            ASSERT_EQ(0u, commandProcessor.undoMemoryUsage());
+        }
     }
 }
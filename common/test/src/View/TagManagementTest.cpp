@@ -488,6 +488,34 @@ namespace TrenchBroom {
             }
         }
 
+        TEST_CASE_METHOD(TagManagementTest, "TagManagementTest.tagInitializeManyBrushFaceTags") {
+            std::vector<Model::Node*> brushes;
+            for (size_t i = 0; i < 1000u; ++i) {
+                brushes.push_back(createBrush(i % 2u == 0u ? "some_texture" : "other_texture"));
+            }
+            document->addNodes(brushes, document->currentParent());
+
+            const auto& textureTag = document->smartTag("texture");
+            const auto& surfaceParmTag = document->smartTag("surfaceparm");
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                const auto* brush = static_cast<Model::Brush*>(brushes[i]);
+                for (const auto* face : brush->faces()) {
+                    ASSERT_EQ(i % 2u == 0u, face->hasTag(textureTag));
+                    ASSERT_EQ(i % 2u == 0u, face->hasTag(surfaceParmTag));
+                }
+            }
+
+            auto* brush = static_cast<Model::Brush*>(brushes[1]);
+            document->select(brush);
+            document->setTexture(m_matchingTexture, false);
+            document->deselectAll();
+
+            for (const auto* face : brush->faces()) {
+                ASSERT_TRUE(face->hasTag(textureTag));
+                ASSERT_TRUE(face->hasTag(surfaceParmTag));
+            }
+        }
+
         TEST_CASE_METHOD(TagManagementTest, "TagManagementTest.tagRemoveBrushFaceTags") {
             auto* brushWithTags = createBrush("some_texture");
             document->addNode(brushWithTags, document->currentParent());
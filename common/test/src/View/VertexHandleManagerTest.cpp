@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+#include "View/VertexHandleManager.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        TEST_CASE("VertexHandleManagerTest.addRemoveHandles", "[VertexHandleManagerTest]") {
+            VertexHandleManager manager;
+
+            manager.add(vm::vec3(0, 0, 0));
+            manager.add(vm::vec3(0, 0, 0));
+            manager.add(vm::vec3(1000, 0, 0));
+            ASSERT_EQ(2u, manager.totalHandleCount());
+
+            ASSERT_TRUE(manager.remove(vm::vec3(0, 0, 0)));
+            ASSERT_EQ(2u, manager.totalHandleCount());
+
+            ASSERT_TRUE(manager.remove(vm::vec3(0, 0, 0)));
+            ASSERT_EQ(1u, manager.totalHandleCount());
+            ASSERT_FALSE(manager.contains(vm::vec3(0, 0, 0)));
+
+            ASSERT_FALSE(manager.remove(vm::vec3(0, 0, 0)));
+        }
+
+        TEST_CASE("VertexHandleManagerTest.selectCloseHandles", "[VertexHandleManagerTest]") {
+            // the handle at 64 and the point just below it are in different cells of the spatial hash
+            VertexHandleManager manager;
+            manager.add(vm::vec3(64, 64, 64));
+            manager.add(vm::vec3(128, 128, 128));
+
+            manager.select(vm::vec3(64.0 - 0.0000001, 64, 64));
+            ASSERT_TRUE(manager.selected(vm::vec3(64, 64, 64)));
+            ASSERT_FALSE(manager.selected(vm::vec3(128, 128, 128)));
+            ASSERT_EQ(1u, manager.selectedHandleCount());
+
+            manager.remove(vm::vec3(64, 64, 64));
+            ASSERT_EQ(0u, manager.selectedHandleCount());
+        }
+
+        TEST_CASE("VertexHandleManagerTest.findHandlesInBounds", "[VertexHandleManagerTest]") {
+            VertexHandleManager manager;
+            for (int x = -512; x <= 512; x += 16) {
+                manager.add(vm::vec3(static_cast<FloatType>(x), 0, 0));
+            }
+
+            auto handles = manager.findHandles(vm::bbox3(vm::vec3(-8, -8, -8), vm::vec3(40, 8, 8)));
+            std::sort(std::begin(handles), std::end(handles));
+            ASSERT_EQ((std::vector<vm::vec3>{ vm::vec3(0, 0, 0), vm::vec3(16, 0, 0), vm::vec3(32, 0, 0) }), handles);
+        }
+
+        TEST_CASE("VertexHandleManagerTest.findIncidentBrushes", "[VertexHandleManagerTest]") {
+            const vm::bbox3 worldBounds(4096.0);
+            Model::World world(Model::MapFormat::Standard);
+
+            Model::BrushBuilder builder(&world, worldBounds);
+            auto brush1 = std::unique_ptr<Model::Brush>(builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)), "texture"));
+            auto brush2 = std::unique_ptr<Model::Brush>(builder.createCuboid(vm::bbox3(vm::vec3(64, 0, 0), vm::vec3(128, 64, 64)), "texture"));
+
+            VertexHandleManager vertexHandles;
+            vertexHandles.addHandles(brush1.get());
+            vertexHandles.addHandles(brush2.get());
+            ASSERT_EQ(12u, vertexHandles.totalHandleCount());
+
+            ASSERT_EQ(std::vector<Model::Brush*>{ brush1.get() }, vertexHandles.findIncidentBrushes(vm::vec3(0, 0, 0)));
+            ASSERT_EQ(std::vector<Model::Brush*>{ brush2.get() }, vertexHandles.findIncidentBrushes(vm::vec3(128, 0, 0)));
+            ASSERT_EQ(2u, vertexHandles.findIncidentBrushes(vm::vec3(64, 0, 0)).size());
+            ASSERT_TRUE(vertexHandles.findIncidentBrushes(vm::vec3(32, 0, 0)).empty());
+
+            vertexHandles.removeHandles(brush1.get());
+            ASSERT_EQ(std::vector<Model::Brush*>{ brush2.get() }, vertexHandles.findIncidentBrushes(vm::vec3(64, 0, 0)));
+        }
+    }
+}
@@ -28,6 +28,7 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace kdl {
@@ -223,6 +224,7 @@ namespace kdl {
          */
         class node {
         private:
+            friend class compact_trie;
             friend struct node_cmp;
             friend class match_state;
 
@@ -292,8 +294,11 @@ namespace kdl {
                         // case 0, 1: m_key is a prefix of key, find or create a child that has a common prefix with
                         // the remainder of key and insert there
                         const auto remainder = key.substr(mismatch);
-                        const auto& child = *m_children.insert(node(std::string(remainder))).first;
-                        child.insert(remainder, value);
+                        auto it = m_children.find(remainder);
+                        if (it == std::end(m_children)) {
+                            it = m_children.insert(node(std::string(remainder))).first;
+                        }
+                        it->insert(remainder, value);
                     } else { // mismatch == m_key.size()
                         // case 2: key and m_key have a common prefix, split this node and insert again
                         split_node(mismatch);
@@ -471,7 +476,7 @@ namespace kdl {
                                 }
                             } else {
                                 // the key is consumed, so continue matching at the children
-                                for (auto it = m_children.lower_bound("0"), end = m_children.upper_bound("9"); it != end; ++it) {
+                                for (auto it = m_children.lower_bound(std::string_view("0")), end = m_children.upper_bound(std::string_view("9")); it != end; ++it) {
                                     it->find_matches(pattern, p_i, this, match_state, out);
                                 }
                             }
@@ -484,7 +489,7 @@ namespace kdl {
                                 }
                             } else {
                                 // the key is consumed, so continue matching at the children
-                                for (auto it = m_children.lower_bound("0"), end = m_children.upper_bound("9"); it != end; ++it) {
+                                for (auto it = m_children.lower_bound(std::string_view("0")), end = m_children.upper_bound(std::string_view("9")); it != end; ++it) {
                                     it->find_matches(pattern, p_i, this, match_state, out);
                                 }
                             }
@@ -505,6 +510,85 @@ namespace kdl {
                 }
             }
 
+            /**
+             * Finds the node in this node's subtree at which the given key ends. The key ends either at the end of the
+             * returned node's key or somewhere inside of it.
+             *
+             * @param key the key to find
+             * @return the node and the position in its key at which the given key ends, or a null node if no key in
+             * this subtree has the given key as a prefix
+             */
+            std::pair<const node*, std::size_t> find_node(std::string_view key) const {
+                const node* n = this;
+                while (true) {
+                    const std::size_t mismatch = kdl::cs::str_mismatch(key, n->m_key);
+                    if (mismatch == key.length()) {
+                        return { n, mismatch };
+                    }
+                    if (mismatch < n->m_key.length()) {
+                        return { nullptr, 0u };
+                    }
+
+                    key = key.substr(mismatch);
+                    const auto it = n->m_children.find(key);
+                    if (it == std::end(n->m_children)) {
+                        return { nullptr, 0u };
+                    }
+                    n = &*it;
+                }
+            }
+
+            /**
+             * Adds the values of this node to the given output iterator.
+             *
+             * @tparam O the type of the output iterator
+             * @param out the output iterator
+             */
+            template <typename O>
+            void get_values(O out) const {
+                for (const auto& [value, count] : m_values) {
+                    for (std::size_t i = 0u; i < count; ++i) {
+                        out++ = value;
+                    }
+                }
+            }
+
+            /**
+             * Adds the values of this node and of all nodes in its subtree to the given output iterator.
+             *
+             * @tparam O the type of the output iterator
+             * @param out the output iterator
+             */
+            template <typename O>
+            void get_values_and_recurse(O out) const {
+                get_values(out);
+                for (const auto& child : m_children) {
+                    child.get_values_and_recurse(out);
+                }
+            }
+
+            /**
+             * Adds the values of every node in this subtree whose key consists only of digits after the given position
+             * of this node's key to the given output iterator.
+             *
+             * @tparam O the type of the output iterator
+             * @param key_position the position in this node's key at which the digits start
+             * @param out the output iterator
+             */
+            template <typename O>
+            void get_numbered_values(const std::size_t key_position, O out) const {
+                for (std::size_t i = key_position; i < m_key.length(); ++i) {
+                    if (m_key[i] < '0' || m_key[i] > '9') {
+                        return;
+                    }
+                }
+
+                get_values(out);
+                for (auto it = m_children.lower_bound(std::string_view("0")), end = m_children.upper_bound(std::string_view("9")); it != end; ++it) {
+                    it->get_numbered_values(0u, out);
+                }
+            }
+
             /**
              * Adds the keys of all nodes in this subtree to the given output iterator.
              *
@@ -594,22 +678,6 @@ namespace kdl {
                 m_key += child.m_key;
             }
 
-            template <typename O>
-            void get_values(O out) const {
-                for (const auto& [value, count] : m_values) {
-                    for (std::size_t i = 0u; i < count; ++i) {
-                        out++ = value;
-                    }
-                }
-            }
-
-            template <typename O>
-            void get_values_and_recurse(O out) const {
-                get_values(out);
-                for (const auto& child : m_children) {
-                    child.get_values_and_recurse(out);
-                }
-            }
         };
 
         /**
@@ -695,6 +763,57 @@ namespace kdl {
             m_root.find_matches(pattern, { 0u }, nullptr, match_state, out);
         }
 
+        /**
+         * Finds all values which were inserted under exactly the given key and adds them to the given output iterator.
+         * Unlike `find_matches`, the key is not interpreted as a pattern, and no memory is allocated by the trie.
+         *
+         * @tparam O the type of the output iterator
+         * @param key the key to find
+         * @param out the output iterator
+         */
+        template <typename O>
+        void find_exact(const std::string_view key, O out) const {
+            const auto [n, key_position] = m_root.find_node(key);
+            if (n != nullptr && key_position == n->m_key.length()) {
+                n->get_values(out);
+            }
+        }
+
+        /**
+         * Finds all values whose keys start with the given prefix and adds them to the given output iterator. This is
+         * equivalent to matching the pattern `prefix*`, but does not allocate any memory within the trie.
+         *
+         * @tparam O the type of the output iterator
+         * @param prefix the prefix
+         * @param out the output iterator
+         */
+        template <typename O>
+        void find_prefix(const std::string_view prefix, O out) const {
+            const auto [n, key_position] = m_root.find_node(prefix);
+            if (n != nullptr) {
+                n->get_values_and_recurse(out);
+            }
+        }
+
+        /**
+         * Finds all values whose keys consist of the given prefix followed by any number of digits, e.g. "target",
+         * "target1" and "target23" for the prefix "target", and adds them to the given output iterator. This is
+         * equivalent to matching the pattern `prefix%*`, but does not allocate any memory within the trie.
+         *
+         * If a value was inserted under several matching keys, it is added once for each key.
+         *
+         * @tparam O the type of the output iterator
+         * @param prefix the prefix
+         * @param out the output iterator
+         */
+        template <typename O>
+        void find_numbered(const std::string_view prefix, O out) const {
+            const auto [n, key_position] = m_root.find_node(prefix);
+            if (n != nullptr) {
+                n->get_numbered_values(key_position, out);
+            }
+        }
+
         /**
          * Adds the keys of all nodes in this trie to the give output iterator.
          *
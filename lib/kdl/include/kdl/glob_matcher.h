@@ -0,0 +1,234 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef KDL_GLOB_MATCHER_H
+#define KDL_GLOB_MATCHER_H
+
+#include "string_compare.h"
+
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace kdl {
+    /**
+     * Matches strings against a glob pattern that is compiled once, which is much faster than calling
+     * str_matches_glob for every string if many strings must be matched against the same pattern.
+     *
+     * The supported patterns are the same as for str_matches_glob, see there. A pattern that contains an invalid escape
+     * sequence does not match any string.
+     *
+     * The pattern is compiled into a nondeterministic automaton with one state per pattern element, and the set of
+     * active states is kept in the bits of an integer. For each character, a lookup table yields the states that may
+     * consume the character, so matching a string requires a few bit operations per character and no allocations.
+     * The tables already account for the case sensitivity, so the matched strings need not be case folded.
+     *
+     * Patterns with more than 63 elements fall back to str_matches_glob.
+     */
+    class glob_matcher {
+    private:
+        using state_set = std::uint64_t;
+        static constexpr std::size_t max_elements = 63u;
+
+        std::string m_pattern;
+        bool m_case_sensitive;
+        bool m_valid;
+        bool m_compiled;
+
+        /**
+         * The number of elements of the compiled pattern. The automaton accepts if the state with this index is active.
+         */
+        std::size_t m_count;
+
+        /**
+         * For each character, the states of the elements which consume exactly one such character.
+         */
+        std::array<state_set, 256> m_advance;
+
+        /**
+         * For each character, the states of the elements which consume any number of such characters ('*' and "%*").
+         */
+        std::array<state_set, 256> m_stay;
+
+        /**
+         * The states of all elements that can consume any number of characters, including none.
+         */
+        state_set m_repeat;
+    public:
+        /**
+         * Creates a matcher for the given pattern.
+         *
+         * @param pattern the glob pattern
+         * @param case_sensitive whether characters are compared with case sensitivity
+         */
+        explicit glob_matcher(const std::string_view pattern, const bool case_sensitive = true) :
+        m_pattern(pattern),
+        m_case_sensitive(case_sensitive),
+        m_valid(true),
+        m_compiled(true),
+        m_count(0u),
+        m_advance{},
+        m_stay{},
+        m_repeat(0u) {
+            compile();
+        }
+
+        /**
+         * Creates a matcher that matches every string which contains the given string. Unlike the pattern passed to
+         * the constructor, the given string has no special characters.
+         *
+         * @param needle the string to search for
+         * @param case_sensitive whether characters are compared with case sensitivity
+         */
+        static glob_matcher substring(const std::string_view needle, const bool case_sensitive = true) {
+            std::string pattern;
+            pattern.reserve(needle.size() + 2u);
+            pattern.push_back('*');
+            for (const auto c : needle) {
+                if (c == '*' || c == '?' || c == '%' || c == '\\') {
+                    pattern.push_back('\\');
+                }
+                pattern.push_back(c);
+            }
+            pattern.push_back('*');
+            return glob_matcher(pattern, case_sensitive);
+        }
+
+        /**
+         * Returns the pattern of this matcher.
+         */
+        const std::string& pattern() const {
+            return m_pattern;
+        }
+
+        /**
+         * Checks whether the given string matches the pattern of this matcher.
+         *
+         * @param str the string to match
+         * @return true if the given string matches and false otherwise
+         */
+        bool matches(const std::string_view str) const {
+            if (!m_valid) {
+                return false;
+            }
+            if (!m_compiled) {
+                return m_case_sensitive ? cs::str_matches_glob(str, m_pattern) : ci::str_matches_glob(str, m_pattern);
+            }
+
+            auto states = close(state_set(1u));
+            for (const auto c : str) {
+                const auto i = static_cast<unsigned char>(c);
+                states = ((states & m_advance[i]) << 1u) | (states & m_stay[i]);
+                if (states == 0u) {
+                    return false;
+                }
+                states = close(states);
+            }
+
+            return (states >> m_count) & 1u;
+        }
+
+        bool operator()(const std::string_view str) const {
+            return matches(str);
+        }
+    private:
+        /**
+         * Activates the successors of all active states whose elements may consume no characters.
+         */
+        state_set close(state_set states) const {
+            while (true) {
+                const auto closed = states | ((states & m_repeat) << 1u);
+                if (closed == states) {
+                    return states;
+                }
+                states = closed;
+            }
+        }
+
+        void compile() {
+            const auto& p = m_pattern;
+            std::size_t i = 0u;
+            while (i < p.length()) {
+                if (m_count == max_elements) {
+                    m_compiled = false;
+                    return;
+                }
+
+                if (p[i] == '\\' && i < p.length() - 1u) {
+                    const auto n = p[i + 1u];
+                    if (n != '*' && n != '?' && n != '%' && n != '\\') {
+                        m_valid = false;
+                        return;
+                    }
+                    add_exact(n);
+                    i += 2u;
+                } else if (p[i] == '*') {
+                    add_class(m_stay, [](unsigned char) { return true; });
+                    m_repeat |= state_set(1u) << m_count;
+                    ++i;
+                } else if (p[i] == '?') {
+                    add_class(m_advance, [](unsigned char) { return true; });
+                    ++i;
+                } else if (p[i] == '%') {
+                    if (i < p.length() - 1u && p[i + 1u] == '*') {
+                        add_class(m_stay, is_digit);
+                        m_repeat |= state_set(1u) << m_count;
+                        i += 2u;
+                    } else {
+                        add_class(m_advance, is_digit);
+                        ++i;
+                    }
+                } else {
+                    add_literal(p[i]);
+                    ++i;
+                }
+                ++m_count;
+            }
+        }
+
+        static bool is_digit(const unsigned char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        template <typename P>
+        void add_class(std::array<state_set, 256>& table, const P& pred) {
+            for (std::size_t c = 0u; c < table.size(); ++c) {
+                if (pred(static_cast<unsigned char>(c))) {
+                    table[c] |= state_set(1u) << m_count;
+                }
+            }
+        }
+
+        void add_exact(const char l) {
+            m_advance[static_cast<unsigned char>(l)] |= state_set(1u) << m_count;
+        }
+
+        void add_literal(const char l) {
+            if (m_case_sensitive) {
+                add_exact(l);
+            } else {
+                const auto folded = std::tolower(static_cast<unsigned char>(l));
+                add_class(m_advance, [&](const unsigned char c) { return std::tolower(c) == folded; });
+            }
+        }
+    };
+}
+
+#endif //KDL_GLOB_MATCHER_H
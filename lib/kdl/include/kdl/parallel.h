@@ -0,0 +1,123 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef KDL_PARALLEL_H
+#define KDL_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace kdl {
+    /**
+     * Calls the given function once for every index in [0, count), distributing the indices over up to
+     * std::thread::hardware_concurrency() threads. Each thread processes a contiguous range of indices. If the number
+     * of indices is less than the given minimum per thread, or if only one hardware thread is available, all indices
+     * are processed on the calling thread.
+     *
+     * The function is called concurrently and must therefore be safe to call from several threads at once. If any call
+     * throws, the remaining indices of its range are skipped, and the first exception (in the order of the ranges) is
+     * rethrown after all threads have finished.
+     *
+     * @tparam F the type of the function, must be callable with a size_t
+     * @param count the number of indices
+     * @param func the function to call
+     * @param minCountPerThread the minimum number of indices that justify starting another thread
+     */
+    template <typename F>
+    void parallel_for(const std::size_t count, F&& func, const std::size_t minCountPerThread = 1u) {
+        const auto hardwareThreads = static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u));
+        const auto threadCount = std::min(hardwareThreads, count / std::max(minCountPerThread, std::size_t(1)));
+
+        if (threadCount <= 1u) {
+            for (std::size_t i = 0u; i < count; ++i) {
+                func(i);
+            }
+            return;
+        }
+
+        const auto processRange = [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                func(i);
+            }
+        };
+
+        // the calling thread processes the first range itself
+        const auto countPerThread = count / threadCount;
+        const auto remainder = count % threadCount;
+        const auto rangeEnd = [&](const std::size_t t) {
+            return (t + 1u) * countPerThread + std::min(t + 1u, remainder);
+        };
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(threadCount - 1u);
+        for (std::size_t t = 1u; t < threadCount; ++t) {
+            futures.push_back(std::async(std::launch::async, processRange, rangeEnd(t - 1u), rangeEnd(t)));
+        }
+
+        std::exception_ptr exception;
+        try {
+            processRange(0u, rangeEnd(0u));
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        for (auto& future : futures) {
+            try {
+                future.get();
+            } catch (...) {
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    /**
+     * Applies the given function to every element of the given vector in parallel and returns a vector containing the
+     * results in the order of the elements. See parallel_for.
+     *
+     * The function must not return bool because the elements of std::vector<bool> cannot be written concurrently.
+     *
+     * @tparam T the type of the vector elements
+     * @tparam A the vector's allocator type
+     * @tparam F the type of the function, must be callable with a const T&
+     * @param v the vector
+     * @param func the function to apply
+     * @param minCountPerThread the minimum number of elements that justify starting another thread
+     * @return a vector containing the results
+     */
+    template <typename T, typename A, typename F>
+    auto vec_parallel_transform(const std::vector<T, A>& v, F&& func, const std::size_t minCountPerThread = 1u) {
+        using R = std::decay_t<decltype(func(std::declval<const T&>()))>;
+        static_assert(!std::is_same_v<R, bool>, "std::vector<bool> cannot be written concurrently");
+
+        std::vector<R> result(v.size());
+        parallel_for(v.size(), [&](const std::size_t i) { result[i] = func(v[i]); }, minCountPerThread);
+        return result;
+    }
+}
+
+#endif //KDL_PARALLEL_H
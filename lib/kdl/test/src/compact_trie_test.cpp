@@ -182,6 +182,91 @@ namespace kdl {
         ASSERT_MATCHES(std::vector<std::string>({}), index, "k%*")
     }
 
+#define ASSERT_FOUND(exp_, index, find, key) {\
+    std::vector<std::string> exp(exp_);\
+    std::vector<std::string> act;\
+    index.find(key, std::back_inserter(act));\
+    vec_sort(exp);\
+    vec_sort(act);\
+    ASSERT_EQ(exp, act);\
+}
+
+    TEST_CASE("compact_trie_test.find_exact", "[compact_trie_test]") {
+        test_index index;
+        index.insert("key", "value");
+        index.insert("key2", "value");
+        index.insert("key22", "value2");
+        index.insert("k*y", "value3");
+
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_exact, "whoops")
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_exact, "k")
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_exact, "key222")
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_exact, "")
+        ASSERT_FOUND(std::vector<std::string>({ "value" }), index, find_exact, "key")
+        ASSERT_FOUND(std::vector<std::string>({ "value2" }), index, find_exact, "key22")
+
+        // the key is not interpreted as a pattern
+        ASSERT_FOUND(std::vector<std::string>({ "value3" }), index, find_exact, "k*y")
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_exact, "k?y")
+
+        index.insert("key", "value4");
+        ASSERT_FOUND(std::vector<std::string>({ "value", "value4" }), index, find_exact, "key")
+
+        index.remove("key", "value");
+        ASSERT_FOUND(std::vector<std::string>({ "value4" }), index, find_exact, "key")
+    }
+
+    TEST_CASE("compact_trie_test.find_prefix", "[compact_trie_test]") {
+        test_index index;
+        index.insert("key", "value");
+        index.insert("key2", "value");
+        index.insert("key22", "value2");
+        index.insert("k1", "value3");
+        index.insert("test", "value4");
+
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_prefix, "whoops")
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_prefix, "key222")
+        ASSERT_FOUND(std::vector<std::string>({ "value", "value", "value2", "value3" }), index, find_prefix, "k")
+        ASSERT_FOUND(std::vector<std::string>({ "value", "value", "value2" }), index, find_prefix, "ke")
+        ASSERT_FOUND(std::vector<std::string>({ "value", "value2" }), index, find_prefix, "key2")
+        ASSERT_FOUND(std::vector<std::string>({ "value4" }), index, find_prefix, "test")
+        ASSERT_FOUND(std::vector<std::string>({ "value", "value", "value2", "value3", "value4" }), index, find_prefix, "")
+    }
+
+    TEST_CASE("compact_trie_test.find_numbered", "[compact_trie_test]") {
+        test_index index;
+        index.insert("key", "value");
+        index.insert("key2", "value");
+        index.insert("key22", "value2");
+        index.insert("key22bs", "value4");
+        index.insert("key2b3", "value5");
+        index.insert("keyb", "value6");
+        index.insert("k1", "value3");
+
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_numbered, "whoops")
+        ASSERT_FOUND(std::vector<std::string>({ "value", "value", "value2" }), index, find_numbered, "key")
+        ASSERT_FOUND(std::vector<std::string>({ "value", "value2" }), index, find_numbered, "key2")
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_numbered, "ke")
+        ASSERT_FOUND(std::vector<std::string>({ "value3" }), index, find_numbered, "k")
+        ASSERT_FOUND(std::vector<std::string>({ "value4" }), index, find_numbered, "key22bs")
+
+        // the prefix may end inside of a node's key
+        index.insert("target12", "value7");
+        ASSERT_FOUND(std::vector<std::string>({ "value7" }), index, find_numbered, "target")
+        ASSERT_FOUND(std::vector<std::string>({ "value7" }), index, find_numbered, "target1")
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_numbered, "targ")
+
+        // same results as matching the pattern prefix%*
+        for (const auto* prefix : { "k", "ke", "key", "key2", "key22", "target", "targ" }) {
+            std::vector<std::string> expected;
+            index.find_matches(std::string(prefix) + "%*", std::back_inserter(expected));
+            ASSERT_FOUND(expected, index, find_numbered, prefix)
+        }
+
+        index.remove("k1", "value3");
+        ASSERT_FOUND(std::vector<std::string>({}), index, find_numbered, "k")
+    }
+
     TEST_CASE("compact_trie_test.get_keys", "[compact_trie_test]") {
         test_index index;
         index.insert("key", "value");
@@ -0,0 +1,144 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "kdl/glob_matcher.h"
+#include "kdl/string_compare.h"
+
+#include <string>
+
+namespace kdl {
+    static bool matches_cs(const std::string_view str, const std::string_view pattern) {
+        return glob_matcher(pattern, true).matches(str);
+    }
+
+    static bool matches_ci(const std::string_view str, const std::string_view pattern) {
+        return glob_matcher(pattern, false).matches(str);
+    }
+
+    TEST_CASE("glob_matcher_test.matches_case_sensitive", "[glob_matcher_test]") {
+        ASSERT_TRUE(matches_cs("", ""));
+        ASSERT_TRUE(matches_cs("", "*"));
+        ASSERT_FALSE(matches_cs("", "?"));
+        ASSERT_TRUE(matches_cs("asdf", "asdf"));
+        ASSERT_TRUE(matches_cs("asdf", "*"));
+        ASSERT_TRUE(matches_cs("asdf", "a??f"));
+        ASSERT_FALSE(matches_cs("asdf", "a?f"));
+        ASSERT_TRUE(matches_cs("asdf", "*f"));
+        ASSERT_TRUE(matches_cs("asdf", "a*f"));
+        ASSERT_TRUE(matches_cs("asdf", "?s?f"));
+        ASSERT_TRUE(matches_cs("asdfjkl", "a*f*l"));
+        ASSERT_TRUE(matches_cs("asdfjkl", "*a*f*l*"));
+        ASSERT_TRUE(matches_cs("asd*fjkl", "*a*f*l*"));
+        ASSERT_TRUE(matches_cs("asd*fjkl", "asd\\*fjkl"));
+        ASSERT_TRUE(matches_cs("asd*?fj\\kl", "asd\\*\\?fj\\\\kl"));
+        ASSERT_FALSE(matches_cs("asdf", "*F"));
+        ASSERT_FALSE(matches_cs("asdF", "a*f"));
+        ASSERT_FALSE(matches_cs("ASDF", "?S?f"));
+
+        ASSERT_FALSE(matches_cs("classname", "*_color"));
+
+        ASSERT_FALSE(matches_cs("", "%"));
+        ASSERT_TRUE(matches_cs("", "%*"));
+        ASSERT_TRUE(matches_cs("0", "%"));
+        ASSERT_TRUE(matches_cs("9", "%"));
+        ASSERT_FALSE(matches_cs("99", "%"));
+        ASSERT_FALSE(matches_cs("a", "%"));
+        ASSERT_FALSE(matches_cs("3Z", "%*"));
+        ASSERT_FALSE(matches_cs("Zasdf", "*%"));
+        ASSERT_TRUE(matches_cs("Zasdf33", "Z*%%"));
+        ASSERT_TRUE(matches_cs("Zasdf3376", "Z*%*"));
+        ASSERT_FALSE(matches_cs("Zasdf3376bdc", "Zasdf%*"));
+        ASSERT_TRUE(matches_cs("Zasdf3376bdc", "Z*%*bdc"));
+        ASSERT_TRUE(matches_cs("78777Zasdf3376bdc", "%*Z*%**"));
+
+        ASSERT_TRUE(matches_cs("34dkadj%773", "*\\%%*"));
+
+        // a trailing backslash is a literal character, but invalid escape sequences never match
+        ASSERT_TRUE(matches_cs("asdf\\", "asdf\\"));
+        ASSERT_FALSE(matches_cs("asdf", "as\\df"));
+        ASSERT_FALSE(matches_cs("as\\df", "as\\df"));
+    }
+
+    TEST_CASE("glob_matcher_test.matches_case_insensitive", "[glob_matcher_test]") {
+        ASSERT_TRUE(matches_ci("ASdf", "asdf"));
+        ASSERT_TRUE(matches_ci("AsdF", "*"));
+        ASSERT_TRUE(matches_ci("ASdf", "a??f"));
+        ASSERT_FALSE(matches_ci("AsDF", "a?f"));
+        ASSERT_TRUE(matches_ci("asdF", "*f"));
+        ASSERT_TRUE(matches_ci("aSDF", "a*f"));
+        ASSERT_TRUE(matches_ci("AsDfjkl", "*a*f*l*"));
+        ASSERT_TRUE(matches_ci("ASd*fjKl", "asd\\*fjkl"));
+        ASSERT_TRUE(matches_ci("aSD*?fJ\\kL", "asd\\*\\?fj\\\\kl"));
+        ASSERT_FALSE(matches_ci("asdf", "asdg"));
+    }
+
+    TEST_CASE("glob_matcher_test.substring", "[glob_matcher_test]") {
+        ASSERT_TRUE(glob_matcher::substring("").matches(""));
+        ASSERT_TRUE(glob_matcher::substring("").matches("asdf"));
+        ASSERT_TRUE(glob_matcher::substring("sd").matches("asdf"));
+        ASSERT_FALSE(glob_matcher::substring("sD").matches("asdf"));
+        ASSERT_TRUE(glob_matcher::substring("sD", false).matches("aSdf"));
+        ASSERT_FALSE(glob_matcher::substring("df", false).matches("asd"));
+        ASSERT_TRUE(glob_matcher::substring("*?%\\").matches("a*?%\\b"));
+        ASSERT_FALSE(glob_matcher::substring("*").matches("asdf"));
+        ASSERT_FALSE(glob_matcher::substring("%").matches("as3df"));
+    }
+
+    TEST_CASE("glob_matcher_test.long_pattern", "[glob_matcher_test]") {
+        // patterns with too many elements are not compiled
+        const auto pattern = std::string(70u, 'a') + "*" + std::string(10u, 'b');
+        const auto matcher = glob_matcher(pattern, false);
+        ASSERT_TRUE(matcher.matches(std::string(70u, 'A') + "xyz" + std::string(10u, 'b')));
+        ASSERT_FALSE(matcher.matches(std::string(69u, 'a') + "xyz" + std::string(10u, 'b')));
+
+        const auto longest = std::string(62u, 'a') + "*";
+        ASSERT_TRUE(glob_matcher(longest).matches(std::string(62u, 'a')));
+        ASSERT_TRUE(glob_matcher(longest).matches(std::string(100u, 'a')));
+        ASSERT_FALSE(glob_matcher(longest).matches(std::string(61u, 'a')));
+    }
+
+    TEST_CASE("glob_matcher_test.matches_like_str_matches_glob", "[glob_matcher_test]") {
+        const auto patterns = std::vector<std::string>({
+            "", "*", "**", "?", "a*", "*a", "a?b", "a*b*c", "*%*", "%%*", "%*a%", "a%*%b", "\\**", "*\\?", "?*?*?", "A*b"
+        });
+        const auto alphabet = std::string("ab1?*");
+
+        // enumerate all strings of up to five characters over the alphabet
+        std::vector<std::string> strings({ "" });
+        for (std::size_t i = 0u; i < strings.size(); ++i) {
+            if (strings[i].size() < 5u) {
+                for (const auto c : alphabet) {
+                    strings.push_back(strings[i] + c);
+                }
+            }
+        }
+
+        for (const auto& pattern : patterns) {
+            const auto csMatcher = glob_matcher(pattern, true);
+            const auto ciMatcher = glob_matcher(pattern, false);
+            for (const auto& str : strings) {
+                CHECK(csMatcher.matches(str) == cs::str_matches_glob(str, pattern));
+                CHECK(ciMatcher.matches(str) == ci::str_matches_glob(str, pattern));
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "kdl/parallel.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace kdl {
+    TEST_CASE("parallel_test.parallel_for", "[parallel_test]") {
+        for (const std::size_t count : { 0u, 1u, 7u, 1000u }) {
+            std::vector<int> visited(count, 0);
+            parallel_for(count, [&](const std::size_t i) { ++visited[i]; });
+            ASSERT_EQ(std::vector<int>(count, 1), visited);
+        }
+    }
+
+    TEST_CASE("parallel_test.parallel_for_min_count", "[parallel_test]") {
+        std::atomic<std::size_t> sum(0u);
+        parallel_for(100u, [&](const std::size_t i) { sum += i; }, 1000u);
+        ASSERT_EQ(4950u, sum.load());
+    }
+
+    TEST_CASE("parallel_test.parallel_for_exception", "[parallel_test]") {
+        ASSERT_THROW(parallel_for(100u, [&](const std::size_t i) {
+            if (i == 50u) {
+                throw std::runtime_error("test");
+            }
+        }), std::runtime_error);
+    }
+
+    TEST_CASE("parallel_test.vec_parallel_transform", "[parallel_test]") {
+        ASSERT_EQ(std::vector<int>{}, vec_parallel_transform(std::vector<int>{}, [](const int i) { return 2 * i; }));
+        ASSERT_EQ(std::vector<int>({ 2, 4, 6, 8 }), vec_parallel_transform(std::vector<int>({ 1, 2, 3, 4 }), [](const int i) { return 2 * i; }));
+    }
+}